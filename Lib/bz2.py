@@ -184,6 +184,12 @@ class BZ2File(io.BufferedIOBase):
         # Depending on the input data, our call to the decompressor may not
         # return any data. In this case, try again after reading another block.
         while self._buffer_offset == len(self._buffer):
+            if not (self._decompressor.eof or self._decompressor.needs_input):
+                # Drain input held back by an earlier readinto().
+                self._buffer = self._decompressor.decompress(b"")
+                self._buffer_offset = 0
+                continue
+
             rawblock = (self._decompressor.unused_data or
                         self._fp.read(_BUFFER_SIZE))
 
@@ -317,7 +323,50 @@ class BZ2File(io.BufferedIOBase):
         Returns the number of bytes read (0 for EOF).
         """
         with self._lock:
-            return io.BufferedIOBase.readinto(self, b)
+            self._check_can_read()
+            view = memoryview(b).cast("B")
+            # Hand out buffered data first, then decompress straight into b.
+            n = min(len(view), len(self._buffer) - self._buffer_offset)
+            view[:n] = self._buffer[self._buffer_offset :
+                                    self._buffer_offset + n]
+            self._buffer_offset += n
+            self._pos += n
+            while n < len(view) and self._mode != _MODE_READ_EOF:
+                n += self._decompress_into(view[n:])
+            return n
+
+    # Decompress into view without going through self._buffer.
+    # Returns the number of bytes written, which may be 0 if more input
+    # is needed or EOF was reached.
+    def _decompress_into(self, view):
+        if self._decompressor.eof or self._decompressor.needs_input:
+            rawblock = (self._decompressor.unused_data or
+                        self._fp.read(_BUFFER_SIZE))
+            if not rawblock:
+                if self._decompressor.eof:
+                    self._mode = _MODE_READ_EOF
+                    self._size = self._pos
+                    return 0
+                else:
+                    raise EOFError("Compressed file ended before the "
+                                   "end-of-stream marker was reached")
+        else:
+            rawblock = b""
+
+        # Continue to next stream.
+        if self._decompressor.eof:
+            self._decompressor = BZ2Decompressor()
+            try:
+                n = self._decompressor.decompress_into(rawblock, view)
+            except OSError:
+                # Trailing data isn't a valid bzip2 stream. We're done here.
+                self._mode = _MODE_READ_EOF
+                self._size = self._pos
+                return 0
+        else:
+            n = self._decompressor.decompress_into(rawblock, view)
+        self._pos += n
+        return n
 
     def readline(self, size=-1):
         """Read a line of uncompressed bytes from the file.
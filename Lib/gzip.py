@@ -126,7 +126,7 @@ class _PaddedFile:
 
 class GzipFile(io.BufferedIOBase):
     """The GzipFile class simulates most of the methods of a file object with
-    the exception of the readinto() and truncate() methods.
+    the exception of the truncate() method.
 
     This class only supports opening files in binary mode. If you need to open a
     compressed file in text mode, use the gzip.open() function.
@@ -426,6 +426,36 @@ class GzipFile(io.BufferedIOBase):
         assert remaining == len(self.extrabuf) - offset
         return self.extrabuf[offset:offset + n]
 
+    def readinto(self, b):
+        self._check_closed()
+        if self.mode != READ:
+            import errno
+            raise IOError(errno.EBADF, "readinto() on write-only GzipFile object")
+
+        if self.extrasize <= 0 and self.fileobj is None:
+            return 0
+
+        # Hand out buffered data first, then decompress straight into b.
+        view = memoryview(b).cast("B")
+        n = self._read_buffered(view)
+        try:
+            while n < len(view):
+                n += self._read_into(view[n:])
+        except EOFError:
+            # The final flush may have left some data in extrabuf.
+            n += self._read_buffered(view[n:])
+        return n
+
+    def _read_buffered(self, view):
+        size = min(len(view), self.extrasize)
+        if size <= 0:
+            return 0
+        offset = self.offset - self.extrastart
+        view[:size] = self.extrabuf[offset: offset + size]
+        self.extrasize -= size
+        self.offset += size
+        return size
+
     def _unread(self, buf):
         self.extrasize = len(buf) + self.extrasize
         self.offset -= len(buf)
@@ -442,20 +472,24 @@ class GzipFile(io.BufferedIOBase):
             self.decompress = zlib.decompressobj(-zlib.MAX_WBITS)
             self._new_member = False
 
-        # Read a chunk of data from the file
-        buf = self.fileobj.read(size)
-
-        # If the EOF has been reached, flush the decompression object
-        # and mark this object as finished.
-
-        if buf == b"":
-            uncompress = self.decompress.flush()
-            # Prepend the already read bytes to the fileobj to they can be
-            # seen by _read_eof()
-            self.fileobj.prepend(self.decompress.unused_data, True)
-            self._read_eof()
-            self._add_read_data( uncompress )
-            raise EOFError('Reached EOF')
+        # Read a chunk of data from the file, unless readinto() left some
+        # in the decompression object
+        if self.decompress.needs_input:
+            buf = self.fileobj.read(size)
+
+            # If the EOF has been reached, flush the decompression object
+            # and mark this object as finished.
+
+            if buf == b"":
+                uncompress = self.decompress.flush()
+                # Prepend the already read bytes to the fileobj to they can
+                # be seen by _read_eof()
+                self.fileobj.prepend(self.decompress.unused_data, True)
+                self._read_eof()
+                self._add_read_data( uncompress )
+                raise EOFError('Reached EOF')
+        else:
+            buf = b""
 
         uncompress = self.decompress.decompress(buf)
         self._add_read_data( uncompress )
@@ -472,6 +506,47 @@ class GzipFile(io.BufferedIOBase):
             self._read_eof()
             self._new_member = True
 
+    # Like _read(), but decompress into view instead of extrabuf, which must
+    # be empty.  Returns the number of bytes written to view.
+    def _read_into(self, view):
+        if self.fileobj is None:
+            raise EOFError("Reached EOF")
+
+        if self._new_member:
+            self._init_read()
+            self._read_gzip_header()
+            self.decompress = zlib.decompressobj(-zlib.MAX_WBITS)
+            self._new_member = False
+
+        # After the end of the stream the trailer may still be in the file;
+        # read it so that it ends up in unused_data.
+        if self.decompress.needs_input or self.decompress.eof:
+            buf = self.fileobj.read(max(1024, min(len(view),
+                                                  self.max_read_chunk)))
+            if buf == b"":
+                uncompress = self.decompress.flush()
+                self.fileobj.prepend(self.decompress.unused_data, True)
+                self._read_eof()
+                self._add_read_data( uncompress )
+                raise EOFError('Reached EOF')
+        else:
+            # The decompressor kept input back when view last filled up.
+            buf = b""
+
+        size = self.decompress.decompress_into(buf, view)
+        self.crc = zlib.crc32(view[:size], self.crc) & 0xffffffff
+        self.size += size
+        self.offset += size
+        self.extrabuf = b""
+        self.extrastart = self.offset
+
+        if self.decompress.unused_data != b"":
+            # End of this member; see _read().
+            self.fileobj.prepend(self.decompress.unused_data, True)
+            self._read_eof()
+            self._new_member = True
+        return size
+
     def _add_read_data(self, data):
         self.crc = zlib.crc32(data, self.crc) & 0xffffffff
         offset = self.offset - self.extrastart
@@ -95,6 +95,24 @@ def _path_split(path):
     return front, tail
 
 
+def _path_isabs(path):
+    """Replacement for os.path.isabs."""
+    if path.startswith(tuple(path_separators)):
+        return True
+    # A drive letter on Windows.
+    return path_sep == '\\' and path[1:3] in (':\\', ':/')
+
+
+def _path_absolute(path):
+    """Replacement for os.path.abspath that only drops leading '.'
+    components."""
+    if _path_isabs(path):
+        return path
+    while path == '.' or path[:2] in ['.' + sep for sep in path_separators]:
+        path = path[2:]
+    return _path_join(_os.getcwd(), path)
+
+
 def _path_is_mode_type(path, mode):
     """Test whether the path is the specified mode type."""
     try:
@@ -396,13 +414,15 @@ Known values:
                      3210 (added size modulo 2**32 to the pyc header)
     Python 3.3a1  3220 (changed PEP 380 implementation)
     Python 3.3a4  3230 (revert changes to implicit __class__ closure)
+                  3240 (marshal version 3: object references)
+                  3250 (add superinstructions)
 
 MAGIC must change whenever the bytecode emitted by the compiler may no
 longer be understood by older implementations of the eval loop (usually
 due to the addition of new opcodes).
 
 """
-_RAW_MAGIC_NUMBER = 3230 | ord('\r') << 16 | ord('\n') << 24
+_RAW_MAGIC_NUMBER = 3250 | ord('\r') << 16 | ord('\n') << 24
 _MAGIC_BYTES = bytes(_RAW_MAGIC_NUMBER >> n & 0xff for n in range(0, 25, 8))
 
 _PYCACHE = '__pycache__'
@@ -799,6 +819,10 @@ class _LoaderBasics:
         tail_name = fullname.rpartition('.')[2]
         return filename_base == '__init__' and tail_name != '__init__'
 
+    def _get_bytecode_data(self, path):
+        """Return the contents of the bytecode file at path."""
+        return self.get_data(path)
+
     def _bytes_from_bytecode(self, fullname, data, bytecode_path, source_stats):
         """Return the marshalled bytes from bytecode, verifying the magic
         number, timestamp and source size along the way.
@@ -806,7 +830,7 @@ class _LoaderBasics:
         If source_stats is None then skip the timestamp check.
 
         """
-        magic = data[:4]
+        magic = bytes(data[:4])
         raw_timestamp = data[4:8]
         raw_size = data[8:12]
         if magic != _MAGIC_BYTES:
@@ -842,8 +866,10 @@ class _LoaderBasics:
                         "bytecode is stale for {}".format(fullname),
                         name=fullname, path=bytecode_path)
         # Can't return the code object as errors from marshal loading need to
-        # propagate even when source is available.
-        return data[12:]
+        # propagate even when source is available.  A memoryview lets
+        # marshal.loads() read the code straight out of data, without copying
+        # it first.
+        return memoryview(data)[12:]
 
     @module_for_loader
     def _load_module(self, module, *, sourceless=False):
@@ -951,7 +977,7 @@ class SourceLoader(_LoaderBasics):
             else:
                 source_mtime = int(st['mtime'])
                 try:
-                    data = self.get_data(bytecode_path)
+                    data = self._get_bytecode_data(bytecode_path)
                 except IOError:
                     pass
                 else:
@@ -1031,6 +1057,18 @@ class FileLoader:
         with _io.FileIO(path, 'r') as file:
             return file.read()
 
+    def _get_bytecode_data(self, path):
+        """Map the bytecode file at path instead of reading it, so that
+        marshal unmarshals the code straight from the page cache."""
+        if (type(self).get_data is FileLoader.get_data and
+                hasattr(marshal, '_map_file')):
+            with _io.FileIO(path, 'r') as file:
+                try:
+                    return marshal._map_file(file.fileno())
+                except OSError:
+                    pass
+        return self.get_data(path)
+
 
 class SourceFileLoader(FileLoader, SourceLoader):
 
@@ -1090,7 +1128,7 @@ class SourcelessFileLoader(FileLoader, _LoaderBasics):
 
     def get_code(self, fullname):
         path = self.get_filename(fullname)
-        data = self.get_data(path)
+        data = self._get_bytecode_data(path)
         bytes_data = self._bytes_from_bytecode(fullname, data, path, None)
         found = marshal.loads(bytes_data)
         if isinstance(found, _code_type):
@@ -1318,6 +1356,129 @@ class PathFinder:
                 return None
 
 
+class ImportIndex:
+
+    """Persistent index of the directory listings used by FileFinder.
+
+    For every absolute directory searched by a FileFinder the index keeps the
+    directory mtime, its listing and the file type of the entries that were
+    probed while searching it.  As long as a directory's mtime is unchanged
+    its listing and the types of its entries are known to be unchanged too,
+    so a process that starts from a saved index needs one stat() per
+    directory instead of a listdir() plus a stat() for every candidate file.
+
+    The index is used once it is loaded or enabled; running with
+    -X importindex=PATH loads it from PATH at startup and writes it back at
+    exit when it changed (site must be imported for the latter).
+
+    """
+
+    _MAGIC = b'IIDX'
+    _enabled = False
+    _changed = False
+    # Maps directory -> (mtime, listing, {name: file type bits}).
+    _dirs = {}
+    _listdir_avoided = 0
+    _stat_avoided = 0
+
+    @classmethod
+    def enable(cls):
+        """Start recording directory listings in the index."""
+        cls._enabled = True
+
+    @classmethod
+    def load(cls, path):
+        """Load the index saved at path and enable it."""
+        with _io.FileIO(path, 'r') as file:
+            data = file.read()
+        if data[:4] != _MAGIC_BYTES or data[4:8] != cls._MAGIC:
+            raise ImportError('bad magic number in import index {!r}'.format(
+                              path), path=path)
+        dirs = {}
+        for directory, mtime, listing, kinds in marshal.loads(
+                memoryview(data)[8:]):
+            dirs[directory] = (mtime, listing, dict(kinds))
+        cls._dirs = dirs
+        cls._enabled = True
+        cls._changed = False
+        _verbose_message('loaded import index of {} directories from {!r}',
+                         len(dirs), path)
+
+    @classmethod
+    def dump(cls, path):
+        """Save the index to path."""
+        entries = tuple((directory, mtime, listing, tuple(kinds.items()))
+                        for directory, (mtime, listing, kinds)
+                        in sorted(cls._dirs.items()))
+        data = bytearray(_MAGIC_BYTES)
+        data.extend(cls._MAGIC)
+        data.extend(marshal.dumps(entries))
+        _write_atomic(path, data)
+        cls._changed = False
+
+    @classmethod
+    def changed(cls):
+        """Return True if the index was modified since it was last loaded or
+        saved."""
+        return cls._changed
+
+    @classmethod
+    def clear(cls):
+        """Forget every directory recorded in the index."""
+        cls._dirs = {}
+        cls._changed = True
+
+    @classmethod
+    def stats(cls):
+        """Return a dict with the number of listdir() and stat() calls that
+        were answered from the index."""
+        return {'listdir': cls._listdir_avoided, 'stat': cls._stat_avoided}
+
+    @classmethod
+    def _listdir(cls, directory, mtime):
+        """Return the cached listing of directory, or None."""
+        if not cls._enabled or mtime == -1 or not _path_isabs(directory):
+            return None
+        entry = cls._dirs.get(directory)
+        if entry is None or entry[0] != mtime:
+            return None
+        cls._listdir_avoided += 1
+        return entry[1]
+
+    @classmethod
+    def _record(cls, directory, mtime, contents):
+        """Record a fresh listing of directory."""
+        if not cls._enabled or mtime == -1 or not _path_isabs(directory):
+            return
+        entry = cls._dirs.get(directory)
+        if entry is not None and entry[0] == mtime:
+            return
+        cls._dirs[directory] = (mtime, tuple(contents), {})
+        cls._changed = True
+
+    @classmethod
+    def _is_mode_type(cls, directory, mtime, name, mode):
+        """Test whether the entry name of directory is of the specified mode
+        type, using the type recorded in the index when there is one."""
+        path = _path_join(directory, name)
+        entry = cls._dirs.get(directory) if cls._enabled else None
+        if entry is None or entry[0] != mtime:
+            return _path_is_mode_type(path, mode)
+        kinds = entry[2]
+        try:
+            kind = kinds[name]
+        except KeyError:
+            try:
+                kind = _os.stat(path).st_mode & 0o170000
+            except OSError:
+                kind = 0
+            kinds[name] = kind
+            cls._changed = True
+        else:
+            cls._stat_avoided += 1
+        return kind == mode
+
+
 class FileFinder:
 
     """File-based finder.
@@ -1357,7 +1518,7 @@ class FileFinder:
         except OSError:
             mtime = -1
         if mtime != self._path_mtime:
-            self._fill_cache()
+            self._fill_cache(mtime)
             self._path_mtime = mtime
         # tail_module keeps the original casing, for __file__ and friends
         if _relax_case():
@@ -1369,7 +1530,8 @@ class FileFinder:
         # Check if the module is the name of a directory (and thus a package).
         if cache_module in cache:
             base_path = _path_join(self.path, tail_module)
-            if _path_isdir(base_path):
+            if ImportIndex._is_mode_type(self.path, mtime, tail_module,
+                                         0o040000):
                 for suffix, loader in self._loaders:
                     init_filename = '__init__' + suffix
                     full_path = _path_join(base_path, init_filename)
@@ -1384,22 +1546,27 @@ class FileFinder:
             full_path = _path_join(self.path, tail_module + suffix)
             _verbose_message('trying {}'.format(full_path), verbosity=2)
             if cache_module + suffix in cache:
-                if _path_isfile(full_path):
+                if ImportIndex._is_mode_type(self.path, mtime,
+                                             tail_module + suffix, 0o100000):
                     return (loader(fullname, full_path), [])
         if is_namespace:
             _verbose_message('possible namespace for {}'.format(base_path))
             return (None, [base_path])
         return (None, [])
 
-    def _fill_cache(self):
+    def _fill_cache(self, mtime=-1):
         """Fill the cache of potential modules and packages for this directory."""
         path = self.path
-        try:
-            contents = _os.listdir(path)
-        except (FileNotFoundError, PermissionError, NotADirectoryError):
-            # Directory has either been removed, turned into a file, or made
-            # unreadable.
-            contents = []
+        contents = ImportIndex._listdir(path, mtime)
+        if contents is None:
+            try:
+                contents = _os.listdir(path)
+            except (FileNotFoundError, PermissionError, NotADirectoryError):
+                # Directory has either been removed, turned into a file, or
+                # made unreadable.
+                contents = []
+            else:
+                ImportIndex._record(path, mtime, contents)
         # We store two cached versions, to handle runtime changes of the
         # PYTHONCASEOK environment variable.
         if not sys.platform.startswith('win'):
@@ -1444,6 +1611,134 @@ class FileFinder:
         return "FileFinder(%r)" % (self.path,)
 
 
+class _SnapshotLoader(SourceFileLoader):
+
+    """Source file loader whose code object comes from a startup snapshot."""
+
+    def __init__(self, fullname, path, code_data):
+        super().__init__(fullname, path)
+        self._code_data = code_data
+
+    def get_code(self, fullname):
+        """Return the code object stored in the snapshot."""
+        code_data, self._code_data = self._code_data, None
+        if code_data is None:
+            return super().get_code(fullname)
+        found = marshal.loads(code_data)
+        _imp._fix_co_filename(found, self.path)
+        _verbose_message('code object from snapshot for {!r}', fullname)
+        return found
+
+
+class SnapshotFinder(FileFinder):
+
+    """File finder which also answers from a startup snapshot.
+
+    A snapshot stores the compiled code of a set of source modules, with the
+    location and size and mtime of each source file.  Loading one costs a
+    single file read.  While a snapshot is loaded this finder replaces
+    FileFinder as the path hook, and a module that the snapshot recorded in
+    the finder's directory is found with one stat() call instead of a scan
+    of the directory; its code doesn't have to be read from its own bytecode
+    file either.  The finders for earlier path entries are still asked
+    first, so the snapshot never shadows a module that they provide.
+    Modules whose source changed since the snapshot was written are left to
+    the directory scan.
+
+    Paths below sys.prefix are stored relative to it, so that a snapshot
+    stays valid when the installation is moved.
+
+    """
+
+    _SNAPSHOT_MAGIC = b'SNAP'
+    # Maps module name -> (directory, filename, mtime, size, code data,
+    # is package).
+    _modules = {}
+
+    def find_loader(self, fullname):
+        """Find a module recorded in the snapshot for this directory, or
+        else search the directory like FileFinder."""
+        try:
+            directory, filename, mtime, size, code_data, is_package = \
+                self._modules[fullname]
+        except KeyError:
+            return FileFinder.find_loader(self, fullname)
+        # Path entries may carry a trailing separator.
+        path = _path_absolute(self.path).rstrip(''.join(path_separators))
+        if path != directory:
+            return FileFinder.find_loader(self, fullname)
+        try:
+            st = _os.stat(filename)
+        except OSError:
+            return FileFinder.find_loader(self, fullname)
+        if int(st.st_mtime) != mtime or st.st_size & 0xFFFFFFFF != size:
+            _verbose_message('snapshot is stale for {!r}', fullname)
+            return FileFinder.find_loader(self, fullname)
+        loader = _SnapshotLoader(fullname, filename, code_data)
+        if is_package:
+            return (loader, [_path_split(filename)[0]])
+        return (loader, [])
+
+    @classmethod
+    def load(cls, path):
+        """Load the snapshot stored at path, replacing the current one."""
+        with _io.FileIO(path, 'r') as file:
+            data = file.read()
+        if data[:4] != _MAGIC_BYTES or data[4:8] != cls._SNAPSHOT_MAGIC:
+            raise ImportError('bad magic number in snapshot {!r}'.format(path),
+                              path=path)
+        modules = {}
+        for name, filename, in_prefix, mtime, size, code_data in marshal.loads(
+                memoryview(data)[8:]):
+            if in_prefix:
+                filename = _path_join(sys.prefix, filename)
+            directory, tail = _path_split(filename)
+            is_package = (tail.rpartition('.')[0] == '__init__' and
+                          name.rpartition('.')[2] != '__init__')
+            if is_package:
+                directory = _path_split(directory)[0]
+            modules[name] = (directory, filename, mtime, size, code_data,
+                             is_package)
+        cls._modules = modules
+        _verbose_message('loaded snapshot of {} modules from {!r}',
+                         len(modules), path)
+
+    @classmethod
+    def dump(cls, path, names=None):
+        """Write a snapshot of the source modules in sys.modules (or of the
+        modules listed in names) to path.  Returns the number of modules
+        recorded."""
+        prefix = sys.prefix
+        if prefix and prefix[-1] not in path_separators:
+            prefix += path_sep
+        entries = []
+        for name in sorted(sys.modules if names is None else names):
+            loader = getattr(sys.modules.get(name), '__loader__', None)
+            if not isinstance(loader, SourceFileLoader) or loader.name != name:
+                continue
+            try:
+                filename = loader.get_filename(name)
+                st = loader.path_stats(filename)
+                code = loader.get_code(name)
+            except (ImportError, OSError):
+                continue
+            filename = _path_absolute(filename)
+            in_prefix = bool(prefix) and filename.startswith(prefix)
+            if in_prefix:
+                filename = filename[len(prefix):]
+            entries.append((name, filename, in_prefix,
+                            int(st['mtime']), st['size'] & 0xFFFFFFFF,
+                            marshal.dumps(code)))
+        data = bytearray(_MAGIC_BYTES)
+        data.extend(cls._SNAPSHOT_MAGIC)
+        data.extend(marshal.dumps(tuple(entries)))
+        _write_atomic(path, data)
+        return len(entries)
+
+    def __repr__(self):
+        return "SnapshotFinder(%r)" % (self.path,)
+
+
 # Import itself ###############################################################
 
 class _ImportLockContext:
@@ -1770,9 +2065,27 @@ def _install(sys_module, _imp_module):
     """Install importlib as the implementation of import."""
     _setup(sys_module, _imp_module)
     supported_loaders = _get_supported_file_loaders()
-    sys.path_hooks.extend([FileFinder.path_hook(*supported_loaders)])
+    finder = FileFinder
+    snapshot = sys._xoptions.get('snapshot')
+    if isinstance(snapshot, str):
+        try:
+            SnapshotFinder.load(snapshot)
+        except (ImportError, OSError, EOFError, ValueError, TypeError) as exc:
+            _verbose_message('could not load snapshot {!r}: {!r}',
+                             snapshot, exc)
+        else:
+            finder = SnapshotFinder
+    sys.path_hooks.extend([finder.path_hook(*supported_loaders)])
     sys.meta_path.append(BuiltinImporter)
     sys.meta_path.append(FrozenImporter)
     if _os.__name__ == 'nt':
         sys.meta_path.append(WindowsRegistryFinder)
+    index = sys._xoptions.get('importindex')
+    if isinstance(index, str):
+        try:
+            ImportIndex.load(index)
+        except (ImportError, OSError, EOFError, ValueError, TypeError) as exc:
+            _verbose_message('could not load import index {!r}: {!r}',
+                             index, exc)
+            ImportIndex.enable()
     sys.meta_path.append(PathFinder)
@@ -10,6 +10,8 @@ from ._bootstrap import FrozenImporter
 from ._bootstrap import WindowsRegistryFinder
 from ._bootstrap import PathFinder
 from ._bootstrap import FileFinder
+from ._bootstrap import ImportIndex
+from ._bootstrap import SnapshotFinder
 from ._bootstrap import SourceFileLoader
 from ._bootstrap import SourcelessFileLoader
 from ._bootstrap import ExtensionFileLoader
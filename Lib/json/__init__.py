@@ -98,13 +98,13 @@ Using json.tool from the shell to validate and pretty-print::
 """
 __version__ = '2.0.9'
 __all__ = [
-    'dump', 'dumps', 'load', 'loads',
-    'JSONDecoder', 'JSONEncoder',
+    'dump', 'dumps', 'dump_utf8', 'dumps_utf8', 'load', 'loads', 'iterload',
+    'JSONDecoder', 'JSONStreamDecoder', 'JSONEncoder',
 ]
 
 __author__ = 'Bob Ippolito <bob@redivi.com>'
 
-from .decoder import JSONDecoder
+from .decoder import JSONDecoder, JSONStreamDecoder
 from .encoder import JSONEncoder
 
 _default_encoder = JSONEncoder(
@@ -240,6 +240,38 @@ def dumps(obj, skipkeys=False, ensure_ascii=True, check_circular=True,
         **kw).encode(obj)
 
 
+def dump_utf8(obj, fp, *, cls=None, **kw):
+    """Serialize ``obj`` as a JSON formatted stream of UTF-8 encoded bytes
+    to ``fp`` (a ``.write()``-supporting binary file-like object).
+
+    The keyword arguments are those of ``dump()``.  Unless ``indent`` is
+    given, the bytes are produced directly, without building a ``str``
+    first, and ``fp.write()`` is called with chunks of about 64 KiB.
+
+    """
+    if cls is None and not kw:
+        _default_encoder.dump_utf8(obj, fp)
+        return
+    if cls is None:
+        cls = JSONEncoder
+    cls(**kw).dump_utf8(obj, fp)
+
+
+def dumps_utf8(obj, *, cls=None, **kw):
+    """Serialize ``obj`` to JSON formatted, UTF-8 encoded ``bytes``.
+
+    The keyword arguments are those of ``dumps()``, and the result is
+    equal to ``dumps(obj, **kw).encode('utf-8')``.  Unless ``indent`` is
+    given, it is produced directly, without building a ``str`` first.
+
+    """
+    if cls is None and not kw:
+        return _default_encoder.encode_utf8(obj)
+    if cls is None:
+        cls = JSONEncoder
+    return cls(**kw).encode_utf8(obj)
+
+
 _default_decoder = JSONDecoder(object_hook=None, object_pairs_hook=None)
 
 
@@ -327,3 +359,41 @@ def loads(s, encoding=None, cls=None, object_hook=None, parse_float=None,
     if parse_constant is not None:
         kw['parse_constant'] = parse_constant
     return cls(**kw).decode(s)
+
+
+def iterload(fp, *, depth=0, chunk_size=65536, cls=None, **kw):
+    """Deserialize the stream of JSON values in ``fp`` (a ``.read()``-supporting
+    file-like object) and yield them one at a time.
+
+    ``fp`` may be opened in binary mode, in which case it must contain UTF-8,
+    or in text mode.  It is read ``chunk_size`` at a time and only the value
+    being decoded is kept in memory, so this reads streams of any size, such
+    as newline delimited JSON files::
+
+        >>> import io
+        >>> list(iterload(io.BytesIO(b'{"a": 1}\\n{"a": 2}\\n')))
+        [{'a': 1}, {'a': 2}]
+
+    With a ``depth`` of N, arrays and objects nested less than N levels deep
+    are not built; each value found at depth N is yielded as soon as it is
+    complete, as a ``(path, value)`` pair::
+
+        >>> list(iterload(io.BytesIO(b'{"rows": [1, {"b": 2}]}'), depth=2))
+        [(('rows', 0), 1), (('rows', 1), {'b': 2})]
+
+    To use a custom ``JSONStreamDecoder`` subclass, specify it with the
+    ``cls`` kwarg; otherwise ``JSONStreamDecoder`` is used.  The other
+    keyword arguments are passed to it, and are those of ``loads()``.
+
+    """
+    if cls is None:
+        cls = JSONStreamDecoder
+    decoder = cls(depth=depth, **kw)
+    while True:
+        chunk = fp.read(chunk_size)
+        if not chunk:
+            break
+        if isinstance(chunk, str):
+            chunk = chunk.encode('utf-8')
+        yield from decoder.feed(chunk)
+    yield from decoder.close()
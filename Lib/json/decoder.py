@@ -10,8 +10,12 @@ try:
     from _json import scanstring as c_scanstring
 except ImportError:
     c_scanstring = None
+try:
+    from _json import make_stream_scanner as c_make_stream_scanner
+except ImportError:
+    c_make_stream_scanner = None
 
-__all__ = ['JSONDecoder']
+__all__ = ['JSONDecoder', 'JSONStreamDecoder']
 
 FLAGS = re.VERBOSE | re.MULTILINE | re.DOTALL
 
@@ -262,6 +266,254 @@ def JSONArray(s_and_end, scan_once, _w=WHITESPACE.match, _ws=WHITESPACE_STR):
     return values, end
 
 
+STREAM_WHITESPACE = re.compile(br'[ \t\n\r]*')
+STREAM_SCALAR_END = re.compile(br'[ \t\n\r,:"\[\]{}]')
+STREAM_STRING_END = re.compile(br'["\\]')
+STREAM_VALUE_TOKEN = re.compile(br'["\[\]{}]')
+STREAM_MEMO_SIZE = 1024
+
+(_EXPECT_VALUE, _EXPECT_KEY, _EXPECT_COLON, _EXPECT_COMMA) = range(4)
+
+
+class py_make_stream_scanner(object):
+    """Incremental JSON scanner over chunks of UTF-8 encoded bytes.
+
+    ``feed(data)`` returns the values completed by ``data``, ``close()``
+    the ones still pending at the end of the stream.  With a ``depth``
+    greater than zero, the arrays and objects nested less deep than that
+    are tokenized here, and the values below them are returned as
+    ``(path, value)`` pairs as soon as each is complete.
+
+    """
+    def __init__(self, context, depth=0):
+        if depth < 0:
+            raise ValueError("depth must not be negative")
+        self.depth = depth
+        self.strict = context.strict
+        self.memo = context.memo
+        self.scan_once = scanner.py_make_scanner(context)
+        self._reset()
+
+    def _reset(self):
+        self.buf = bytearray()
+        self.pos = 0
+        self.consumed = 0
+        # start of a partial value in buf, its bracket nesting and whether
+        # the scan stopped inside a string, after a backslash, or in a scalar
+        self.value_start = -1
+        self.value_depth = 0
+        self.in_string = False
+        self.escape = False
+        self.scalar = False
+        # [kind, expect, index, start, key] for each tokenized level
+        self.levels = []
+
+    def _error(self, msg, pos):
+        return ValueError('{0}: byte {1}'.format(msg, self.consumed + pos))
+
+    def _pop(self):
+        self.levels.pop()
+        if self.levels:
+            parent = self.levels[-1]
+            parent[1] = _EXPECT_COMMA
+            parent[2] += 1
+            parent[4] = None
+
+    def _emit(self, end, values):
+        doc = bytes(self.buf[self.value_start:end]).decode('utf-8')
+        try:
+            value, next_idx = self.scan_once(doc, 0)
+        except StopIteration:
+            raise ValueError(errmsg("Expecting value", doc, 0))
+        finally:
+            # Keep the keys memoized across values, within bounds
+            if len(self.memo) > STREAM_MEMO_SIZE:
+                self.memo.clear()
+        if next_idx != len(doc):
+            raise ValueError(errmsg("Extra data", doc, next_idx))
+        if self.depth:
+            path = tuple(level[4] if level[0] == '{' else level[2]
+                         for level in self.levels)
+            value = (path, value)
+        values.append(value)
+        self.value_start = -1
+        self.pos = end
+        if self.levels:
+            level = self.levels[-1]
+            level[1] = _EXPECT_COMMA
+            level[2] += 1
+            level[4] = None
+
+    def _find_end(self, final):
+        # Continue scanning the partial value for its end; return the
+        # index after its last byte, or -1 if it isn't complete yet.
+        buf = self.buf
+        idx = self.pos
+        if self.scalar:
+            m = STREAM_SCALAR_END.search(buf, idx)
+            if m is not None:
+                return m.start()
+            self.pos = len(buf)
+            return len(buf) if final else -1
+        if self.escape:
+            if idx >= len(buf):
+                return -1
+            self.escape = False
+            idx += 1
+        while True:
+            if self.in_string:
+                m = STREAM_STRING_END.search(buf, idx)
+                if m is None:
+                    break
+                idx = m.end()
+                if buf[m.start()] == 0x5c:
+                    if idx >= len(buf):
+                        self.escape = True
+                        break
+                    idx += 1
+                    continue
+                self.in_string = False
+                if self.value_depth == 0:
+                    return idx
+            else:
+                m = STREAM_VALUE_TOKEN.search(buf, idx)
+                if m is None:
+                    break
+                idx = m.end()
+                c = buf[m.start()]
+                if c == 0x22:
+                    self.in_string = True
+                elif c == 0x7b or c == 0x5b:
+                    self.value_depth += 1
+                else:
+                    self.value_depth -= 1
+                    if self.value_depth == 0:
+                        return idx
+        self.pos = len(buf)
+        return -1
+
+    def _scan(self, final, values, _w=STREAM_WHITESPACE.match):
+        buf = self.buf
+        while True:
+            if self.value_start >= 0:
+                end = self._find_end(final)
+                if end < 0:
+                    return
+                self._emit(end, values)
+                continue
+
+            idx = self.pos = _w(buf, self.pos).end()
+            if idx == len(buf):
+                return
+            c = chr(buf[idx])
+            level = self.levels[-1] if self.levels else None
+            expect = level[1] if level is not None else _EXPECT_VALUE
+
+            if expect == _EXPECT_VALUE:
+                if (c == ']' and level is not None and level[0] == '[' and
+                        level[2] == 0):
+                    self._pop()
+                    self.pos = idx + 1
+                elif c in '{[' and len(self.levels) < self.depth:
+                    expect = _EXPECT_KEY if c == '{' else _EXPECT_VALUE
+                    self.levels.append([c, expect, 0, self.consumed + idx,
+                                        None])
+                    self.pos = idx + 1
+                elif c in ',:]}':
+                    raise self._error("Expecting value", idx)
+                else:
+                    self.value_start = idx
+                    self.value_depth = 0
+                    self.in_string = self.escape = False
+                    self.scalar = c not in '"{['
+                    self.pos = idx + 1 if self.scalar else idx
+            elif expect == _EXPECT_KEY:
+                if c == '}' and level[2] == 0:
+                    self._pop()
+                    self.pos = idx + 1
+                elif c == '"':
+                    # Wait until the whole key has arrived
+                    end = idx + 1
+                    while True:
+                        m = STREAM_STRING_END.search(buf, end)
+                        if m is None:
+                            return
+                        end = m.end()
+                        if buf[m.start()] == 0x22:
+                            break
+                        end += 1
+                    doc = bytes(buf[idx:end]).decode('utf-8')
+                    level[4], _ = scanstring(doc, 1, self.strict)
+                    level[1] = _EXPECT_COLON
+                    self.pos = end
+                else:
+                    raise self._error("Expecting property name enclosed in "
+                                      "double quotes", idx)
+            elif expect == _EXPECT_COLON:
+                if c != ':':
+                    raise self._error("Expecting ':' delimiter", idx)
+                level[1] = _EXPECT_VALUE
+                self.pos = idx + 1
+            else:
+                if c == ',':
+                    level[1] = _EXPECT_KEY if level[0] == '{' else _EXPECT_VALUE
+                    self.pos = idx + 1
+                elif c == ('}' if level[0] == '{' else ']'):
+                    self._pop()
+                    self.pos = idx + 1
+                else:
+                    raise self._error("Expecting ',' delimiter", idx)
+
+    def feed(self, data):
+        """Add a chunk of UTF-8 encoded JSON and return the values it
+        completed.
+
+        """
+        buf = self.buf
+        live = self.value_start if self.value_start >= 0 else self.pos
+        # Dropping the consumed prefix is only worth it once it is at
+        # least as long as the rest, which keeps the cost linear
+        if live > 0 and live >= len(buf) - live:
+            del buf[:live]
+            self.pos -= live
+            if self.value_start >= 0:
+                self.value_start -= live
+            self.consumed += live
+        buf += data
+        values = []
+        try:
+            self._scan(False, values)
+        except:
+            self._reset()
+            raise
+        return values
+
+    def close(self):
+        """Signal the end of the stream and return the values still pending.
+
+        Raise ValueError if the stream ends inside a value.  The scanner is
+        ready for a new stream afterwards.
+
+        """
+        values = []
+        try:
+            self._scan(True, values)
+            if self.value_start >= 0:
+                # Decoding the partial value gives the most precise error
+                end = len(self.buf)
+                self._emit(end, values)
+                raise self._error("Unterminated value", end)
+            if self.levels:
+                level = self.levels[-1]
+                raise ValueError("Unterminated {0} starting at: byte {1}".format(
+                    'object' if level[0] == '{' else 'array', level[3]))
+        finally:
+            self._reset()
+        return values
+
+make_stream_scanner = c_make_stream_scanner or py_make_stream_scanner
+
+
 class JSONDecoder(object):
     """Simple JSON <http://json.org> decoder
 
@@ -368,3 +620,62 @@ class JSONDecoder(object):
         except StopIteration:
             raise ValueError("No JSON object could be decoded")
         return obj, end
+
+
+class JSONStreamDecoder(JSONDecoder):
+    """Incremental JSON decoder for a stream of UTF-8 encoded bytes.
+
+    The stream is fed in chunks split at arbitrary points, even inside a
+    multi-byte character, and every value is returned as soon as it is
+    complete::
+
+        >>> decoder = JSONStreamDecoder()
+        >>> decoder.feed(b'{"a": 1}\\n{"a"')
+        [{'a': 1}]
+        >>> decoder.feed(b': 2}\\n')
+        [{'a': 2}]
+        >>> decoder.close()
+        []
+
+    Only the unfinished part of the input is kept, so a stream of many
+    values, such as newline delimited JSON, is decoded in memory bounded
+    by its largest value.
+
+    """
+    def __init__(self, *, depth=0, **kw):
+        """``depth`` selects what is returned.  When it is zero (the
+        default), the stream is a sequence of whitespace separated JSON
+        values and each is returned whole.
+
+        With a ``depth`` of N, arrays and objects nested less than N
+        levels deep are not built.  Instead, each value found inside them
+        at depth N, and each scalar found above it, is returned as a
+        ``(path, value)`` pair, where ``path`` is the tuple of object keys
+        and array indices leading to the value.  This reads a single huge
+        array or object one element at a time::
+
+            >>> decoder = JSONStreamDecoder(depth=2)
+            >>> decoder.feed(b'{"rows": [[1, 2], {"b": 3}], "n": 2}')
+            [(('rows', 0), [1, 2]), (('rows', 1), {'b': 3}), (('n',), 2)]
+
+        The other keyword arguments are those of ``JSONDecoder``.
+
+        """
+        super().__init__(**kw)
+        self.depth = depth
+        self.scan_stream = make_stream_scanner(self, depth)
+
+    def feed(self, data):
+        """Add ``data``, a chunk of UTF-8 encoded JSON in a bytes-like
+        object, and return the list of values it completed.
+
+        """
+        return self.scan_stream.feed(data)
+
+    def close(self):
+        """Signal the end of the stream and return the list of values still
+        pending, raising ValueError if it ends inside a value.  The decoder
+        can be fed a new stream afterwards.
+
+        """
+        return self.scan_stream.close()
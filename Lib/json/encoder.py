@@ -6,6 +6,10 @@ try:
     from _json import encode_basestring_ascii as c_encode_basestring_ascii
 except ImportError:
     c_encode_basestring_ascii = None
+try:
+    from _json import encode_basestring as c_encode_basestring
+except ImportError:
+    c_encode_basestring = None
 try:
     from _json import make_encoder as c_make_encoder
 except ImportError:
@@ -30,7 +34,7 @@ for i in range(0x20):
 INFINITY = float('inf')
 FLOAT_REPR = repr
 
-def encode_basestring(s):
+def py_encode_basestring(s):
     """Return a JSON representation of a Python string
 
     """
@@ -39,6 +43,9 @@ def encode_basestring(s):
     return '"' + ESCAPE.sub(replace, s) + '"'
 
 
+encode_basestring = (c_encode_basestring or py_encode_basestring)
+
+
 def py_encode_basestring_ascii(s):
     """Return an ASCII-only JSON representation of a Python string
 
@@ -193,6 +200,50 @@ class JSONEncoder(object):
             chunks = list(chunks)
         return ''.join(chunks)
 
+    def encode_utf8(self, o):
+        """Return a JSON representation of a Python data structure as
+        UTF-8 encoded ``bytes``.
+
+        >>> JSONEncoder(ensure_ascii=False).encode_utf8({"foo": "b\xe4r"})
+        b'{"foo": "b\\xc3\\xa4r"}'
+
+        """
+        encoder = self._make_utf8_encoder()
+        if encoder is None:
+            return self.encode(o).encode('utf-8')
+        return encoder.encode_utf8(o)
+
+    def dump_utf8(self, o, fp):
+        """Write a JSON representation of a Python data structure, encoded
+        to UTF-8, to ``fp`` (a ``.write()``-supporting binary file-like
+        object).
+
+        """
+        encoder = self._make_utf8_encoder()
+        if encoder is None:
+            for chunk in self.iterencode(o):
+                fp.write(chunk.encode('utf-8'))
+        else:
+            encoder.encode_utf8(o, fp.write)
+
+    def _make_utf8_encoder(self):
+        # The C encoder writes UTF-8 straight into a bytes buffer, without
+        # building the str first, but it can't indent.
+        if c_make_encoder is None or self.indent is not None:
+            return None
+        if self.check_circular:
+            markers = {}
+        else:
+            markers = None
+        if self.ensure_ascii:
+            _encoder = encode_basestring_ascii
+        else:
+            _encoder = encode_basestring
+        return c_make_encoder(
+            markers, self.default, _encoder, self.indent,
+            self.key_separator, self.item_separator, self.sort_keys,
+            self.skipkeys, self.allow_nan)
+
     def iterencode(self, o, _one_shot=False):
         """Encode the given object and yield each string
         representation as available.
@@ -210,6 +210,11 @@ class LZMAFile(io.BufferedIOBase):
             if self._buffer:
                 return True
 
+            if not (self._decompressor.eof or self._decompressor.needs_input):
+                # Drain input held back by an earlier readinto().
+                self._buffer = self._decompressor.decompress(b"")
+                continue
+
             if self._decompressor.unused_data:
                 rawblock = self._decompressor.unused_data
             else:
@@ -314,6 +319,60 @@ class LZMAFile(io.BufferedIOBase):
         self._pos += len(data)
         return data
 
+    def readinto(self, b):
+        """Read up to len(b) uncompressed bytes into b.
+
+        Returns the number of bytes read (0 for EOF).
+        """
+        self._check_can_read()
+        view = memoryview(b).cast("B")
+        # Hand out buffered data first, then decompress straight into b.
+        n = 0
+        if self._buffer:
+            n = min(len(view), len(self._buffer))
+            view[:n] = self._buffer[:n]
+            self._buffer = self._buffer[n:]
+            self._pos += n
+        while n < len(view) and self._mode != _MODE_READ_EOF:
+            n += self._decompress_into(view[n:])
+        return n
+
+    # Decompress into view without going through self._buffer.
+    # Returns the number of bytes written, which may be 0 if more input
+    # is needed or EOF was reached.
+    def _decompress_into(self, view):
+        if self._decompressor.eof or self._decompressor.needs_input:
+            if self._decompressor.unused_data:
+                rawblock = self._decompressor.unused_data
+            else:
+                rawblock = self._fp.read(_BUFFER_SIZE)
+
+            if not rawblock:
+                if self._decompressor.eof:
+                    self._mode = _MODE_READ_EOF
+                    self._size = self._pos
+                    return 0
+                else:
+                    raise EOFError("Compressed file ended before the "
+                                   "end-of-stream marker was reached")
+        else:
+            rawblock = b""
+
+        if self._decompressor.eof:
+            # Continue to next stream.
+            self._decompressor = LZMADecompressor(**self._init_args)
+            try:
+                n = self._decompressor.decompress_into(rawblock, view)
+            except LZMAError:
+                # Trailing data isn't a valid compressed stream; ignore it.
+                self._mode = _MODE_READ_EOF
+                self._size = self._pos
+                return 0
+        else:
+            n = self._decompressor.decompress_into(rawblock, view)
+        self._pos += n
+        return n
+
     def write(self, data):
         """Write a bytes object to the file.
 
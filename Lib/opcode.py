@@ -179,6 +179,17 @@ def_op('LIST_APPEND', 145)
 def_op('SET_ADD', 146)
 def_op('MAP_ADD', 147)
 
+# Superinstructions, emitted by the peephole optimizer in place of the
+# first instruction of a pair.  The second instruction follows unchanged.
+def_op('LOAD_FAST_LOAD_FAST', 148)
+haslocal.append(148)
+def_op('LOAD_FAST_LOAD_ATTR', 149)
+haslocal.append(149)
+def_op('COMPARE_OP_POP_JUMP_IF_FALSE', 150)
+hascompare.append(150)
+def_op('LOAD_CONST_RETURN_VALUE', 151)
+hasconst.append(151)
+
 def_op('EXTENDED_ARG', 144)
 EXTENDED_ARG = 144
 
@@ -37,6 +37,13 @@ import _compat_pickle
 __all__ = ["PickleError", "PicklingError", "UnpicklingError", "Pickler",
            "Unpickler", "dump", "dumps", "load", "loads"]
 
+try:
+    from _pickle import PickleBuffer
+    __all__.append("PickleBuffer")
+    _HAVE_PICKLE_BUFFER = True
+except ImportError:
+    _HAVE_PICKLE_BUFFER = False
+
 # Shortcut for use in isinstance testing
 bytes_types = (bytes, bytearray)
 
@@ -48,10 +55,12 @@ compatible_formats = ["1.0",            # Original protocol 0
                       "1.3",            # Protocol 1 with BINFLOAT added
                       "2.0",            # Protocol 2
                       "3.0",            # Protocol 3
+                      "4.0",            # Protocol 4
+                      "5.0",            # Protocol 5
                       ]                 # Old format versions we can read
 
 # This is the highest protocol number we know how to read.
-HIGHEST_PROTOCOL = 3
+HIGHEST_PROTOCOL = 5
 
 # The protocol we write by default.  May be less than HIGHEST_PROTOCOL.
 # We intentionally write a protocol that Python 2.x cannot read;
@@ -168,19 +177,133 @@ _tuplesize2code = [EMPTY_TUPLE, TUPLE1, TUPLE2, TUPLE3]
 BINBYTES       = b'B'   # push bytes; counted binary string argument
 SHORT_BINBYTES = b'C'   #  "     "   ;    "      "       "      " < 256 bytes
 
+# Protocol 4
+
+SHORT_BINUNICODE = b'\x8c'  # push short string; UTF-8 length < 256 bytes
+BINUNICODE8      = b'\x8d'  # push very long string
+BINBYTES8        = b'\x8e'  # push very long bytes string
+EMPTY_SET        = b'\x8f'  # push empty set on the stack
+ADDITEMS         = b'\x90'  # modify set by adding topmost stack items
+FROZENSET        = b'\x91'  # build frozenset from topmost stack items
+NEWOBJ_EX        = b'\x92'  # like NEWOBJ but work with keyword only arguments
+STACK_GLOBAL     = b'\x93'  # same as GLOBAL but using names on the stacks
+MEMOIZE          = b'\x94'  # store top of the stack in memo
+FRAME            = b'\x95'  # indicate the beginning of a new frame
+
+# Protocol 5
+
+BYTEARRAY8       = b'\x96'  # push bytearray
+NEXT_BUFFER      = b'\x97'  # push next out-of-band buffer
+READONLY_BUFFER  = b'\x98'  # make top of stack readonly
+
 __all__.extend([x for x in dir() if re.match("[A-Z][A-Z0-9_]+$",x)])
 
+# Framing for protocol 4: opcodes are accumulated in frames of about
+# _FRAME_SIZE_TARGET bytes, each preceded by a FRAME opcode giving its length,
+# so that the unpickler can fetch a whole frame with a single read().  Large
+# payloads bypass the frames and are written to the file as they are.
+
+class _Framer:
+
+    _FRAME_SIZE_MIN = 4
+    _FRAME_SIZE_TARGET = 64 * 1024
+
+    def __init__(self, file_write):
+        self.file_write = file_write
+        self.current_frame = None
+
+    def start_framing(self):
+        self.current_frame = io.BytesIO()
+
+    def end_framing(self):
+        if self.current_frame and self.current_frame.tell() > 0:
+            self.commit_frame(force=True)
+            self.current_frame = None
+
+    def commit_frame(self, force=False):
+        if self.current_frame:
+            f = self.current_frame
+            if f.tell() >= self._FRAME_SIZE_TARGET or force:
+                data = f.getbuffer()
+                write = self.file_write
+                if len(data) >= self._FRAME_SIZE_MIN:
+                    write(FRAME + struct.pack("<Q", len(data)))
+                write(data)
+                self.current_frame = io.BytesIO()
+
+    def write(self, data):
+        if self.current_frame:
+            return self.current_frame.write(data)
+        else:
+            return self.file_write(data)
+
+    def write_large_bytes(self, header, payload):
+        if self.current_frame:
+            # Terminate the current frame; the payload goes to the file
+            # outside of any frame, without being copied.
+            self.commit_frame(force=True)
+        write = self.file_write
+        write(header)
+        write(payload)
+
+
+class _Unframer:
+
+    def __init__(self, file_read, file_readline):
+        self.file_read = file_read
+        self.file_readline = file_readline
+        self.current_frame = None
+
+    def read(self, n):
+        if self.current_frame:
+            data = self.current_frame.read(n)
+            if not data and n != 0:
+                self.current_frame = None
+                return self.file_read(n)
+            if len(data) < n:
+                raise UnpicklingError(
+                    "pickle exhausted before end of frame")
+            return data
+        else:
+            return self.file_read(n)
+
+    def readline(self):
+        if self.current_frame:
+            data = self.current_frame.readline()
+            if not data:
+                self.current_frame = None
+                return self.file_readline()
+            if data[-1] != b'\n'[0]:
+                raise UnpicklingError(
+                    "pickle exhausted before end of frame")
+            return data
+        else:
+            return self.file_readline()
+
+    def load_frame(self, frame_size):
+        if self.current_frame and self.current_frame.read() != b'':
+            raise UnpicklingError(
+                "beginning of a new frame before end of current frame")
+        self.current_frame = io.BytesIO(self.file_read(frame_size))
+
+
 # Pickling machinery
 
+# Longest str or bytes object still treated as an atom (and not memoized)
+# when a Pickler is created with memoize_atoms=False.
+_MEMO_ATOM_MAX_SIZE = 64
+
 class _Pickler:
 
-    def __init__(self, file, protocol=None, *, fix_imports=True):
+    def __init__(self, file, protocol=None, *, fix_imports=True,
+                 buffer_callback=None, memoize_atoms=True):
         """This takes a binary file for writing a pickle data stream.
 
         The optional protocol argument tells the pickler to use the
-        given protocol; supported protocols are 0, 1, 2, 3.  The default
-        protocol is 3; a backward-incompatible protocol designed for
-        Python 3.0.
+        given protocol; supported protocols are 0, 1, 2, 3, 4, 5.  The
+        default protocol is 3; a backward-incompatible protocol designed for
+        Python 3.0.  Protocol 4 adds framing, sets and very large objects,
+        and protocol 5 adds out-of-band buffers.
 
         Specifying a negative protocol version selects the highest
         protocol version supported.  The higher the protocol used, the
@@ -195,6 +318,18 @@ class _Pickler:
         If fix_imports is True and protocol is less than 3, pickle will try to
         map the new Python 3.x names to the old module names used in Python
         2.x, so that the pickle data stream is readable with Python 2.x.
+
+        If buffer_callback is not None, it is called with each PickleBuffer
+        being pickled.  If it returns a false value, the buffer is
+        serialized out-of-band: the pickle only records its position, and
+        the same buffers must be passed to the unpickler.  buffer_callback
+        requires protocol 5 or higher.
+
+        If memoize_atoms is false, str and bytes objects of at most 64
+        characters are written out each time they occur instead of being
+        remembered in the memo, like ints and floats.  This trades a larger
+        pickle for less memo maintenance when pickling many small objects;
+        the unpickled strings are equal but no longer shared.
         """
         if protocol is None:
             protocol = DEFAULT_PROTOCOL
@@ -202,10 +337,17 @@ class _Pickler:
             protocol = HIGHEST_PROTOCOL
         elif not 0 <= protocol <= HIGHEST_PROTOCOL:
             raise ValueError("pickle protocol must be <= %d" % HIGHEST_PROTOCOL)
+        if buffer_callback is not None and protocol < 5:
+            raise ValueError("buffer_callback needs protocol >= 5")
+        self._buffer_callback = buffer_callback
+        self._memoize_atoms = memoize_atoms
         try:
-            self.write = file.write
+            self._file_write = file.write
         except AttributeError:
             raise TypeError("file must have a 'write' attribute")
+        self.framer = _Framer(self._file_write)
+        self.write = self.framer.write
+        self._write_large_bytes = self.framer.write_large_bytes
         self.memo = {}
         self.proto = int(protocol)
         self.bin = protocol >= 1
@@ -227,13 +369,16 @@ class _Pickler:
         """Write a pickled representation of obj to the open file."""
         # Check whether Pickler was initialized correctly. This is
         # only needed to mimic the behavior of _pickle.Pickler.dump().
-        if not hasattr(self, "write"):
+        if not hasattr(self, "_file_write"):
             raise PicklingError("Pickler.__init__() was not called by "
                                 "%s.__init__()" % (self.__class__.__name__,))
         if self.proto >= 2:
             self.write(PROTO + bytes([self.proto]))
+        if self.proto >= 4:
+            self.framer.start_framing()
         self.save(obj)
         self.write(STOP)
+        self.framer.end_framing()
 
     def memoize(self, obj):
         """Store an object in the memo."""
@@ -252,13 +397,20 @@ class _Pickler:
         # growable) array, indexed by memo key.
         if self.fast:
             return
+        if (not self._memoize_atoms and type(obj) in (str, bytes) and
+            len(obj) <= _MEMO_ATOM_MAX_SIZE):
+            return
         assert id(obj) not in self.memo
         memo_len = len(self.memo)
         self.write(self.put(memo_len))
         self.memo[id(obj)] = memo_len, obj
 
-    # Return a PUT (BINPUT, LONG_BINPUT) opcode string, with argument i.
+    # Return a PUT (BINPUT, LONG_BINPUT, MEMOIZE) opcode string, with
+    # argument i.  MEMOIZE takes no argument; the unpickler uses the size
+    # of its memo, which is i.
     def put(self, i, pack=struct.pack):
+        if self.proto >= 4:
+            return MEMOIZE
         if self.bin:
             if i < 256:
                 return BINPUT + bytes([i])
@@ -278,6 +430,8 @@ class _Pickler:
         return GET + repr(i).encode("ascii") + b'\n'
 
     def save(self, obj, save_persistent_id=True):
+        self.framer.commit_frame()
+
         # Check for persistent id (defined by a subclass)
         pid = self.persistent_id(obj)
         if pid is not None and save_persistent_id:
@@ -368,8 +522,25 @@ class _Pickler:
         save = self.save
         write = self.write
 
+        func_name = getattr(func, "__name__", "")
+        if self.proto >= 4 and func_name == "__newobj_ex__":
+            # Like __newobj__ below, but with keyword arguments for
+            # cls.__new__:  the arguments are (cls, args, kwargs), and
+            # NEWOBJ_EX calls cls.__new__(cls, *args, **kwargs) at
+            # unpickling time (see load_newobj_ex below).
+            cls, args, kwargs = args
+            if not hasattr(cls, "__new__"):
+                raise PicklingError("args[0] from {} args has no __new__"
+                                    .format(func_name))
+            if obj is not None and cls is not obj.__class__:
+                raise PicklingError("args[0] from {} args has the wrong class"
+                                    .format(func_name))
+            save(cls)
+            save(args)
+            save(kwargs)
+            write(NEWOBJ_EX)
         # Protocol 2 special case: if func's name is __newobj__, use NEWOBJ
-        if self.proto >= 2 and getattr(func, "__name__", "") == "__newobj__":
+        elif self.proto >= 2 and func_name == "__newobj__":
             # A __reduce__ implementation can direct protocol 2 to
             # use the more efficient NEWOBJ opcode, while still
             # allowing protocol 0 and 1 to work normally.  For this to
@@ -491,7 +662,27 @@ class _Pickler:
             self.write(FLOAT + repr(obj).encode("ascii") + b'\n')
     dispatch[float] = save_float
 
-    def save_bytes(self, obj, pack=struct.pack):
+    def _save_bytes_data(self, obj, data, pack=struct.pack):
+        n = len(data)
+        if n < 256:
+            self.write(SHORT_BINBYTES + bytes([n]) + bytes(data))
+        elif n > 0xffffffff and self.proto >= 4:
+            self._write_large_bytes(BINBYTES8 + pack("<Q", n), data)
+        elif n >= self.framer._FRAME_SIZE_TARGET:
+            self._write_large_bytes(BINBYTES + pack("<I", n), data)
+        else:
+            self.write(BINBYTES + pack("<I", n) + bytes(data))
+        self.memoize(obj)
+
+    def _save_bytearray_data(self, obj, data, pack=struct.pack):
+        n = len(data)
+        if n >= self.framer._FRAME_SIZE_TARGET:
+            self._write_large_bytes(BYTEARRAY8 + pack("<Q", n), data)
+        else:
+            self.write(BYTEARRAY8 + pack("<Q", n) + bytes(data))
+        self.memoize(obj)
+
+    def save_bytes(self, obj):
         if self.proto < 3:
             if len(obj) == 0:
                 self.save_reduce(bytes, (), obj=obj)
@@ -499,19 +690,58 @@ class _Pickler:
                 self.save_reduce(codecs.encode,
                                  (str(obj, 'latin1'), 'latin1'), obj=obj)
             return
-        n = len(obj)
-        if n < 256:
-            self.write(SHORT_BINBYTES + bytes([n]) + bytes(obj))
-        else:
-            self.write(BINBYTES + pack("<I", n) + bytes(obj))
-        self.memoize(obj)
+        self._save_bytes_data(obj, obj)
     dispatch[bytes] = save_bytes
 
+    def save_bytearray(self, obj):
+        if self.proto < 5:
+            self.save_reduce(obj=obj, *obj.__reduce_ex__(self.proto))
+            return
+        self._save_bytearray_data(obj, obj)
+    dispatch[bytearray] = save_bytearray
+
+    if _HAVE_PICKLE_BUFFER:
+        def save_picklebuffer(self, obj):
+            if self.proto < 5:
+                raise PicklingError("PickleBuffer can only be pickled with "
+                                    "protocol >= 5")
+            try:
+                m = obj.raw()
+            except BufferError:
+                raise PicklingError("PickleBuffer can not be pickled when "
+                                    "pointing to a non-contiguous buffer")
+            with m:
+                in_band = True
+                if self._buffer_callback is not None:
+                    in_band = bool(self._buffer_callback(obj))
+                if in_band:
+                    # Write data in-band
+                    if m.readonly:
+                        self._save_bytes_data(obj, m)
+                    else:
+                        self._save_bytearray_data(obj, m)
+                else:
+                    # Write data out-of-band
+                    self.write(NEXT_BUFFER)
+                    if m.readonly:
+                        self.write(READONLY_BUFFER)
+
+        dispatch[PickleBuffer] = save_picklebuffer
+
     def save_str(self, obj, pack=struct.pack):
         if self.bin:
             encoded = obj.encode('utf-8', 'surrogatepass')
             n = len(encoded)
-            self.write(BINUNICODE + pack("<I", n) + encoded)
+            if n < 256 and self.proto >= 4:
+                header = SHORT_BINUNICODE + bytes([n])
+            elif n > 0xffffffff and self.proto >= 4:
+                header = BINUNICODE8 + pack("<Q", n)
+            else:
+                header = BINUNICODE + pack("<I", n)
+            if n >= self.framer._FRAME_SIZE_TARGET:
+                self._write_large_bytes(header, encoded)
+            else:
+                self.write(header + encoded)
         else:
             obj = obj.replace("\\", "\\u005c")
             obj = obj.replace("\n", "\\u000a")
@@ -672,10 +902,66 @@ class _Pickler:
                 write(SETITEM)
             # else tmp is empty, and we're done
 
+    def save_set(self, obj):
+        save = self.save
+        write = self.write
+
+        if self.proto < 4:
+            self.save_reduce(obj=obj, *obj.__reduce_ex__(self.proto))
+            return
+
+        write(EMPTY_SET)
+        self.memoize(obj)
+
+        items = iter(obj)
+        r = range(self._BATCHSIZE)
+        while items is not None:
+            tmp = []
+            for i in r:
+                try:
+                    tmp.append(next(items))
+                except StopIteration:
+                    items = None
+                    break
+            if tmp:
+                write(MARK)
+                for x in tmp:
+                    save(x)
+                write(ADDITEMS)
+            # else tmp is empty, and we're done
+    dispatch[set] = save_set
+
+    def save_frozenset(self, obj):
+        save = self.save
+        write = self.write
+
+        if self.proto < 4:
+            self.save_reduce(obj=obj, *obj.__reduce_ex__(self.proto))
+            return
+
+        write(MARK)
+        for item in obj:
+            save(item)
+
+        if id(obj) in self.memo:
+            # If the object is already in the memo, this means it is
+            # recursive. In this case, throw away everything we put on the
+            # stack, and fetch the object back from the memo.
+            write(POP_MARK + self.get(self.memo[id(obj)][0]))
+            return
+
+        write(FROZENSET)
+        self.memoize(obj)
+    dispatch[frozenset] = save_frozenset
+
     def save_global(self, obj, name=None, pack=struct.pack):
         write = self.write
         memo = self.memo
 
+        # Protocol 4 can name nested classes and methods by their
+        # qualified name, which STACK_GLOBAL resolves one dot at a time.
+        if name is None and self.proto >= 4:
+            name = getattr(obj, '__qualname__', None)
         if name is None:
             name = obj.__name__
 
@@ -686,7 +972,10 @@ class _Pickler:
         try:
             __import__(module, level=0)
             mod = sys.modules[module]
-            klass = getattr(mod, name)
+            if self.proto >= 4:
+                klass = _getattribute(mod, name)
+            else:
+                klass = getattr(mod, name)
         except (ImportError, KeyError, AttributeError):
             raise PicklingError(
                 "Can't pickle %r: it's not found as %s.%s" %
@@ -708,8 +997,12 @@ class _Pickler:
                 else:
                     write(EXT4 + pack("<i", code))
                 return
+        if self.proto >= 4:
+            self.save(module)
+            self.save(name)
+            write(STACK_GLOBAL)
         # Non-ASCII identifiers are supported only with protocols >= 3.
-        if self.proto >= 3:
+        elif self.proto >= 3:
             write(GLOBAL + bytes(module, "utf-8") + b'\n' +
                   bytes(name, "utf-8") + b'\n')
         else:
@@ -765,6 +1058,12 @@ def _keep_alive(x, memo):
 
 classmap = {} # called classmap for backwards compatibility
 
+def _getattribute(obj, name):
+    # Resolve a dotted name such as "str.maketrans" one attribute at a time.
+    for subpath in name.split('.'):
+        obj = getattr(obj, subpath)
+    return obj
+
 def whichmodule(func, funcname):
     """Figure out the module in which a function occurs.
 
@@ -783,8 +1082,13 @@ def whichmodule(func, funcname):
     for name, module in list(sys.modules.items()):
         if module is None:
             continue # skip dummy package entries
-        if name != '__main__' and getattr(module, funcname, None) is func:
-            break
+        if name == '__main__':
+            continue
+        try:
+            if _getattribute(module, funcname) is func:
+                break
+        except AttributeError:
+            pass
     else:
         name = '__main__'
     classmap[func] = name
@@ -796,7 +1100,7 @@ def whichmodule(func, funcname):
 class _Unpickler:
 
     def __init__(self, file, *, fix_imports=True,
-                 encoding="ASCII", errors="strict"):
+                 encoding="ASCII", errors="strict", buffers=None):
         """This takes a binary file for reading a pickle data stream.
 
         The protocol version of the pickle is detected automatically, so no
@@ -816,9 +1120,15 @@ class _Unpickler:
         *encoding* and *errors* tell pickle how to decode 8-bit string
         instances pickled by Python 2.x; these default to 'ASCII' and
         'strict', respectively.
+
+        If *buffers* is not None, it should be an iterable of buffer-enabled
+        objects that is consumed each time the pickle stream references an
+        out-of-band buffer, in the order the pickler's buffer_callback saw
+        them.
         """
-        self.readline = file.readline
-        self.read = file.read
+        self._buffers = iter(buffers) if buffers is not None else None
+        self._file_readline = file.readline
+        self._file_read = file.read
         self.memo = {}
         self.encoding = encoding
         self.errors = errors
@@ -832,9 +1142,12 @@ class _Unpickler:
         """
         # Check whether Unpickler was initialized correctly. This is
         # only needed to mimic the behavior of _pickle.Unpickler.dump().
-        if not hasattr(self, "read"):
+        if not hasattr(self, "_file_read"):
             raise UnpicklingError("Unpickler.__init__() was not called by "
                                   "%s.__init__()" % (self.__class__.__name__,))
+        self._unframer = _Unframer(self._file_read, self._file_readline)
+        self.read = self._unframer.read
+        self.readline = self._unframer.readline
         self.mark = object() # any new unique object
         self.stack = []
         self.append = self.stack.append
@@ -877,6 +1190,14 @@ class _Unpickler:
         self.proto = proto
     dispatch[PROTO[0]] = load_proto
 
+    def load_frame(self, unpack=struct.unpack, maxsize=sys.maxsize):
+        frame_size, = unpack('<Q', self.read(8))
+        if frame_size > maxsize:
+            raise UnpicklingError("FRAME length exceeds system's maximum "
+                                  "of %d bytes" % maxsize)
+        self._unframer.load_frame(frame_size)
+    dispatch[FRAME[0]] = load_frame
+
     def load_persid(self):
         pid = self.readline()[:-1].decode("ascii")
         self.append(self.persistent_load(pid))
@@ -987,6 +1308,40 @@ class _Unpickler:
         self.append(self.read(len))
     dispatch[BINBYTES[0]] = load_binbytes
 
+    def load_binbytes8(self, unpack=struct.unpack, maxsize=sys.maxsize):
+        len, = unpack('<Q', self.read(8))
+        if len > maxsize:
+            raise UnpicklingError("BINBYTES8 exceeds system's maximum size of %d bytes" % maxsize);
+        self.append(self.read(len))
+    dispatch[BINBYTES8[0]] = load_binbytes8
+
+    def load_bytearray8(self, unpack=struct.unpack, maxsize=sys.maxsize):
+        len, = unpack('<Q', self.read(8))
+        if len > maxsize:
+            raise UnpicklingError("BYTEARRAY8 exceeds system's maximum size of %d bytes" % maxsize);
+        self.append(bytearray(self.read(len)))
+    dispatch[BYTEARRAY8[0]] = load_bytearray8
+
+    def load_next_buffer(self):
+        if self._buffers is None:
+            raise UnpicklingError("pickle stream refers to out-of-band data "
+                                  "but no *buffers* argument was given")
+        try:
+            buf = next(self._buffers)
+        except StopIteration:
+            raise UnpicklingError("not enough out-of-band buffers")
+        self.append(buf)
+    dispatch[NEXT_BUFFER[0]] = load_next_buffer
+
+    def load_readonly_buffer(self):
+        buf = self.stack[-1]
+        with memoryview(buf) as m:
+            if not m.readonly:
+                # A memoryview cannot be made read-only from Python code,
+                # so this falls back to a read-only copy.
+                self.stack[-1] = memoryview(bytes(m))
+    dispatch[READONLY_BUFFER[0]] = load_readonly_buffer
+
     def load_unicode(self):
         self.append(str(self.readline()[:-1], 'raw-unicode-escape'))
     dispatch[UNICODE[0]] = load_unicode
@@ -998,6 +1353,18 @@ class _Unpickler:
         self.append(str(self.read(len), 'utf-8', 'surrogatepass'))
     dispatch[BINUNICODE[0]] = load_binunicode
 
+    def load_binunicode8(self, unpack=struct.unpack, maxsize=sys.maxsize):
+        len, = unpack('<Q', self.read(8))
+        if len > maxsize:
+            raise UnpicklingError("BINUNICODE8 exceeds system's maximum size of %d bytes" % maxsize);
+        self.append(str(self.read(len), 'utf-8', 'surrogatepass'))
+    dispatch[BINUNICODE8[0]] = load_binunicode8
+
+    def load_short_binunicode(self):
+        len = ord(self.read(1))
+        self.append(str(self.read(len), 'utf-8', 'surrogatepass'))
+    dispatch[SHORT_BINUNICODE[0]] = load_short_binunicode
+
     def load_short_binstring(self):
         len = ord(self.read(1))
         data = bytes(self.read(len))
@@ -1039,6 +1406,15 @@ class _Unpickler:
         self.append({})
     dispatch[EMPTY_DICT[0]] = load_empty_dictionary
 
+    def load_empty_set(self):
+        self.append(set())
+    dispatch[EMPTY_SET[0]] = load_empty_set
+
+    def load_frozenset(self):
+        k = self.marker()
+        self.stack[k:] = [frozenset(self.stack[k+1:])]
+    dispatch[FROZENSET[0]] = load_frozenset
+
     def load_list(self):
         k = self.marker()
         self.stack[k:] = [self.stack[k+1:]]
@@ -1095,6 +1471,14 @@ class _Unpickler:
         self.stack[-1] = obj
     dispatch[NEWOBJ[0]] = load_newobj
 
+    def load_newobj_ex(self):
+        kwargs = self.stack.pop()
+        args = self.stack.pop()
+        cls = self.stack[-1]
+        obj = cls.__new__(cls, *args, **kwargs)
+        self.stack[-1] = obj
+    dispatch[NEWOBJ_EX[0]] = load_newobj_ex
+
     def load_global(self):
         module = self.readline()[:-1].decode("utf-8")
         name = self.readline()[:-1].decode("utf-8")
@@ -1102,6 +1486,14 @@ class _Unpickler:
         self.append(klass)
     dispatch[GLOBAL[0]] = load_global
 
+    def load_stack_global(self):
+        name = self.stack.pop()
+        module = self.stack.pop()
+        if type(name) is not str or type(module) is not str:
+            raise UnpicklingError("STACK_GLOBAL requires str")
+        self.append(self.find_class(module, name))
+    dispatch[STACK_GLOBAL[0]] = load_stack_global
+
     def load_ext1(self):
         code = ord(self.read(1))
         self.get_extension(code)
@@ -1142,6 +1534,8 @@ class _Unpickler:
                 module = _compat_pickle.IMPORT_MAPPING[module]
         __import__(module, level=0)
         mod = sys.modules[module]
+        if self.proto >= 4:
+            return _getattribute(mod, name)
         klass = getattr(mod, name)
         return klass
 
@@ -1207,6 +1601,11 @@ class _Unpickler:
         self.memo[i] = self.stack[-1]
     dispatch[LONG_BINPUT[0]] = load_long_binput
 
+    def load_memoize(self):
+        memo = self.memo
+        memo[len(memo)] = self.stack[-1]
+    dispatch[MEMOIZE[0]] = load_memoize
+
     def load_append(self):
         stack = self.stack
         value = stack.pop()
@@ -1246,6 +1645,20 @@ class _Unpickler:
         del stack[mark:]
     dispatch[SETITEMS[0]] = load_setitems
 
+    def load_additems(self):
+        stack = self.stack
+        mark = self.marker()
+        set_obj = stack[mark - 1]
+        items = stack[mark + 1:]
+        if isinstance(set_obj, set):
+            set_obj.update(items)
+        else:
+            add = set_obj.add
+            for item in items:
+                add(item)
+        del stack[mark:]
+    dispatch[ADDITEMS[0]] = load_additems
+
     def load_build(self):
         stack = self.stack
         state = stack.pop()
@@ -1333,25 +1746,33 @@ def decode_long(data):
 
 # Shorthands
 
-def dump(obj, file, protocol=None, *, fix_imports=True):
-    Pickler(file, protocol, fix_imports=fix_imports).dump(obj)
+def dump(obj, file, protocol=None, *, fix_imports=True,
+         buffer_callback=None, memoize_atoms=True):
+    Pickler(file, protocol, fix_imports=fix_imports,
+            buffer_callback=buffer_callback,
+            memoize_atoms=memoize_atoms).dump(obj)
 
-def dumps(obj, protocol=None, *, fix_imports=True):
+def dumps(obj, protocol=None, *, fix_imports=True, buffer_callback=None,
+          memoize_atoms=True):
     f = io.BytesIO()
-    Pickler(f, protocol, fix_imports=fix_imports).dump(obj)
+    Pickler(f, protocol, fix_imports=fix_imports,
+            buffer_callback=buffer_callback,
+            memoize_atoms=memoize_atoms).dump(obj)
     res = f.getvalue()
     assert isinstance(res, bytes_types)
     return res
 
-def load(file, *, fix_imports=True, encoding="ASCII", errors="strict"):
-    return Unpickler(file, fix_imports=fix_imports,
+def load(file, *, fix_imports=True, encoding="ASCII", errors="strict",
+         buffers=None):
+    return Unpickler(file, fix_imports=fix_imports, buffers=buffers,
                      encoding=encoding, errors=errors).load()
 
-def loads(s, *, fix_imports=True, encoding="ASCII", errors="strict"):
+def loads(s, *, fix_imports=True, encoding="ASCII", errors="strict",
+          buffers=None):
     if isinstance(s, str):
         raise TypeError("Can't load pickle from unicode string")
     file = io.BytesIO(s)
-    return Unpickler(file, fix_imports=fix_imports,
+    return Unpickler(file, fix_imports=fix_imports, buffers=buffers,
                      encoding=encoding, errors=errors).load()
 
 # Use the faster _pickle if possible
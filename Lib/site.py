@@ -574,6 +574,23 @@ def execusercustomize():
                 (err.__class__.__name__, err))
 
 
+def saveimportindex():
+    """Write the import index named by -X importindex back at exit, if
+    importing modules added to it."""
+    path = sys._xoptions.get('importindex')
+    if not isinstance(path, str):
+        return
+    import atexit
+    from importlib.machinery import ImportIndex
+    def save():
+        if ImportIndex.changed():
+            try:
+                ImportIndex.dump(path)
+            except OSError:
+                pass
+    atexit.register(save)
+
+
 def main():
     """Add standard site-specific directories to the module search path.
 
@@ -598,6 +615,7 @@ def main():
     execsitecustomize()
     if ENABLE_USER_SITE:
         execusercustomize()
+    saveimportindex()
 
 # Prevent edition of sys.path when python was started with -S and
 # site is imported later.
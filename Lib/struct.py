@@ -1,6 +1,7 @@
 __all__ = [
     # Functions
     'calcsize', 'pack', 'pack_into', 'unpack', 'unpack_from',
+    'iter_unpack', 'unpack_many', 'pack_many', 'pack_many_into',
 
     # Classes
     'Struct',
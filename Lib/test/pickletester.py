@@ -470,6 +470,18 @@ DATA9 = (b'\x80\x02cexceptions\nUnicodeEncodeError\n'
          b'q\x00(U\x05asciiq\x01X\x03\x00\x00\x00fooq\x02K\x00K\x01'
          b'U\x03badq\x03tq\x04Rq\x05.')
 
+# {'set': {1, 2, 3}, 'fs': frozenset({4, 5}), 's': 'abc', 't': (1, 'abc'),
+#  'mt': str.maketrans} pickled from 3.11 with protocol 4
+DATA10 = (b'\x80\x04\x95t\x00\x00\x00\x00\x00\x00\x00}\x94(\x8c\x03set'
+          b'\x94\x8f\x94(K\x01K\x02K\x03\x90\x8c\x02fs\x94(K\x04K\x05\x91'
+          b'\x94\x8c\x01s\x94\x8c\x03abc\x94\x8c\x01t\x94K\x01h\x06\x86\x94'
+          b'\x8c\x02mt\x94\x8c\x08builtins\x94\x8c\x07getattr\x94\x93\x94'
+          b'\x8c\x08builtins\x94\x8c\x03str\x94\x93\x94\x8c\tmaketrans\x94'
+          b'\x86\x94R\x94u.')
+
+# str.maketrans pickled with protocol 4, using a dotted STACK_GLOBAL name
+DATA11 = b'\x80\x04\x8c\x08builtins\x8c\rstr.maketrans\x93.'
+
 
 def create_data():
     c = C()
@@ -718,6 +730,48 @@ class AbstractPickleTests(unittest.TestCase):
                 p = self.dumps(s, proto)
                 self.assertEqual(self.loads(p), s)
 
+    def test_bytearray(self):
+        for proto in protocols:
+            for s in b'', b'xyz', b'xyz'*100:
+                b = bytearray(s)
+                p = self.dumps(b, proto)
+                bb = self.loads(p)
+                self.assertIsNot(bb, b)
+                self.assertEqual(type(bb), bytearray)
+                self.assertEqual(bb, b)
+                if proto >= 5:
+                    self.assertTrue(opcode_in_pickle(pickle.BYTEARRAY8, p))
+
+    def test_sets(self):
+        for proto in protocols:
+            for x in set(), {1, 2, 3}, frozenset(), frozenset('abc'):
+                s = self.dumps(x, proto)
+                y = self.loads(s)
+                self.assertEqual(x, y)
+                self.assertIs(type(y), type(x))
+                if proto >= 4:
+                    opcode = (pickle.EMPTY_SET if type(x) is set
+                              else pickle.FROZENSET)
+                    self.assertTrue(opcode_in_pickle(opcode, s))
+            # Several ADDITEMS batches.
+            x = set(range(2500))
+            s = self.dumps(x, proto)
+            self.assertEqual(self.loads(s), x)
+            if proto >= 4:
+                self.assertEqual(count_opcode(pickle.ADDITEMS, s), 3)
+
+    def test_recursive_frozenset(self):
+        b = BBB()
+        fs = frozenset([b])
+        b.fs = fs
+        # Older protocols rebuild frozensets with REDUCE, which cannot
+        # express the cycle.
+        for proto in range(4, pickle.HIGHEST_PROTOCOL + 1):
+            s = self.dumps(fs, proto)
+            y = self.loads(s)
+            self.assertIs(type(y), frozenset)
+            self.assertIs(list(y)[0].fs, y)
+
     def test_ints(self):
         import sys
         for proto in protocols:
@@ -902,6 +956,18 @@ class AbstractPickleTests(unittest.TestCase):
                            (3, 2): pickle.TUPLE2,
                            (3, 3): pickle.TUPLE3,
                            (3, 4): pickle.TUPLE,
+
+                           (4, 0): pickle.EMPTY_TUPLE,
+                           (4, 1): pickle.TUPLE1,
+                           (4, 2): pickle.TUPLE2,
+                           (4, 3): pickle.TUPLE3,
+                           (4, 4): pickle.TUPLE,
+
+                           (5, 0): pickle.EMPTY_TUPLE,
+                           (5, 1): pickle.TUPLE1,
+                           (5, 2): pickle.TUPLE2,
+                           (5, 3): pickle.TUPLE3,
+                           (5, 4): pickle.TUPLE,
                           }
         a = ()
         b = (1,)
@@ -922,16 +988,22 @@ class AbstractPickleTests(unittest.TestCase):
                            (1, None): pickle.NONE,
                            (2, None): pickle.NONE,
                            (3, None): pickle.NONE,
+                           (4, None): pickle.NONE,
+                           (5, None): pickle.NONE,
 
                            (0, True): pickle.INT,
                            (1, True): pickle.INT,
                            (2, True): pickle.NEWTRUE,
                            (3, True): pickle.NEWTRUE,
+                           (4, True): pickle.NEWTRUE,
+                           (5, True): pickle.NEWTRUE,
 
                            (0, False): pickle.INT,
                            (1, False): pickle.INT,
                            (2, False): pickle.NEWFALSE,
                            (3, False): pickle.NEWFALSE,
+                           (4, False): pickle.NEWFALSE,
+                           (5, False): pickle.NEWFALSE,
                           }
         for proto in protocols:
             for x in None, False, True:
@@ -961,6 +1033,34 @@ class AbstractPickleTests(unittest.TestCase):
             self.assertEqual(list(x), list(y))
             self.assertEqual(x.__dict__, y.__dict__)
 
+    def test_newobj_ex(self):
+        x = KeywordNewObj.__new__(KeywordNewObj, 0xface)
+        x.abc = 666
+        for proto in protocols:
+            s = self.dumps(x, proto)
+            y = self.loads(s)
+            self.assertIs(type(y), KeywordNewObj)
+            self.assertEqual(int(y), 0xface)
+            self.assertEqual(y.__dict__, x.__dict__)
+            self.assertEqual(opcode_in_pickle(pickle.NEWOBJ_EX, s),
+                             proto >= 4)
+
+    def test_nested_names(self):
+        for proto in protocols:
+            for obj in Nested.Inner, Nested.Inner.method:
+                if proto < 4:
+                    # The plain __name__ isn't found in the module.
+                    self.assertRaises((pickle.PicklingError, TypeError),
+                                      self.dumps, obj, proto)
+                    continue
+                s = self.dumps(obj, proto)
+                self.assertIs(self.loads(s), obj)
+                self.assertTrue(opcode_in_pickle(pickle.STACK_GLOBAL, s))
+            if proto >= 4:
+                x = Nested.Inner()
+                self.assertIs(type(self.loads(self.dumps(x, proto))),
+                              Nested.Inner)
+
     def test_newobj_generic(self):
         for proto in protocols:
             for C in myclasses:
@@ -1248,6 +1348,27 @@ class AbstractPickleTests(unittest.TestCase):
         dumped = self.dumps(set([3]), 2)
         self.assertEqual(dumped, DATA6)
 
+    def test_load_python34_proto4(self):
+        # Protocol 4 as written by Python 3.4 and later: framing, MEMOIZE,
+        # SHORT_BINUNICODE, set opcodes and STACK_GLOBAL.
+        loaded = self.loads(DATA10)
+        self.assertEqual(loaded, {'set': {1, 2, 3}, 'fs': frozenset([4, 5]),
+                                  's': 'abc', 't': (1, 'abc'),
+                                  'mt': str.maketrans})
+        self.assertIs(type(loaded['fs']), frozenset)
+        self.assertIs(loaded['t'][1], loaded['s'])
+        self.assertIs(self.loads(DATA11), str.maketrans)
+
+    def test_stack_global(self):
+        for proto in protocols:
+            s = self.dumps(len, proto)
+            self.assertIs(self.loads(s), len)
+            self.assertEqual(opcode_in_pickle(pickle.STACK_GLOBAL, s),
+                             proto >= 4)
+        # The names must be str objects.
+        self.assertRaises(pickle.UnpicklingError, self.loads,
+                          b'\x80\x04\x8c\x08builtinsC\x03len\x93.')
+
     def test_large_pickles(self):
         # Test the correctness of internal buffering routines when handling
         # large data.
@@ -1269,7 +1390,10 @@ class AbstractPickleTests(unittest.TestCase):
             sizes = [len(self.dumps(2**n, proto)) for n in range(70)]
             # the size function is monotonic
             self.assertEqual(sorted(sizes), sizes)
-            if proto >= 2:
+            if proto >= 4:
+                # plus the 9 bytes of the FRAME header
+                self.assertLessEqual(sizes[-1], 14 + 9)
+            elif proto >= 2:
                 self.assertLessEqual(sizes[-1], 14)
 
     def check_negative_32b_binXXX(self, dumped):
@@ -1301,6 +1425,74 @@ class AbstractPickleTests(unittest.TestCase):
         dumped = b'\x80\x03X\x01\x00\x00\x00ar\xff\xff\xff\xff.'
         self.assertRaises(ValueError, self.loads, dumped)
 
+    FRAME_SIZE_MIN = 4
+    FRAME_SIZE_TARGET = 64 * 1024
+
+    def check_frame_opcodes(self, pickled):
+        # Frames end on opcode boundaries.  Outside of frames there may only
+        # be large payloads, and runs of opcodes too short to be worth a
+        # frame header.
+        frameless_opcodes = {'BINBYTES', 'BINBYTES8', 'BINUNICODE',
+                             'BINUNICODE8', 'BYTEARRAY8'}
+        frame_end = frameless_start = None
+        for op, arg, pos in pickletools.genops(pickled):
+            if frame_end is not None:
+                self.assertLessEqual(pos, frame_end)
+                if pos == frame_end:
+                    frame_end = None
+            if frame_end is not None:
+                self.assertNotEqual(op.name, 'FRAME')
+            elif (op.name == 'FRAME' or
+                  (op.name in frameless_opcodes and
+                   len(arg) >= self.FRAME_SIZE_TARGET)):
+                if frameless_start is not None:
+                    self.assertLess(pos - frameless_start,
+                                    self.FRAME_SIZE_MIN)
+                    frameless_start = None
+            elif frameless_start is None and op.name != 'PROTO':
+                frameless_start = pos
+            if op.name == 'FRAME':
+                self.assertGreaterEqual(arg, self.FRAME_SIZE_MIN)
+                frame_end = pos + 9 + arg
+        pos = len(pickled)
+        if frame_end is not None:
+            self.assertEqual(frame_end, pos)
+        elif frameless_start is not None:
+            self.assertLess(pos - frameless_start, self.FRAME_SIZE_MIN)
+
+    def test_framing_many_objects(self):
+        obj = list(range(10**5))
+        for proto in range(4, pickle.HIGHEST_PROTOCOL + 1):
+            pickled = self.dumps(obj, proto)
+            self.assertEqual(self.loads(pickled), obj)
+            self.assertGreaterEqual(count_opcode(pickle.FRAME, pickled), 2)
+            self.check_frame_opcodes(pickled)
+
+    def test_framing_large_objects(self):
+        N = 1024 * 1024
+        obj = [b'x' * N, bytearray(b'y' * N), 'z' * N, list(range(100))]
+        for proto in range(4, pickle.HIGHEST_PROTOCOL + 1):
+            pickled = self.dumps(obj, proto)
+            unpickled = self.loads(pickled)
+            self.assertEqual(unpickled, obj)
+            self.assertEqual(type(unpickled[1]), bytearray)
+            self.check_frame_opcodes(pickled)
+
+    def test_picklebuffer_in_band(self):
+        for proto in protocols:
+            pb = pickle.PickleBuffer(b'abc' * 100)
+            if proto < 5:
+                self.assertRaises(pickle.PicklingError, self.dumps, pb, proto)
+                continue
+            # Read-only buffers come back as bytes, writable ones as
+            # bytearrays; the same PickleBuffer is memoized.
+            data = self.loads(self.dumps([pb, pb], proto))
+            self.assertEqual(data, [b'abc' * 100] * 2)
+            self.assertIs(data[0], data[1])
+            pb = pickle.PickleBuffer(bytearray(b'xyz'))
+            self.assertEqual(self.loads(self.dumps(pb, proto)),
+                             bytearray(b'xyz'))
+
     def _check_pickling_with_opcode(self, obj, opcode, proto):
         pickled = self.dumps(obj, proto)
         self.assertTrue(opcode_in_pickle(opcode, pickled))
@@ -1366,7 +1558,8 @@ class BigmemPickleTests(unittest.TestCase):
         data = b"a" * size
         try:
             for proto in protocols:
-                if proto < 3:
+                # Protocol 4 and above have BINBYTES8
+                if proto != 3:
                     continue
                 with self.assertRaises((ValueError, OverflowError)):
                     self.dumps(data, protocol=proto)
@@ -1398,7 +1591,8 @@ class BigmemPickleTests(unittest.TestCase):
         data = "a" * size
         try:
             for proto in protocols:
-                if proto == 0:
+                # Protocol 4 and above have BINUNICODE8
+                if proto == 0 or proto >= 4:
                     continue
                 with self.assertRaises((ValueError, OverflowError)):
                     self.dumps(data, protocol=proto)
@@ -1511,6 +1705,18 @@ class SimpleNewObj(object):
         # raise an error, to make sure this isn't called
         raise TypeError("SimpleNewObj.__init__() didn't expect to get called")
 
+class KeywordNewObj(int):
+    def __init__(self, *args, **kwargs):
+        # raise an error, to make sure this isn't called
+        raise TypeError("KeywordNewObj.__init__() didn't expect to get called")
+    def __getnewargs_ex__(self):
+        return ('%X' % self,), {'base': 16}
+
+class Nested:
+    class Inner:
+        def method(self):
+            pass
+
 class BadGetattr:
     def __getattr__(self, key):
         self.foo
@@ -1546,7 +1752,7 @@ class AbstractPickleModuleTests(unittest.TestCase):
 
     def test_highest_protocol(self):
         # Of course this needs to be changed when HIGHEST_PROTOCOL changes.
-        self.assertEqual(pickle.HIGHEST_PROTOCOL, 3)
+        self.assertEqual(pickle.HIGHEST_PROTOCOL, 5)
 
     def test_callapi(self):
         f = io.BytesIO()
@@ -1754,6 +1960,96 @@ class AbstractPicklerUnpicklerObjectTests(unittest.TestCase):
     def test_multiple_unpicklings_unseekable(self):
         self._check_multiple_unpicklings(UnseekableIO)
 
+    def test_buffer_callback(self):
+        ro = pickle.PickleBuffer(b'abc' * 100000)
+        rw = pickle.PickleBuffer(bytearray(b'xyz' * 10))
+        data = [ro, rw, ro]
+        for proto in protocols:
+            f = io.BytesIO()
+            if proto < 5:
+                self.assertRaises(ValueError, self.pickler_class, f, proto,
+                                  buffer_callback=list().append)
+                continue
+            buffers = []
+            self.pickler_class(f, proto,
+                               buffer_callback=buffers.append).dump(data)
+            pickled = f.getvalue()
+            # The buffer contents stay out of the pickle.
+            self.assertLess(len(pickled), 100)
+            self.assertEqual(buffers, [ro, rw, ro])
+            self.assertEqual(count_opcode(pickle.NEXT_BUFFER, pickled), 3)
+            self.assertEqual(count_opcode(pickle.READONLY_BUFFER, pickled), 2)
+
+            u = self.unpickler_class(io.BytesIO(pickled), buffers=buffers)
+            new = u.load()
+            self.assertEqual([bytes(memoryview(b)) for b in new],
+                             [bytes(ro.raw()), bytes(rw.raw()),
+                              bytes(ro.raw())])
+            self.assertTrue(memoryview(new[0]).readonly)
+            self.assertFalse(memoryview(new[1]).readonly)
+            # Writable buffers declared read-only are made read-only.
+            u = self.unpickler_class(io.BytesIO(pickled),
+                                     buffers=[bytearray(b'a')] * 3)
+            new = u.load()
+            self.assertTrue(memoryview(new[0]).readonly)
+            self.assertFalse(memoryview(new[1]).readonly)
+
+            # Missing buffers are an error.
+            u = self.unpickler_class(io.BytesIO(pickled))
+            self.assertRaises(pickle.UnpicklingError, u.load)
+            u = self.unpickler_class(io.BytesIO(pickled), buffers=buffers[:2])
+            self.assertRaises(pickle.UnpicklingError, u.load)
+
+            # A true result from the callback keeps the buffer in-band.
+            f = io.BytesIO()
+            self.pickler_class(f, proto,
+                               buffer_callback=lambda b: True).dump(data)
+            new = self.unpickler_class(io.BytesIO(f.getvalue())).load()
+            self.assertEqual(new, [b'abc' * 100000, bytearray(b'xyz' * 10),
+                                   b'abc' * 100000])
+
+    def test_memoize_atoms(self):
+        short_str, short_bytes = 'abc' * 3, b'xyz' * 3
+        long_str = 'abc' * 100
+        shared = [1, 2]
+        # 64 is the longest size still treated as an atom.
+        atom_str, nonatom_bytes = 'x' * 64, b'y' * 65
+        data = [short_str, short_str, short_bytes, short_bytes,
+                long_str, long_str, shared, shared,
+                atom_str, atom_str, nonatom_bytes, nonatom_bytes]
+        for proto in protocols:
+            f = io.BytesIO()
+            self.pickler_class(f, proto).dump(data)
+            memoized = f.getvalue()
+            f = io.BytesIO()
+            self.pickler_class(f, proto, memoize_atoms=False).dump(data)
+            pickled = f.getvalue()
+            puts = lambda p: (count_opcode(pickle.PUT, p) +
+                              count_opcode(pickle.BINPUT, p) +
+                              count_opcode(pickle.MEMOIZE, p))
+            self.assertLess(puts(pickled), puts(memoized))
+            new = self.unpickler_class(io.BytesIO(pickled)).load()
+            self.assertEqual(new, data)
+            # Short strings are written twice, everything else is shared.
+            self.assertIsNot(new[0], new[1])
+            self.assertIs(new[4], new[5])
+            self.assertIs(new[6], new[7])
+            self.assertIsNot(new[8], new[9])
+            self.assertIs(new[10], new[11])
+
+    def test_large_memo(self):
+        # Enough distinct objects to make the memo grow several times.
+        objs = [[i] for i in range(20000)]
+        data = {'a': objs, 'b': list(reversed(objs)),
+                'c': [(o, str(i)) for i, o in enumerate(objs)]}
+        for proto in protocols:
+            f = io.BytesIO()
+            self.pickler_class(f, proto).dump(data)
+            new = self.unpickler_class(io.BytesIO(f.getvalue())).load()
+            self.assertEqual(new, data)
+            self.assertIs(new['a'][0], new['b'][-1])
+            self.assertIs(new['a'][123], new['c'][123][0])
+
     def test_unpickling_buffering_readline(self):
         # Issue #12687: the unpickler's buffering logic could fail with
         # text mode opcodes.
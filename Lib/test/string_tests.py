@@ -212,6 +212,28 @@ class BaseTest:
                 if loc != -1:
                     self.assertEqual(i[loc:loc+len(j)], j)
 
+    def test_find_long(self):
+        # Needles and haystacks long enough to go through the vectorized
+        # search and the Two-Way algorithm
+        for m in (2, 3, 15, 16, 17, 33, 99, 100, 101, 250):
+            half = m // 2
+            for needle in ('a' * (m - 1) + 'b', 'b' + 'a' * (m - 1),
+                           'ab' * half + 'c' * (m % 2),
+                           'a' * half + 'b' + 'a' * (m - half - 1)):
+                for n in (m, 100, 2500):
+                    haystack = 'a' * n
+                    self.checkequal(-1, haystack, 'find', needle)
+                    self.checkequal(0, haystack, 'count', needle)
+                    for pos in (0, 1, n // 2, n):
+                        s = haystack[:pos] + needle + haystack[pos:]
+                        self.checkequal(pos, s, 'find', needle)
+                        self.checkequal(pos, s, 'index', needle)
+                        self.checkequal(1, s, 'count', needle)
+                    s = (needle + 'x') * 40
+                    self.checkequal(40, s, 'count', needle)
+                    self.checkequal(m + 1, s, 'find', needle, 1)
+                    self.checkequal(40, s, 'count', 'x')
+
     def test_rfind(self):
         self.checkequal(9,  'abcdefghiabc', 'rfind', 'abc')
         self.checkequal(12, 'abcdefghiabc', 'rfind', '')
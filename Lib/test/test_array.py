@@ -7,6 +7,7 @@ from test import support
 import weakref
 import pickle
 import operator
+import bisect
 import io
 import math
 import struct
@@ -215,6 +216,41 @@ class BaseTest:
         self.assertIsInstance(bi[1], int)
         self.assertEqual(bi[1], len(a))
 
+    def test_frombuffer(self):
+        a = array.array(self.typecode, self.example)
+        raw = bytearray(a.tobytes())
+        b = array.frombuffer(self.typecode, raw)
+        self.assertEqual(b, a)
+        b[0] = b[1]
+        self.assertEqual(raw[:a.itemsize], raw[a.itemsize:2*a.itemsize])
+        raw[:a.itemsize] = a.tobytes()[:a.itemsize]
+        self.assertEqual(b, a)
+        # Same-size slice assignment is fine, resizing is not
+        b[1:3] = a[2:4]
+        self.assertEqual(b[1:3], a[2:4])
+        self.assertRaises(BufferError, b.append, a[0])
+        self.assertRaises(BufferError, b.extend, a)
+        self.assertRaises(BufferError, b.pop)
+        self.assertRaises(BufferError, b.frombytes, a.tobytes())
+        def delslice():
+            del b[1:3]
+        self.assertRaises(BufferError, delslice)
+        self.assertEqual(len(b), len(a))
+        self.assertRaises(BufferError, raw.append, 0)
+        del b
+        raw.append(0)
+
+        if a.itemsize > 1:
+            # Partial items and misaligned memory are rejected
+            self.assertRaises(ValueError, array.frombuffer, self.typecode,
+                              bytearray(a.itemsize + 1))
+            unaligned = memoryview(bytearray(2 * a.itemsize))[1:-1]
+            self.assertRaises(ValueError, array.frombuffer, self.typecode,
+                              unaligned[:a.itemsize])
+        self.assertRaises(BufferError, array.frombuffer, self.typecode,
+                          a.tobytes())
+        self.assertRaises(ValueError, array.frombuffer, 'x', bytearray(8))
+
     def test_byteswap(self):
         if self.typecode == 'u':
             example = '\U00100100'
@@ -1016,14 +1052,14 @@ class BaseTest:
     @support.cpython_only
     def test_sizeof_with_buffer(self):
         a = array.array(self.typecode, self.example)
-        basesize = support.calcvobjsize('Pn2Pi')
+        basesize = support.calcvobjsize('Pn3Pi')
         buffer_size = a.buffer_info()[1] * a.itemsize
         support.check_sizeof(self, a, basesize + buffer_size)
 
     @support.cpython_only
     def test_sizeof_without_buffer(self):
         a = array.array(self.typecode)
-        basesize = support.calcvobjsize('Pn2Pi')
+        basesize = support.calcvobjsize('Pn3Pi')
         support.check_sizeof(self, a, basesize)
 
 
@@ -1172,6 +1208,51 @@ class NumberTest(BaseTest):
         b = array.array(self.typecode, a)
         self.assertEqual(a, b)
 
+    def test_sum_min_max(self):
+        a = array.array(self.typecode, self.example * 3)
+        self.assertEntryEqual(a.sum(), sum(a.tolist()))
+        self.assertEqual(a.min(), min(a.tolist()))
+        self.assertEqual(a.max(), max(a.tolist()))
+        a = array.array(self.typecode)
+        self.assertEqual(a.sum(), 0)
+        self.assertRaises(ValueError, a.min)
+        self.assertRaises(ValueError, a.max)
+
+    def test_dot(self):
+        a = array.array(self.typecode, self.example)
+        b = array.array(self.typecode, self.biggerexample)
+        self.assertEntryEqual(a.dot(b),
+                              sum(x * y for x, y in zip(a.tolist(),
+                                                        b.tolist())))
+        self.assertRaises(ValueError, a.dot, b[1:])
+        self.assertRaises(TypeError, a.dot, self.example)
+        other = 'd' if self.typecode != 'd' else 'f'
+        self.assertRaises(TypeError, a.dot, array.array(other, a.tolist()))
+
+    def test_add_mul(self):
+        a = array.array(self.typecode, range(10))
+        a.add(2)
+        self.assertEqual(a.tolist(), list(range(2, 12)))
+        a.mul(3)
+        self.assertEqual(a.tolist(), [3 * x for x in range(2, 12)])
+        a.add(array.array(self.typecode, range(10)))
+        self.assertEqual(a.tolist(), [4 * x + 6 for x in range(10)])
+        a.mul(array.array(self.typecode, [2] * 10))
+        self.assertEqual(a.tolist(), [8 * x + 12 for x in range(10)])
+        self.assertRaises(ValueError, a.add, array.array(self.typecode, [1]))
+        self.assertRaises(TypeError, a.mul, 'x')
+
+    def test_searchsorted(self):
+        a = array.array(self.typecode, sorted(self.example + self.example))
+        items = a.tolist()
+        for x in items + [self.outside]:
+            self.assertEqual(a.searchsorted(x), bisect.bisect_left(items, x))
+            self.assertEqual(a.searchsorted(x, side='right'),
+                             bisect.bisect_right(items, x))
+        self.assertEqual(a.searchsorted(-10**30), 0)
+        self.assertEqual(a.searchsorted(10**30), len(a))
+        self.assertRaises(ValueError, a.searchsorted, 0, side='middle')
+
 class SignedNumberTest(NumberTest):
     example = [-1, 0, 1, 42, 0x7f]
     smallerexample = [-1, 0, 1, 42, 0x7e]
@@ -1184,6 +1265,23 @@ class SignedNumberTest(NumberTest):
         upper = int(pow(2, a.itemsize * 8 - 1)) - 1
         self.check_overflow(lower, upper)
 
+    def test_exact_kernels(self):
+        a = array.array(self.typecode)
+        lower = -1 * int(pow(2, a.itemsize * 8 - 1))
+        upper = int(pow(2, a.itemsize * 8 - 1)) - 1
+        a = array.array(self.typecode, [upper, upper, lower, -1, upper])
+        self.assertEqual(a.sum(), 3 * upper + lower - 1)
+        self.assertEqual(a.dot(a), 3 * upper ** 2 + lower ** 2 + 1)
+        self.assertEqual((a.min(), a.max()), (lower, upper))
+        # Overflowing results leave the array unchanged
+        self.assertRaises(OverflowError, a.add, 1)
+        self.assertRaises(OverflowError, a.add, -1)
+        self.assertRaises(OverflowError, a.mul, 2)
+        self.assertEqual(a.tolist(), [upper, upper, lower, -1, upper])
+        a = array.array(self.typecode, [upper, lower + 1])
+        a.mul(-1)
+        self.assertEqual(a.tolist(), [-upper, -lower - 1])
+
 class UnsignedNumberTest(NumberTest):
     example = [0, 1, 17, 23, 42, 0xff]
     smallerexample = [0, 1, 17, 23, 42, 0xfe]
@@ -1196,6 +1294,23 @@ class UnsignedNumberTest(NumberTest):
         upper = int(pow(2, a.itemsize * 8)) - 1
         self.check_overflow(lower, upper)
 
+    def test_exact_kernels(self):
+        a = array.array(self.typecode)
+        upper = int(pow(2, a.itemsize * 8)) - 1
+        a = array.array(self.typecode, [upper, upper, 0, 1, upper])
+        self.assertEqual(a.sum(), 3 * upper + 1)
+        self.assertEqual(a.dot(a), 3 * upper ** 2 + 1)
+        self.assertEqual((a.min(), a.max()), (0, upper))
+        # Overflowing results leave the array unchanged
+        self.assertRaises(OverflowError, a.add, 1)
+        self.assertRaises(OverflowError, a.add, -1)
+        self.assertRaises(OverflowError, a.mul, 2)
+        self.assertRaises(OverflowError, a.mul, -1)
+        self.assertEqual(a.tolist(), [upper, upper, 0, 1, upper])
+        a = array.array(self.typecode, [5, 10])
+        a.add(-5)
+        self.assertEqual(a.tolist(), [0, 5])
+
     def test_bytes_extend(self):
         s = bytes(self.example)
 
@@ -1265,6 +1380,16 @@ class FPTest(NumberTest):
     def assertEntryEqual(self, entry1, entry2):
         self.assertAlmostEqual(entry1, entry2)
 
+    def test_nan_kernels(self):
+        a = array.array(self.typecode, [1.0, float('nan'), -1.0])
+        self.assertTrue(math.isnan(a.min()))
+        self.assertTrue(math.isnan(a.max()))
+        self.assertTrue(math.isnan(a.sum()))
+        a = array.array(self.typecode, [0.5, 1.5])
+        a.add(0.25)
+        a.mul(2)
+        self.assertEqual(a.tolist(), [1.5, 3.5])
+
     def test_byteswap(self):
         a = array.array(self.typecode, self.example)
         self.assertRaises(TypeError, a.byteswap, 42)
@@ -191,6 +191,20 @@ class BZ2FileTest(BaseTest):
             self.assertEqual(bz2f.readinto(b), n)
             self.assertEqual(b[:n], self.TEXT[-n:])
 
+    def testReadIntoMultiStream(self):
+        self.createTempFile(streams=5, suffix=self.BAD_DATA)
+        with BZ2File(self.filename) as bz2f:
+            blocks = []
+            b = bytearray(100)
+            while True:
+                n = bz2f.readinto(b)
+                if not n:
+                    break
+                blocks.append(bytes(b[:n]))
+                blocks.append(bz2f.read(7))
+            self.assertEqual(b"".join(blocks), self.TEXT * 5)
+            self.assertEqual(bz2f.tell(), len(self.TEXT) * 5)
+
     def testReadLine(self):
         self.createTempFile()
         with BZ2File(self.filename) as bz2f:
@@ -678,6 +692,35 @@ class BZ2DecompressorTest(BaseTest):
         self.assertRaises(EOFError, bz2d.decompress, b"anything")
         self.assertRaises(EOFError, bz2d.decompress, b"")
 
+    def testDecompressInto(self):
+        bz2d = BZ2Decompressor()
+        self.assertTrue(bz2d.needs_input)
+        unused_data = b"this is unused data"
+        data = self.DATA + unused_data
+        b = bytearray(10)
+        text = []
+        n = 0
+        while not bz2d.eof:
+            if bz2d.needs_input:
+                chunk = data[n*50:(n+1)*50]
+                n += 1
+            else:
+                chunk = b""
+            text.append(bytes(b[:bz2d.decompress_into(chunk, b)]))
+        self.assertEqual(b"".join(text), self.TEXT)
+        self.assertFalse(bz2d.needs_input)
+        self.assertEqual(bz2d.unused_data + data[n*50:], unused_data)
+        self.assertRaises(EOFError, bz2d.decompress_into, b"", b)
+
+    def testDecompressAfterDecompressInto(self):
+        # Input held back by decompress_into() is used by decompress()
+        bz2d = BZ2Decompressor()
+        b = bytearray(10)
+        self.assertEqual(bz2d.decompress_into(self.DATA, b), 10)
+        self.assertFalse(bz2d.needs_input)
+        self.assertEqual(bytes(b) + bz2d.decompress(b""), self.TEXT)
+        self.assertTrue(bz2d.eof)
+
     @bigmemtest(size=_4G + 100, memuse=3.3)
     def testDecompress4G(self, size):
         # "Test BZ2Decompressor.decompress() with >4GiB input"
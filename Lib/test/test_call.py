@@ -122,6 +122,41 @@ class CFunctionCalls(unittest.TestCase):
     def test_oldargs1_2_kw(self):
         self.assertRaises(TypeError, [].count, x=2, y=2)
 
+    def test_fastcall0(self):
+        self.assertRaises(TypeError, {}.get)
+
+    def test_fastcall1(self):
+        self.assertIsNone({}.get(0))
+
+    def test_fastcall2(self):
+        self.assertEqual({}.get(0, 1), 1)
+
+    def test_fastcall3(self):
+        self.assertRaises(TypeError, {}.get, 0, 1, 2)
+
+    def test_fastcall_ext(self):
+        self.assertEqual({}.get(*(0, 1)), 1)
+        self.assertEqual(dict.get({0: 2}, *(0,)), 2)
+
+    def test_fastcall_kw(self):
+        self.assertRaises(TypeError, {}.get, x=2)
+        self.assertRaises(TypeError, {}.get, 0, x=2)
+        self.assertRaises(TypeError, {}.get, **{'x': 2})
+
+    def test_fastcall_from_c(self):
+        # PyObject_CallFunctionObjArgs() passes its arguments on the C
+        # stack; make sure every kind of callable still sees them.
+        import operator
+        self.assertEqual(sorted([3, 1, 2], key={1: 'c', 2: 'b', 3: 'a'}.get),
+                         [3, 2, 1])
+        self.assertEqual(sorted([3, 1, 2], key=lambda x: -x), [3, 2, 1])
+        self.assertEqual(sorted([3, 1, 2], key=operator.neg), [3, 2, 1])
+        class Neg:
+            def neg(self, x):
+                return -x
+        self.assertEqual(sorted([3, 1, 2], key=Neg().neg), [3, 2, 1])
+        self.assertEqual(list(map(divmod, [7, 8], [2, 3])), [(3, 1), (2, 2)])
+
 
 def test_main():
     support.run_unittest(CFunctionCalls)
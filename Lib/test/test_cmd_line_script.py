@@ -173,6 +173,20 @@ class CmdLineTest(unittest.TestCase):
                                pyc_file, script_dir, None,
                                importlib.machinery.SourcelessFileLoader)
 
+    def test_script_compiled_large(self):
+        # bytecode files that are too large to be read in one go are
+        # unmarshalled from a memory mapping
+        with temp_dir() as script_dir:
+            source = ('data = %r\n'
+                      'print(len(data), data[-3:])\n' % ('x' * 400000 + 'end'))
+            script_name = _make_test_script(script_dir, 'script', source)
+            py_compile.compile(script_name, doraise=True)
+            os.remove(script_name)
+            pyc_file = support.make_legacy_pyc(script_name)
+            self.assertGreater(os.path.getsize(pyc_file), 1 << 18)
+            rc, out, err = assert_python_ok(pyc_file)
+            self.assertEqual(out.strip(), b'400003 end')
+
     def test_directory(self):
         with temp_dir() as script_dir:
             script_name = _make_test_script(script_dir, '__main__')
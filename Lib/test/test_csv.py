@@ -1,6 +1,7 @@
 # Copyright (C) 2001,2002 Python Software Foundation
 # csv package unit tests
 
+import array
 import io
 import sys
 import os
@@ -298,6 +299,72 @@ class Test_Csv(unittest.TestCase):
         self.assertRaises(StopIteration, next, r)
         self.assertEqual(r.line_num, 3)
 
+    def test_read_fast_path(self):
+        # Lines without escape characters are split in bulk; an escapechar
+        # that never occurs forces the character by character parser.
+        lines = ['a,b,c\r\n', 'abcdefghijklmnopqrstuvwxyz,"x,y",3\n',
+                 '"q""q",2,\n', '"multi\n', 'line",z,\n', '\n',
+                 ' 1, "2" ,3\n', '\xe9\xe9,\u20ac\u20ac\n', '"a"b,c\n',
+                 ',,\n', '"unterminated']
+        for kwargs in ({}, {'skipinitialspace': True}, {'doublequote': False},
+                       {'quoting': csv.QUOTE_NONE}, {'delimiter': ';'}):
+            self.assertEqual(list(csv.reader(lines, **kwargs)),
+                             list(csv.reader(lines, escapechar='\x01',
+                                             **kwargs)))
+        self._read_test(['1,"2",3.5\n'], [[1, '2', 3.5]],
+                        quoting=csv.QUOTE_NONNUMERIC)
+        self.assertRaises(csv.Error, self._read_test,
+                          ['a,"b"c\n'], [], strict=True)
+        self.assertRaises(csv.Error, self._read_test,
+                          ['abcdefghijklmnopqrstuvwxyz,\0\n'], [])
+
+    def test_read_columns(self):
+        data = 'a,1,2.5\n\nb,-2,1e3\n"c,d",3,nan\n'
+        r = csv.reader(io.StringIO(data))
+        self.assertEqual(r.read_columns(),
+                         [['a', 'b', 'c,d'], ['1', '-2', '3'],
+                          ['2.5', '1e3', 'nan']])
+        r = csv.reader(io.StringIO(data))
+        cols = r.read_columns([None, int, float])
+        self.assertEqual(cols[:2], [['a', 'b', 'c,d'], [1, -2, 3]])
+        self.assertEqual(cols[2][:2], [2.5, 1000.0])
+        self.assertNotEqual(cols[2][2], cols[2][2])
+        self.assertEqual(r.read_columns([int]), [[]])
+        self.assertEqual(csv.reader([]).read_columns(), [])
+        big = '123456789012345678901234567890'
+        cols = csv.reader([' 7 ,' + big]).read_columns([int, int])
+        self.assertEqual(cols, [[7], [int(big)]])
+        r = csv.reader(['1,"2"', '3,4.5'], quoting=csv.QUOTE_NONNUMERIC)
+        cols = r.read_columns([str, str])
+        self.assertEqual(cols, [[1.0, 3.0], ['2', 4.5]])
+
+    def test_read_columns_arrays(self):
+        r = csv.reader(['1,2.5,3,-4', '-128,0.5,65535,9223372036854775807'])
+        cols = r.read_columns(['b', 'd', 'H', 'q'])
+        self.assertEqual(cols[0], array.array('b', [1, -128]))
+        self.assertEqual(cols[1], array.array('d', [2.5, 0.5]))
+        self.assertEqual(cols[2], array.array('H', [3, 65535]))
+        self.assertEqual(cols[3], array.array('q', [-4, 2**63 - 1]))
+        cols = csv.reader(['1.25,18446744073709551615']).read_columns('fQ')
+        self.assertEqual(cols, [array.array('f', [1.25]),
+                                array.array('Q', [2**64 - 1])])
+        for typecode, value in [('b', '128'), ('B', '-1'), ('h', '32768'),
+                                ('H', '65536'), ('Q', '-1')]:
+            r = csv.reader([value])
+            self.assertRaises(OverflowError, r.read_columns, [typecode])
+
+    def test_read_columns_errors(self):
+        self.assertRaises(csv.Error, csv.reader(['1,2', '3']).read_columns)
+        self.assertRaises(csv.Error,
+                          csv.reader(['1,2', '3,4,5']).read_columns)
+        self.assertRaises(ValueError,
+                          csv.reader(['1,x']).read_columns, [int, int])
+        self.assertRaises(ValueError,
+                          csv.reader(['1,x']).read_columns, [int, float])
+        self.assertRaises(ValueError, csv.reader(['1']).read_columns, ['u'])
+        self.assertRaises(TypeError, csv.reader(['1']).read_columns, [list])
+        self.assertRaises(TypeError, csv.reader(['1']).read_columns, 1)
+
     def test_roundtrip_quoteed_newlines(self):
         with TemporaryFile("w+", newline='') as fileobj:
             writer = csv.writer(fileobj)
@@ -18,7 +18,7 @@ dis_c_instance_method = """\
               6 COMPARE_OP               2 (==)
               9 LOAD_FAST                0 (self)
              12 STORE_ATTR               0 (x)
-             15 LOAD_CONST               0 (None)
+             15 LOAD_CONST_RETURN_VALUE     0 (None)
              18 RETURN_VALUE
 """ % (_C.__init__.__code__.co_firstlineno + 1,)
 
@@ -28,7 +28,7 @@ dis_c_instance_method_bytes = """\
           6 COMPARE_OP          2 (==)
           9 LOAD_FAST           0 (0)
          12 STORE_ATTR          0 (0)
-         15 LOAD_CONST          0 (0)
+         15 LOAD_CONST_RETURN_VALUE     0 (0)
          18 RETURN_VALUE
 """
 
@@ -42,7 +42,7 @@ dis_f = """\
               6 CALL_FUNCTION            1 (1 positional, 0 keyword pair)
               9 POP_TOP
 
- %-4d        10 LOAD_CONST               1 (1)
+ %-4d        10 LOAD_CONST_RETURN_VALUE     1 (1)
              13 RETURN_VALUE
 """ % (_f.__code__.co_firstlineno + 1,
        _f.__code__.co_firstlineno + 2)
@@ -53,7 +53,7 @@ dis_f_co_code = """\
           3 LOAD_FAST           0 (0)
           6 CALL_FUNCTION       1 (1 positional, 0 keyword pair)
           9 POP_TOP
-         10 LOAD_CONST          1 (1)
+         10 LOAD_CONST_RETURN_VALUE     1 (1)
          13 RETURN_VALUE
 """
 
@@ -76,7 +76,7 @@ dis_bug708901 = """\
 
  %-4d        22 JUMP_ABSOLUTE           16
         >>   25 POP_BLOCK
-        >>   26 LOAD_CONST               0 (None)
+        >>   26 LOAD_CONST_RETURN_VALUE     0 (None)
              29 RETURN_VALUE
 """ % (bug708901.__code__.co_firstlineno + 1,
        bug708901.__code__.co_firstlineno + 2,
@@ -104,7 +104,7 @@ dis_bug1333982 = """\
              29 CALL_FUNCTION            1 (1 positional, 0 keyword pair)
              32 RAISE_VARARGS            1
 
- %-4d   >>   35 LOAD_CONST               0 (None)
+ %-4d   >>   35 LOAD_CONST_RETURN_VALUE     0 (None)
              38 RETURN_VALUE
 """ % (bug1333982.__code__.co_firstlineno + 1,
        __file__,
@@ -115,17 +115,17 @@ dis_bug1333982 = """\
 _BIG_LINENO_FORMAT = """\
 %3d           0 LOAD_GLOBAL              0 (spam)
               3 POP_TOP
-              4 LOAD_CONST               0 (None)
+              4 LOAD_CONST_RETURN_VALUE     0 (None)
               7 RETURN_VALUE
 """
 
 dis_module_expected_results = """\
 Disassembly of f:
-  4           0 LOAD_CONST               0 (None)
+  4           0 LOAD_CONST_RETURN_VALUE     0 (None)
               3 RETURN_VALUE
 
 Disassembly of g:
-  5           0 LOAD_CONST               0 (None)
+  5           0 LOAD_CONST_RETURN_VALUE     0 (None)
               3 RETURN_VALUE
 
 """
@@ -146,7 +146,7 @@ dis_simple_stmt_str = """\
               3 LOAD_CONST               0 (1)
               6 BINARY_ADD
               7 STORE_NAME               0 (x)
-             10 LOAD_CONST               1 (None)
+             10 LOAD_CONST_RETURN_VALUE     1 (None)
              13 RETURN_VALUE
 """
 
@@ -167,7 +167,7 @@ dis_compound_stmt_str = """\
              15 INPLACE_ADD
              16 STORE_NAME               0 (x)
              19 JUMP_ABSOLUTE            9
-        >>   22 LOAD_CONST               2 (None)
+        >>   22 LOAD_CONST_RETURN_VALUE     2 (None)
              25 RETURN_VALUE
 """
 
@@ -611,6 +611,80 @@ class GCTests(unittest.TestCase):
         self.assertNotIn(b"uncollectable objects at shutdown", stderr)
 
 
+def parallel_marking_supported():
+    try:
+        old = gc.get_mark_threads()
+        gc.set_mark_threads(2)
+    except NotImplementedError:
+        return False
+    gc.set_mark_threads(*old)
+    return True
+
+@unittest.skipUnless(parallel_marking_supported(),
+                     "parallel marking not supported")
+class GCParallelMarkTests(unittest.TestCase):
+    def setUp(self):
+        self.old = gc.get_mark_threads()
+        gc.collect()
+        # Mark with several threads even for small heaps.
+        gc.set_mark_threads(4, 0)
+
+    def tearDown(self):
+        gc.set_mark_threads(*self.old)
+
+    def test_settings(self):
+        self.assertEqual(gc.get_mark_threads(), (4, 0))
+        gc.set_mark_threads(3)
+        self.assertEqual(gc.get_mark_threads(), (3, 0))
+        self.assertRaises(ValueError, gc.set_mark_threads, 0)
+        self.assertRaises(ValueError, gc.set_mark_threads, 1000)
+        self.assertRaises(ValueError, gc.set_mark_threads, 2, -1)
+
+    def test_cycles(self):
+        # Many independent cycles, interleaved with reachable objects.
+        keep = []
+        for i in range(1000):
+            l = [i]
+            l.append(l)
+            keep.append([l] if i % 2 else [i])
+        del l
+        self.assertEqual(gc.collect(), 500)
+        self.assertEqual(gc.collect(), 0)
+        for i in range(1, 1000, 2):
+            self.assertIs(keep[i][0][1], keep[i][0])
+
+    def test_long_chain(self):
+        # A long chain hanging off a single root exercises the mark stacks;
+        # once the chain is closed into a cycle and the root goes away, all
+        # of it is garbage.
+        head = node = []
+        for i in range(10000):
+            node.append([])
+            node = node[0]
+        self.assertEqual(gc.collect(), 0)
+        node.append(head)
+        del head, node
+        self.assertEqual(gc.collect(), 10001)
+
+    def test_same_results_as_sequential(self):
+        class A:
+            pass
+        def make_garbage():
+            objs = []
+            for i in range(200):
+                a = A()
+                a.other = A()
+                a.other.back = a
+                a.data = {'x': [a]}
+                objs.append(a)
+            return objs
+        make_garbage()
+        parallel = gc.collect()
+        gc.set_mark_threads(1)
+        make_garbage()
+        self.assertEqual(gc.collect(), parallel)
+
+
 class GCCallbackTests(unittest.TestCase):
     def setUp(self):
         # Save gc state and disable it.
@@ -885,7 +959,8 @@ def test_main():
 
     try:
         gc.collect() # Delete 2nd generation garbage
-        run_unittest(GCTests, GCTogglingTests, GCCallbackTests)
+        run_unittest(GCTests, GCTogglingTests, GCCallbackTests,
+                     GCParallelMarkTests)
     finally:
         gc.set_debug(debug)
         # test gc.enable() even if GC is disabled by default
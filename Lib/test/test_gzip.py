@@ -79,6 +79,64 @@ class TestGzip(BaseTest):
                 self.assertEqual(f.tell(), nread)
         self.assertEqual(b''.join(blocks), data1 * 50)
 
+    def test_readinto(self):
+        self.test_write()
+        with gzip.GzipFile(self.filename, 'r') as f:
+            b = bytearray(100)
+            self.assertEqual(f.readinto(b), 100)
+            self.assertEqual(b, (data1*50)[:100])
+            self.assertEqual(f.tell(), 100)
+            self.assertEqual(f.read(10), (data1*50)[100:110])
+            b = bytearray(len(data1*50))
+            n = len(b) - 110
+            self.assertEqual(f.readinto(b), n)
+            self.assertEqual(b[:n], (data1*50)[110:])
+            self.assertEqual(f.readinto(b), 0)
+
+    def test_readinto_multimember(self):
+        # Members and small buffers that split them
+        data = data1 * 100 + data2 * 100
+        with gzip.GzipFile(self.filename, 'wb') as f:
+            f.write(data1 * 100)
+        with gzip.GzipFile(self.filename, 'ab') as f:
+            f.write(data2 * 100)
+        for size in (1, 37, 1000, len(data) + 1):
+            out = bytearray()
+            b = bytearray(size)
+            with gzip.GzipFile(self.filename, 'r') as f:
+                while True:
+                    n = f.readinto(b)
+                    if not n:
+                        break
+                    out += b[:n]
+            self.assertEqual(out, data)
+
+    def test_readinto_small_buffer(self):
+        # Compressed input that doesn't fit is held by the decompressor
+        # rather than copied back into the file buffer on every call.
+        with gzip.GzipFile(self.filename, 'wb') as f:
+            f.write(data1 * 500)
+        with gzip.GzipFile(self.filename, 'r') as f:
+            b = bytearray(10)
+            self.assertEqual(f.readinto(b), 10)
+            self.assertFalse(f.decompress.needs_input)
+            self.assertEqual(f.decompress.unconsumed_tail, b'')
+            self.assertEqual(b, data1[:10])
+            self.assertEqual(f.read(), (data1 * 500)[10:])
+
+    def test_readinto_stream_ends_with_read(self):
+        # The first read ends exactly with the deflate stream, so the
+        # trailer is still in the file when the decompressor reaches EOF.
+        data = os.urandom(5000)
+        compressed = gzip.compress(data)
+        deflate_len = len(compressed) - 18   # 10-byte header, 8-byte trailer
+        self.assertGreater(deflate_len, len(data))
+        with gzip.GzipFile(fileobj=io.BytesIO(compressed)) as f:
+            b = bytearray(deflate_len)
+            self.assertEqual(f.readinto(b), len(data))
+            self.assertEqual(b[:len(data)], data)
+            self.assertEqual(f.read(), b'')
+
     def test_io_on_closed_object(self):
         # Test that I/O operations on closed GzipFile objects raise a
         # ValueError, just like the corresponding functions on file objects.
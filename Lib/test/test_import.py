@@ -1,5 +1,6 @@
 # We import importlib *ASAP* in order to test #15386
 import importlib
+import importlib.machinery
 from importlib._bootstrap import _get_sourcefile
 import builtins
 import imp
@@ -1049,13 +1050,84 @@ class ImportTracebackTests(unittest.TestCase):
             importlib.SourceLoader.load_module = old_load_module
 
 
+class SnapshotTests(unittest.TestCase):
+
+    """Tests for importing through a startup snapshot (-X snapshot=PATH)."""
+
+    def setUp(self):
+        self.snapshot = TESTFN + '.snap'
+        self.module = 'snapshot_test_module'
+        self.addCleanup(unlink, self.snapshot)
+        self.addCleanup(unload, self.module)
+        self.addCleanup(remove_files, self.module)
+        sys.path.insert(0, os.curdir)
+        self.addCleanup(sys.path.remove, os.curdir)
+        with open(self.module + '.py', 'w') as f:
+            f.write('value = 42\n')
+        importlib.invalidate_caches()
+        __import__(self.module)
+
+    def run_with_snapshot(self, code):
+        return script_helper.assert_python_ok(
+            '-X', 'snapshot=' + self.snapshot, '-c', code,
+            PYTHONPATH=os.curdir)
+
+    def test_dump_and_load(self):
+        n = importlib.machinery.SnapshotFinder.dump(self.snapshot)
+        self.assertGreaterEqual(n, 1)
+        code = ('import sys, {0}; '
+                'print({0}.value, '
+                'type({0}.__loader__).__name__)').format(self.module)
+        rc, out, err = self.run_with_snapshot(code)
+        self.assertEqual(out.split(), [b'42', b'_SnapshotLoader'])
+        code = ('import os, sys; '
+                'print(type(sys.path_hooks[-1](os.getcwd())).__name__)')
+        rc, out, err = self.run_with_snapshot(code)
+        self.assertEqual(out.strip(), b'SnapshotFinder')
+
+    def test_stale_source(self):
+        importlib.machinery.SnapshotFinder.dump(self.snapshot,
+                                                [self.module])
+        remove_files(self.module)
+        with open(self.module + '.py', 'w') as f:
+            f.write('value = 43 # changed\n')
+        code = ('import {0}; '
+                'print({0}.value, '
+                'type({0}.__loader__).__name__)').format(self.module)
+        rc, out, err = self.run_with_snapshot(code)
+        self.assertEqual(out.split(), [b'43', b'SourceFileLoader'])
+
+    def test_earlier_path_entry_wins(self):
+        # The snapshot doesn't hide a module provided by an earlier entry
+        importlib.machinery.SnapshotFinder.dump(self.snapshot,
+                                                [self.module])
+        shadow = TESTFN + '_shadow'
+        os.mkdir(shadow)
+        self.addCleanup(rmtree, shadow)
+        with open(os.path.join(shadow, self.module + '.py'), 'w') as f:
+            f.write('value = 44\n')
+        code = ('import sys; sys.path.insert(0, {1!r}); import {0}; '
+                'print({0}.value, '
+                'type({0}.__loader__).__name__)').format(self.module, shadow)
+        rc, out, err = self.run_with_snapshot(code)
+        self.assertEqual(out.split(), [b'44', b'SourceFileLoader'])
+
+    def test_bad_snapshot(self):
+        with open(self.snapshot, 'wb') as f:
+            f.write(b'not a snapshot')
+        code = ('import os, sys; '
+                'print(type(sys.path_hooks[-1](os.getcwd())).__name__)')
+        rc, out, err = self.run_with_snapshot(code)
+        self.assertEqual(out.strip(), b'FileFinder')
+
+
 def test_main(verbose=None):
     run_unittest(ImportTests, PycacheTests, FilePermissionTests,
                  PycRewritingTests, PathsTests, RelativeImportTests,
                  OverridingImportBuiltinTests,
                  ImportlibBootstrapTests, GetSourcefileTests,
                  TestSymbolicallyLinkedPackage,
-                 ImportTracebackTests)
+                 ImportTracebackTests, SnapshotTests)
 
 
 if __name__ == '__main__':
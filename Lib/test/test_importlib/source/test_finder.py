@@ -9,6 +9,7 @@ import py_compile
 import stat
 import sys
 import tempfile
+from test import support
 from test.support import make_legacy_pyc
 import unittest
 import warnings
@@ -182,9 +183,76 @@ class FinderTests(abc.FinderTests):
             self.assertEqual((None, []), finder.find_loader('doesnotexist'))
 
 
+class ImportIndexTests(unittest.TestCase):
+
+    """Tests for the persistent directory index used by FileFinder."""
+
+    def setUp(self):
+        index = machinery.ImportIndex
+        saved = {name: getattr(index, name) for name in
+                 ('_enabled', '_changed', '_dirs', '_listdir_avoided',
+                  '_stat_avoided')}
+        def restore():
+            for name, value in saved.items():
+                setattr(index, name, value)
+        self.addCleanup(restore)
+        index._dirs = {}
+        index._enabled = False
+        self.index_file = tempfile.mktemp()
+        self.addCleanup(support.unlink, self.index_file)
+
+    def get_finder(self, root):
+        return machinery.FileFinder(root, (machinery.SourceFileLoader,
+                                           machinery.SOURCE_SUFFIXES))
+
+    def test_round_trip(self):
+        index = machinery.ImportIndex
+        with source_util.create_modules('mod', 'pkg.__init__') as mapping:
+            root = mapping['.root']
+            index.enable()
+            self.assertIsNotNone(self.get_finder(root).find_module('mod'))
+            self.assertIsNotNone(self.get_finder(root).find_module('pkg'))
+            self.assertTrue(index.changed())
+            index.dump(self.index_file)
+            self.assertFalse(index.changed())
+            index.clear()
+            index.load(self.index_file)
+            before = index.stats()
+            for name in ('mod', 'pkg'):
+                self.assertIsNotNone(self.get_finder(root).find_module(name))
+            self.assertIsNone(self.get_finder(root).find_module('missing'))
+            after = index.stats()
+            self.assertEqual(after['listdir'] - before['listdir'], 3)
+            self.assertEqual(after['stat'] - before['stat'], 2)
+            self.assertFalse(index.changed())
+
+    def test_stale_directory(self):
+        # A directory whose mtime changed is listed again.
+        index = machinery.ImportIndex
+        with source_util.create_modules('mod') as mapping:
+            root = mapping['.root']
+            index.enable()
+            self.assertIsNone(self.get_finder(root).find_module('new'))
+            index.dump(self.index_file)
+            index.load(self.index_file)
+            with open(os.path.join(root, 'new.py'), 'w') as file:
+                file.write('attr = 1')
+            mtime = os.stat(root).st_mtime
+            os.utime(root, (mtime + 10, mtime + 10))
+            self.assertIsNotNone(self.get_finder(root).find_module('new'))
+            self.assertEqual(index.stats()['listdir'], 0)
+            self.assertTrue(index.changed())
+
+    def test_bad_magic(self):
+        with open(self.index_file, 'wb') as file:
+            file.write(b'not an index')
+        with self.assertRaises(ImportError):
+            machinery.ImportIndex.load(self.index_file)
+
+
 def test_main():
     from test.support import run_unittest
-    run_unittest(FinderTests)
+    run_unittest(FinderTests, ImportIndexTests)
 
 
 if __name__ == '__main__':
@@ -30,16 +30,24 @@ class TestPyTest(PyTest):
                          'json.scanner')
         self.assertEqual(self.json.decoder.scanstring.__module__,
                          'json.decoder')
+        self.assertEqual(self.json.decoder.make_stream_scanner.__module__,
+                         'json.decoder')
         self.assertEqual(self.json.encoder.encode_basestring_ascii.__module__,
                          'json.encoder')
+        self.assertEqual(self.json.encoder.encode_basestring.__module__,
+                         'json.encoder')
 
 class TestCTest(CTest):
     def test_cjson(self):
         self.assertEqual(self.json.scanner.make_scanner.__module__, '_json')
         self.assertEqual(self.json.decoder.scanstring.__module__, '_json')
+        self.assertEqual(self.json.decoder.make_stream_scanner.__module__,
+                         '_json')
         self.assertEqual(self.json.encoder.c_make_encoder.__module__, '_json')
         self.assertEqual(self.json.encoder.encode_basestring_ascii.__module__,
                          '_json')
+        self.assertEqual(self.json.encoder.encode_basestring.__module__,
+                         '_json')
 
 
 here = os.path.dirname(__file__)
@@ -1,4 +1,4 @@
-from io import StringIO
+from io import BytesIO, StringIO
 from test.test_json import PyTest, CTest
 
 from test.support import bigmemtest, _1G
@@ -27,6 +27,57 @@ class TestDump:
             del a[-1]
         self.assertEqual(self.dumps(a, default=crasher),
                  '[null, null, null, null, null]')
+        a = [object()] * 10
+        self.assertEqual(self.json.dumps_utf8(a, default=crasher),
+                 b'[null, null, null, null, null]')
+
+    def test_dumps_utf8(self):
+        obj = {"a": [1, -2, 2**70, 2.5, 1e16, -0.0, None, True, False, (3,)],
+               "s": "\u00e9\u20ac\U0001f600\n\x7f\"\\", 4: {}, 5.5: [],
+               None: "", False: {"b": [{"c": "d"}]}}
+        options = [{}, {"ensure_ascii": False}, {"sort_keys": True},
+                   {"separators": (",", ":")}, {"indent": 2},
+                   {"check_circular": False}]
+        for kw in options:
+            if "sort_keys" in kw:
+                obj2 = {str(k): v for k, v in obj.items()}
+            else:
+                obj2 = obj
+            expected = self.dumps(obj2, **kw).encode('utf-8')
+            self.assertEqual(self.json.dumps_utf8(obj2, **kw), expected)
+            bio = BytesIO()
+            self.json.dump_utf8(obj2, bio, **kw)
+            self.assertEqual(bio.getvalue(), expected)
+        self.assertEqual(self.json.dumps_utf8("\ud800"), b'"\\ud800"')
+        self.assertRaises(UnicodeEncodeError, self.json.dumps_utf8, "\ud800",
+                          ensure_ascii=False)
+
+    def test_dumps_utf8_options(self):
+        dumps_utf8 = self.json.dumps_utf8
+        self.assertEqual(dumps_utf8({1j: 1, "a": 2}, skipkeys=True),
+                         b'{"a": 2}')
+        self.assertRaises(TypeError, dumps_utf8, {1j: 1})
+        self.assertRaises(TypeError, dumps_utf8, object())
+        self.assertEqual(dumps_utf8([1j], default=repr), b'["1j"]')
+        self.assertRaises(ValueError, dumps_utf8, float("nan"),
+                          allow_nan=False)
+        a = []
+        a.append(a)
+        self.assertRaises(ValueError, dumps_utf8, a)
+        d = {}
+        d["d"] = d
+        self.assertRaises(ValueError, dumps_utf8, d)
+
+    def test_dump_utf8_chunks(self):
+        # Large documents reach the file in several writes
+        writes = []
+        obj = [{"key": "value \u20ac", "n": i} for i in range(20000)]
+        class Writer:
+            def write(self, data):
+                writes.append(bytes(data))
+        self.json.dump_utf8(obj, Writer())
+        self.assertEqual(b"".join(writes), self.dumps(obj).encode('utf-8'))
+        self.assertGreater(len(writes), 1)
 
 
 class TestPyDump(TestDump, PyTest): pass
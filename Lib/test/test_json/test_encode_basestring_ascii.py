@@ -28,6 +28,16 @@ class TestEncodeBasestringAscii:
                 '{0!r} != {1!r} for {2}({3!r})'.format(
                     result, expect, fname, input_string))
 
+    def test_encode_basestring(self):
+        encode_basestring = self.json.encoder.encode_basestring
+        for input_string, expect in CASES:
+            result = encode_basestring(input_string)
+            self.assertEqual(self.loads(result), input_string)
+        self.assertEqual(encode_basestring('\u03b1\x7f"\\\x00\n'),
+                         '"\u03b1\x7f\\"\\\\\\u0000\\n"')
+        self.assertEqual(encode_basestring('\U0001d120\x1f'),
+                         '"\U0001d120\\u001f"')
+
     def test_ordered_dict(self):
         # See issue 6105
         items = [('one', 1), ('two', 2), ('three', 3), ('four', 4), ('five', 5)]
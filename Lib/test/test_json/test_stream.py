@@ -0,0 +1,112 @@
+import decimal
+from io import BytesIO, StringIO
+from test.test_json import PyTest, CTest
+
+
+class TestStream:
+    def decoder(self, **kw):
+        return self.json.JSONStreamDecoder(**kw)
+
+    def feed_all(self, data, step, **kw):
+        decoder = self.decoder(**kw)
+        values = []
+        for i in range(0, len(data), step):
+            values.extend(decoder.feed(data[i:i + step]))
+        values.extend(decoder.close())
+        return values
+
+    def test_ndjson(self):
+        docs = [{"id": i, "name": "né€\U0001f600 %d" % i,
+                 "tags": ["x", "y\"\\"], "v": i / 4, "ok": i % 2 == 0,
+                 "none": None} for i in range(20)]
+        data = "\n".join(self.dumps(d, ensure_ascii=False)
+                         for d in docs).encode('utf-8')
+        # every split point, including inside multi-byte characters
+        for step in (1, 2, 3, 5, 7, 64, len(data)):
+            self.assertEqual(self.feed_all(data, step), docs)
+
+    def test_values_returned_early(self):
+        decoder = self.decoder()
+        self.assertEqual(decoder.feed(b'{"a": [1, 2]} "x'), [{"a": [1, 2]}])
+        self.assertEqual(decoder.feed(b'y" 12'), ["xy"])
+        # a trailing number may still continue
+        self.assertEqual(decoder.feed(b'3'), [])
+        self.assertEqual(decoder.feed(b' '), [123])
+        self.assertEqual(decoder.feed(b'true'), [])
+        self.assertEqual(decoder.close(), [True])
+
+    def test_concatenated_values(self):
+        data = b'[1][2]{"a":null}"s"-1.5e3 NaN\t false\r\n[]'
+        values = self.feed_all(data, 1)
+        self.assertEqual(values[:5], [[1], [2], {"a": None}, "s", -1500.0])
+        self.assertNotEqual(values[5], values[5])
+        self.assertEqual(values[6:], [False, []])
+
+    def test_buffer_objects(self):
+        decoder = self.decoder()
+        self.assertEqual(decoder.feed(bytearray(b'[1]')), [[1]])
+        self.assertEqual(decoder.feed(memoryview(b'[2]')), [[2]])
+        self.assertRaises(TypeError, decoder.feed, '[3]')
+
+    def test_hooks(self):
+        values = self.feed_all(b'{"a": 1.5, "b": 2}', 1,
+                               parse_float=decimal.Decimal,
+                               object_pairs_hook=list)
+        self.assertEqual(values, [[("a", decimal.Decimal("1.5")), ("b", 2)]])
+
+    def test_key_reuse(self):
+        values = self.feed_all(b'{"key": 1, "k\\u00e9y": 2}\n' * 3, 4)
+        self.assertEqual(values, [{"key": 1, "kéy": 2}] * 3)
+        keys = [sorted(d) for d in values]
+        self.assertIs(keys[0][0], keys[2][0])
+
+    def test_depth(self):
+        data = (b'{"rows": [{"k": 1}, 2, [3, [4]]], "n": "v", '
+                b'"empty": {}, "e2": []} 7 [8]')
+        expected = [(("rows", 0), {"k": 1}), (("rows", 1), 2),
+                    (("rows", 2), [3, [4]]), (("n",), "v"),
+                    ((), 7), ((0,), 8)]
+        for step in (1, 3, len(data)):
+            self.assertEqual(self.feed_all(data, step, depth=2), expected)
+        self.assertEqual(self.feed_all(data, 1, depth=1),
+                         [(("rows",), [{"k": 1}, 2, [3, [4]]]), (("n",), "v"),
+                          (("empty",), {}), (("e2",), []),
+                          ((), 7), ((0,), 8)])
+        self.assertEqual(self.feed_all(b'[[[1]]]', 1, depth=3),
+                         [((0, 0, 0), 1)])
+        self.assertRaises(ValueError, self.decoder, depth=-1)
+
+    def test_errors(self):
+        for data in [b'[1,', b'{"a" 1}', b'[1 2]', b'nul', b'"abc', b'1.5.3',
+                     b'{"a": 1,}', b'[1,]', b'{"a":', b']', b'{"a": 1} }']:
+            for depth in (0, 1):
+                decoder = self.decoder(depth=depth)
+                with self.assertRaises(ValueError, msg=(data, depth)):
+                    decoder.feed(data)
+                    decoder.close()
+                # the decoder is reset after an error
+                self.assertEqual(decoder.feed(b'[1] '), [[1] if not depth
+                                                         else ((0,), 1)])
+                self.assertEqual(decoder.close(), [])
+
+    def test_unterminated(self):
+        decoder = self.decoder(depth=1)
+        self.assertEqual(decoder.feed(b'[1, 2, {"a": '), [((0,), 1), ((1,), 2)])
+        self.assertRaises(ValueError, decoder.close)
+        decoder = self.decoder()
+        self.assertEqual(decoder.feed('"€'.encode('utf-8')[:-1]), [])
+        self.assertRaises(ValueError, decoder.close)
+
+    def test_iterload(self):
+        data = '{"a": "€"}\n[1, 2]\n3\n'
+        self.assertEqual(list(self.json.iterload(StringIO(data),
+                                                 chunk_size=1)),
+                         [{"a": "€"}, [1, 2], 3])
+        self.assertEqual(list(self.json.iterload(BytesIO(data.encode('utf-8')),
+                                                 chunk_size=2, depth=1)),
+                         [(("a",), "€"), ((0,), 1), ((1,), 2), ((), 3)])
+        self.assertEqual(list(self.json.iterload(BytesIO(b''))), [])
+
+
+class TestPyStream(TestStream, PyTest): pass
+class TestCStream(TestStream, CTest): pass
@@ -21,6 +21,9 @@ SHIFT = sys.int_info.bits_per_digit
 BASE = 2 ** SHIFT
 MASK = BASE - 1
 KARATSUBA_CUTOFF = 70   # from longobject.c
+NTT_CUTOFF = 2000   # from longobject.c
+DECIMAL_FORMAT_CUTOFF = 2000   # from longobject.c
+DECIMAL_PARSE_CUTOFF = 8000    # from longobject.c
 
 # Max number of base BASE digits to use in test cases.  Doubling
 # this will more than double the runtime.
@@ -214,6 +217,30 @@ class LongTest(unittest.TestCase):
 
 
 
+    def test_ntt_mul(self):
+        # Products of NTT_CUTOFF digits or more use the number-theoretic
+        # transform; check them against the sum of the products of pieces
+        # small enough for Karatsuba.
+        def slow_mul(a, b):
+            n = SHIFT * (NTT_CUTOFF // 2)
+            mask = (1 << n) - 1
+            pa = [(a >> i) & mask for i in range(0, a.bit_length(), n)]
+            pb = [(b >> i) & mask for i in range(0, b.bit_length(), n)]
+            return sum((x * y) << (n * (i + j))
+                       for i, x in enumerate(pa) for j, y in enumerate(pb))
+        for adigits in (NTT_CUTOFF, NTT_CUTOFF + 1):
+            for bdigits in (adigits, adigits + 17, 4 * adigits):
+                # All-ones digits give the largest convolution terms.
+                for a, b in ((abs(self.getran(adigits)),
+                              abs(self.getran(bdigits))),
+                             ((1 << adigits * SHIFT) - 1,
+                              (1 << bdigits * SHIFT) - 1)):
+                    expected = slow_mul(a, b)
+                    self.assertEqual(a * b, expected)
+                    self.assertEqual(-a * b, -expected)
+                    self.assertEqual(b * a, expected)
+                self.assertEqual(a * a, slow_mul(a, a))
+
     def test_karatsuba(self):
         digits = list(range(1, 5)) + list(range(KARATSUBA_CUTOFF,
                                                 KARATSUBA_CUTOFF + 10))
@@ -338,6 +365,36 @@ class LongTest(unittest.TestCase):
                 x = self.getran(lenx)
                 self.check_format_1(x)
 
+    def test_format_large(self):
+        # Large values go through the divide-and-conquer conversions in
+        # both directions; check them against the quadratic code, used
+        # here on chunks of 1000 digits.
+        def slow_str(x):
+            chunks = []
+            while x >= 10**1000:
+                x, r = divmod(x, 10**1000)
+                chunks.append(str(r).zfill(1000))
+            chunks.append(str(x))
+            return ''.join(reversed(chunks))
+        for bits in (SHIFT * (DECIMAL_FORMAT_CUTOFF - 1),
+                     SHIFT * (DECIMAL_FORMAT_CUTOFF + 1), 100000, 250000):
+            for x in (abs(self.getran(bits // SHIFT)), 2**bits - 1, 2**bits,
+                      random.getrandbits(bits)):
+                s = slow_str(x)
+                self.assertEqual(str(x), s)
+                self.assertEqual(str(-x), '-' + s)
+                self.assertEqual(int(s), x)
+                self.assertEqual(int('-' + s), -x)
+        for n in (DECIMAL_PARSE_CUTOFF - 1, DECIMAL_PARSE_CUTOFF,
+                  DECIMAL_PARSE_CUTOFF + 1, 20000):
+            self.assertEqual(str(10**n), '1' + '0' * n)
+            self.assertEqual(str(10**n - 1), '9' * n)
+            self.assertEqual(int('1' + '0' * n), 10**n)
+            self.assertEqual(int('0' * n + '17'), 17)
+            self.assertEqual(int(' -' + '0' * n + '1 '), -1)
+            self.assertEqual(int(b'0' * n), 0)
+            self.assertRaises(ValueError, int, '1' * n + 'x')
+
     def test_long(self):
         # Check conversions from string
         LL = [
@@ -135,6 +135,36 @@ class CompressorDecompressorTestCase(unittest.TestCase):
         self.assertTrue(lzd.eof)
         self.assertEqual(lzd.unused_data, b"")
 
+    def test_decompressor_decompress_into(self):
+        lzd = LZMADecompressor()
+        self.assertTrue(lzd.needs_input)
+        extra = b"fooblibar"
+        data = COMPRESSED_XZ + extra
+        b = bytearray(10)
+        out = []
+        i = 0
+        while not lzd.eof:
+            if lzd.needs_input:
+                chunk = data[i:i+50]
+                i += 50
+            else:
+                chunk = b""
+            out.append(bytes(b[:lzd.decompress_into(chunk, b)]))
+        self.assertEqual(b"".join(out), INPUT)
+        self.assertEqual(lzd.check, lzma.CHECK_CRC64)
+        self.assertFalse(lzd.needs_input)
+        self.assertEqual(lzd.unused_data + data[i:], extra)
+        self.assertRaises(EOFError, lzd.decompress_into, b"", b)
+
+    def test_decompressor_decompress_after_decompress_into(self):
+        # Input held back by decompress_into() is used by decompress()
+        lzd = LZMADecompressor()
+        b = bytearray(10)
+        self.assertEqual(lzd.decompress_into(COMPRESSED_XZ, b), 10)
+        self.assertFalse(lzd.needs_input)
+        self.assertEqual(bytes(b) + lzd.decompress(b""), INPUT)
+        self.assertTrue(lzd.eof)
+
     def test_decompressor_unused_data(self):
         lzd = LZMADecompressor()
         extra = b"fooblibar"
@@ -711,6 +741,19 @@ class FileTestCase(unittest.TestCase):
         with LZMAFile(BytesIO(COMPRESSED_BOGUS)) as f:
             self.assertRaises(LZMAError, f.read)
 
+    def test_readinto(self):
+        with LZMAFile(BytesIO(COMPRESSED_XZ * 3 + COMPRESSED_BOGUS)) as f:
+            blocks = []
+            b = bytearray(100)
+            while True:
+                n = f.readinto(b)
+                if not n:
+                    break
+                blocks.append(bytes(b[:n]))
+                blocks.append(f.read(7))
+            self.assertEqual(b"".join(blocks), INPUT * 3)
+            self.assertEqual(f.tell(), len(INPUT) * 3)
+
     def test_read1(self):
         with LZMAFile(BytesIO(COMPRESSED_XZ)) as f:
             blocks = []
@@ -185,6 +185,32 @@ class BugsTestCase(unittest.TestCase):
         self.assertRaises(Exception, marshal.loads, 'f')
         self.assertRaises(Exception, marshal.loads, marshal.dumps(2**65)[:-1])
 
+    def test_loads_from_buffer(self):
+        # strings are decoded straight from the input buffer
+        sample = ['abc', 'd\xe9f' * 100, '\u20ac', b'xyz', ('abc', 1)]
+        data = marshal.dumps(sample)
+        self.assertEqual(marshal.loads(memoryview(data)), sample)
+        self.assertEqual(marshal.loads(bytearray(data)), sample)
+        padded = memoryview(b'pad' + data)[3:]
+        self.assertEqual(marshal.loads(padded), sample)
+        for i in range(1, len(data)):
+            self.assertRaises((EOFError, ValueError, TypeError),
+                              marshal.loads, memoryview(data)[:i])
+
+    @unittest.skipUnless(hasattr(marshal, '_map_file'), 'needs _map_file')
+    def test_map_file(self):
+        sample = ['abc', 'd\xe9f' * 100, b'xyz', compile('x = 1', '', 'exec')]
+        with open(support.TESTFN, 'wb') as f:
+            marshal.dump(sample, f)
+        try:
+            with open(support.TESTFN, 'rb') as f:
+                view = marshal._map_file(f.fileno())
+            self.assertEqual(marshal.loads(view), sample)
+            self.assertEqual(bytes(view), marshal.dumps(sample))
+            view.release()
+        finally:
+            support.unlink(support.TESTFN)
+
     def test_version_argument(self):
         # Python 2.4.0 crashes for any call to marshal.dumps(x, y)
         self.assertEqual(marshal.loads(marshal.dumps(5, 0)), 5)
@@ -289,6 +315,95 @@ class BugsTestCase(unittest.TestCase):
             self.assertRaises(ValueError, marshal.load,
                               BadReader(marshal.dumps(value)))
 
+class InstancingTestCase(unittest.TestCase, HelperMixin):
+    intobj = 123321
+    floatobj = 1.2345
+    strobj = "abcde"*3
+    dictobj = {"hello":floatobj, "goodbye":floatobj, floatobj:"hello"}
+
+    def helper3(self, rsample, recursive=False, simple=False):
+        #we have two instances
+        sample = (rsample, rsample)
+
+        n0 = CollectObjectIDs(set(), sample)
+
+        s3 = marshal.dumps(sample, 3)
+        n3 = CollectObjectIDs(set(), marshal.loads(s3))
+
+        #same number of instances generated
+        self.assertEqual(n3, n0)
+
+        if not recursive:
+            #can compare with version 2
+            s2 = marshal.dumps(sample, 2)
+            n2 = CollectObjectIDs(set(), marshal.loads(s2))
+            #old format generated more instances
+            self.assertGreater(n2, n0)
+
+            #if complex objects are in there, old format is larger
+            if not simple:
+                self.assertGreater(len(s2), len(s3))
+            else:
+                self.assertGreaterEqual(len(s2), len(s3))
+
+    def testInt(self):
+        self.helper(self.intobj)
+        self.helper3(self.intobj, simple=True)
+
+    def testFloat(self):
+        self.helper(self.floatobj)
+        self.helper3(self.floatobj)
+
+    def testStr(self):
+        self.helper(self.strobj)
+        self.helper3(self.strobj)
+
+    def testDict(self):
+        self.helper(self.dictobj)
+        self.helper3(self.dictobj)
+
+    def testModule(self):
+        with open(__file__, "rb") as f:
+            code = f.read()
+        if __file__.endswith(".py"):
+            code = compile(code, __file__, "exec")
+        self.helper(code)
+        self.helper3(code)
+        # version 3 code is smaller than version 2 code
+        self.assertLess(len(marshal.dumps(code, 3)),
+                        len(marshal.dumps(code, 2)))
+
+    def testInterned(self):
+        self.assertEqual(marshal.loads(b't\x03\x00\x00\x00abc'), 'abc')
+        s = sys.intern("marshal_interned_" + str(3))
+        data = marshal.dumps(s, 3)
+        if s is sys.intern("marshal_interned_" + str(3)):
+            self.assertEqual(data[0] & 0x7f, ord('t'))
+            self.assertIs(marshal.loads(data), s)
+        t = marshal.loads(marshal.dumps("marshal_not_" + str(3), 3))
+        self.assertEqual(t, "marshal_not_3")
+
+    def testBadReference(self):
+        # reference to an index that was never stored
+        self.assertRaises(ValueError, marshal.loads, b'r\x00\x00\x00\x00')
+        # reference to an object that is still being built
+        self.assertRaises(ValueError, marshal.loads,
+                          b'\xbe\x01\x00\x00\x00r\x00\x00\x00\x00')
+
+def CollectObjectIDs(ids, obj):
+    """Collect object ids seen in a structure"""
+    if id(obj) in ids:
+        return
+    ids.add(id(obj))
+    if isinstance(obj, (list, tuple, set, frozenset)):
+        for e in obj:
+            CollectObjectIDs(ids, e)
+    elif isinstance(obj, dict):
+        for k, v in obj.items():
+            CollectObjectIDs(ids, k)
+            CollectObjectIDs(ids, v)
+    return len(ids)
+
 LARGE_SIZE = 2**31
 pointer_size = 8 if sys.maxsize > 0xFFFFFFFF else 4
 
@@ -343,6 +458,7 @@ def test_main():
                          ExceptionTestCase,
                          BufferTestCase,
                          BugsTestCase,
+                         InstancingTestCase,
                          LargeValuesTestCase,
                         )
 
@@ -6,6 +6,7 @@ import re
 import itertools
 import socket
 import sys
+import array
 
 # Skip test if we can't import mmap.
 mmap = import_module('mmap')
@@ -690,6 +691,71 @@ class MmapTests(unittest.TestCase):
                               "wrong exception raised in context manager")
         self.assertTrue(m.closed, "context manager failed")
 
+@unittest.skipUnless(hasattr(mmap, 'shm_open'), 'requires mmap.shm_open()')
+class SharedMemoryTests(unittest.TestCase):
+
+    def setUp(self):
+        self.name = '/test_mmap_%d' % os.getpid()
+
+    def tearDown(self):
+        try:
+            mmap.shm_unlink(self.name)
+        except OSError:
+            pass
+
+    def test_create_open_unlink(self):
+        with mmap.shm_open(self.name, PAGESIZE, create=True) as m:
+            self.assertEqual(len(m), PAGESIZE)
+            m[:5] = b'hello'
+            with mmap.shm_open(self.name) as m2:
+                self.assertEqual(len(m2), PAGESIZE)
+                self.assertEqual(m2[:5], b'hello')
+                m2[5:6] = b'!'
+            self.assertEqual(m[:6], b'hello!')
+            with mmap.shm_open(self.name, access=mmap.ACCESS_READ) as m3:
+                self.assertEqual(m3[:6], b'hello!')
+                self.assertRaises(TypeError, m3.write, b'x')
+            self.assertRaises(FileExistsError, mmap.shm_open, self.name,
+                              PAGESIZE, create=True)
+        mmap.shm_unlink(self.name)
+        self.assertRaises(FileNotFoundError, mmap.shm_open, self.name)
+        self.assertRaises(FileNotFoundError, mmap.shm_unlink, self.name)
+        self.assertRaises(ValueError, mmap.shm_open, self.name, create=True)
+        self.assertRaises(ValueError, mmap.shm_open, self.name, PAGESIZE,
+                          create=True, access=mmap.ACCESS_READ)
+        self.assertRaises(FileNotFoundError, mmap.shm_open, self.name)
+
+    def test_views(self):
+        with mmap.shm_open(self.name, PAGESIZE, create=True) as m:
+            a = array.frombuffer('i', m)
+            b = memoryview(m)
+            self.assertEqual(len(a), PAGESIZE // a.itemsize)
+            a[0] = 0x01020304
+            self.assertEqual(b[:4].tobytes(), m[:4])
+            # The mapping can't go away under the views
+            self.assertRaises(BufferError, m.close)
+            self.assertRaises(BufferError, a.append, 0)
+            del a, b
+
+    @unittest.skipUnless(hasattr(os, 'fork'), 'requires os.fork()')
+    def test_cross_process(self):
+        m = mmap.shm_open(self.name, PAGESIZE, create=True)
+        a = array.frombuffer('l', m)
+        pid = os.fork()
+        if pid == 0:
+            try:
+                with mmap.shm_open(self.name) as child:
+                    c = array.frombuffer('l', child)
+                    c[:3] = array.array('l', [1, 2, 3])
+                    del c
+            finally:
+                os._exit(0)
+        os.waitpid(pid, 0)
+        self.assertEqual(a[:4].tolist(), [1, 2, 3, 0])
+        del a
+        m.close()
+
+
 class LargeMmapTests(unittest.TestCase):
 
     def setUp(self):
@@ -749,7 +815,7 @@ class LargeMmapTests(unittest.TestCase):
 
 
 def test_main():
-    run_unittest(MmapTests, LargeMmapTests)
+    run_unittest(MmapTests, SharedMemoryTests, LargeMmapTests)
 
 if __name__ == '__main__':
     test_main()
@@ -323,6 +323,35 @@ class TestTranforms(unittest.TestCase):
             self.assertNotIn('BINARY_', asm, e)
             self.assertNotIn('BUILD_', asm, e)
 
+    def test_superinstructions(self):
+        def f(a, b):
+            if a < b:
+                return a.real
+            return 0
+        asm = disassemble(f)
+        for elem in ('LOAD_FAST_LOAD_FAST', 'COMPARE_OP_POP_JUMP_IF_FALSE',
+                     'LOAD_FAST_LOAD_ATTR', 'LOAD_CONST_RETURN_VALUE'):
+            self.assertIn(elem, asm)
+        self.assertEqual(f(1, 2), 1)
+        self.assertEqual(f(2, 1), 0)
+        self.assertEqual(f(1.5, 2.5), 1.5)
+        self.assertRaises(TypeError, f, 1, 'x')
+        self.assertRaises(AttributeError, f, 'a', 'b')
+
+        def g(unbound):
+            if unbound:
+                del unbound
+            x = 1
+            return x + unbound
+        self.assertIn('LOAD_FAST_LOAD_FAST', disassemble(g))
+        self.assertRaisesRegex(UnboundLocalError, "'unbound'", g, True)
+
+        # Pairs split over two lines are left alone for line tracing
+        def h(a, b):
+            return (a +
+                    b)
+        self.assertNotIn('LOAD_FAST_LOAD_FAST', disassemble(h))
+
 class TestBuglets(unittest.TestCase):
 
     def test_bug_11510(self):
@@ -260,6 +260,170 @@ class TestDecorateSortUndecorate(unittest.TestCase):
         copy2.sort(key=lambda x: x[0], reverse=True)
         self.assertEqual(data, copy2)
 
+class TestOptimizedCompares(unittest.TestCase):
+    # list.sort() uses specialized compares when all the keys are ints,
+    # floats, 1-byte strs, or tuples starting with one of those.  The
+    # second items of tuples are always compared generically, so sorting
+    # (0, x) pairs gives a reference for the order of the x.
+
+    def check_against_generic(self, L):
+        random.seed(0)
+        random.shuffle(L)
+        for L in (L, [(x,) for x in L], [((x,),) for x in L]):
+            optimized = sorted(L)
+            reference = [y[1] for y in sorted([(0, x) for x in L])]
+            self.assertEqual(len(optimized), len(reference))
+            for opt, ref in zip(optimized, reference):
+                self.assertIs(opt, ref)
+
+    def test_safe_object_compare(self):
+        heterogeneous = [[1, 2.0, 'a', (1,)][i % 2] for i in range(100)]
+        self.check_against_generic(heterogeneous)
+
+    def test_unsafe_object_compare(self):
+        class WackyComparator(int):
+            def __lt__(self, other):
+                elem.__class__ = WackyList2
+                return int.__lt__(self, other)
+        class WackyList1(list):
+            pass
+        class WackyList2(list):
+            def __lt__(self, other):
+                raise ValueError
+        L = [WackyList1([WackyComparator(i), i]) for i in range(10)]
+        elem = L[-1]
+        with self.assertRaises(ValueError):
+            L.sort()
+        L = [WackyList1([WackyComparator(i), i]) for i in range(10)]
+        elem = L[-1]
+        with self.assertRaises(ValueError):
+            [(x,) for x in L].sort()
+
+        self.check_against_generic([set([i]) for i in range(100)])
+        self.check_against_generic([bytes([i % 256]) * i for i in range(300)])
+
+    def test_unsafe_latin_compare(self):
+        self.check_against_generic([str(i) for i in range(1000)] +
+                                   ['', '\xff', 'a\x00', 'a'])
+        # a str that isn't 1-byte turns the optimization off
+        self.check_against_generic(['b', 'a', '\u20ac', 'ab', 'ba'])
+
+    def test_unsafe_long_compare(self):
+        self.check_against_generic([(x * (-1) ** x) for x in range(100)])
+        # big ints fall back to the generic compare
+        self.check_against_generic([2**70 * (-1) ** x + x
+                                    for x in range(100)])
+        self.check_against_generic([-2**30, 2**30 - 1, 2**30, 0, -1, 1])
+
+    def test_unsafe_float_compare(self):
+        self.check_against_generic([float(x) * (-1) ** x
+                                    for x in range(100)] + [-0.0, 0.0])
+
+    def test_unsafe_tuple_compare(self):
+        # Tuples of different lengths and with equal first items
+        self.check_against_generic([(x % 7, x % 3) for x in range(100)] +
+                                   [(1,), (2, 1, 0)])
+        # Not all tuples
+        L = [(1, 2), (1,), 1]
+        self.assertRaises(TypeError, L.sort)
+
+    def test_large(self):
+        # Large enough for the parallel sort when more than one CPU is
+        # available.
+        n = (1 << 20) + 17
+        L = list(range(n))
+        random.shuffle(L)
+        self.assertEqual(sorted(L), list(range(n)))
+        self.assertEqual(sorted(L, reverse=True), list(range(n - 1, -1, -1)))
+        # stability, with the keys sorted apart from the values
+        pairs = [(x % 1000, i) for i, x in enumerate(L)]
+        result = sorted(pairs, key=lambda p: p[0])
+        self.assertEqual(result, sorted(pairs))
+
+class TestParallelSort(unittest.TestCase):
+    # Force the threaded sort for small lists, whatever the CPU count.
+
+    def setUp(self):
+        self.saved = sys._getparallelsort()
+        sys._setparallelsort(4, 2)
+
+    def tearDown(self):
+        sys._setparallelsort(*self.saved)
+
+    def check_against_generic(self, L, **kwds):
+        # (0, x) tuples are compared generically, so never in parallel.
+        if 'key' in kwds:
+            key = kwds['key']
+            kwds['key'] = lambda p: (0, key(p[1]))
+        reference = [p[1] for p in sorted([(0, x) for x in L], **kwds)]
+        if 'key' in kwds:
+            kwds['key'] = key
+        result = sorted(L, **kwds)
+        self.assertEqual(len(result), len(reference))
+        for res, ref in zip(result, reference):
+            self.assertIs(res, ref)
+
+    def test_settings(self):
+        sys._setparallelsort(0, 1000)
+        self.assertEqual(sys._getparallelsort(), (0, 1000))
+        self.assertRaises(ValueError, sys._setparallelsort, -1, 1000)
+        self.assertRaises(ValueError, sys._setparallelsort, 9, 1000)
+        self.assertRaises(ValueError, sys._setparallelsort, 2, 1)
+        self.assertEqual(sys._getparallelsort(), (0, 1000))
+
+    def test_sizes(self):
+        # Including lists shorter than the number of threads
+        random.seed(1)
+        for n in list(range(2, 40)) + [1000, 4099]:
+            L = [random.randrange(n // 2 + 1) for i in range(n)]
+            self.check_against_generic(L)
+            self.check_against_generic(L, reverse=True)
+
+    def test_types(self):
+        random.seed(2)
+        L = [random.random() for i in range(1000)]
+        self.check_against_generic(L)
+        self.check_against_generic([str(int(x * 100)) for x in L])
+        self.check_against_generic([int(x * 100) - 50 for x in L])
+
+    def test_stability(self):
+        random.seed(3)
+        pairs = [(random.randrange(50), i) for i in range(3000)]
+        self.assertEqual(sorted(pairs, key=lambda p: p[0]), sorted(pairs))
+        self.assertEqual(sorted(pairs, key=lambda p: p[0], reverse=True),
+                         sorted(pairs, key=lambda p: (-p[0], p[1])))
+        self.check_against_generic(pairs, key=lambda p: p[0])
+
+    def test_key_functions(self):
+        random.seed(4)
+        L = [random.randrange(10000) for i in range(2000)]
+        self.check_against_generic(L, key=str)
+        self.check_against_generic(L, key=float)
+        self.check_against_generic(L, key=lambda x: -x, reverse=True)
+
+    def test_exception_in_compare(self):
+        # A compare that can raise runs under the GIL, so the list is sorted
+        # serially even with parallel sorting forced.
+        class Bad(int):
+            def __lt__(self, other):
+                raise RuntimeError
+        L = list(range(1000))
+        random.shuffle(L)
+        L[500] = Bad(500)
+        saved = sorted(L, key=int)
+        self.assertRaises(RuntimeError, L.sort)
+        self.assertEqual(sorted(L, key=int), saved)
+
+    def test_mutation_during_sort(self):
+        # int keys are sorted in parallel; the key function mutates the list
+        L = list(range(1000))
+        random.shuffle(L)
+        def key(x):
+            L.append(x)
+            return x
+        self.assertRaises(ValueError, L.sort, key=key)
+        self.assertEqual(L, list(range(1000)))
+
 #==============================================================================
 
 def test_main(verbose=None):
@@ -267,6 +431,8 @@ def test_main(verbose=None):
         TestBase,
         TestDecorateSortUndecorate,
         TestBugs,
+        TestOptimizedCompares,
+        TestParallelSort,
     )
 
     support.run_unittest(*test_classes)
@@ -1,3 +1,4 @@
+from collections import abc
 import array
 import unittest
 import struct
@@ -593,8 +594,145 @@ class StructTest(unittest.TestCase):
         self.check_sizeof('0s', 1)
         self.check_sizeof('0c', 0)
 
+
+class UnpackIteratorTest(unittest.TestCase):
+    """
+    Tests for iterative unpacking (struct.Struct.iter_unpack).
+    """
+
+    def test_construct(self):
+        def _check_iterator(it):
+            self.assertIsInstance(it, abc.Iterator)
+            self.assertIsInstance(it, abc.Iterable)
+        s = struct.Struct('>ibcp')
+        it = s.iter_unpack(b"")
+        _check_iterator(it)
+        it = s.iter_unpack(b"1234567")
+        _check_iterator(it)
+        # Wrong bytes length
+        with self.assertRaises(struct.error):
+            s.iter_unpack(b"123456")
+        with self.assertRaises(struct.error):
+            s.iter_unpack(b"12345678")
+        # Zero-length struct
+        s = struct.Struct('>')
+        with self.assertRaises(struct.error):
+            s.iter_unpack(b"")
+        with self.assertRaises(struct.error):
+            s.iter_unpack(b"12")
+
+    def test_iterate(self):
+        s = struct.Struct('>IB')
+        b = bytes(range(1, 16))
+        it = s.iter_unpack(b)
+        self.assertEqual(next(it), (0x01020304, 5))
+        self.assertEqual(next(it), (0x06070809, 10))
+        self.assertEqual(next(it), (0x0b0c0d0e, 15))
+        self.assertRaises(StopIteration, next, it)
+        self.assertRaises(StopIteration, next, it)
+
+    def test_arbitrary_buffer(self):
+        s = struct.Struct('>IB')
+        b = bytes(range(1, 11))
+        it = s.iter_unpack(memoryview(b))
+        self.assertEqual(next(it), (0x01020304, 5))
+        self.assertEqual(next(it), (0x06070809, 10))
+        self.assertRaises(StopIteration, next, it)
+        self.assertRaises(StopIteration, next, it)
+
+    def test_length_hint(self):
+        s = struct.Struct('>IB')
+        b = bytes(range(1, 16))
+        it = s.iter_unpack(b)
+        self.assertEqual(it.__length_hint__(), 3)
+        next(it)
+        self.assertEqual(it.__length_hint__(), 2)
+        next(it)
+        self.assertEqual(it.__length_hint__(), 1)
+        next(it)
+        self.assertEqual(it.__length_hint__(), 0)
+        self.assertRaises(StopIteration, next, it)
+        self.assertEqual(it.__length_hint__(), 0)
+
+    def test_module_func(self):
+        # Sanity check for the global struct.iter_unpack()
+        it = struct.iter_unpack('>IB', bytes(range(1, 11)))
+        self.assertEqual(next(it), (0x01020304, 5))
+        self.assertEqual(next(it), (0x06070809, 10))
+        self.assertRaises(StopIteration, next, it)
+        self.assertRaises(StopIteration, next, it)
+
+
+class BulkPackTest(unittest.TestCase):
+    """
+    Tests for struct.Struct.unpack_many, pack_many and pack_many_into.
+    """
+
+    records = [(i, -i, i * 1.5, b'ab', i % 2 == 0, i * 1000003 - 7,
+                -70000 * i) for i in range(20)]
+
+    def test_roundtrip(self):
+        for byteorder in byteorders:
+            fmt = byteorder + 'Hhd2s?ql'
+            if byteorder in ('', '@') and not HAVE_LONG_LONG:
+                continue
+            s = struct.Struct(fmt)
+            data = s.pack_many(self.records)
+            self.assertEqual(data,
+                             b''.join(s.pack(*r) for r in self.records))
+            self.assertEqual(list(s.iter_unpack(data)), self.records)
+            columns = s.unpack_many(data)
+            self.assertEqual(list(zip(*columns)), self.records)
+            self.assertEqual([getattr(c, 'typecode', None) for c in columns],
+                             ['H', 'h', 'd', None, None, 'q', 'l'])
+
+    def test_unpack_many_codes(self):
+        values = (-1, 255, -2, 65535, -3, 2**32 - 1, -4, 2**64 - 1, 1.5, 2.25)
+        for byteorder in '<', '>':
+            fmt = byteorder + 'bBhHiIqQfd'
+            columns = struct.unpack_many(fmt, struct.pack(fmt, *values))
+            self.assertEqual(columns,
+                             [array.array(c, [v]) for c, v in
+                              zip('bBhHiIqQfd', values)])
+        self.assertEqual(struct.unpack_many('>i', b''), [array.array('i')])
+        self.assertRaises(struct.error, struct.unpack_many, '>i', b'123')
+        self.assertRaises(struct.error, struct.unpack_many, '>', b'')
+
+    def test_pack_many(self):
+        s = struct.Struct('<hb')
+        self.assertEqual(s.pack_many([]), b'')
+        self.assertEqual(s.pack_many(iter([(1, 2), [3, 4]])),
+                         b'\x01\x00\x02\x03\x00\x04')
+        self.assertEqual(struct.pack_many('<hb', ((i, i) for i in range(3))),
+                         s.pack(0, 0) + s.pack(1, 1) + s.pack(2, 2))
+        self.assertRaises(struct.error, s.pack_many, [(1, 2, 3)])
+        self.assertRaises(struct.error, s.pack_many, [(1, 1000)])
+        self.assertRaises(TypeError, s.pack_many, [1])
+        self.assertRaises(TypeError, s.pack_many, 1)
+
+    def test_pack_many_into(self):
+        s = struct.Struct('<h')
+        buf = bytearray(8)
+        self.assertEqual(s.pack_many_into(buf, 2, [(1,), (2,), (3,)]), 3)
+        self.assertEqual(buf, b'\x00\x00\x01\x00\x02\x00\x03\x00')
+        self.assertEqual(struct.pack_many_into('<h', buf, -2, [(4,)]), 1)
+        self.assertEqual(buf[-2:], b'\x04\x00')
+        self.assertRaises(struct.error, s.pack_many_into, buf, 4,
+                          [(1,)] * 3)
+        self.assertRaises(struct.error, s.pack_many_into, buf, 9, [])
+        self.assertRaises(BufferError, s.pack_many_into, b'1234', 0, [])
+
+        def resize():
+            yield (1,)
+            del buf[:]
+            yield (2,)
+        # The buffer is exported while packing, so it cannot shrink
+        self.assertRaises(BufferError, s.pack_many_into, buf, 0, resize())
+        self.assertEqual(len(buf), 8)
+
+
 def test_main():
-    support.run_unittest(StructTest)
+    support.run_unittest(StructTest, UnpackIteratorTest, BulkPackTest)
 
 if __name__ == '__main__':
     test_main()
@@ -169,6 +169,45 @@ class SysModuleTest(unittest.TestCase):
                 sys.setcheckinterval(n)
                 self.assertEqual(sys.getcheckinterval(), n)
 
+    def test_opcodeprofile(self):
+        import opcode
+        self.assertRaises(TypeError, sys.setopcodeprofile)
+        self.assertRaises(TypeError, sys.getopcodecounts, None)
+        def f(n):
+            total = 0
+            for i in range(n):
+                total += i
+            return total
+        code = f.__code__
+        self.assertIsNone(sys.getopcodecounts(code))
+        self.assertFalse(sys.getopcodeprofile())
+        sys.getdxp()
+        sys.setopcodeprofile(True)
+        try:
+            self.assertTrue(sys.getopcodeprofile())
+            f(10)
+        finally:
+            sys.setopcodeprofile(False)
+        self.assertFalse(sys.getopcodeprofile())
+        counts = sys.getopcodecounts(code)
+        self.assertEqual(len(counts), 256)
+        self.assertEqual(counts[opcode.opmap['INPLACE_ADD']], 10)
+        self.assertEqual(counts[opcode.opmap['FOR_ITER']], 11)
+        self.assertEqual(counts[opcode.opmap['RETURN_VALUE']], 1)
+        self.assertGreater(sys.getsizeof(code), code.__sizeof__() - 1)
+        pairs = sys.getdxp()
+        self.assertEqual(len(pairs), 257)
+        self.assertTrue(all(len(row) == 256 for row in pairs))
+        self.assertGreaterEqual(pairs[256][opcode.opmap['INPLACE_ADD']], 10)
+        self.assertGreaterEqual(
+            pairs[opcode.opmap['INPLACE_ADD']][opcode.opmap['STORE_FAST']],
+            10)
+        self.assertEqual(sum(pairs[256]), sum(map(sum, pairs[:256])))
+        # getdxp() starts over, f's own counts stay
+        self.assertEqual(sum(sys.getdxp()[256]), 0)
+        f(10)
+        self.assertEqual(sys.getopcodecounts(code), counts)
+
     @unittest.skipUnless(threading, 'Threading required for this test.')
     def test_switchinterval(self):
         self.assertRaises(TypeError, sys.setswitchinterval)
@@ -488,6 +527,32 @@ class SysModuleTest(unittest.TestCase):
 
         self.assertRaises(TypeError, sys.intern, S("abc"))
 
+    def test_intern_many(self):
+        # Enough strings to grow the intern table a few times, some of
+        # which die on the way and leave dummies behind.
+        prefix = "intern many " + str(numruns)
+        keep = []
+        for i in range(50000):
+            s = sys.intern(prefix + str(i))
+            if i % 2:
+                keep.append(s)
+        for i, s in zip(range(1, 50000, 2), keep):
+            self.assertIs(sys.intern(prefix + str(i)), s)
+        s = prefix + "0"
+        self.assertIs(sys.intern(s), s)
+
+    def test_intern_churn(self):
+        # Short-lived strings turn into dummies, which later strings reuse
+        # or a rebuild of the table drops; the survivors must stay put.
+        prefix = "intern churn " + str(numruns)
+        keep = [sys.intern(prefix + str(i)) for i in range(100)]
+        for i in range(200000):
+            sys.intern(prefix + "x" + str(i))
+        for i, s in enumerate(keep):
+            self.assertIs(sys.intern(prefix + str(i)), s)
+        s = prefix + "x0"
+        self.assertIs(sys.intern(s), s)
+
     def test_sys_flags(self):
         self.assertTrue(sys.flags)
         attrs = ("debug",
@@ -645,13 +710,13 @@ class SizeofTest(unittest.TestCase):
             return inner
         check(get_cell().__closure__[0], size('P'))
         # code
-        check(get_cell().__code__, size('5i9Pi3P'))
-        check(get_cell.__code__, size('5i9Pi3P'))
+        check(get_cell().__code__, size('5i9Pi4P'))
+        check(get_cell.__code__, size('5i9Pi4P'))
         def get_cell2(x):
             def inner():
                 return x
             return inner
-        check(get_cell2.__code__, size('5i9Pi3P') + 1)
+        check(get_cell2.__code__, size('5i9Pi4P') + 1)
         # complex
         check(complex(0,1), size('2d'))
         # method_descriptor (descriptor object)
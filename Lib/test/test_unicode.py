@@ -1379,6 +1379,30 @@ class UnicodeTest(string_tests.CommonTest,
             self.assertRaises(UnicodeDecodeError,
                               (b'\xF4'+cb+b'\xBF\xBF').decode, 'utf-8')
 
+    def test_codecs_long_runs(self):
+        # Long runs are converted a vector at a time; check that a character
+        # of each kind is handled at every position around the vector size.
+        encodings = ('utf-8', 'utf-16-le', 'utf-16-be', 'latin-1', 'ascii')
+        for fill in ('a', '\xe9', '\u20ac', '\U00010000'):
+            for char in ('\x7f', '\x80', '\xff', '\u0100', '\ud7ff',
+                         '\U0010ffff'):
+                for length in (15, 16, 17, 31, 32, 33, 64, 100):
+                    for pos in range(length):
+                        s = fill * pos + char + fill * (length - pos - 1)
+                        for encoding in encodings:
+                            try:
+                                b = s.encode(encoding)
+                            except UnicodeEncodeError:
+                                continue
+                            self.assertEqual(b.decode(encoding), s)
+                        b = s.encode('utf-8')
+                        with self.assertRaises(UnicodeDecodeError) as cm:
+                            (b + b'\xff' + b).decode('utf-8')
+                        self.assertEqual(cm.exception.start, len(b))
+                        with self.assertRaises(UnicodeEncodeError) as cm:
+                            (s + '\udc80' + s).encode('utf-8')
+                        self.assertEqual(cm.exception.start, len(s))
+
     def test_issue8271(self):
         # Issue #8271: during the decoding of an invalid UTF-8 byte sequence,
         # only the start byte and the continuation byte(s) are now considered
@@ -10,6 +10,10 @@ zlib = support.import_module('zlib')
 requires_Compress_copy = unittest.skipUnless(
         hasattr(zlib.compressobj(), "copy"),
         'requires Compress.copy()')
+requires_compress_parallel = unittest.skipUnless(
+        hasattr(zlib, 'compress_parallel'),
+        'requires zlib.compress_parallel()')
+
 requires_Decompress_copy = unittest.skipUnless(
         hasattr(zlib.decompressobj(), "copy"),
         'requires Decompress.copy()')
@@ -175,6 +179,64 @@ class CompressTestCase(BaseCompressTestCase, unittest.TestCase):
             "Error -5 while decompressing data: incomplete or truncated stream",
             zlib.decompress, x[:-1])
 
+    @requires_compress_parallel
+    def test_compress_parallel(self):
+        data = HAMLET_SCENE * 64
+        for wbits in (zlib.MAX_WBITS, 9, -zlib.MAX_WBITS, 16 + zlib.MAX_WBITS):
+            for level in (-1, 0, 1, 9):
+                x = zlib.compress_parallel(data, level, wbits, blocksize=1000)
+                self.assertEqual(zlib.decompress(x, wbits), data)
+        # Blocks find matches in the input preceding them
+        x = zlib.compress_parallel(data, blocksize=4096)
+        separate = sum(len(zlib.compress(data[i:i+4096]))
+                       for i in range(0, len(data), 4096))
+        self.assertLess(len(x), separate / 2)
+        # Same header and trailer as a one-shot compress
+        for level in (1, 6, 9):
+            x = zlib.compress_parallel(data, level, blocksize=2048)
+            y = zlib.compress(data, level)
+            self.assertEqual(x[:2], y[:2])
+            self.assertEqual(x[-4:], y[-4:])
+        gz = zlib.compress_parallel(data, wbits=31, blocksize=2048)
+        self.assertEqual(gz[:3], b'\x1f\x8b\x08')
+        self.assertEqual(gz[-4:], len(data).to_bytes(4, 'little'))
+        for ob in (b'', b'x', bytearray(data)):
+            x = zlib.compress_parallel(ob, blocksize=100)
+            self.assertEqual(zlib.decompress(x), ob)
+
+    @requires_compress_parallel
+    def test_compress_parallel_threads(self):
+        # The output doesn't depend on how blocks are scheduled
+        data = genblock(1, 16 * 1024) + HAMLET_SCENE * 32
+        expected = zlib.compress_parallel(data, blocksize=1024, threads=1)
+        for threads in (0, 2, 3, 16, 1000):
+            x = zlib.compress_parallel(data, blocksize=1024, threads=threads)
+            self.assertEqual(x, expected)
+        self.assertEqual(zlib.decompress(expected), data)
+
+    @requires_compress_parallel
+    def test_compress_parallel_zdict(self):
+        zdict = b'blessing father thy thee my lord Laertes'
+        data = HAMLET_SCENE * 4
+        x = zlib.compress_parallel(data, blocksize=512, zdict=zdict)
+        self.assertRaises(zlib.error, zlib.decompress, x)
+        dco = zlib.decompressobj(zdict=zdict)
+        self.assertEqual(dco.decompress(x) + dco.flush(), data)
+        x = zlib.compress_parallel(data, wbits=-15, zdict=zdict)
+        dco = zlib.decompressobj(-15, zdict=zdict)
+        self.assertEqual(dco.decompress(x) + dco.flush(), data)
+
+    @requires_compress_parallel
+    def test_compress_parallel_badargs(self):
+        cp = zlib.compress_parallel
+        self.assertRaises(zlib.error, cp, HAMLET_SCENE, 10)
+        self.assertRaises(ValueError, cp, HAMLET_SCENE, wbits=8)
+        self.assertRaises(ValueError, cp, HAMLET_SCENE, wbits=47)
+        self.assertRaises(ValueError, cp, HAMLET_SCENE, blocksize=0)
+        self.assertRaises(ValueError, cp, HAMLET_SCENE, threads=-1)
+        self.assertRaises(ValueError, cp, HAMLET_SCENE, wbits=31, zdict=b'a')
+        self.assertRaises(TypeError, cp, 'text')
+
     # Memory use of the following functions takes into account overallocation
 
     @bigmemtest(size=_1G + 1024 * 1024, memuse=3)
@@ -353,6 +415,85 @@ class CompressObjectTestCase(BaseCompressTestCase, unittest.TestCase):
     def test_decompressmaxlenflush(self):
         self.test_decompressmaxlen(flush=True)
 
+    def test_decompress_into(self):
+        # Decompress into a small buffer; input that doesn't fit is held by
+        # the decompressor until needs_input is set again.
+        data = HAMLET_SCENE * 128
+        combuf = zlib.compress(data)
+        dco = zlib.decompressobj()
+        self.assertTrue(dco.needs_input)
+        buf = bytearray(100)
+        bufs = []
+        pos = 0
+        while not dco.eof:
+            if dco.needs_input:
+                cb = combuf[pos:pos + 256]
+                pos += 256
+            else:
+                cb = b''
+            n = dco.decompress_into(cb, buf)
+            self.assertLessEqual(n, len(buf))
+            self.assertEqual(dco.unconsumed_tail, b'')
+            bufs.append(bytes(buf[:n]))
+        self.assertEqual(data, b''.join(bufs))
+        self.assertEqual(dco.unused_data, b'')
+        self.assertFalse(dco.needs_input)
+
+    def test_decompress_into_held_input(self):
+        # Input held back by decompress_into() is used first by the other
+        # methods.
+        data = HAMLET_SCENE * 128
+        combuf = zlib.compress(data)
+        buf = bytearray(100)
+        dco = zlib.decompressobj()
+        n = dco.decompress_into(combuf, buf)
+        self.assertEqual(n, len(buf))
+        self.assertFalse(dco.needs_input)
+        self.assertEqual(buf[:n] + dco.decompress(b''), data)
+        self.assertTrue(dco.eof)
+        dco = zlib.decompressobj()
+        n = dco.decompress_into(combuf[:1000], buf)
+        self.assertFalse(dco.needs_input)
+        expected = zlib.decompressobj().decompress(combuf[:1000])
+        self.assertEqual(buf[:n] + dco.flush(), expected)
+        dco = zlib.decompressobj()
+        n = dco.decompress_into(combuf + b'tail', buf)
+        if hasattr(dco, 'copy'):
+            dco2 = dco.copy()
+            self.assertFalse(dco2.needs_input)
+            self.assertEqual(dco2.decompress(b''), data[n:])
+        m = dco.decompress_into(b'', bytearray(len(data)))
+        self.assertEqual(n + m, len(data))
+        self.assertTrue(dco.eof)
+        self.assertEqual(dco.unused_data, b'tail')
+
+    def test_decompress_into_memoryview(self):
+        data = HAMLET_SCENE * 8
+        out = bytearray(len(data) + 10)
+        dco = zlib.decompressobj()
+        n = dco.decompress_into(zlib.compress(data), memoryview(out)[10:])
+        self.assertEqual(n, len(data))
+        self.assertEqual(out[:10], bytes(10))
+        self.assertEqual(out[10:], data)
+        self.assertTrue(dco.eof)
+
+    def test_decompress_into_zdict(self):
+        zdict = b'abcdefghijklmnopqrstuvwxyz'
+        co = zlib.compressobj(zdict=zdict)
+        comp = co.compress(zdict * 10) + co.flush()
+        dco = zlib.decompressobj(zdict=zdict)
+        buf = bytearray(300)
+        self.assertEqual(dco.decompress_into(comp, buf), 260)
+        self.assertEqual(buf[:260], zdict * 10)
+
+    def test_decompress_into_bad_args(self):
+        dco = zlib.decompressobj()
+        comp = zlib.compress(b'abc')
+        self.assertRaises(TypeError, dco.decompress_into, comp, b'readonly')
+        self.assertRaises(TypeError, dco.decompress_into, 'abc', bytearray(10))
+        self.assertRaises(zlib.error, dco.decompress_into, b'garbage',
+                          bytearray(10))
+
     def test_maxlenmisc(self):
         # Misc tests of max_length
         dco = zlib.decompressobj()
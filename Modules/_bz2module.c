@@ -52,7 +52,11 @@ typedef struct {
     PyObject_HEAD
     bz_stream bzs;
     char eof;           /* T_BOOL expects a char */
+    char needs_input;
     PyObject *unused_data;
+    /* Input held back by decompress_into() when its buffer filled up. */
+    char *input_buffer;
+    size_t input_len;
 #ifdef WITH_THREAD
     PyThread_type_lock lock;
 #endif
@@ -367,12 +371,44 @@ static PyTypeObject BZ2Compressor_Type = {
 
 /* BZ2Decompressor class. */
 
+/* If input is held back from an earlier decompress_into(), append the new
+   data to it and point *data and *len at the whole. */
+static int
+append_held_input(BZ2Decompressor *d, char **data, size_t *len)
+{
+    char *buf;
+
+    if (d->input_len == 0)
+        return 0;
+    if (*len > 0) {
+        if (*len > PY_SSIZE_T_MAX - d->input_len) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        buf = PyMem_Realloc(d->input_buffer, d->input_len + *len);
+        if (buf == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        memcpy(buf + d->input_len, *data, *len);
+        d->input_buffer = buf;
+        d->input_len += *len;
+    }
+    *data = d->input_buffer;
+    *len = d->input_len;
+    return 0;
+}
+
 static PyObject *
 decompress(BZ2Decompressor *d, char *data, size_t len)
 {
     size_t data_size = 0;
     PyObject *result;
 
+    if (append_held_input(d, &data, &len) < 0)
+        return NULL;
+    /* All of the input is used up below, held or not. */
+    d->input_len = 0;
     result = PyBytes_FromStringAndSize(NULL, SMALLCHUNK);
     if (result == NULL)
         return result;
@@ -406,7 +442,9 @@ decompress(BZ2Decompressor *d, char *data, size_t len)
             break;
         }
         if (d->bzs.avail_in == 0) {
-            if (len == 0)
+            /* A full output buffer may leave output inside the decoder,
+               e.g. after decompress_into(); keep going until it drains. */
+            if (len == 0 && d->bzs.avail_out != 0)
                 break;
             d->bzs.avail_in = MIN(len, UINT_MAX);
             len -= d->bzs.avail_in;
@@ -425,6 +463,7 @@ decompress(BZ2Decompressor *d, char *data, size_t len)
     if (data_size != PyBytes_GET_SIZE(result))
         if (_PyBytes_Resize(&result, data_size) < 0)
             goto error;
+    d->needs_input = !d->eof;
     return result;
 
 error:
@@ -432,6 +471,86 @@ error:
     return NULL;
 }
 
+/* Like decompress(), but write at most outlen bytes to out.  Input left
+   over when out fills up is held back for the next call. */
+static Py_ssize_t
+decompress_into(BZ2Decompressor *d, char *data, size_t len,
+                char *out, size_t outlen)
+{
+    size_t written = 0, out_left = outlen;
+    int held;
+    char *buf;
+
+    if (append_held_input(d, &data, &len) < 0)
+        return -1;
+    held = d->input_len > 0;
+    d->bzs.next_in = data;
+    d->bzs.avail_in = MIN(len, UINT_MAX);
+    len -= d->bzs.avail_in;
+    d->bzs.next_out = out;
+    d->bzs.avail_out = MIN(out_left, UINT_MAX);
+    out_left -= d->bzs.avail_out;
+    for (;;) {
+        char *this_out;
+        int bzerror;
+
+        Py_BEGIN_ALLOW_THREADS
+        this_out = d->bzs.next_out;
+        bzerror = BZ2_bzDecompress(&d->bzs);
+        written += d->bzs.next_out - this_out;
+        Py_END_ALLOW_THREADS
+        if (catch_bz2_error(bzerror))
+            return -1;
+        if (bzerror == BZ_STREAM_END) {
+            d->eof = 1;
+            break;
+        }
+        if (d->bzs.avail_in == 0 && len > 0) {
+            d->bzs.avail_in = MIN(len, UINT_MAX);
+            len -= d->bzs.avail_in;
+        }
+        else if (d->bzs.avail_out == 0 && out_left > 0) {
+            d->bzs.avail_out = MIN(out_left, UINT_MAX);
+            out_left -= d->bzs.avail_out;
+        }
+        else
+            break;
+    }
+
+    len += d->bzs.avail_in;
+    if (d->eof) {
+        d->needs_input = 0;
+        if (len > 0) { /* Save leftover input to unused_data */
+            Py_CLEAR(d->unused_data);
+            d->unused_data = PyBytes_FromStringAndSize(d->bzs.next_in, len);
+            if (d->unused_data == NULL)
+                return -1;
+        }
+        d->input_len = 0;
+    }
+    else if (len > 0) {
+        if (held)
+            memmove(d->input_buffer, d->bzs.next_in, len);
+        else {
+            buf = PyMem_Realloc(d->input_buffer, len);
+            if (buf == NULL) {
+                PyErr_NoMemory();
+                return -1;
+            }
+            memcpy(buf, d->bzs.next_in, len);
+            d->input_buffer = buf;
+        }
+        d->input_len = len;
+        d->needs_input = 0;
+    }
+    else {
+        d->input_len = 0;
+        /* A full buffer may have left output inside the decompressor. */
+        d->needs_input = written < outlen;
+    }
+    return written;
+}
+
 PyDoc_STRVAR(BZ2Decompressor_decompress__doc__,
 "decompress(data) -> bytes\n"
 "\n"
@@ -461,6 +580,40 @@ BZ2Decompressor_decompress(BZ2Decompressor *self, PyObject *args)
     return result;
 }
 
+PyDoc_STRVAR(BZ2Decompressor_decompress_into__doc__,
+"decompress_into(data, buffer) -> int\n"
+"\n"
+"Like decompress(), but write the decompressed data into buffer, a\n"
+"writable object such as a bytearray or memoryview, and return the\n"
+"number of bytes written.\n"
+"\n"
+"If buffer fills up, the rest of data is kept and used by the next\n"
+"call, and needs_input is set to False.  Call again, with b'' if there\n"
+"is no new input, until needs_input is True.\n");
+
+static PyObject *
+BZ2Decompressor_decompress_into(BZ2Decompressor *self, PyObject *args)
+{
+    Py_buffer buffer, out;
+    Py_ssize_t written = -1;
+
+    if (!PyArg_ParseTuple(args, "y*w*:decompress_into", &buffer, &out))
+        return NULL;
+
+    ACQUIRE_LOCK(self);
+    if (self->eof)
+        PyErr_SetString(PyExc_EOFError, "End of stream already reached");
+    else
+        written = decompress_into(self, buffer.buf, buffer.len,
+                                  out.buf, out.len);
+    RELEASE_LOCK(self);
+    PyBuffer_Release(&buffer);
+    PyBuffer_Release(&out);
+    if (written < 0)
+        return NULL;
+    return PyLong_FromSsize_t(written);
+}
+
 static PyObject *
 BZ2Decompressor_getstate(BZ2Decompressor *self, PyObject *noargs)
 {
@@ -485,6 +638,7 @@ BZ2Decompressor_init(BZ2Decompressor *self, PyObject *args, PyObject *kwargs)
     }
 #endif
 
+    self->needs_input = 1;
     self->unused_data = PyBytes_FromStringAndSize("", 0);
     if (self->unused_data == NULL)
         goto error;
@@ -509,6 +663,7 @@ BZ2Decompressor_dealloc(BZ2Decompressor *self)
 {
     BZ2_bzDecompressEnd(&self->bzs);
     Py_CLEAR(self->unused_data);
+    PyMem_Free(self->input_buffer);
 #ifdef WITH_THREAD
     if (self->lock != NULL)
         PyThread_free_lock(self->lock);
@@ -519,6 +674,8 @@ BZ2Decompressor_dealloc(BZ2Decompressor *self)
 static PyMethodDef BZ2Decompressor_methods[] = {
     {"decompress", (PyCFunction)BZ2Decompressor_decompress, METH_VARARGS,
      BZ2Decompressor_decompress__doc__},
+    {"decompress_into", (PyCFunction)BZ2Decompressor_decompress_into,
+     METH_VARARGS, BZ2Decompressor_decompress_into__doc__},
     {"__getstate__", (PyCFunction)BZ2Decompressor_getstate, METH_NOARGS},
     {NULL}
 };
@@ -529,11 +686,16 @@ PyDoc_STRVAR(BZ2Decompressor_eof__doc__,
 PyDoc_STRVAR(BZ2Decompressor_unused_data__doc__,
 "Data found after the end of the compressed stream.");
 
+PyDoc_STRVAR(BZ2Decompressor_needs_input__doc__,
+"False if decompress_into() may have more output without new input.");
+
 static PyMemberDef BZ2Decompressor_members[] = {
     {"eof", T_BOOL, offsetof(BZ2Decompressor, eof),
      READONLY, BZ2Decompressor_eof__doc__},
     {"unused_data", T_OBJECT_EX, offsetof(BZ2Decompressor, unused_data),
      READONLY, BZ2Decompressor_unused_data__doc__},
+    {"needs_input", T_BOOL, offsetof(BZ2Decompressor, needs_input),
+     READONLY, BZ2Decompressor_needs_input__doc__},
     {NULL}
 };
 
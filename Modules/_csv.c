@@ -13,6 +13,15 @@ module instead.
 #include "Python.h"
 #include "structmember.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define HAVE_CSV_SSE2
+# include <emmintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
+
 
 typedef struct {
     PyObject *error_obj;   /* CSV exception */
@@ -87,6 +96,17 @@ typedef struct {
 
 static PyTypeObject Dialect_Type;
 
+/* Where read_columns() collects the fields of one column */
+typedef struct {
+    int code;                   /* 0 for str, 'n' for int, 'f' for float,
+                                   else the typecode of an array */
+    PyObject *values;           /* list of objects, NULL for an array */
+    char *data;                 /* items of an array */
+    Py_ssize_t len;             /* number of items in data */
+    Py_ssize_t allocated;
+    int itemsize;
+} ColumnBuf;
+
 typedef struct {
     PyObject_HEAD
 
@@ -101,6 +121,11 @@ typedef struct {
     Py_ssize_t field_len;       /* length of current field */
     int numeric_field;          /* treat field as numeric */
     unsigned long line_num;     /* Source-file line number */
+    int fast_path;              /* dialect allows parse_line_fast() */
+
+    ColumnBuf *columns;         /* set while read_columns() runs */
+    Py_ssize_t ncolumns;
+    Py_ssize_t column;          /* column of the next field of the record */
 } ReaderObj;
 
 static PyTypeObject Reader_Type;
@@ -533,16 +558,19 @@ _call_dialect(PyObject *dialect_inst, PyObject *kwargs)
 /*
  * READER
  */
+static int column_add(ReaderObj *self, int kind, const void *data,
+                      Py_ssize_t len);
+
 static int
-parse_save_field(ReaderObj *self)
+parse_save_data(ReaderObj *self, int kind, const void *data, Py_ssize_t len)
 {
     PyObject *field;
 
-    field = PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND,
-                                      (void *) self->field, self->field_len);
+    if (self->columns != NULL)
+        return column_add(self, kind, data, len);
+    field = PyUnicode_FromKindAndData(kind, data, len);
     if (field == NULL)
         return -1;
-    self->field_len = 0;
     if (self->numeric_field) {
         PyObject *tmp;
 
@@ -558,6 +586,14 @@ parse_save_field(ReaderObj *self)
     return 0;
 }
 
+static int
+parse_save_field(ReaderObj *self)
+{
+    Py_ssize_t len = self->field_len;
+    self->field_len = 0;
+    return parse_save_data(self, PyUnicode_4BYTE_KIND, self->field, len);
+}
+
 static int
 parse_grow_buff(ReaderObj *self)
 {
@@ -780,6 +816,138 @@ parse_reset(ReaderObj *self)
     return 0;
 }
 
+/* Index of the first of the bytes a, b, c, d in s[i:end], or end. */
+static Py_ssize_t
+find_special(const Py_UCS1 *s, Py_ssize_t i, Py_ssize_t end,
+             Py_UCS1 a, Py_UCS1 b, Py_UCS1 c, Py_UCS1 d)
+{
+#ifdef HAVE_CSV_SSE2
+    if (end - i >= 16) {
+        const __m128i va = _mm_set1_epi8((char)a);
+        const __m128i vb = _mm_set1_epi8((char)b);
+        const __m128i vc = _mm_set1_epi8((char)c);
+        const __m128i vd = _mm_set1_epi8((char)d);
+
+        for (; i + 16 <= end; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+            __m128i m = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, vc), _mm_cmpeq_epi8(v, vd)));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(m);
+            if (mask != 0) {
+#if defined(__GNUC__)
+                return i + __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+                unsigned long bit;
+                _BitScanForward(&bit, mask);
+                return i + bit;
+#else
+                while (!(mask & 1)) {
+                    mask >>= 1;
+                    i++;
+                }
+                return i;
+#endif
+            }
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        Py_UCS1 ch = s[i];
+        if (ch == a || ch == b || ch == c || ch == d)
+            break;
+    }
+    return i;
+}
+
+/* Can parse_line_fast() be used with this dialect?  It does not know
+   about escape characters, and the special characters must fit in a
+   byte and must not be confused with line endings or skipped spaces. */
+static int
+dialect_allows_fast_path(DialectObj *dialect)
+{
+    Py_UCS4 quotechar = dialect->quoting == QUOTE_NONE ? 0 :
+                        dialect->quotechar;
+
+    if (dialect->escapechar != 0)
+        return 0;
+    if (dialect->delimiter > 0xff || quotechar > 0xff)
+        return 0;
+    if (dialect->delimiter == '\r' || dialect->delimiter == '\n' ||
+        dialect->delimiter == '\0' || quotechar == '\r' ||
+        quotechar == '\n')
+        return 0;
+    if (dialect->skipinitialspace &&
+        (dialect->delimiter == ' ' || quotechar == ' '))
+        return 0;
+    return 1;
+}
+
+/* Split a one-byte line starting a new record by scanning for the
+   delimiter instead of feeding the state machine one character at a
+   time.  Unquoted fields and quoted fields that end on the same line
+   without doubled quotes are saved straight from the line.  On anything
+   else (doubled quotes, a field spanning lines, a NUL byte, a field over
+   the limit) it stops at the start of that field in state START_FIELD,
+   so the state machine carries on and reports errors itself.
+
+   Returns the number of characters consumed, or -1 on error. */
+static Py_ssize_t
+parse_line_fast(ReaderObj *self, const Py_UCS1 *line, Py_ssize_t len)
+{
+    DialectObj *dialect = self->dialect;
+    Py_UCS1 delimiter = (Py_UCS1)dialect->delimiter;
+    int quotechar = dialect->quoting == QUOTE_NONE ? -1 :
+                    (int)dialect->quotechar;
+    long field_limit = _csvstate_global->field_limit;
+    Py_ssize_t pos = 0, start, end;
+
+    if (len == 0 || line[0] == '\r' || line[0] == '\n')
+        return 0;
+    self->state = START_FIELD;
+    for (;;) {
+        start = pos;
+        if (dialect->skipinitialspace)
+            while (pos < len && line[pos] == ' ')
+                pos++;
+        if (pos < len && line[pos] == quotechar) {
+            Py_UCS1 q = (Py_UCS1)quotechar;
+
+            end = find_special(line, pos + 1, len, q, q, q, '\0');
+            if (end == len || line[end] != q || end - pos - 1 > field_limit)
+                return start;
+            if (end + 1 < len && line[end + 1] != delimiter &&
+                line[end + 1] != '\r' && line[end + 1] != '\n')
+                return start;
+            if (parse_save_data(self, PyUnicode_1BYTE_KIND, line + pos + 1,
+                                end - pos - 1) < 0)
+                return -1;
+            pos = end + 1;
+        }
+        else {
+            end = find_special(line, pos, len, delimiter, '\r', '\n', '\0');
+            if ((end < len && line[end] == '\0') || end - pos > field_limit)
+                return start;
+            if (end > pos && dialect->quoting == QUOTE_NONNUMERIC)
+                self->numeric_field = 1;
+            if (parse_save_data(self, PyUnicode_1BYTE_KIND, line + pos,
+                                end - pos) < 0)
+                return -1;
+            pos = end;
+        }
+        if (pos == len) {
+            self->state = START_RECORD;
+            return pos;
+        }
+        if (line[pos] != delimiter) {
+            /* the line ending is left to the state machine */
+            self->state = EAT_CRNL;
+            return pos;
+        }
+        pos++;
+    }
+}
+
 static PyObject *
 Reader_iternext(ReaderObj *self)
 {
@@ -825,6 +993,15 @@ Reader_iternext(ReaderObj *self)
         data = PyUnicode_DATA(lineobj);
         pos = 0;
         linelen = PyUnicode_GET_LENGTH(lineobj);
+        if (self->fast_path && self->state == START_RECORD &&
+            kind == PyUnicode_1BYTE_KIND) {
+            pos = parse_line_fast(self, (Py_UCS1 *)data, linelen);
+            if (pos < 0) {
+                Py_DECREF(lineobj);
+                goto err;
+            }
+            linelen -= pos;
+        }
         while (linelen--) {
             c = PyUnicode_READ(kind, data, pos);
             if (c == '\0') {
@@ -850,6 +1027,503 @@ err:
     return fields;
 }
 
+/*
+ * COLUMNS
+ *
+ * read_columns() points the reader at one ColumnBuf per column and lets
+ * parse_save_data() hand each field to column_add() instead of building
+ * row lists.  Typed columns convert the field text in place, and array
+ * columns keep raw C values until the end.
+ */
+
+#define COLUMN_STR   0
+#define COLUMN_INT   1
+#define COLUMN_FLOAT 2
+
+/* Decimal digits that always fit in a long */
+#if SIZEOF_LONG >= 8
+#define SMALL_INT_DIGITS 18
+#else
+#define SMALL_INT_DIGITS 9
+#endif
+
+static int
+column_init(ColumnBuf *col, PyObject *type)
+{
+    memset(col, 0, sizeof(ColumnBuf));
+    if (type == Py_None || type == (PyObject *)&PyUnicode_Type)
+        col->code = COLUMN_STR;
+    else if (type == (PyObject *)&PyLong_Type)
+        col->code = COLUMN_INT;
+    else if (type == (PyObject *)&PyFloat_Type)
+        col->code = COLUMN_FLOAT;
+    else if (PyUnicode_Check(type) && PyUnicode_READY(type) == 0 &&
+             PyUnicode_GET_LENGTH(type) == 1) {
+        col->code = PyUnicode_READ_CHAR(type, 0);
+        switch (col->code) {
+        case 'b': case 'B': col->itemsize = sizeof(char); break;
+        case 'h': case 'H': col->itemsize = sizeof(short); break;
+        case 'i': case 'I': col->itemsize = sizeof(int); break;
+        case 'l': case 'L': col->itemsize = sizeof(long); break;
+#ifdef HAVE_LONG_LONG
+        case 'q': case 'Q': col->itemsize = sizeof(PY_LONG_LONG); break;
+#endif
+        case 'f': col->itemsize = sizeof(float); break;
+        case 'd': col->itemsize = sizeof(double); break;
+        default:
+            PyErr_Format(PyExc_ValueError,
+                         "unsupported array typecode %R", type);
+            return -1;
+        }
+        return 0;
+    }
+    else {
+        PyErr_Format(PyExc_TypeError,
+                     "column type must be str, int, float or an array "
+                     "typecode, not %.200s", Py_TYPE(type)->tp_name);
+        return -1;
+    }
+    col->values = PyList_New(0);
+    if (col->values == NULL)
+        return -1;
+    return 0;
+}
+
+static void
+columns_free(ColumnBuf *columns, Py_ssize_t ncolumns)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < ncolumns; i++) {
+        Py_XDECREF(columns[i].values);
+        if (columns[i].data != NULL)
+            PyMem_Free(columns[i].data);
+    }
+    PyMem_Free(columns);
+}
+
+/* Room for one more item in an array column */
+static char *
+column_reserve(ColumnBuf *col)
+{
+    if (col->len == col->allocated) {
+        Py_ssize_t allocated = col->allocated ? col->allocated * 2 : 64;
+        char *data;
+
+        if (allocated > PY_SSIZE_T_MAX / col->itemsize) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        data = PyMem_Realloc(col->data, allocated * col->itemsize);
+        if (data == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        col->data = data;
+        col->allocated = allocated;
+    }
+    return col->data + col->itemsize * col->len++;
+}
+
+/* Parse a sign and at most SMALL_INT_DIGITS ASCII digits without creating
+   an object.  Returns 0 if the field needs the general int() rules. */
+static int
+parse_small_int(int kind, const void *data, Py_ssize_t len, long *result)
+{
+    Py_ssize_t i = 0;
+    unsigned long value = 0;
+    int negative = 0;
+    Py_UCS4 c;
+
+    if (len > 0) {
+        c = PyUnicode_READ(kind, data, 0);
+        if (c == '-' || c == '+') {
+            negative = c == '-';
+            i = 1;
+        }
+    }
+    if (len - i == 0 || len - i > SMALL_INT_DIGITS)
+        return 0;
+    for (; i < len; i++) {
+        c = PyUnicode_READ(kind, data, i);
+        if (c < '0' || c > '9')
+            return 0;
+        value = value * 10 + (c - '0');
+    }
+    *result = negative ? -(long)value : (long)value;
+    return 1;
+}
+
+static PyObject *
+parse_int_object(int kind, const void *data, Py_ssize_t len)
+{
+    PyObject *field, *result;
+    long value;
+
+    if (parse_small_int(kind, data, len, &value))
+        return PyLong_FromLong(value);
+    field = PyUnicode_FromKindAndData(kind, data, len);
+    if (field == NULL)
+        return NULL;
+    result = PyLong_FromUnicodeObject(field, 10);
+    Py_DECREF(field);
+    return result;
+}
+
+/* Convert a field with the same rules as float(); short ASCII fields
+   skip the temporary str object. */
+static int
+parse_double(int kind, const void *data, Py_ssize_t len, double *result)
+{
+    PyObject *field, *number;
+
+    if (kind == PyUnicode_1BYTE_KIND && len > 0 && len < 64) {
+        char buf[64], *end;
+        double value;
+
+        memcpy(buf, data, len);
+        buf[len] = '\0';
+        value = PyOS_string_to_double(buf, &end, NULL);
+        if (end == buf + len && !(value == -1.0 && PyErr_Occurred())) {
+            *result = value;
+            return 0;
+        }
+        PyErr_Clear();
+    }
+    field = PyUnicode_FromKindAndData(kind, data, len);
+    if (field == NULL)
+        return -1;
+    number = PyFloat_FromString(field);
+    Py_DECREF(field);
+    if (number == NULL)
+        return -1;
+    *result = PyFloat_AS_DOUBLE(number);
+    Py_DECREF(number);
+    return 0;
+}
+
+static int
+column_add_integer(ColumnBuf *col, int kind, const void *data,
+                   Py_ssize_t len)
+{
+    PyObject *number = NULL;
+    char *item;
+    long value = 0;
+    unsigned long uvalue = 0;
+    int small;
+
+    small = parse_small_int(kind, data, len, &value);
+    if (!small) {
+        number = parse_int_object(kind, data, len);
+        if (number == NULL)
+            return -1;
+    }
+    switch (col->code) {
+    case 'b': case 'h': case 'i': case 'l':
+        if (!small) {
+            value = PyLong_AsLong(number);
+            if (value == -1 && PyErr_Occurred())
+                goto error;
+        }
+        if ((col->code == 'b' && (value < SCHAR_MIN || value > SCHAR_MAX)) ||
+            (col->code == 'h' && (value < SHRT_MIN || value > SHRT_MAX)) ||
+            (col->code == 'i' && (value < INT_MIN || value > INT_MAX)))
+            goto overflow;
+        if ((item = column_reserve(col)) == NULL)
+            goto error;
+        switch (col->code) {
+        case 'b': *(signed char *)item = (signed char)value; break;
+        case 'h': *(short *)item = (short)value; break;
+        case 'i': *(int *)item = (int)value; break;
+        default: *(long *)item = value; break;
+        }
+        break;
+    case 'B': case 'H': case 'I': case 'L':
+        if (!small) {
+            uvalue = PyLong_AsUnsignedLong(number);
+            if (uvalue == (unsigned long)-1 && PyErr_Occurred())
+                goto error;
+        }
+        else if (value < 0)
+            goto overflow;
+        else
+            uvalue = (unsigned long)value;
+        if ((col->code == 'B' && uvalue > UCHAR_MAX) ||
+            (col->code == 'H' && uvalue > USHRT_MAX) ||
+            (col->code == 'I' && uvalue > UINT_MAX))
+            goto overflow;
+        if ((item = column_reserve(col)) == NULL)
+            goto error;
+        switch (col->code) {
+        case 'B': *(unsigned char *)item = (unsigned char)uvalue; break;
+        case 'H': *(unsigned short *)item = (unsigned short)uvalue; break;
+        case 'I': *(unsigned int *)item = (unsigned int)uvalue; break;
+        default: *(unsigned long *)item = uvalue; break;
+        }
+        break;
+#ifdef HAVE_LONG_LONG
+    case 'q': {
+        PY_LONG_LONG llvalue = value;
+
+        if (!small) {
+            llvalue = PyLong_AsLongLong(number);
+            if (llvalue == -1 && PyErr_Occurred())
+                goto error;
+        }
+        if ((item = column_reserve(col)) == NULL)
+            goto error;
+        *(PY_LONG_LONG *)item = llvalue;
+        break;
+    }
+    case 'Q': {
+        unsigned PY_LONG_LONG ullvalue;
+
+        if (!small) {
+            ullvalue = PyLong_AsUnsignedLongLong(number);
+            if (ullvalue == (unsigned PY_LONG_LONG)-1 && PyErr_Occurred())
+                goto error;
+        }
+        else if (value < 0)
+            goto overflow;
+        else
+            ullvalue = (unsigned PY_LONG_LONG)value;
+        if ((item = column_reserve(col)) == NULL)
+            goto error;
+        *(unsigned PY_LONG_LONG *)item = ullvalue;
+        break;
+    }
+#endif
+    }
+    Py_XDECREF(number);
+    return 0;
+
+overflow:
+    PyErr_Format(PyExc_OverflowError,
+                 "integer out of range for array typecode '%c'", col->code);
+error:
+    Py_XDECREF(number);
+    return -1;
+}
+
+static int
+column_add(ReaderObj *self, int kind, const void *data, Py_ssize_t len)
+{
+    ColumnBuf *col;
+    PyObject *value;
+    int numeric = self->numeric_field;
+    double d;
+    char *item;
+
+    self->numeric_field = 0;
+    if (self->column >= self->ncolumns) {
+        PyErr_Format(_csvstate_global->error_obj,
+                     "too many fields on line %lu (expected %zd)",
+                     self->line_num, self->ncolumns);
+        return -1;
+    }
+    col = &self->columns[self->column++];
+    switch (col->code) {
+    case COLUMN_STR:
+        value = PyUnicode_FromKindAndData(kind, data, len);
+        if (value != NULL && numeric) {
+            PyObject *tmp = PyNumber_Float(value);
+            Py_DECREF(value);
+            value = tmp;
+        }
+        break;
+    case COLUMN_INT:
+        value = parse_int_object(kind, data, len);
+        break;
+    case COLUMN_FLOAT:
+        if (parse_double(kind, data, len, &d) < 0)
+            return -1;
+        value = PyFloat_FromDouble(d);
+        break;
+    case 'f':
+    case 'd':
+        if (parse_double(kind, data, len, &d) < 0)
+            return -1;
+        if ((item = column_reserve(col)) == NULL)
+            return -1;
+        if (col->code == 'f')
+            *(float *)item = (float)d;
+        else
+            *(double *)item = d;
+        return 0;
+    default:
+        return column_add_integer(col, kind, data, len);
+    }
+    if (value == NULL)
+        return -1;
+    if (PyList_Append(col->values, value) < 0) {
+        Py_DECREF(value);
+        return -1;
+    }
+    Py_DECREF(value);
+    return 0;
+}
+
+/* Turn the filled column buffers into the list returned by
+   read_columns(). */
+static PyObject *
+columns_finish(ColumnBuf *columns, Py_ssize_t ncolumns)
+{
+    PyObject *result, *arraytype = NULL, *column, *view, *tmp;
+    Py_ssize_t i;
+
+    result = PyList_New(ncolumns);
+    if (result == NULL)
+        return NULL;
+    for (i = 0; i < ncolumns; i++) {
+        ColumnBuf *col = &columns[i];
+
+        if (col->values != NULL) {
+            column = col->values;
+            col->values = NULL;
+        }
+        else {
+            if (arraytype == NULL) {
+                PyObject *module = PyImport_ImportModule("array");
+                if (module == NULL)
+                    goto error;
+                arraytype = PyObject_GetAttrString(module, "array");
+                Py_DECREF(module);
+                if (arraytype == NULL)
+                    goto error;
+            }
+            /* Fill the array straight from the column buffer rather than
+               through an intermediate bytes object. */
+            column = PyObject_CallFunction(arraytype, "C", col->code);
+            if (column == NULL)
+                goto error;
+            view = PyMemoryView_FromMemory(col->data,
+                                           col->len * col->itemsize,
+                                           PyBUF_READ);
+            if (view == NULL) {
+                Py_DECREF(column);
+                goto error;
+            }
+            tmp = PyObject_CallMethod(column, "frombytes", "O", view);
+            Py_DECREF(view);
+            if (tmp == NULL) {
+                Py_DECREF(column);
+                goto error;
+            }
+            Py_DECREF(tmp);
+            PyMem_Free(col->data);
+            col->data = NULL;
+        }
+        PyList_SET_ITEM(result, i, column);
+    }
+    Py_XDECREF(arraytype);
+    return result;
+
+error:
+    Py_XDECREF(arraytype);
+    Py_DECREF(result);
+    return NULL;
+}
+
+PyDoc_STRVAR(Reader_read_columns_doc,
+"read_columns(types=None) -> list of columns\n"
+"\n"
+"Read all remaining records and return their fields column by column.\n"
+"Each item of types selects how one column is stored: str (or None)\n"
+"gives a list of strings, int and float give lists of numbers converted\n"
+"like int() and float(), and an array typecode ('b', 'B', 'h', 'H', 'i',\n"
+"'I', 'l', 'L', 'q', 'Q', 'f' or 'd') gives an array.array.  Without\n"
+"types every column is a list of strings and the first record sets the\n"
+"number of columns.  Blank lines are skipped; any other record with the\n"
+"wrong number of fields raises Error.");
+
+static PyObject *
+Reader_read_columns(ReaderObj *self, PyObject *args)
+{
+    PyObject *types = Py_None, *seq, *fields, *result = NULL;
+    ColumnBuf *columns;
+    Py_ssize_t i, ncolumns;
+
+    if (!PyArg_ParseTuple(args, "|O:read_columns", &types))
+        return NULL;
+    if (self->columns != NULL) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "read_columns() is already running");
+        return NULL;
+    }
+
+    if (types == Py_None) {
+        /* the first record sets the number of columns */
+        do {
+            fields = Reader_iternext(self);
+            if (fields == NULL)
+                return PyErr_Occurred() ? NULL : PyList_New(0);
+            ncolumns = PyList_GET_SIZE(fields);
+            if (ncolumns == 0)
+                Py_DECREF(fields);
+        } while (ncolumns == 0);
+        columns = PyMem_New(ColumnBuf, ncolumns);
+        if (columns == NULL) {
+            Py_DECREF(fields);
+            return PyErr_NoMemory();
+        }
+        memset(columns, 0, ncolumns * sizeof(ColumnBuf));
+        for (i = 0; i < ncolumns; i++) {
+            columns[i].code = COLUMN_STR;
+            columns[i].values = PyList_New(1);
+            if (columns[i].values == NULL) {
+                Py_DECREF(fields);
+                columns_free(columns, ncolumns);
+                return NULL;
+            }
+            Py_INCREF(PyList_GET_ITEM(fields, i));
+            PyList_SET_ITEM(columns[i].values, 0, PyList_GET_ITEM(fields, i));
+        }
+        Py_DECREF(fields);
+    }
+    else {
+        seq = PySequence_Fast(types, "types must be a sequence");
+        if (seq == NULL)
+            return NULL;
+        ncolumns = PySequence_Fast_GET_SIZE(seq);
+        columns = PyMem_New(ColumnBuf, ncolumns ? ncolumns : 1);
+        if (columns == NULL) {
+            Py_DECREF(seq);
+            return PyErr_NoMemory();
+        }
+        for (i = 0; i < ncolumns; i++) {
+            if (column_init(&columns[i],
+                            PySequence_Fast_GET_ITEM(seq, i)) < 0) {
+                Py_DECREF(seq);
+                columns_free(columns, i + 1);
+                return NULL;
+            }
+        }
+        Py_DECREF(seq);
+    }
+
+    self->columns = columns;
+    self->ncolumns = ncolumns;
+    for (;;) {
+        self->column = 0;
+        fields = Reader_iternext(self);
+        if (fields == NULL)
+            break;
+        Py_DECREF(fields);
+        if (self->column != 0 && self->column != ncolumns) {
+            PyErr_Format(_csvstate_global->error_obj,
+                         "too few fields on line %lu (expected %zd)",
+                         self->line_num, ncolumns);
+            break;
+        }
+    }
+    self->columns = NULL;
+    self->ncolumns = 0;
+    if (!PyErr_Occurred())
+        result = columns_finish(columns, ncolumns);
+    columns_free(columns, ncolumns);
+    return result;
+}
+
 static void
 Reader_dealloc(ReaderObj *self)
 {
@@ -888,6 +1562,8 @@ PyDoc_STRVAR(Reader_Type_doc,
 );
 
 static struct PyMethodDef Reader_methods[] = {
+    { "read_columns", (PyCFunction)Reader_read_columns,
+        METH_VARARGS, Reader_read_columns_doc},
     { NULL, NULL }
 };
 #define R_OFF(x) offsetof(ReaderObj, x)
@@ -950,6 +1626,10 @@ csv_reader(PyObject *module, PyObject *args, PyObject *keyword_args)
     self->field = NULL;
     self->field_size = 0;
     self->line_num = 0;
+    self->fast_path = 0;
+    self->columns = NULL;
+    self->ncolumns = 0;
+    self->column = 0;
 
     if (parse_reset(self) < 0) {
         Py_DECREF(self);
@@ -972,6 +1652,7 @@ csv_reader(PyObject *module, PyObject *args, PyObject *keyword_args)
         Py_DECREF(self);
         return NULL;
     }
+    self->fast_path = dialect_allows_fast_path(self->dialect);
 
     PyObject_GC_Track(self);
     return (PyObject *)self;
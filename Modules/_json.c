@@ -39,8 +39,14 @@ typedef struct _PyScannerObject {
     PyObject *parse_int;
     PyObject *parse_constant;
     PyObject *memo;
+    PyObject **key_cache;
 } PyScannerObject;
 
+/* Size of the direct-mapped cache of object keys kept by the UTF-8 scanner,
+   and the longest key (in bytes) it holds */
+#define KEY_CACHE_SIZE 1024
+#define KEY_CACHE_MAXLEN 64
+
 static PyMemberDef scanner_members[] = {
     {"strict", T_OBJECT, offsetof(PyScannerObject, strict), READONLY, "strict"},
     {"object_hook", T_OBJECT, offsetof(PyScannerObject, object_hook), READONLY, "object_hook"},
@@ -62,6 +68,7 @@ typedef struct _PyEncoderObject {
     PyObject *sort_keys;
     PyObject *skipkeys;
     int fast_encode;
+    int fast_encode_unicode;
     int allow_nan;
 } PyEncoderObject;
 
@@ -96,10 +103,14 @@ static PyObject *
 ascii_escape_unicode(PyObject *pystr);
 static PyObject *
 py_encode_basestring_ascii(PyObject* self UNUSED, PyObject *pystr);
+static PyObject *
+py_encode_basestring(PyObject* self UNUSED, PyObject *pystr);
 void init_json(void);
 static PyObject *
 scan_once_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ssize_t *next_idx_ptr);
 static PyObject *
+scan_once_utf8(PyScannerObject *s, const char *str, Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr);
+static PyObject *
 _build_rval_index_tuple(PyObject *rval, Py_ssize_t idx);
 static PyObject *
 scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
@@ -252,6 +263,84 @@ ascii_escape_unicode(PyObject *pystr)
     return rval;
 }
 
+static PyObject *
+escape_unicode(PyObject *pystr)
+{
+    /* Take a PyUnicode pystr and return a new escaped PyUnicode */
+    Py_ssize_t i;
+    Py_ssize_t input_chars;
+    Py_ssize_t output_size;
+    Py_ssize_t chars;
+    PyObject *rval;
+    void *input;
+    int kind;
+    Py_UCS4 maxchar;
+
+    if (PyUnicode_READY(pystr) == -1)
+        return NULL;
+
+    maxchar = PyUnicode_MAX_CHAR_VALUE(pystr);
+    input_chars = PyUnicode_GET_LENGTH(pystr);
+    input = PyUnicode_DATA(pystr);
+    kind = PyUnicode_KIND(pystr);
+
+    /* Compute the output size */
+    for (i = 0, output_size = 2; i < input_chars; i++) {
+        Py_UCS4 c = PyUnicode_READ(kind, input, i);
+        switch (c) {
+        case '\\': case '"': case '\b': case '\f':
+        case '\n': case '\r': case '\t':
+            output_size += 2;
+            break;
+        default:
+            output_size += c <= 0x1f ? 6 : 1;
+        }
+    }
+
+    rval = PyUnicode_New(output_size, maxchar);
+    if (rval == NULL)
+        return NULL;
+
+    kind = PyUnicode_KIND(rval);
+    if (kind == PyUnicode_1BYTE_KIND) {
+        unsigned char *output = PyUnicode_1BYTE_DATA(rval);
+        chars = 0;
+        output[chars++] = '"';
+        for (i = 0; i < input_chars; i++) {
+            Py_UCS4 c = PyUnicode_READ(PyUnicode_KIND(pystr), input, i);
+            if (c > 0x1f && c != '\\' && c != '"')
+                output[chars++] = c;
+            else
+                chars = ascii_escape_unichar(c, output, chars);
+        }
+        output[chars++] = '"';
+    }
+    else {
+        /* Escapes are ASCII and at most 6 characters long; build them in
+           a small buffer and widen them into the output */
+        unsigned char escape[12];
+        Py_ssize_t j, n;
+        void *output = PyUnicode_DATA(rval);
+        chars = 0;
+        PyUnicode_WRITE(kind, output, chars++, '"');
+        for (i = 0; i < input_chars; i++) {
+            Py_UCS4 c = PyUnicode_READ(PyUnicode_KIND(pystr), input, i);
+            if (c > 0x1f && c != '\\' && c != '"') {
+                PyUnicode_WRITE(kind, output, chars++, c);
+                continue;
+            }
+            n = ascii_escape_unichar(c, escape, 0);
+            for (j = 0; j < n; j++)
+                PyUnicode_WRITE(kind, output, chars++, escape[j]);
+        }
+        PyUnicode_WRITE(kind, output, chars++, '"');
+    }
+#ifdef Py_DEBUG
+    assert(_PyUnicode_CheckConsistency(rval, 1));
+#endif
+    return rval;
+}
+
 static void
 raise_errmsg(char *msg, PyObject *s, Py_ssize_t end)
 {
@@ -554,6 +643,30 @@ py_encode_basestring_ascii(PyObject* self UNUSED, PyObject *pystr)
     return rval;
 }
 
+PyDoc_STRVAR(pydoc_encode_basestring,
+    "encode_basestring(string) -> string\n"
+    "\n"
+    "Return a JSON representation of a Python string"
+);
+
+static PyObject *
+py_encode_basestring(PyObject* self UNUSED, PyObject *pystr)
+{
+    PyObject *rval;
+    /* Return a JSON representation of a Python string */
+    /* METH_O */
+    if (PyUnicode_Check(pystr)) {
+        rval = escape_unicode(pystr);
+    }
+    else {
+        PyErr_Format(PyExc_TypeError,
+                     "first argument must be a string, not %.80s",
+                     Py_TYPE(pystr)->tp_name);
+        return NULL;
+    }
+    return rval;
+}
+
 static void
 scanner_dealloc(PyObject *self)
 {
@@ -590,6 +703,13 @@ scanner_clear(PyObject *self)
     Py_CLEAR(s->parse_int);
     Py_CLEAR(s->parse_constant);
     Py_CLEAR(s->memo);
+    if (s->key_cache != NULL) {
+        Py_ssize_t i;
+        for (i = 0; i < KEY_CACHE_SIZE; i++)
+            Py_CLEAR(s->key_cache[i]);
+        PyMem_Free(s->key_cache);
+        s->key_cache = NULL;
+    }
     return 0;
 }
 
@@ -1066,113 +1186,1351 @@ scan_once_unicode(PyScannerObject *s, PyObject *pystr, Py_ssize_t idx, Py_ssize_
     return _match_number_unicode(s, pystr, idx, next_idx_ptr);
 }
 
-static PyObject *
-scanner_call(PyObject *self, PyObject *args, PyObject *kwds)
-{
-    /* Python callable interface to scan_once_{str,unicode} */
-    PyObject *pystr;
-    PyObject *rval;
-    Py_ssize_t idx;
-    Py_ssize_t next_idx = -1;
-    static char *kwlist[] = {"string", "idx", NULL};
-    PyScannerObject *s;
-    assert(PyScanner_Check(self));
-    s = (PyScannerObject *)self;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO&:scan_once", kwlist, &pystr, _convertPyInt_AsSsize_t, &idx))
-        return NULL;
+/* The scanner below reads JSON from UTF-8 encoded bytes; it follows the same
+   grammar as the unicode scanner above.  Every character that has a meaning
+   in JSON is ASCII, and the bytes of a multi-byte UTF-8 sequence are never
+   ASCII, so the structure can be scanned byte by byte.  Only the contents of
+   strings need decoding, and they are decoded straight from slices of the
+   input; no intermediate str of the whole document is ever built. */
 
-    if (PyUnicode_Check(pystr)) {
-        rval = scan_once_unicode(s, pystr, idx, &next_idx);
-    }
-    else {
-        PyErr_Format(PyExc_TypeError,
-                 "first argument must be a string, not %.80s",
-                 Py_TYPE(pystr)->tp_name);
-        return NULL;
-    }
-    PyDict_Clear(s->memo);
-    if (rval == NULL)
-        return NULL;
-    return _build_rval_index_tuple(rval, next_idx);
+static void
+raise_errmsg_utf8(char *msg, const char *str, Py_ssize_t len, Py_ssize_t end)
+{
+    /* Like raise_errmsg(), for a position in a UTF-8 buffer */
+    PyObject *doc = PyBytes_FromStringAndSize(str, len);
+    if (doc == NULL)
+        return;
+    raise_errmsg(msg, doc, end);
+    Py_DECREF(doc);
 }
 
-static PyObject *
-scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+static int
+_decode_hex4_utf8(const char *str, Py_ssize_t idx, Py_UCS4 *c_ptr)
 {
-    PyScannerObject *s;
-    s = (PyScannerObject *)type->tp_alloc(type, 0);
-    if (s != NULL) {
-        s->strict = NULL;
-        s->object_hook = NULL;
-        s->object_pairs_hook = NULL;
-        s->parse_float = NULL;
-        s->parse_int = NULL;
-        s->parse_constant = NULL;
+    /* Decode the 4 hex digits at str[idx], return -1 if they aren't */
+    Py_UCS4 c = 0;
+    Py_ssize_t end = idx + 4;
+
+    for (; idx < end; idx++) {
+        char digit = str[idx];
+        c <<= 4;
+        switch (digit) {
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                c |= (digit - '0'); break;
+            case 'a': case 'b': case 'c': case 'd': case 'e':
+            case 'f':
+                c |= (digit - 'a' + 10); break;
+            case 'A': case 'B': case 'C': case 'D': case 'E':
+            case 'F':
+                c |= (digit - 'A' + 10); break;
+            default:
+                return -1;
+        }
     }
-    return (PyObject *)s;
+    *c_ptr = c;
+    return 0;
 }
 
-static int
-scanner_init(PyObject *self, PyObject *args, PyObject *kwds)
+static PyObject *
+scanstring_utf8(const char *str, Py_ssize_t len, Py_ssize_t end, int strict,
+                Py_ssize_t *next_end_ptr)
 {
-    /* Initialize Scanner object */
-    PyObject *ctx;
-    static char *kwlist[] = {"context", NULL};
-    PyScannerObject *s;
-
-    assert(PyScanner_Check(self));
-    s = (PyScannerObject *)self;
+    /* Read the JSON string from the UTF-8 buffer str of len bytes.
+    end is the index of the first byte after the quote.
+    if strict is zero then literal control characters are allowed
+    *next_end_ptr is a return-by-reference index of the byte
+        after the end quote
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:make_scanner", kwlist, &ctx))
-        return -1;
+    Return value is a new PyUnicode
+    */
+    PyObject *rval = NULL;
+    Py_ssize_t begin = end - 1;
+    Py_ssize_t next /* = begin */;
+    PyObject *chunks = NULL;
+    PyObject *chunk = NULL;
 
-    if (s->memo == NULL) {
-        s->memo = PyDict_New();
-        if (s->memo == NULL)
+    if (end < 0 || len <= end) {
+        PyErr_SetString(PyExc_ValueError, "end is out of bounds");
+        goto bail;
+    }
+    while (1) {
+        /* Find the end of the string or the next escape */
+        Py_UCS4 c = 0;
+        for (next = end; next < len; next++) {
+            c = (unsigned char)str[next];
+            if (c == '"' || c == '\\') {
+                break;
+            }
+            else if (strict && c <= 0x1f) {
+                raise_errmsg_utf8("Invalid control character at",
+                                  str, len, next);
+                goto bail;
+            }
+        }
+        if (!(c == '"' || c == '\\')) {
+            raise_errmsg_utf8("Unterminated string starting at",
+                              str, len, begin);
+            goto bail;
+        }
+        /* Pick up this chunk if it's not zero length.  It can't end in the
+           middle of a UTF-8 sequence, since it stops at an ASCII byte. */
+        if (next != end) {
+            APPEND_OLD_CHUNK
+                chunk = PyUnicode_DecodeUTF8(str + end, next - end, NULL);
+            if (chunk == NULL) {
+                goto bail;
+            }
+        }
+        next++;
+        if (c == '"') {
+            end = next;
+            break;
+        }
+        if (next == len) {
+            raise_errmsg_utf8("Unterminated string starting at",
+                              str, len, begin);
+            goto bail;
+        }
+        c = (unsigned char)str[next];
+        if (c != 'u') {
+            /* Non-unicode backslash escapes */
+            end = next + 1;
+            switch (c) {
+                case '"': break;
+                case '\\': break;
+                case '/': break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                default: c = 0;
+            }
+            if (c == 0) {
+                raise_errmsg_utf8("Invalid \\escape", str, len, end - 2);
+                goto bail;
+            }
+        }
+        else {
+            next++;
+            end = next + 4;
+            if (end >= len || _decode_hex4_utf8(str, next, &c) < 0) {
+                raise_errmsg_utf8("Invalid \\uXXXX escape",
+                                  str, len, next - 1);
+                goto bail;
+            }
+            next = end;
+            /* Surrogate pair */
+            if (Py_UNICODE_IS_HIGH_SURROGATE(c) && end + 6 < len &&
+                str[next] == '\\' && str[next + 1] == 'u') {
+                Py_UCS4 c2 = 0;
+                if (_decode_hex4_utf8(str, next + 2, &c2) < 0) {
+                    raise_errmsg_utf8("Invalid \\uXXXX escape",
+                                      str, len, next + 1);
+                    goto bail;
+                }
+                if (Py_UNICODE_IS_LOW_SURROGATE(c2)) {
+                    c = Py_UNICODE_JOIN_SURROGATES(c, c2);
+                    end += 6;
+                }
+            }
+        }
+        APPEND_OLD_CHUNK
+        chunk = PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND, &c, 1);
+        if (chunk == NULL) {
             goto bail;
+        }
     }
 
-    /* All of these will fail "gracefully" so we don't need to verify them */
-    s->strict = PyObject_GetAttrString(ctx, "strict");
-    if (s->strict == NULL)
-        goto bail;
-    s->object_hook = PyObject_GetAttrString(ctx, "object_hook");
-    if (s->object_hook == NULL)
-        goto bail;
-    s->object_pairs_hook = PyObject_GetAttrString(ctx, "object_pairs_hook");
-    if (s->object_pairs_hook == NULL)
-        goto bail;
-    s->parse_float = PyObject_GetAttrString(ctx, "parse_float");
-    if (s->parse_float == NULL)
-        goto bail;
-    s->parse_int = PyObject_GetAttrString(ctx, "parse_int");
-    if (s->parse_int == NULL)
-        goto bail;
-    s->parse_constant = PyObject_GetAttrString(ctx, "parse_constant");
-    if (s->parse_constant == NULL)
-        goto bail;
-
-    return 0;
+    if (chunks == NULL) {
+        if (chunk != NULL)
+            rval = chunk;
+        else
+            rval = PyUnicode_FromStringAndSize("", 0);
+    }
+    else {
+        APPEND_OLD_CHUNK
+        rval = join_list_unicode(chunks);
+        if (rval == NULL) {
+            goto bail;
+        }
+        Py_CLEAR(chunks);
+    }
 
+    *next_end_ptr = end;
+    return rval;
 bail:
-    Py_CLEAR(s->strict);
-    Py_CLEAR(s->object_hook);
-    Py_CLEAR(s->object_pairs_hook);
-    Py_CLEAR(s->parse_float);
-    Py_CLEAR(s->parse_int);
-    Py_CLEAR(s->parse_constant);
-    return -1;
+    *next_end_ptr = -1;
+    Py_XDECREF(chunks);
+    Py_XDECREF(chunk);
+    return NULL;
 }
 
-PyDoc_STRVAR(scanner_doc, "JSON scanner object");
+static PyObject *
+_scan_key_utf8(PyScannerObject *s, const char *str, Py_ssize_t len,
+               Py_ssize_t end, int strict, Py_ssize_t *next_end_ptr)
+{
+    /* Read an object key from the UTF-8 buffer str, like scanstring_utf8().
+    Short ASCII keys without escapes, which is what almost all keys are,
+    are looked up in s->key_cache by their bytes; a repeated key is then
+    returned without decoding or allocating anything.
 
-static
-PyTypeObject PyScannerType = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    "_json.Scanner",       /* tp_name */
-    sizeof(PyScannerObject), /* tp_basicsize */
+    Return value is a new PyUnicode
+    */
+    Py_ssize_t next;
+    unsigned char bits = 0;
+    Py_uhash_t hash = 2166136261U;
+    PyObject *key;
+    PyObject **slot;
+
+    for (next = end; next < len && next - end <= KEY_CACHE_MAXLEN; next++) {
+        unsigned char c = (unsigned char)str[next];
+        if (c == '"' || c == '\\' || c <= 0x1f)
+            break;
+        bits |= c;
+        hash = (hash ^ c) * 16777619U;
+    }
+    if (next == len || str[next] != '"' || bits >= 0x80 ||
+        next - end > KEY_CACHE_MAXLEN || s->key_cache == NULL) {
+        /* The general case, memoized through s->memo */
+        PyObject *memokey;
+
+        key = scanstring_utf8(str, len, end, strict, next_end_ptr);
+        if (key == NULL)
+            return NULL;
+        memokey = PyDict_GetItem(s->memo, key);
+        if (memokey != NULL) {
+            Py_INCREF(memokey);
+            Py_DECREF(key);
+            return memokey;
+        }
+        if (PyDict_SetItem(s->memo, key, key) < 0) {
+            Py_DECREF(key);
+            return NULL;
+        }
+        return key;
+    }
+
+    slot = &s->key_cache[hash & (KEY_CACHE_SIZE - 1)];
+    key = *slot;
+    if (key == NULL || PyUnicode_GET_LENGTH(key) != next - end ||
+        memcmp(PyUnicode_1BYTE_DATA(key), str + end, next - end) != 0) {
+        key = PyUnicode_New(next - end, 127);
+        if (key == NULL)
+            return NULL;
+        memcpy(PyUnicode_1BYTE_DATA(key), str + end, next - end);
+        Py_XDECREF(*slot);
+        *slot = key;
+    }
+    Py_INCREF(key);
+    *next_end_ptr = next + 1;
+    return key;
+}
+
+static PyObject *
+_parse_object_utf8(PyScannerObject *s, const char *str, Py_ssize_t len, Py_ssize_t idx, Py_ssize_t *next_idx_ptr) {
+    /* Read a JSON object from the UTF-8 buffer str.
+    idx is the index of the first byte after the opening curly brace.
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the closing curly brace.
+
+    Returns a new PyObject (usually a dict, but object_hook can change that)
+    */
+    Py_ssize_t end_idx = len - 1;
+    PyObject *val = NULL;
+    PyObject *rval = NULL;
+    PyObject *key = NULL;
+    int strict = PyObject_IsTrue(s->strict);
+    int has_pairs_hook = (s->object_pairs_hook != Py_None);
+    Py_ssize_t next_idx;
+
+    if (has_pairs_hook)
+        rval = PyList_New(0);
+    else
+        rval = PyDict_New();
+    if (rval == NULL)
+        return NULL;
+
+    /* skip whitespace after { */
+    while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+    /* only loop if the object is non-empty */
+    if (idx <= end_idx && str[idx] != '}') {
+        while (idx <= end_idx) {
+            /* read key */
+            if (str[idx] != '"') {
+                raise_errmsg_utf8("Expecting property name enclosed in double quotes", str, len, idx);
+                goto bail;
+            }
+            key = _scan_key_utf8(s, str, len, idx + 1, strict, &next_idx);
+            if (key == NULL)
+                goto bail;
+            idx = next_idx;
+
+            /* skip whitespace between key and : delimiter, read :, skip whitespace */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+            if (idx > end_idx || str[idx] != ':') {
+                raise_errmsg_utf8("Expecting ':' delimiter", str, len, idx);
+                goto bail;
+            }
+            idx++;
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+            /* read any JSON term */
+            val = scan_once_utf8(s, str, len, idx, &next_idx);
+            if (val == NULL)
+                goto bail;
+
+            if (has_pairs_hook) {
+                PyObject *item = PyTuple_Pack(2, key, val);
+                if (item == NULL)
+                    goto bail;
+                Py_CLEAR(key);
+                Py_CLEAR(val);
+                if (PyList_Append(rval, item) == -1) {
+                    Py_DECREF(item);
+                    goto bail;
+                }
+                Py_DECREF(item);
+            }
+            else {
+                if (PyDict_SetItem(rval, key, val) < 0)
+                    goto bail;
+                Py_CLEAR(key);
+                Py_CLEAR(val);
+            }
+            idx = next_idx;
+
+            /* skip whitespace before } or , */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+            /* bail if the object is closed or we didn't get the , delimiter */
+            if (idx > end_idx) break;
+            if (str[idx] == '}') {
+                break;
+            }
+            else if (str[idx] != ',') {
+                raise_errmsg_utf8("Expecting ',' delimiter", str, len, idx);
+                goto bail;
+            }
+            idx++;
+
+            /* skip whitespace after , delimiter */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+        }
+    }
+
+    /* verify that idx < end_idx, str[idx] should be '}' */
+    if (idx > end_idx || str[idx] != '}') {
+        raise_errmsg_utf8("Expecting object", str, len, end_idx);
+        goto bail;
+    }
+
+    *next_idx_ptr = idx + 1;
+
+    if (has_pairs_hook) {
+        val = PyObject_CallFunctionObjArgs(s->object_pairs_hook, rval, NULL);
+        Py_DECREF(rval);
+        return val;
+    }
+
+    /* if object_hook is not None: rval = object_hook(rval) */
+    if (s->object_hook != Py_None) {
+        val = PyObject_CallFunctionObjArgs(s->object_hook, rval, NULL);
+        Py_DECREF(rval);
+        return val;
+    }
+    return rval;
+bail:
+    Py_XDECREF(key);
+    Py_XDECREF(val);
+    Py_XDECREF(rval);
+    return NULL;
+}
+
+static PyObject *
+_parse_array_utf8(PyScannerObject *s, const char *str, Py_ssize_t len, Py_ssize_t idx, Py_ssize_t *next_idx_ptr) {
+    /* Read a JSON array from the UTF-8 buffer str.
+    idx is the index of the first byte after the opening brace.
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the closing brace.
+
+    Returns a new PyList
+    */
+    Py_ssize_t end_idx = len - 1;
+    PyObject *val = NULL;
+    PyObject *rval = PyList_New(0);
+    Py_ssize_t next_idx;
+    if (rval == NULL)
+        return NULL;
+
+    /* skip whitespace after [ */
+    while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+    /* only loop if the array is non-empty */
+    if (idx <= end_idx && str[idx] != ']') {
+        while (idx <= end_idx) {
+
+            /* read any JSON term  */
+            val = scan_once_utf8(s, str, len, idx, &next_idx);
+            if (val == NULL)
+                goto bail;
+
+            if (PyList_Append(rval, val) == -1)
+                goto bail;
+
+            Py_CLEAR(val);
+            idx = next_idx;
+
+            /* skip whitespace between term and , */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+
+            /* bail if the array is closed or we didn't get the , delimiter */
+            if (idx > end_idx) break;
+            if (str[idx] == ']') {
+                break;
+            }
+            else if (str[idx] != ',') {
+                raise_errmsg_utf8("Expecting ',' delimiter", str, len, idx);
+                goto bail;
+            }
+            idx++;
+
+            /* skip whitespace after , */
+            while (idx <= end_idx && IS_WHITESPACE(str[idx])) idx++;
+        }
+    }
+
+    /* verify that idx < end_idx, str[idx] should be ']' */
+    if (idx > end_idx || str[idx] != ']') {
+        raise_errmsg_utf8("Expecting object", str, len, end_idx);
+        goto bail;
+    }
+    *next_idx_ptr = idx + 1;
+    return rval;
+bail:
+    Py_XDECREF(val);
+    Py_DECREF(rval);
+    return NULL;
+}
+
+static PyObject *
+_match_number_utf8(PyScannerObject *s, const char *str, Py_ssize_t len, Py_ssize_t start, Py_ssize_t *next_idx_ptr) {
+    /* Read a JSON number from the UTF-8 buffer str.
+    idx is the index of the first byte of the number
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the number.
+
+    Returns a new PyObject representation of that number:
+        PyInt, PyLong, or PyFloat.
+        May return other types if parse_int or parse_float are set
+    */
+    Py_ssize_t end_idx = len - 1;
+    Py_ssize_t idx = start;
+    int is_float = 0;
+    PyObject *rval;
+    PyObject *numstr = NULL;
+    PyObject *custom_func;
+
+    /* read a sign if it's there, make sure it's not the end of the string */
+    if (str[idx] == '-') {
+        idx++;
+        if (idx > end_idx) {
+            PyErr_SetNone(PyExc_StopIteration);
+            return NULL;
+        }
+    }
+
+    /* read as many integer digits as we find as long as it doesn't start with 0 */
+    if (str[idx] >= '1' && str[idx] <= '9') {
+        idx++;
+        while (idx <= end_idx && str[idx] >= '0' && str[idx] <= '9') idx++;
+    }
+    /* if it starts with 0 we only expect one integer digit */
+    else if (str[idx] == '0') {
+        idx++;
+    }
+    /* no integer digits, error */
+    else {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+
+    /* if the next char is '.' followed by a digit then read all float digits */
+    if (idx < end_idx && str[idx] == '.' && str[idx + 1] >= '0' && str[idx + 1] <= '9') {
+        is_float = 1;
+        idx += 2;
+        while (idx <= end_idx && str[idx] >= '0' && str[idx] <= '9') idx++;
+    }
+
+    /* if the next char is 'e' or 'E' then maybe read the exponent (or backtrack) */
+    if (idx < end_idx && (str[idx] == 'e' || str[idx] == 'E')) {
+        Py_ssize_t e_start = idx;
+        idx++;
+
+        /* read an exponent sign if present */
+        if (idx < end_idx && (str[idx] == '-' || str[idx] == '+')) idx++;
+
+        /* read all digits */
+        while (idx <= end_idx && str[idx] >= '0' && str[idx] <= '9') idx++;
+
+        /* if we got a digit, then parse as float. if not, backtrack */
+        if (str[idx - 1] >= '0' && str[idx - 1] <= '9') {
+            is_float = 1;
+        }
+        else {
+            idx = e_start;
+        }
+    }
+
+    if (is_float && s->parse_float != (PyObject *)&PyFloat_Type)
+        custom_func = s->parse_float;
+    else if (!is_float && s->parse_int != (PyObject *) &PyLong_Type)
+        custom_func = s->parse_int;
+    else
+        custom_func = NULL;
+
+    if (custom_func) {
+        /* copy the section we determined to be a number */
+        numstr = PyUnicode_DecodeASCII(str + start, idx - start, NULL);
+        if (numstr == NULL)
+            return NULL;
+        rval = PyObject_CallFunctionObjArgs(custom_func, numstr, NULL);
+        Py_DECREF(numstr);
+    }
+    else {
+        /* The digits are ASCII already, they only need a terminating NUL */
+        char small[64];
+        char *buf = small;
+        Py_ssize_t n = idx - start;
+
+        if (n >= (Py_ssize_t)sizeof(small)) {
+            numstr = PyBytes_FromStringAndSize(str + start, n);
+            if (numstr == NULL)
+                return NULL;
+            buf = PyBytes_AS_STRING(numstr);
+        }
+        else {
+            memcpy(small, str + start, n);
+            small[n] = '\0';
+        }
+        if (is_float) {
+            double d = PyOS_string_to_double(buf, NULL, NULL);
+            if (d == -1.0 && PyErr_Occurred())
+                rval = NULL;
+            else
+                rval = PyFloat_FromDouble(d);
+        }
+        else
+            rval = PyLong_FromString(buf, NULL, 10);
+        Py_XDECREF(numstr);
+    }
+    *next_idx_ptr = idx;
+    return rval;
+}
+
+static PyObject *
+scan_once_utf8(PyScannerObject *s, const char *str, Py_ssize_t length, Py_ssize_t idx, Py_ssize_t *next_idx_ptr)
+{
+    /* Read one JSON term (of any kind) from the UTF-8 buffer str.
+    idx is the index of the first byte of the term
+    *next_idx_ptr is a return-by-reference index to the first byte after
+        the term.
+
+    Returns a new PyObject representation of the term.
+    */
+    PyObject *res;
+
+    if (idx >= length) {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+
+    switch (str[idx]) {
+        case '"':
+            /* string */
+            return scanstring_utf8(str, length, idx + 1,
+                PyObject_IsTrue(s->strict),
+                next_idx_ptr);
+        case '{':
+            /* object */
+            if (Py_EnterRecursiveCall(" while decoding a JSON object "
+                                      "from UTF-8 bytes"))
+                return NULL;
+            res = _parse_object_utf8(s, str, length, idx + 1, next_idx_ptr);
+            Py_LeaveRecursiveCall();
+            return res;
+        case '[':
+            /* array */
+            if (Py_EnterRecursiveCall(" while decoding a JSON array "
+                                      "from UTF-8 bytes"))
+                return NULL;
+            res = _parse_array_utf8(s, str, length, idx + 1, next_idx_ptr);
+            Py_LeaveRecursiveCall();
+            return res;
+        case 'n':
+            /* null */
+            if ((idx + 3 < length) && memcmp(str + idx, "null", 4) == 0) {
+                Py_INCREF(Py_None);
+                *next_idx_ptr = idx + 4;
+                return Py_None;
+            }
+            break;
+        case 't':
+            /* true */
+            if ((idx + 3 < length) && memcmp(str + idx, "true", 4) == 0) {
+                Py_INCREF(Py_True);
+                *next_idx_ptr = idx + 4;
+                return Py_True;
+            }
+            break;
+        case 'f':
+            /* false */
+            if ((idx + 4 < length) && memcmp(str + idx, "false", 5) == 0) {
+                Py_INCREF(Py_False);
+                *next_idx_ptr = idx + 5;
+                return Py_False;
+            }
+            break;
+        case 'N':
+            /* NaN */
+            if ((idx + 2 < length) && memcmp(str + idx, "NaN", 3) == 0) {
+                return _parse_constant(s, "NaN", idx, next_idx_ptr);
+            }
+            break;
+        case 'I':
+            /* Infinity */
+            if ((idx + 7 < length) && memcmp(str + idx, "Infinity", 8) == 0) {
+                return _parse_constant(s, "Infinity", idx, next_idx_ptr);
+            }
+            break;
+        case '-':
+            /* -Infinity */
+            if ((idx + 8 < length) && memcmp(str + idx, "-Infinity", 9) == 0) {
+                return _parse_constant(s, "-Infinity", idx, next_idx_ptr);
+            }
+            break;
+    }
+    /* Didn't find a string, object, array, or named constant. Look for a number. */
+    return _match_number_utf8(s, str, length, idx, next_idx_ptr);
+}
+
+static PyObject *
+scanner_call(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    /* Python callable interface to scan_once_{str,unicode} */
+    PyObject *pystr;
+    PyObject *rval;
+    Py_ssize_t idx;
+    Py_ssize_t next_idx = -1;
+    static char *kwlist[] = {"string", "idx", NULL};
+    PyScannerObject *s;
+    assert(PyScanner_Check(self));
+    s = (PyScannerObject *)self;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO&:scan_once", kwlist, &pystr, _convertPyInt_AsSsize_t, &idx))
+        return NULL;
+
+    if (PyUnicode_Check(pystr)) {
+        rval = scan_once_unicode(s, pystr, idx, &next_idx);
+    }
+    else {
+        PyErr_Format(PyExc_TypeError,
+                 "first argument must be a string, not %.80s",
+                 Py_TYPE(pystr)->tp_name);
+        return NULL;
+    }
+    PyDict_Clear(s->memo);
+    if (rval == NULL)
+        return NULL;
+    return _build_rval_index_tuple(rval, next_idx);
+}
+
+static PyObject *
+scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyScannerObject *s;
+    s = (PyScannerObject *)type->tp_alloc(type, 0);
+    if (s != NULL) {
+        s->strict = NULL;
+        s->object_hook = NULL;
+        s->object_pairs_hook = NULL;
+        s->parse_float = NULL;
+        s->parse_int = NULL;
+        s->parse_constant = NULL;
+        s->key_cache = NULL;
+    }
+    return (PyObject *)s;
+}
+
+static int
+scanner_init(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    /* Initialize Scanner object */
+    PyObject *ctx;
+    static char *kwlist[] = {"context", NULL};
+    PyScannerObject *s;
+
+    assert(PyScanner_Check(self));
+    s = (PyScannerObject *)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:make_scanner", kwlist, &ctx))
+        return -1;
+
+    if (s->memo == NULL) {
+        s->memo = PyDict_New();
+        if (s->memo == NULL)
+            goto bail;
+    }
+
+    /* All of these will fail "gracefully" so we don't need to verify them */
+    s->strict = PyObject_GetAttrString(ctx, "strict");
+    if (s->strict == NULL)
+        goto bail;
+    s->object_hook = PyObject_GetAttrString(ctx, "object_hook");
+    if (s->object_hook == NULL)
+        goto bail;
+    s->object_pairs_hook = PyObject_GetAttrString(ctx, "object_pairs_hook");
+    if (s->object_pairs_hook == NULL)
+        goto bail;
+    s->parse_float = PyObject_GetAttrString(ctx, "parse_float");
+    if (s->parse_float == NULL)
+        goto bail;
+    s->parse_int = PyObject_GetAttrString(ctx, "parse_int");
+    if (s->parse_int == NULL)
+        goto bail;
+    s->parse_constant = PyObject_GetAttrString(ctx, "parse_constant");
+    if (s->parse_constant == NULL)
+        goto bail;
+
+    return 0;
+
+bail:
+    Py_CLEAR(s->strict);
+    Py_CLEAR(s->object_hook);
+    Py_CLEAR(s->object_pairs_hook);
+    Py_CLEAR(s->parse_float);
+    Py_CLEAR(s->parse_int);
+    Py_CLEAR(s->parse_constant);
+    return -1;
+}
+
+PyDoc_STRVAR(scanner_doc, "JSON scanner object");
+
+static
+PyTypeObject PyScannerType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_json.Scanner",       /* tp_name */
+    sizeof(PyScannerObject), /* tp_basicsize */
+    0,                    /* tp_itemsize */
+    scanner_dealloc, /* tp_dealloc */
+    0,                    /* tp_print */
+    0,                    /* tp_getattr */
+    0,                    /* tp_setattr */
+    0,                    /* tp_compare */
+    0,                    /* tp_repr */
+    0,                    /* tp_as_number */
+    0,                    /* tp_as_sequence */
+    0,                    /* tp_as_mapping */
+    0,                    /* tp_hash */
+    scanner_call,         /* tp_call */
+    0,                    /* tp_str */
+    0,/* PyObject_GenericGetAttr, */                    /* tp_getattro */
+    0,/* PyObject_GenericSetAttr, */                    /* tp_setattro */
+    0,                    /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,   /* tp_flags */
+    scanner_doc,          /* tp_doc */
+    scanner_traverse,                    /* tp_traverse */
+    scanner_clear,                    /* tp_clear */
+    0,                    /* tp_richcompare */
+    0,                    /* tp_weaklistoffset */
+    0,                    /* tp_iter */
+    0,                    /* tp_iternext */
+    0,                    /* tp_methods */
+    scanner_members,                    /* tp_members */
+    0,                    /* tp_getset */
+    0,                    /* tp_base */
+    0,                    /* tp_dict */
+    0,                    /* tp_descr_get */
+    0,                    /* tp_descr_set */
+    0,                    /* tp_dictoffset */
+    scanner_init,                    /* tp_init */
+    0,/* PyType_GenericAlloc, */        /* tp_alloc */
+    scanner_new,          /* tp_new */
+    0,/* PyObject_GC_Del, */              /* tp_free */
+};
+
+/* The stream scanner accepts a JSON document in arbitrarily split chunks of
+   UTF-8 encoded bytes and hands back each value as soon as its last byte has
+   arrived.  Input is kept only from the start of the value being read, so a
+   stream of many values, such as newline delimited JSON, is decoded in
+   memory bounded by its largest value.
+
+   With a depth of zero the stream is a sequence of whitespace separated
+   top-level values.  With a depth of N the arrays and objects nested less
+   than N levels deep are tokenized here instead, and each value found below
+   them at depth N (or any scalar found above it) is handed back as a
+   (path, value) pair, where path is a tuple of the object keys and array
+   indices leading to the value.  This lets a single huge array or object be
+   read one element at a time. */
+
+#define STREAM_EXPECT_VALUE 0
+#define STREAM_EXPECT_KEY 1
+#define STREAM_EXPECT_COLON 2
+#define STREAM_EXPECT_COMMA 3
+
+typedef struct {
+    char kind;                  /* '{' or '[' */
+    char expect;                /* STREAM_EXPECT_* */
+    Py_ssize_t index;           /* number of members read so far */
+    Py_ssize_t start;           /* stream offset of the opening bracket */
+    PyObject *key;              /* key of the member being read, or NULL */
+} StreamLevel;
+
+typedef struct _PyStreamScannerObject {
+    PyObject_HEAD
+    PyScannerObject *scanner;
+    char *buf;                  /* unconsumed input */
+    Py_ssize_t len;
+    Py_ssize_t allocated;
+    Py_ssize_t pos;             /* where scanning resumes in buf */
+    Py_ssize_t consumed;        /* stream offset of buf[0] */
+    Py_ssize_t value_start;     /* start in buf of a partial value, or -1 */
+    Py_ssize_t value_depth;     /* bracket nesting inside that value */
+    int in_string;
+    int escape;
+    int scalar;                 /* the partial value is a bare scalar */
+    Py_ssize_t depth;
+    Py_ssize_t nlevels;
+    StreamLevel *levels;
+} PyStreamScannerObject;
+
+static PyTypeObject PyStreamScannerType;
+
+#define PyStreamScanner_Check(op) PyObject_TypeCheck(op, &PyStreamScannerType)
+
+static PyMemberDef stream_scanner_members[] = {
+    {"depth", T_PYSSIZET, offsetof(PyStreamScannerObject, depth), READONLY, "depth"},
+    {NULL}
+};
+
+static void
+stream_scanner_reset(PyStreamScannerObject *s)
+{
+    /* Forget all input and position state, ready for a new stream */
+    while (s->nlevels > 0) {
+        s->nlevels--;
+        Py_CLEAR(s->levels[s->nlevels].key);
+    }
+    s->len = 0;
+    s->pos = 0;
+    s->consumed = 0;
+    s->value_start = -1;
+    s->value_depth = 0;
+    s->in_string = 0;
+    s->escape = 0;
+    s->scalar = 0;
+}
+
+static void
+stream_scanner_error(PyStreamScannerObject *s, char *msg, Py_ssize_t pos)
+{
+    PyErr_Format(PyExc_ValueError, "%s: byte %zd", msg, s->consumed + pos);
+}
+
+static int
+stream_scanner_pop(PyStreamScannerObject *s)
+{
+    /* Close the innermost tokenized array or object */
+    s->nlevels--;
+    Py_CLEAR(s->levels[s->nlevels].key);
+    if (s->nlevels > 0) {
+        StreamLevel *parent = &s->levels[s->nlevels - 1];
+        parent->expect = STREAM_EXPECT_COMMA;
+        parent->index++;
+        Py_CLEAR(parent->key);
+    }
+    return 0;
+}
+
+static PyObject *
+stream_scanner_path(PyStreamScannerObject *s)
+{
+    /* Return the tuple of keys and indices leading to the current value */
+    Py_ssize_t i;
+    PyObject *path = PyTuple_New(s->nlevels);
+    if (path == NULL)
+        return NULL;
+    for (i = 0; i < s->nlevels; i++) {
+        StreamLevel *level = &s->levels[i];
+        PyObject *item;
+        if (level->kind == '{') {
+            item = level->key;
+            Py_INCREF(item);
+        }
+        else {
+            item = PyLong_FromSsize_t(level->index);
+            if (item == NULL) {
+                Py_DECREF(path);
+                return NULL;
+            }
+        }
+        PyTuple_SET_ITEM(path, i, item);
+    }
+    return path;
+}
+
+static int
+stream_scanner_emit(PyStreamScannerObject *s, Py_ssize_t end, PyObject *rval)
+{
+    /* Decode the value in buf[value_start:end] and append it to rval */
+    const char *str = s->buf + s->value_start;
+    Py_ssize_t len = end - s->value_start;
+    Py_ssize_t next_idx = -1;
+    PyObject *val;
+    int res;
+
+    val = scan_once_utf8(s->scanner, str, len, 0, &next_idx);
+    PyDict_Clear(s->scanner->memo);
+    if (val == NULL) {
+        if (PyErr_ExceptionMatches(PyExc_StopIteration)) {
+            PyErr_Clear();
+            raise_errmsg_utf8("Expecting value", str, len, 0);
+        }
+        return -1;
+    }
+    if (next_idx != len) {
+        Py_DECREF(val);
+        raise_errmsg_utf8("Extra data", str, len, next_idx);
+        return -1;
+    }
+    if (s->depth > 0) {
+        PyObject *path = stream_scanner_path(s);
+        PyObject *item;
+        if (path == NULL) {
+            Py_DECREF(val);
+            return -1;
+        }
+        item = PyTuple_Pack(2, path, val);
+        Py_DECREF(path);
+        Py_DECREF(val);
+        if (item == NULL)
+            return -1;
+        val = item;
+    }
+    res = PyList_Append(rval, val);
+    Py_DECREF(val);
+    if (res < 0)
+        return -1;
+
+    s->value_start = -1;
+    s->pos = end;
+    if (s->nlevels > 0) {
+        StreamLevel *level = &s->levels[s->nlevels - 1];
+        level->expect = STREAM_EXPECT_COMMA;
+        level->index++;
+        Py_CLEAR(level->key);
+    }
+    return 0;
+}
+
+static Py_ssize_t
+stream_scanner_find_end(PyStreamScannerObject *s, int final)
+{
+    /* Continue scanning the partial value for its end.  Return the index
+       after its last byte, or -1 if it isn't complete yet. */
+    const char *buf = s->buf;
+    Py_ssize_t len = s->len;
+    Py_ssize_t idx = s->pos;
+
+    if (s->scalar) {
+        for (; idx < len; idx++) {
+            switch (buf[idx]) {
+                case ' ': case '\t': case '\n': case '\r':
+                case ',': case ':': case '"':
+                case '[': case ']': case '{': case '}':
+                    return idx;
+            }
+        }
+        s->pos = idx;
+        return final ? idx : -1;
+    }
+    while (idx < len) {
+        char c = buf[idx++];
+        if (s->in_string) {
+            if (s->escape) {
+                s->escape = 0;
+                continue;
+            }
+            /* Skip over the plain content of the string */
+            while (c != '"' && c != '\\' && idx < len)
+                c = buf[idx++];
+            if (c == '\\')
+                s->escape = 1;
+            else if (c == '"') {
+                s->in_string = 0;
+                if (s->value_depth == 0)
+                    return idx;
+            }
+        }
+        else if (c == '"')
+            s->in_string = 1;
+        else if (c == '{' || c == '[')
+            s->value_depth++;
+        else if (c == '}' || c == ']') {
+            if (--s->value_depth == 0)
+                return idx;
+        }
+    }
+    s->pos = idx;
+    return -1;
+}
+
+static int
+stream_scanner_scan(PyStreamScannerObject *s, int final, PyObject *rval)
+{
+    /* Decode everything that is complete in the buffer, appending the
+       values to rval */
+    const char *buf = s->buf;
+    Py_ssize_t len = s->len;
+
+    while (1) {
+        StreamLevel *level;
+        Py_ssize_t idx;
+        char c;
+        int expect;
+
+        if (s->value_start >= 0) {
+            Py_ssize_t end = stream_scanner_find_end(s, final);
+            if (end < 0)
+                return 0;
+            if (stream_scanner_emit(s, end, rval) < 0)
+                return -1;
+            continue;
+        }
+
+        idx = s->pos;
+        while (idx < len && IS_WHITESPACE(buf[idx])) idx++;
+        s->pos = idx;
+        if (idx == len)
+            return 0;
+        c = buf[idx];
+        level = s->nlevels > 0 ? &s->levels[s->nlevels - 1] : NULL;
+        expect = level != NULL ? level->expect : STREAM_EXPECT_VALUE;
+
+        switch (expect) {
+            case STREAM_EXPECT_VALUE:
+                if (c == ']' && level != NULL && level->kind == '[' &&
+                    level->index == 0) {
+                    stream_scanner_pop(s);
+                    s->pos = idx + 1;
+                }
+                else if ((c == '{' || c == '[') && s->nlevels < s->depth) {
+                    level = &s->levels[s->nlevels++];
+                    level->kind = c;
+                    level->expect = (c == '{') ? STREAM_EXPECT_KEY
+                                               : STREAM_EXPECT_VALUE;
+                    level->index = 0;
+                    level->start = s->consumed + idx;
+                    level->key = NULL;
+                    s->pos = idx + 1;
+                }
+                else if (c == ',' || c == ':' || c == ']' || c == '}') {
+                    stream_scanner_error(s, "Expecting value", idx);
+                    return -1;
+                }
+                else {
+                    s->value_start = idx;
+                    s->value_depth = 0;
+                    s->in_string = 0;
+                    s->escape = 0;
+                    s->scalar = (c != '"' && c != '{' && c != '[');
+                    s->pos = s->scalar ? idx + 1 : idx;
+                }
+                break;
+            case STREAM_EXPECT_KEY:
+                if (c == '}' && level->index == 0) {
+                    stream_scanner_pop(s);
+                    s->pos = idx + 1;
+                }
+                else if (c == '"') {
+                    /* Wait until the whole key has arrived */
+                    Py_ssize_t end = idx + 1;
+                    Py_ssize_t next_idx;
+                    PyObject *key;
+                    while (end < len && buf[end] != '"')
+                        end += (buf[end] == '\\') ? 2 : 1;
+                    if (end >= len)
+                        return 0;
+                    key = _scan_key_utf8(s->scanner, buf, len, idx + 1,
+                                         PyObject_IsTrue(s->scanner->strict),
+                                         &next_idx);
+                    if (key == NULL)
+                        return -1;
+                    Py_XDECREF(level->key);
+                    level->key = key;
+                    level->expect = STREAM_EXPECT_COLON;
+                    s->pos = next_idx;
+                }
+                else {
+                    stream_scanner_error(s, "Expecting property name "
+                                         "enclosed in double quotes", idx);
+                    return -1;
+                }
+                break;
+            case STREAM_EXPECT_COLON:
+                if (c != ':') {
+                    stream_scanner_error(s, "Expecting ':' delimiter", idx);
+                    return -1;
+                }
+                level->expect = STREAM_EXPECT_VALUE;
+                s->pos = idx + 1;
+                break;
+            case STREAM_EXPECT_COMMA:
+                if (c == ',') {
+                    level->expect = (level->kind == '{') ? STREAM_EXPECT_KEY
+                                                         : STREAM_EXPECT_VALUE;
+                    s->pos = idx + 1;
+                }
+                else if (c == (level->kind == '{' ? '}' : ']')) {
+                    stream_scanner_pop(s);
+                    s->pos = idx + 1;
+                }
+                else {
+                    stream_scanner_error(s, "Expecting ',' delimiter", idx);
+                    return -1;
+                }
+                break;
+        }
+    }
+}
+
+static int
+stream_scanner_append(PyStreamScannerObject *s, const char *data, Py_ssize_t n)
+{
+    /* Drop the consumed part of the buffer and append n bytes of data */
+    Py_ssize_t live = s->value_start >= 0 ? s->value_start : s->pos;
+
+    /* Moving the live bytes down is only worth it once the dead prefix is
+       at least as long, which keeps the cost linear in the input size */
+    if (live > 0 && (live >= s->len - live || s->len + n > s->allocated)) {
+        memmove(s->buf, s->buf + live, s->len - live);
+        s->len -= live;
+        s->pos -= live;
+        if (s->value_start >= 0)
+            s->value_start -= live;
+        s->consumed += live;
+    }
+    if (s->len + n > s->allocated) {
+        Py_ssize_t newsize = s->allocated * 2;
+        char *newbuf;
+        if (n > PY_SSIZE_T_MAX - s->len) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        if (newsize < s->len + n)
+            newsize = s->len + n;
+        newbuf = PyMem_Realloc(s->buf, newsize);
+        if (newbuf == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        s->buf = newbuf;
+        s->allocated = newsize;
+    }
+    memcpy(s->buf + s->len, data, n);
+    s->len += n;
+    return 0;
+}
+
+PyDoc_STRVAR(stream_scanner_feed_doc,
+"feed(data) -> list\n\
+\n\
+Add a chunk of UTF-8 encoded JSON and return the values it completed.");
+
+static PyObject *
+stream_scanner_feed(PyStreamScannerObject *s, PyObject *args)
+{
+    Py_buffer data;
+    PyObject *rval;
+
+    if (!PyArg_ParseTuple(args, "y*:feed", &data))
+        return NULL;
+    if (stream_scanner_append(s, data.buf, data.len) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    PyBuffer_Release(&data);
+
+    rval = PyList_New(0);
+    if (rval == NULL)
+        return NULL;
+    if (stream_scanner_scan(s, 0, rval) < 0) {
+        stream_scanner_reset(s);
+        Py_DECREF(rval);
+        return NULL;
+    }
+    return rval;
+}
+
+PyDoc_STRVAR(stream_scanner_close_doc,
+"close() -> list\n\
+\n\
+Signal the end of the stream and return the values still pending.\n\
+Raise ValueError if the stream ends inside a value.  The scanner is\n\
+ready for a new stream afterwards.");
+
+static PyObject *
+stream_scanner_close(PyStreamScannerObject *s)
+{
+    PyObject *rval = PyList_New(0);
+    if (rval == NULL)
+        return NULL;
+    if (stream_scanner_scan(s, 1, rval) < 0)
+        goto bail;
+    if (s->value_start >= 0) {
+        /* Decoding the partial value gives the most precise error */
+        Py_ssize_t end = s->len;
+        if (stream_scanner_emit(s, end, rval) == 0)
+            stream_scanner_error(s, "Unterminated value", end);
+        goto bail;
+    }
+    if (s->nlevels > 0) {
+        StreamLevel *level = &s->levels[s->nlevels - 1];
+        PyErr_Format(PyExc_ValueError, "Unterminated %s starting at: byte %zd",
+                     level->kind == '{' ? "object" : "array", level->start);
+        goto bail;
+    }
+    stream_scanner_reset(s);
+    return rval;
+bail:
+    stream_scanner_reset(s);
+    Py_DECREF(rval);
+    return NULL;
+}
+
+static PyMethodDef stream_scanner_methods[] = {
+    {"feed", (PyCFunction)stream_scanner_feed, METH_VARARGS,
+        stream_scanner_feed_doc},
+    {"close", (PyCFunction)stream_scanner_close, METH_NOARGS,
+        stream_scanner_close_doc},
+    {NULL, NULL}
+};
+
+static PyObject *
+stream_scanner_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyStreamScannerObject *s;
+    s = (PyStreamScannerObject *)type->tp_alloc(type, 0);
+    if (s != NULL) {
+        s->scanner = NULL;
+        s->buf = NULL;
+        s->len = s->allocated = 0;
+        s->levels = NULL;
+        s->nlevels = 0;
+        s->depth = 0;
+        stream_scanner_reset(s);
+    }
+    return (PyObject *)s;
+}
+
+static int
+stream_scanner_init(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    /* Initialize StreamScanner object */
+    PyObject *ctx;
+    PyObject *scanner;
+    Py_ssize_t depth = 0;
+    static char *kwlist[] = {"context", "depth", NULL};
+    PyStreamScannerObject *s;
+
+    assert(PyStreamScanner_Check(self));
+    s = (PyStreamScannerObject *)self;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|n:make_stream_scanner",
+                                     kwlist, &ctx, &depth))
+        return -1;
+    if (depth < 0) {
+        PyErr_SetString(PyExc_ValueError, "depth must not be negative");
+        return -1;
+    }
+
+    scanner = PyObject_CallFunctionObjArgs((PyObject *)&PyScannerType,
+                                           ctx, NULL);
+    if (scanner == NULL)
+        return -1;
+    stream_scanner_reset(s);
+    Py_XDECREF(s->scanner);
+    s->scanner = (PyScannerObject *)scanner;
+    s->scanner->key_cache = PyMem_New(PyObject *, KEY_CACHE_SIZE);
+    if (s->scanner->key_cache == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(s->scanner->key_cache, 0, KEY_CACHE_SIZE * sizeof(PyObject *));
+
+    PyMem_Free(s->levels);
+    s->levels = NULL;
+    s->depth = 0;
+    if (depth > 0) {
+        s->levels = PyMem_New(StreamLevel, depth);
+        if (s->levels == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+    s->depth = depth;
+    return 0;
+}
+
+static int
+stream_scanner_traverse(PyObject *self, visitproc visit, void *arg)
+{
+    PyStreamScannerObject *s;
+    Py_ssize_t i;
+    assert(PyStreamScanner_Check(self));
+    s = (PyStreamScannerObject *)self;
+    Py_VISIT(s->scanner);
+    for (i = 0; i < s->nlevels; i++)
+        Py_VISIT(s->levels[i].key);
+    return 0;
+}
+
+static int
+stream_scanner_clear(PyObject *self)
+{
+    PyStreamScannerObject *s;
+    assert(PyStreamScanner_Check(self));
+    s = (PyStreamScannerObject *)self;
+    stream_scanner_reset(s);
+    Py_CLEAR(s->scanner);
+    return 0;
+}
+
+static void
+stream_scanner_dealloc(PyObject *self)
+{
+    /* Deallocate stream scanner object */
+    PyStreamScannerObject *s = (PyStreamScannerObject *)self;
+    PyObject_GC_UnTrack(self);
+    stream_scanner_clear(self);
+    PyMem_Free(s->buf);
+    PyMem_Free(s->levels);
+    Py_TYPE(self)->tp_free(self);
+}
+
+PyDoc_STRVAR(stream_scanner_doc,
+"make_stream_scanner(context, depth=0)\n\
+\n\
+Incremental JSON scanner over chunks of UTF-8 encoded bytes.");
+
+static
+PyTypeObject PyStreamScannerType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_json.StreamScanner",       /* tp_name */
+    sizeof(PyStreamScannerObject), /* tp_basicsize */
     0,                    /* tp_itemsize */
-    scanner_dealloc, /* tp_dealloc */
+    stream_scanner_dealloc, /* tp_dealloc */
     0,                    /* tp_print */
     0,                    /* tp_getattr */
     0,                    /* tp_setattr */
@@ -1182,31 +2540,31 @@ PyTypeObject PyScannerType = {
     0,                    /* tp_as_sequence */
     0,                    /* tp_as_mapping */
     0,                    /* tp_hash */
-    scanner_call,         /* tp_call */
+    0,                    /* tp_call */
     0,                    /* tp_str */
-    0,/* PyObject_GenericGetAttr, */                    /* tp_getattro */
-    0,/* PyObject_GenericSetAttr, */                    /* tp_setattro */
+    0,                    /* tp_getattro */
+    0,                    /* tp_setattro */
     0,                    /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,   /* tp_flags */
-    scanner_doc,          /* tp_doc */
-    scanner_traverse,                    /* tp_traverse */
-    scanner_clear,                    /* tp_clear */
+    stream_scanner_doc,   /* tp_doc */
+    stream_scanner_traverse,                    /* tp_traverse */
+    stream_scanner_clear,                    /* tp_clear */
     0,                    /* tp_richcompare */
     0,                    /* tp_weaklistoffset */
     0,                    /* tp_iter */
     0,                    /* tp_iternext */
-    0,                    /* tp_methods */
-    scanner_members,                    /* tp_members */
+    stream_scanner_methods,                    /* tp_methods */
+    stream_scanner_members,                    /* tp_members */
     0,                    /* tp_getset */
     0,                    /* tp_base */
     0,                    /* tp_dict */
     0,                    /* tp_descr_get */
     0,                    /* tp_descr_set */
     0,                    /* tp_dictoffset */
-    scanner_init,                    /* tp_init */
-    0,/* PyType_GenericAlloc, */        /* tp_alloc */
-    scanner_new,          /* tp_new */
-    0,/* PyObject_GC_Del, */              /* tp_free */
+    stream_scanner_init,                    /* tp_init */
+    0,                    /* tp_alloc */
+    stream_scanner_new,   /* tp_new */
+    0,                    /* tp_free */
 };
 
 static PyObject *
@@ -1254,6 +2612,7 @@ encoder_init(PyObject *self, PyObject *args, PyObject *kwds)
     s->sort_keys = sort_keys;
     s->skipkeys = skipkeys;
     s->fast_encode = (PyCFunction_Check(s->encoder) && PyCFunction_GetFunction(s->encoder) == (PyCFunction)py_encode_basestring_ascii);
+    s->fast_encode_unicode = (PyCFunction_Check(s->encoder) && PyCFunction_GetFunction(s->encoder) == (PyCFunction)py_encode_basestring);
     s->allow_nan = PyObject_IsTrue(allow_nan);
 
     Py_INCREF(s->markers);
@@ -1355,6 +2714,8 @@ encoder_encode_string(PyEncoderObject *s, PyObject *obj)
     /* Return the JSON representation of a string */
     if (s->fast_encode)
         return py_encode_basestring_ascii(NULL, obj);
+    else if (s->fast_encode_unicode)
+        return py_encode_basestring(NULL, obj);
     else
         return PyObject_CallFunctionObjArgs(s->encoder, obj, NULL);
 }
@@ -1727,6 +3088,576 @@ bail:
     return -1;
 }
 
+/* The functions below encode straight to UTF-8 into a bytes buffer, instead
+   of collecting str fragments to be joined and then encoded.  When given a
+   write callable, the buffer is handed to it every JSON_WRITER_CHUNK_SIZE
+   bytes or so, and a new one is started, so even huge documents need only
+   that much memory. */
+
+#define JSON_WRITER_CHUNK_SIZE (64 * 1024)
+
+typedef struct {
+    PyObject *output;           /* bytes object being filled */
+    Py_ssize_t len;             /* bytes used in output */
+    Py_ssize_t allocated;
+    PyObject *write;            /* where full buffers go, or NULL */
+} JSONWriter;
+
+static int
+_JSONWriter_Flush(JSONWriter *w)
+{
+    /* Pass the buffered bytes to w->write and start a new buffer */
+    PyObject *result;
+
+    if (w->len == 0)
+        return 0;
+    if (_PyBytes_Resize(&w->output, w->len) < 0)
+        return -1;
+    result = PyObject_CallFunctionObjArgs(w->write, w->output, NULL);
+    Py_CLEAR(w->output);
+    w->len = w->allocated = 0;
+    if (result == NULL)
+        return -1;
+    Py_DECREF(result);
+    return 0;
+}
+
+static int
+_JSONWriter_Grow(JSONWriter *w, Py_ssize_t n)
+{
+    /* Make room for n more bytes; only called when they don't fit */
+    Py_ssize_t newsize;
+
+    if (w->write != NULL && _JSONWriter_Flush(w) < 0)
+        return -1;
+    if (n > PY_SSIZE_T_MAX - w->len) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    newsize = w->allocated;
+    if (w->write == NULL && newsize <= PY_SSIZE_T_MAX / 2)
+        newsize *= 2;
+    if (newsize < JSON_WRITER_CHUNK_SIZE)
+        newsize = JSON_WRITER_CHUNK_SIZE;
+    if (newsize < w->len + n)
+        newsize = w->len + n;
+    if (w->output == NULL) {
+        w->output = PyBytes_FromStringAndSize(NULL, newsize);
+        if (w->output == NULL)
+            return -1;
+    }
+    else if (_PyBytes_Resize(&w->output, newsize) < 0)
+        return -1;
+    w->allocated = newsize;
+    return 0;
+}
+
+/* Return a pointer to room for n more bytes in the buffer, or NULL */
+#define _JSONWriter_Reserve(w, n) \
+    (((w)->len + (n) <= (w)->allocated || _JSONWriter_Grow((w), (n)) == 0) ? \
+     PyBytes_AS_STRING((w)->output) + (w)->len : NULL)
+
+static int
+_JSONWriter_WriteBytes(JSONWriter *w, const char *data, Py_ssize_t n)
+{
+    char *p = _JSONWriter_Reserve(w, n);
+    if (p == NULL)
+        return -1;
+    memcpy(p, data, n);
+    w->len += n;
+    return 0;
+}
+
+static int
+_JSONWriter_WriteStr(JSONWriter *w, PyObject *str)
+{
+    /* Write the str as it is, encoded to UTF-8 */
+    PyObject *utf8;
+    int rv;
+
+    if (PyUnicode_READY(str) < 0)
+        return -1;
+    if (PyUnicode_IS_ASCII(str))
+        return _JSONWriter_WriteBytes(w, (char *)PyUnicode_1BYTE_DATA(str),
+                                      PyUnicode_GET_LENGTH(str));
+    /* Don't cache the UTF-8 form in str, it would be used only once */
+    utf8 = PyUnicode_AsUTF8String(str);
+    if (utf8 == NULL)
+        return -1;
+    rv = _JSONWriter_WriteBytes(w, PyBytes_AS_STRING(utf8),
+                                PyBytes_GET_SIZE(utf8));
+    Py_DECREF(utf8);
+    return rv;
+}
+
+static int
+_JSONWriter_WriteStolenStr(JSONWriter *w, PyObject *stolen)
+{
+    /* Write stolen and then decrement its reference count */
+    int rv;
+    if (stolen == NULL)
+        return -1;
+    rv = _JSONWriter_WriteStr(w, stolen);
+    Py_DECREF(stolen);
+    return rv;
+}
+
+/* Number of characters escaped per buffer reservation, so that a huge
+   string doesn't need room for its worst case expansion all at once */
+#define JSON_WRITER_STRING_BLOCK 1024
+
+static int
+encoder_write_string(PyEncoderObject *s, JSONWriter *w, PyObject *pystr)
+{
+    /* Write the JSON representation of a str in a single pass over it */
+    Py_ssize_t i, end, len;
+    void *input;
+    int kind;
+    int ascii_only = s->fast_encode;
+    char *p;
+
+    if (!s->fast_encode && !s->fast_encode_unicode)
+        return _JSONWriter_WriteStolenStr(
+            w, PyObject_CallFunctionObjArgs(s->encoder, pystr, NULL));
+    if (PyUnicode_READY(pystr) < 0)
+        return -1;
+    len = PyUnicode_GET_LENGTH(pystr);
+    input = PyUnicode_DATA(pystr);
+    kind = PyUnicode_KIND(pystr);
+
+    if (_JSONWriter_WriteBytes(w, "\"", 1) < 0)
+        return -1;
+    for (i = 0; i < len; i = end) {
+        end = Py_MIN(len, i + JSON_WRITER_STRING_BLOCK);
+        /* At most 12 bytes per code point, for an escaped surrogate pair */
+        p = _JSONWriter_Reserve(w, (end - i) * 12);
+        if (p == NULL)
+            return -1;
+        for (; i < end; i++) {
+            Py_UCS4 c = PyUnicode_READ(kind, input, i);
+            if (S_CHAR(c)) {
+                *p++ = (char)c;
+            }
+            else if (c < 0x80 || ascii_only) {
+                if (c == 0x7f && !ascii_only)
+                    *p++ = (char)c;
+                else {
+                    unsigned char *start = (unsigned char *)p;
+                    p += ascii_escape_unichar(c, start, 0);
+                }
+            }
+            else if (c < 0x800) {
+                *p++ = (char)(0xc0 | (c >> 6));
+                *p++ = (char)(0x80 | (c & 0x3f));
+            }
+            else if (c < 0x10000) {
+                if (Py_UNICODE_IS_SURROGATE(c)) {
+                    /* Let the codec raise its UnicodeEncodeError */
+                    Py_XDECREF(PyUnicode_AsUTF8String(pystr));
+                    return -1;
+                }
+                *p++ = (char)(0xe0 | (c >> 12));
+                *p++ = (char)(0x80 | ((c >> 6) & 0x3f));
+                *p++ = (char)(0x80 | (c & 0x3f));
+            }
+            else {
+                *p++ = (char)(0xf0 | (c >> 18));
+                *p++ = (char)(0x80 | ((c >> 12) & 0x3f));
+                *p++ = (char)(0x80 | ((c >> 6) & 0x3f));
+                *p++ = (char)(0x80 | (c & 0x3f));
+            }
+        }
+        w->len = p - PyBytes_AS_STRING(w->output);
+    }
+    return _JSONWriter_WriteBytes(w, "\"", 1);
+}
+
+static int
+encoder_write_long(JSONWriter *w, PyObject *obj)
+{
+    /* Write an int, without a detour through str when it fits a C long */
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    unsigned long u;
+    long x;
+    int overflow;
+
+    if (!PyLong_CheckExact(obj))
+        return _JSONWriter_WriteStolenStr(w, PyObject_Str(obj));
+    x = PyLong_AsLongAndOverflow(obj, &overflow);
+    if (overflow)
+        return _JSONWriter_WriteStolenStr(w, PyObject_Str(obj));
+    if (x == -1 && PyErr_Occurred())
+        return -1;
+    u = x < 0 ? (unsigned long)0 - (unsigned long)x : (unsigned long)x;
+    do {
+        *--p = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (x < 0)
+        *--p = '-';
+    return _JSONWriter_WriteBytes(w, p, digits + sizeof(digits) - p);
+}
+
+static int
+encoder_write_float(PyEncoderObject *s, JSONWriter *w, PyObject *obj)
+{
+    /* Write a float the way float.__repr__ spells it */
+    double d = PyFloat_AS_DOUBLE(obj);
+    char *buf;
+    int rv;
+
+    if (!PyFloat_CheckExact(obj) || !Py_IS_FINITE(d))
+        return _JSONWriter_WriteStolenStr(w, encoder_encode_float(s, obj));
+    buf = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+    if (buf == NULL)
+        return -1;
+    rv = _JSONWriter_WriteBytes(w, buf, strlen(buf));
+    PyMem_Free(buf);
+    return rv;
+}
+
+static int
+encoder_write_markers_enter(PyEncoderObject *s, PyObject *obj,
+                            PyObject **ident_ptr)
+{
+    /* Record obj in s->markers, failing if it is being encoded already */
+    int has_key;
+    PyObject *ident;
+
+    *ident_ptr = NULL;
+    if (s->markers == Py_None)
+        return 0;
+    ident = PyLong_FromVoidPtr(obj);
+    if (ident == NULL)
+        return -1;
+    has_key = PyDict_Contains(s->markers, ident);
+    if (has_key) {
+        if (has_key != -1)
+            PyErr_SetString(PyExc_ValueError, "Circular reference detected");
+        Py_DECREF(ident);
+        return -1;
+    }
+    if (PyDict_SetItem(s->markers, ident, obj)) {
+        Py_DECREF(ident);
+        return -1;
+    }
+    *ident_ptr = ident;
+    return 0;
+}
+
+static int
+encoder_write_markers_leave(PyEncoderObject *s, PyObject *ident)
+{
+    int rv = 0;
+    if (ident != NULL) {
+        rv = PyDict_DelItem(s->markers, ident);
+        Py_DECREF(ident);
+    }
+    return rv;
+}
+
+static int
+encoder_write_obj(PyEncoderObject *s, JSONWriter *w, PyObject *obj);
+
+static PyObject *
+encoder_dict_key(PyEncoderObject *s, PyObject *key)
+{
+    /* Return the str a dict key is written as, Py_None if the skipkeys
+       option drops it, or NULL on error */
+    if (PyUnicode_Check(key)) {
+        Py_INCREF(key);
+        return key;
+    }
+    else if (PyFloat_Check(key)) {
+        return encoder_encode_float(s, key);
+    }
+    else if (key == Py_True || key == Py_False || key == Py_None) {
+        /* This must come before the PyLong_Check because
+           True and False are also 1 and 0.*/
+        return _encoded_const(key);
+    }
+    else if (PyLong_Check(key)) {
+        return PyObject_Str(key);
+    }
+    else if (PyObject_IsTrue(s->skipkeys)) {
+        Py_RETURN_NONE;
+    }
+    /* TODO: include repr of key */
+    PyErr_SetString(PyExc_TypeError, "keys must be a string");
+    return NULL;
+}
+
+static int
+encoder_write_item(PyEncoderObject *s, JSONWriter *w, PyObject *key,
+                   PyObject *value, Py_ssize_t *idx_ptr)
+{
+    /* Write one key: value member of an object, after the item separator
+       unless it is the first one */
+    PyObject *kstr = encoder_dict_key(s, key);
+    int rv;
+
+    if (kstr == NULL)
+        return -1;
+    if (kstr == Py_None) {
+        Py_DECREF(kstr);
+        return 0;
+    }
+    if (*idx_ptr && _JSONWriter_WriteStr(w, s->item_separator) < 0) {
+        Py_DECREF(kstr);
+        return -1;
+    }
+    rv = encoder_write_string(s, w, kstr);
+    Py_DECREF(kstr);
+    if (rv < 0 || _JSONWriter_WriteStr(w, s->key_separator) < 0)
+        return -1;
+    if (encoder_write_obj(s, w, value) < 0)
+        return -1;
+    (*idx_ptr)++;
+    return 0;
+}
+
+static int
+encoder_write_dict(PyEncoderObject *s, JSONWriter *w, PyObject *dct)
+{
+    /* Write a dict as a JSON object */
+    PyObject *ident = NULL;
+    PyObject *items = NULL;
+    PyObject *it = NULL;
+    PyObject *item = NULL;
+    Py_ssize_t idx = 0;
+
+    if (PyDict_Size(dct) == 0)
+        return _JSONWriter_WriteBytes(w, "{}", 2);
+    if (encoder_write_markers_enter(s, dct, &ident) < 0)
+        return -1;
+    if (_JSONWriter_WriteBytes(w, "{", 1) < 0)
+        goto bail;
+
+    if (PyDict_CheckExact(dct) && !PyObject_IsTrue(s->sort_keys)) {
+        /* Walk the dict in place rather than through an items list */
+        Py_ssize_t pos = 0;
+        Py_ssize_t size = PyDict_Size(dct);
+        PyObject *key, *value;
+
+        while (PyDict_Next(dct, &pos, &key, &value)) {
+            int rv;
+            Py_INCREF(key);
+            Py_INCREF(value);
+            rv = encoder_write_item(s, w, key, value, &idx);
+            Py_DECREF(key);
+            Py_DECREF(value);
+            if (rv < 0)
+                goto bail;
+            if (PyDict_Size(dct) != size) {
+                PyErr_SetString(PyExc_RuntimeError,
+                                "dictionary changed size during iteration");
+                goto bail;
+            }
+        }
+    }
+    else {
+        if (PyObject_IsTrue(s->sort_keys)) {
+            items = PyMapping_Keys(dct);
+            if (items == NULL)
+                goto bail;
+            if (!PyList_Check(items)) {
+                PyErr_SetString(PyExc_ValueError, "keys must return list");
+                goto bail;
+            }
+            if (PyList_Sort(items) < 0)
+                goto bail;
+        }
+        else {
+            items = PyMapping_Items(dct);
+            if (items == NULL)
+                goto bail;
+        }
+        it = PyObject_GetIter(items);
+        if (it == NULL)
+            goto bail;
+        while ((item = PyIter_Next(it)) != NULL) {
+            int rv;
+            if (PyObject_IsTrue(s->sort_keys)) {
+                PyObject *value = PyObject_GetItem(dct, item);
+                if (value == NULL)
+                    goto bail;
+                rv = encoder_write_item(s, w, item, value, &idx);
+                Py_DECREF(value);
+            }
+            else if (!PyTuple_Check(item) || Py_SIZE(item) != 2) {
+                PyErr_SetString(PyExc_ValueError,
+                                "items must return 2-tuples");
+                goto bail;
+            }
+            else
+                rv = encoder_write_item(s, w, PyTuple_GET_ITEM(item, 0),
+                                        PyTuple_GET_ITEM(item, 1), &idx);
+            Py_CLEAR(item);
+            if (rv < 0)
+                goto bail;
+        }
+        if (PyErr_Occurred())
+            goto bail;
+        Py_CLEAR(it);
+        Py_CLEAR(items);
+    }
+
+    if (_JSONWriter_WriteBytes(w, "}", 1) < 0)
+        goto bail;
+    return encoder_write_markers_leave(s, ident);
+
+bail:
+    Py_XDECREF(item);
+    Py_XDECREF(it);
+    Py_XDECREF(items);
+    Py_XDECREF(ident);
+    return -1;
+}
+
+static int
+encoder_write_list(PyEncoderObject *s, JSONWriter *w, PyObject *seq)
+{
+    /* Write a list or tuple as a JSON array */
+    PyObject *ident = NULL;
+    Py_ssize_t i;
+
+    if (Py_SIZE(seq) == 0)
+        return _JSONWriter_WriteBytes(w, "[]", 2);
+    if (encoder_write_markers_enter(s, seq, &ident) < 0)
+        return -1;
+    if (_JSONWriter_WriteBytes(w, "[", 1) < 0)
+        goto bail;
+    /* The list may shrink while its items are encoded by default() */
+    for (i = 0; i < Py_SIZE(seq); i++) {
+        PyObject *obj = PyList_Check(seq) ? PyList_GET_ITEM(seq, i)
+                                          : PyTuple_GET_ITEM(seq, i);
+        int rv;
+        if (i && _JSONWriter_WriteStr(w, s->item_separator) < 0)
+            goto bail;
+        Py_INCREF(obj);
+        rv = encoder_write_obj(s, w, obj);
+        Py_DECREF(obj);
+        if (rv < 0)
+            goto bail;
+    }
+    if (_JSONWriter_WriteBytes(w, "]", 1) < 0)
+        goto bail;
+    return encoder_write_markers_leave(s, ident);
+
+bail:
+    Py_XDECREF(ident);
+    return -1;
+}
+
+static int
+encoder_write_obj(PyEncoderObject *s, JSONWriter *w, PyObject *obj)
+{
+    /* Write Python object obj as a JSON term */
+    PyObject *ident, *newobj;
+    int rv;
+
+    /* Exact types first, they are what almost every document is made of */
+    if (PyUnicode_CheckExact(obj))
+        return encoder_write_string(s, w, obj);
+    else if (PyLong_CheckExact(obj))
+        return encoder_write_long(w, obj);
+    else if (PyFloat_CheckExact(obj))
+        return encoder_write_float(s, w, obj);
+    else if (obj == Py_None)
+        return _JSONWriter_WriteBytes(w, "null", 4);
+    else if (obj == Py_True)
+        return _JSONWriter_WriteBytes(w, "true", 4);
+    else if (obj == Py_False)
+        return _JSONWriter_WriteBytes(w, "false", 5);
+    else if (PyUnicode_Check(obj))
+        return encoder_write_string(s, w, obj);
+    else if (PyLong_Check(obj))
+        return encoder_write_long(w, obj);
+    else if (PyFloat_Check(obj))
+        return encoder_write_float(s, w, obj);
+    else if (PyList_Check(obj) || PyTuple_Check(obj)) {
+        if (Py_EnterRecursiveCall(" while encoding a JSON object"))
+            return -1;
+        rv = encoder_write_list(s, w, obj);
+        Py_LeaveRecursiveCall();
+        return rv;
+    }
+    else if (PyDict_Check(obj)) {
+        if (Py_EnterRecursiveCall(" while encoding a JSON object"))
+            return -1;
+        rv = encoder_write_dict(s, w, obj);
+        Py_LeaveRecursiveCall();
+        return rv;
+    }
+
+    if (encoder_write_markers_enter(s, obj, &ident) < 0)
+        return -1;
+    newobj = PyObject_CallFunctionObjArgs(s->defaultfn, obj, NULL);
+    if (newobj == NULL) {
+        Py_XDECREF(ident);
+        return -1;
+    }
+    if (Py_EnterRecursiveCall(" while encoding a JSON object")) {
+        Py_DECREF(newobj);
+        Py_XDECREF(ident);
+        return -1;
+    }
+    rv = encoder_write_obj(s, w, newobj);
+    Py_LeaveRecursiveCall();
+    Py_DECREF(newobj);
+    if (rv) {
+        Py_XDECREF(ident);
+        return -1;
+    }
+    return encoder_write_markers_leave(s, ident);
+}
+
+PyDoc_STRVAR(encoder_encode_utf8_doc,
+"encode_utf8(obj, write=None) -> bytes or None\n\
+\n\
+Return the JSON representation of obj encoded to UTF-8.  If write is\n\
+given, pass the representation to it in chunks of bytes instead.");
+
+static PyObject *
+encoder_encode_utf8(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"obj", "write", NULL};
+    PyObject *obj;
+    PyObject *write = Py_None;
+    PyEncoderObject *s;
+    JSONWriter w;
+
+    assert(PyEncoder_Check(self));
+    s = (PyEncoderObject *)self;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:encode_utf8", kwlist,
+        &obj, &write))
+        return NULL;
+    w.output = NULL;
+    w.len = w.allocated = 0;
+    w.write = (write != Py_None) ? write : NULL;
+    if (encoder_write_obj(s, &w, obj) < 0 ||
+        (w.write != NULL && _JSONWriter_Flush(&w) < 0)) {
+        Py_XDECREF(w.output);
+        return NULL;
+    }
+    if (w.write != NULL) {
+        Py_XDECREF(w.output);
+        Py_RETURN_NONE;
+    }
+    if (w.output == NULL)
+        return PyBytes_FromStringAndSize(NULL, 0);
+    if (_PyBytes_Resize(&w.output, w.len) < 0)
+        return NULL;
+    return w.output;
+}
+
+static PyMethodDef encoder_methods[] = {
+    {"encode_utf8", (PyCFunction)encoder_encode_utf8,
+        METH_VARARGS | METH_KEYWORDS, encoder_encode_utf8_doc},
+    {NULL, NULL}
+};
+
 static void
 encoder_dealloc(PyObject *self)
 {
@@ -1801,7 +3732,7 @@ PyTypeObject PyEncoderType = {
     0,                    /* tp_weaklistoffset */
     0,                    /* tp_iter */
     0,                    /* tp_iternext */
-    0,                    /* tp_methods */
+    encoder_methods,      /* tp_methods */
     encoder_members,      /* tp_members */
     0,                    /* tp_getset */
     0,                    /* tp_base */
@@ -1820,6 +3751,10 @@ static PyMethodDef speedups_methods[] = {
         (PyCFunction)py_encode_basestring_ascii,
         METH_O,
         pydoc_encode_basestring_ascii},
+    {"encode_basestring",
+        (PyCFunction)py_encode_basestring,
+        METH_O,
+        pydoc_encode_basestring},
     {"scanstring",
         (PyCFunction)py_scanstring,
         METH_VARARGS,
@@ -1854,6 +3789,8 @@ PyInit__json(void)
     PyEncoderType.tp_new = PyType_GenericNew;
     if (PyType_Ready(&PyEncoderType) < 0)
         goto fail;
+    if (PyType_Ready(&PyStreamScannerType) < 0)
+        goto fail;
     Py_INCREF((PyObject*)&PyScannerType);
     if (PyModule_AddObject(m, "make_scanner", (PyObject*)&PyScannerType) < 0) {
         Py_DECREF((PyObject*)&PyScannerType);
@@ -1864,6 +3801,11 @@ PyInit__json(void)
         Py_DECREF((PyObject*)&PyEncoderType);
         goto fail;
     }
+    Py_INCREF((PyObject*)&PyStreamScannerType);
+    if (PyModule_AddObject(m, "make_stream_scanner", (PyObject*)&PyStreamScannerType) < 0) {
+        Py_DECREF((PyObject*)&PyStreamScannerType);
+        goto fail;
+    }
     return m;
   fail:
     Py_DECREF(m);
@@ -63,7 +63,11 @@ typedef struct {
     lzma_stream lzs;
     int check;
     char eof;
+    char needs_input;
     PyObject *unused_data;
+    /* Input held back by decompress_into() when its buffer filled up. */
+    uint8_t *input_buffer;
+    size_t input_len;
 #ifdef WITH_THREAD
     PyThread_type_lock lock;
 #endif
@@ -796,12 +800,44 @@ static PyTypeObject Compressor_type = {
 
 /* LZMADecompressor class. */
 
+/* If input is held back from an earlier decompress_into(), append the new
+   data to it and point *data and *len at the whole. */
+static int
+append_held_input(Decompressor *d, uint8_t **data, size_t *len)
+{
+    uint8_t *buf;
+
+    if (d->input_len == 0)
+        return 0;
+    if (*len > 0) {
+        if (*len > PY_SSIZE_T_MAX - d->input_len) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        buf = PyMem_Realloc(d->input_buffer, d->input_len + *len);
+        if (buf == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        memcpy(buf + d->input_len, *data, *len);
+        d->input_buffer = buf;
+        d->input_len += *len;
+    }
+    *data = d->input_buffer;
+    *len = d->input_len;
+    return 0;
+}
+
 static PyObject *
 decompress(Decompressor *d, uint8_t *data, size_t len)
 {
     size_t data_size = 0;
     PyObject *result;
 
+    if (append_held_input(d, &data, &len) < 0)
+        return NULL;
+    /* All of the input is used up below, held or not. */
+    d->input_len = 0;
     result = PyBytes_FromStringAndSize(NULL, INITIAL_BUFFER_SIZE);
     if (result == NULL)
         return NULL;
@@ -830,7 +866,9 @@ decompress(Decompressor *d, uint8_t *data, size_t len)
                     goto error;
             }
             break;
-        } else if (d->lzs.avail_in == 0) {
+        } else if (d->lzs.avail_in == 0 && d->lzs.avail_out != 0) {
+            /* A full output buffer may leave output inside the decoder,
+               e.g. after decompress_into(); keep going until it drains. */
             break;
         } else if (d->lzs.avail_out == 0) {
             if (grow_buffer(&result) == -1)
@@ -842,6 +880,7 @@ decompress(Decompressor *d, uint8_t *data, size_t len)
     if (data_size != PyBytes_GET_SIZE(result))
         if (_PyBytes_Resize(&result, data_size) == -1)
             goto error;
+    d->needs_input = !d->eof;
     return result;
 
 error:
@@ -849,6 +888,77 @@ error:
     return NULL;
 }
 
+/* Like decompress(), but write at most outlen bytes to out.  Input left
+   over when out fills up is held back for the next call. */
+static Py_ssize_t
+decompress_into(Decompressor *d, uint8_t *data, size_t len,
+                uint8_t *out, size_t outlen)
+{
+    size_t written;
+    int held;
+    uint8_t *buf;
+
+    if (append_held_input(d, &data, &len) < 0)
+        return -1;
+    held = d->input_len > 0;
+    d->lzs.next_in = data;
+    d->lzs.avail_in = len;
+    d->lzs.next_out = out;
+    d->lzs.avail_out = outlen;
+    for (;;) {
+        lzma_ret lzret;
+
+        Py_BEGIN_ALLOW_THREADS
+        lzret = lzma_code(&d->lzs, LZMA_RUN);
+        Py_END_ALLOW_THREADS
+        if (catch_lzma_error(lzret))
+            return -1;
+        if (lzret == LZMA_GET_CHECK || lzret == LZMA_NO_CHECK)
+            d->check = lzma_get_check(&d->lzs);
+        if (lzret == LZMA_STREAM_END) {
+            d->eof = 1;
+            break;
+        }
+        if (d->lzs.avail_in == 0 || d->lzs.avail_out == 0)
+            break;
+    }
+    written = d->lzs.next_out - out;
+
+    len = d->lzs.avail_in;
+    if (d->eof) {
+        d->needs_input = 0;
+        if (len > 0) {
+            Py_CLEAR(d->unused_data);
+            d->unused_data = PyBytes_FromStringAndSize(
+                    (char *)d->lzs.next_in, len);
+            if (d->unused_data == NULL)
+                return -1;
+        }
+        d->input_len = 0;
+    }
+    else if (len > 0) {
+        if (held)
+            memmove(d->input_buffer, d->lzs.next_in, len);
+        else {
+            buf = PyMem_Realloc(d->input_buffer, len);
+            if (buf == NULL) {
+                PyErr_NoMemory();
+                return -1;
+            }
+            memcpy(buf, d->lzs.next_in, len);
+            d->input_buffer = buf;
+        }
+        d->input_len = len;
+        d->needs_input = 0;
+    }
+    else {
+        d->input_len = 0;
+        /* A full buffer may have left output inside the decoder. */
+        d->needs_input = written < outlen;
+    }
+    return written;
+}
+
 PyDoc_STRVAR(Decompressor_decompress_doc,
 "decompress(data) -> bytes\n"
 "\n"
@@ -878,6 +988,40 @@ Decompressor_decompress(Decompressor *self, PyObject *args)
     return result;
 }
 
+PyDoc_STRVAR(Decompressor_decompress_into_doc,
+"decompress_into(data, buffer) -> int\n"
+"\n"
+"Like decompress(), but write the decompressed data into buffer, a\n"
+"writable object such as a bytearray or memoryview, and return the\n"
+"number of bytes written.\n"
+"\n"
+"If buffer fills up, the rest of data is kept and used by the next\n"
+"call, and needs_input is set to False.  Call again, with b\"\" if there\n"
+"is no new input, until needs_input is True.\n");
+
+static PyObject *
+Decompressor_decompress_into(Decompressor *self, PyObject *args)
+{
+    Py_buffer buffer, out;
+    Py_ssize_t written = -1;
+
+    if (!PyArg_ParseTuple(args, "y*w*:decompress_into", &buffer, &out))
+        return NULL;
+
+    ACQUIRE_LOCK(self);
+    if (self->eof)
+        PyErr_SetString(PyExc_EOFError, "Already at end of stream");
+    else
+        written = decompress_into(self, buffer.buf, buffer.len,
+                                  out.buf, out.len);
+    RELEASE_LOCK(self);
+    PyBuffer_Release(&buffer);
+    PyBuffer_Release(&out);
+    if (written < 0)
+        return NULL;
+    return PyLong_FromSsize_t(written);
+}
+
 static PyObject *
 Decompressor_getstate(Decompressor *self, PyObject *noargs)
 {
@@ -948,6 +1092,7 @@ Decompressor_init(Decompressor *self, PyObject *args, PyObject *kwargs)
 #endif
 
     self->check = LZMA_CHECK_UNKNOWN;
+    self->needs_input = 1;
     self->unused_data = PyBytes_FromStringAndSize(NULL, 0);
     if (self->unused_data == NULL)
         goto error;
@@ -998,6 +1143,7 @@ Decompressor_dealloc(Decompressor *self)
 {
     lzma_end(&self->lzs);
     Py_CLEAR(self->unused_data);
+    PyMem_Free(self->input_buffer);
 #ifdef WITH_THREAD
     if (self->lock != NULL)
         PyThread_free_lock(self->lock);
@@ -1008,6 +1154,8 @@ Decompressor_dealloc(Decompressor *self)
 static PyMethodDef Decompressor_methods[] = {
     {"decompress", (PyCFunction)Decompressor_decompress, METH_VARARGS,
      Decompressor_decompress_doc},
+    {"decompress_into", (PyCFunction)Decompressor_decompress_into,
+     METH_VARARGS, Decompressor_decompress_into_doc},
     {"__getstate__", (PyCFunction)Decompressor_getstate, METH_NOARGS},
     {NULL}
 };
@@ -1021,6 +1169,9 @@ PyDoc_STRVAR(Decompressor_eof_doc,
 PyDoc_STRVAR(Decompressor_unused_data_doc,
 "Data found after the end of the compressed stream.");
 
+PyDoc_STRVAR(Decompressor_needs_input_doc,
+"False if decompress_into() may have more output without new input.");
+
 static PyMemberDef Decompressor_members[] = {
     {"check", T_INT, offsetof(Decompressor, check), READONLY,
      Decompressor_check_doc},
@@ -1028,6 +1179,8 @@ static PyMemberDef Decompressor_members[] = {
      Decompressor_eof_doc},
     {"unused_data", T_OBJECT_EX, offsetof(Decompressor, unused_data), READONLY,
      Decompressor_unused_data_doc},
+    {"needs_input", T_BOOL, offsetof(Decompressor, needs_input), READONLY,
+     Decompressor_needs_input_doc},
     {NULL}
 };
 
@@ -6,7 +6,7 @@ PyDoc_STRVAR(pickle_module_doc,
 
 /* Bump this when new opcodes are added to the pickle protocol. */
 enum {
-    HIGHEST_PROTOCOL = 3,
+    HIGHEST_PROTOCOL = 5,
     DEFAULT_PROTOCOL = 3
 };
 
@@ -71,7 +71,24 @@ enum opcode {
 
     /* Protocol 3 (Python 3.x) */
     BINBYTES       = 'B',
-    SHORT_BINBYTES = 'C'
+    SHORT_BINBYTES = 'C',
+
+    /* Protocol 4 */
+    SHORT_BINUNICODE = '\x8c',
+    BINUNICODE8      = '\x8d',
+    BINBYTES8        = '\x8e',
+    EMPTY_SET        = '\x8f',
+    ADDITEMS         = '\x90',
+    FROZENSET        = '\x91',
+    NEWOBJ_EX        = '\x92',
+    STACK_GLOBAL     = '\x93',
+    MEMOIZE          = '\x94',
+    FRAME            = '\x95',
+
+    /* Protocol 5: out-of-band buffers */
+    BYTEARRAY8       = '\x96',
+    NEXT_BUFFER      = '\x97',
+    READONLY_BUFFER  = '\x98'
 };
 
 /* These aren't opcodes -- they're ways to pickle bools before protocol 2
@@ -103,7 +120,16 @@ enum {
     MAX_WRITE_BUF_SIZE = 64 * 1024,
 
     /* Prefetch size when unpickling (disabled on unpeekable streams) */
-    PREFETCH = 8192 * 16
+    PREFETCH = 8192 * 16,
+
+    /* Protocol 4 frames: the pickler closes the current frame at the first
+       opcode boundary past FRAME_SIZE_TARGET bytes, and drops the header of
+       frames shorter than FRAME_SIZE_MIN.  Payloads of at least
+       FRAME_SIZE_TARGET bytes are written outside of any frame, straight to
+       the output stream. */
+    FRAME_SIZE_MIN = 4,
+    FRAME_SIZE_TARGET = 64 * 1024,
+    FRAME_HEADER_SIZE = 9
 };
 
 /* Exception classes for pickle. These should override the ones defined in
@@ -301,6 +327,196 @@ Pdata_poplist(Pdata *self, Py_ssize_t start)
     return list;
 }
 
+/*************************************************************************
+ PickleBuffer wraps an object exporting the buffer protocol.  With protocol 5,
+ the pickler hands it to the buffer_callback, which may choose to transmit
+ the underlying memory out-of-band instead of copying it into the pickle. */
+
+typedef struct {
+    PyObject_HEAD
+    Py_buffer view;             /* view.obj is NULL once released. */
+    PyObject *weakreflist;
+} PickleBufferObject;
+
+static int
+picklebuf_check_released(PickleBufferObject *self)
+{
+    if (self->view.obj == NULL) {
+        PyErr_SetString(PyExc_ValueError,
+                        "operation forbidden on released PickleBuffer object");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *
+picklebuf_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PickleBufferObject *self;
+    PyObject *base;
+
+    if (!_PyArg_NoKeywords("PickleBuffer", kwds))
+        return NULL;
+    if (!PyArg_UnpackTuple(args, "PickleBuffer", 1, 1, &base))
+        return NULL;
+
+    self = (PickleBufferObject *)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+    self->weakreflist = NULL;
+    if (PyObject_GetBuffer(base, &self->view, PyBUF_FULL_RO) < 0) {
+        self->view.obj = NULL;
+        Py_DECREF(self);
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static void
+picklebuf_dealloc(PickleBufferObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    if (self->weakreflist != NULL)
+        PyObject_ClearWeakRefs((PyObject *)self);
+    if (self->view.obj != NULL)
+        PyBuffer_Release(&self->view);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int
+picklebuf_traverse(PickleBufferObject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->view.obj);
+    return 0;
+}
+
+static int
+picklebuf_clear(PickleBufferObject *self)
+{
+    if (self->view.obj != NULL)
+        PyBuffer_Release(&self->view);
+    return 0;
+}
+
+/* Re-export the wrapped object's buffer, so that consumers get a view
+   whose lifetime is tied to the original exporter. */
+static int
+picklebuf_getbuf(PickleBufferObject *self, Py_buffer *view, int flags)
+{
+    if (self->view.obj == NULL) {
+        PyErr_SetString(PyExc_BufferError,
+                        "operation forbidden on released PickleBuffer object");
+        return -1;
+    }
+    return PyObject_GetBuffer(self->view.obj, view, flags);
+}
+
+static PyBufferProcs picklebuf_as_buffer = {
+    (getbufferproc)picklebuf_getbuf,    /* bf_getbuffer */
+    NULL,                               /* bf_releasebuffer */
+};
+
+PyDoc_STRVAR(picklebuf_raw_doc,
+"raw() -> memoryview. Return a memoryview of the raw memory underlying\n"
+"this buffer, with format 'B'.  Raises BufferError if the buffer is not\n"
+"contiguous.");
+
+static PyObject *
+picklebuf_raw(PickleBufferObject *self)
+{
+    PyObject *m;
+    PyMemoryViewObject *mv;
+
+    if (picklebuf_check_released(self) < 0)
+        return NULL;
+    if (self->view.suboffsets != NULL ||
+        !PyBuffer_IsContiguous(&self->view, 'A')) {
+        PyErr_SetString(PyExc_BufferError,
+                        "cannot extract raw buffer from non-contiguous buffer");
+        return NULL;
+    }
+    m = PyMemoryView_FromObject((PyObject *)self);
+    if (m == NULL)
+        return NULL;
+    /* Turn the view into a flat sequence of unsigned bytes. */
+    mv = (PyMemoryViewObject *)m;
+    mv->view.format = "B";
+    mv->view.ndim = 1;
+    mv->view.itemsize = 1;
+    mv->view.shape = &mv->view.len;
+    mv->view.strides = &mv->view.itemsize;
+    mv->flags = _Py_MEMORYVIEW_C | _Py_MEMORYVIEW_FORTRAN;
+    return m;
+}
+
+PyDoc_STRVAR(picklebuf_release_doc,
+"release() -> None. Release the underlying buffer held by this object.");
+
+static PyObject *
+picklebuf_release(PickleBufferObject *self)
+{
+    if (self->view.obj != NULL)
+        PyBuffer_Release(&self->view);
+    Py_RETURN_NONE;
+}
+
+static struct PyMethodDef picklebuf_methods[] = {
+    {"raw", (PyCFunction)picklebuf_raw, METH_NOARGS,
+     picklebuf_raw_doc},
+    {"release", (PyCFunction)picklebuf_release, METH_NOARGS,
+     picklebuf_release_doc},
+    {NULL, NULL}                /* sentinel */
+};
+
+PyDoc_STRVAR(picklebuf_doc,
+"PickleBuffer(buffer)"
+"\n"
+"Wrapper for potential out-of-band buffers.  With protocol 5, a pickler\n"
+"given a buffer_callback may send the memory of a PickleBuffer out-of-band\n"
+"instead of serializing it into the pickle stream.\n");
+
+static PyTypeObject PickleBuffer_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pickle.PickleBuffer",             /*tp_name*/
+    sizeof(PickleBufferObject),         /*tp_basicsize*/
+    0,                                  /*tp_itemsize*/
+    (destructor)picklebuf_dealloc,      /*tp_dealloc*/
+    0,                                  /*tp_print*/
+    0,                                  /*tp_getattr*/
+    0,                                  /*tp_setattr*/
+    0,                                  /*tp_reserved*/
+    0,                                  /*tp_repr*/
+    0,                                  /*tp_as_number*/
+    0,                                  /*tp_as_sequence*/
+    0,                                  /*tp_as_mapping*/
+    0,                                  /*tp_hash*/
+    0,                                  /*tp_call*/
+    0,                                  /*tp_str*/
+    0,                                  /*tp_getattro*/
+    0,                                  /*tp_setattro*/
+    &picklebuf_as_buffer,               /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC, /*tp_flags*/
+    picklebuf_doc,                      /*tp_doc*/
+    (traverseproc)picklebuf_traverse,   /*tp_traverse*/
+    (inquiry)picklebuf_clear,           /*tp_clear*/
+    0,                                  /*tp_richcompare*/
+    offsetof(PickleBufferObject, weakreflist), /*tp_weaklistoffset*/
+    0,                                  /*tp_iter*/
+    0,                                  /*tp_iternext*/
+    picklebuf_methods,                  /*tp_methods*/
+    0,                                  /*tp_members*/
+    0,                                  /*tp_getset*/
+    0,                                  /*tp_base*/
+    0,                                  /*tp_dict*/
+    0,                                  /*tp_descr_get*/
+    0,                                  /*tp_descr_set*/
+    0,                                  /*tp_dictoffset*/
+    0,                                  /*tp_init*/
+    PyType_GenericAlloc,                /*tp_alloc*/
+    picklebuf_new,                      /*tp_new*/
+    PyObject_GC_Del,                    /*tp_free*/
+};
+
 typedef struct {
     PyObject *me_key;
     Py_ssize_t me_value;
@@ -310,6 +526,10 @@ typedef struct {
     Py_ssize_t mt_mask;
     Py_ssize_t mt_used;
     Py_ssize_t mt_allocated;
+    int mt_shift;               /* Bits to drop from a hashed key to get
+                                   its home slot in mt_table. */
+    Py_ssize_t mt_expected;     /* Number of keys the table is expected to
+                                   reach, see PyMemoTable_Expect(). */
     PyMemoEntry *mt_table;
 } PyMemoTable;
 
@@ -340,6 +560,13 @@ typedef struct PicklerObject {
     int fix_imports;            /* Indicate whether Pickler should fix
                                    the name of globals for Python 2.x. */
     PyObject *fast_memo;
+    int framing;                /* True while dumping with protocol >= 4. */
+    Py_ssize_t frame_start;     /* Offset in output_buffer of the header of
+                                   the open frame, or -1 if there is none. */
+    PyObject *buffer_callback;  /* Callable deciding whether a PickleBuffer
+                                   is sent out-of-band, can be NULL. */
+    int memoize_atoms;          /* If false, short str and bytes objects
+                                   are not memoized, like ints and floats. */
 } PicklerObject;
 
 typedef struct UnpicklerObject {
@@ -350,6 +577,8 @@ typedef struct UnpicklerObject {
        is unnecessary, since the keys are contiguous ints. */
     PyObject **memo;
     Py_ssize_t memo_size;
+    Py_ssize_t memo_len;        /* Number of objects in the memo, which is
+                                   where MEMOIZE stores the next one. */
 
     PyObject *arg;
     PyObject *pers_func;        /* persistent_load() method, can be NULL. */
@@ -377,6 +606,8 @@ typedef struct UnpicklerObject {
     int proto;                  /* Protocol of the pickle loaded. */
     int fix_imports;            /* Indicate whether Unpickler should fix
                                    the name of globals pickled by Python 2.x. */
+    PyObject *buffers;          /* Iterator over the out-of-band buffers,
+                                   can be NULL. */
 } UnpicklerObject;
 
 /* Forward declarations */
@@ -390,10 +621,35 @@ static PyTypeObject Unpickler_Type;
  A custom hashtable mapping void* to Python ints. This is used by the pickler
  for memoization. Using a custom hashtable rather than PyDict allows us to skip
  a bunch of unnecessary object creation. This makes a huge performance
- difference. */
+ difference.
+
+ Keys are hashed by multiplying the pointer with a large odd constant and
+ keeping the top bits (Fibonacci hashing), which spreads the evenly spaced
+ addresses handed out by the object allocator over the whole table.
+ Collisions are resolved by linear probing, so a lookup usually touches a
+ single cache line; the table is kept at most half full to keep probe
+ sequences short. */
 
 #define MT_MINSIZE 8
-#define PERTURB_SHIFT 5
+#define MT_MINSHIFT (SIZEOF_SIZE_T * 8 - 3)     /* log2(MT_MINSIZE) == 3 */
+
+#if SIZEOF_SIZE_T == 8
+#define MT_HASH_MULT ((size_t)Py_ULL(0x9E3779B97F4A7C15))
+#else
+#define MT_HASH_MULT ((size_t)0x9E3779B9UL)
+#endif
+
+#define MT_HASH(table, key) \
+    (((size_t)(key) * MT_HASH_MULT) >> (table)->mt_shift)
+
+/* Smaller tables stay in the cache anyway; prefetching only costs time. */
+#define MT_PREFETCH_MINSIZE 8192
+
+#if defined(__GNUC__)
+#define MT_PREFETCH(addr) __builtin_prefetch((addr), 1, 1)
+#else
+#define MT_PREFETCH(addr) ((void)0)
+#endif
 
 
 static PyMemoTable *
@@ -408,6 +664,8 @@ PyMemoTable_New(void)
     memo->mt_used = 0;
     memo->mt_allocated = MT_MINSIZE;
     memo->mt_mask = MT_MINSIZE - 1;
+    memo->mt_shift = MT_MINSHIFT;
+    memo->mt_expected = 0;
     memo->mt_table = PyMem_MALLOC(MT_MINSIZE * sizeof(PyMemoEntry));
     if (memo->mt_table == NULL) {
         PyMem_FREE(memo);
@@ -430,6 +688,7 @@ PyMemoTable_Copy(PyMemoTable *self)
     new->mt_used = self->mt_used;
     new->mt_allocated = self->mt_allocated;
     new->mt_mask = self->mt_mask;
+    new->mt_shift = self->mt_shift;
     /* The table we get from _New() is probably smaller than we wanted.
        Free it and allocate one that's the right size. */
     PyMem_FREE(new->mt_table);
@@ -462,6 +721,7 @@ PyMemoTable_Clear(PyMemoTable *self)
         Py_XDECREF(self->mt_table[i].me_key);
     }
     self->mt_used = 0;
+    self->mt_expected = 0;
     memset(self->mt_table, 0, self->mt_allocated * sizeof(PyMemoEntry));
     return 0;
 }
@@ -478,32 +738,36 @@ PyMemoTable_Del(PyMemoTable *self)
 }
 
 /* Since entries cannot be deleted from this hashtable, _PyMemoTable_Lookup()
-   can be considerably simpler than dictobject.c's lookdict(). */
+   can be considerably simpler than dictobject.c's lookdict(): the probe
+   sequence ends at the key or at the first empty slot. */
 static PyMemoEntry *
 _PyMemoTable_Lookup(PyMemoTable *self, PyObject *key)
 {
-    size_t i;
-    size_t perturb;
     size_t mask = (size_t)self->mt_mask;
+    size_t i = MT_HASH(self, key);
     PyMemoEntry *table = self->mt_table;
     PyMemoEntry *entry;
-    Py_hash_t hash = (Py_hash_t)key >> 3;
-
-    i = hash & mask;
-    entry = &table[i];
-    if (entry->me_key == NULL || entry->me_key == key)
-        return entry;
 
-    for (perturb = hash; ; perturb >>= PERTURB_SHIFT) {
-        i = (i << 2) + i + perturb + 1;
-        entry = &table[i & mask];
-        if (entry->me_key == NULL || entry->me_key == key)
+    for (;;) {
+        entry = &table[i];
+        if (entry->me_key == key || entry->me_key == NULL)
             return entry;
+        i = (i + 1) & mask;
     }
     assert(0);  /* Never reached */
     return NULL;
 }
 
+/* Start loading the home slot of key into the cache.  The pickler calls this
+   for the next object of a container while it is still busy saving the
+   current one, so that the memo lookup in save() doesn't stall on memory. */
+Py_LOCAL_INLINE(void)
+PyMemoTable_Prefetch(PyMemoTable *self, PyObject *key)
+{
+    if (self->mt_allocated >= MT_PREFETCH_MINSIZE)
+        MT_PREFETCH(&self->mt_table[MT_HASH(self, key)]);
+}
+
 /* Returns -1 on failure, 0 on success. */
 static int
 _PyMemoTable_ResizeTable(PyMemoTable *self, Py_ssize_t min_size)
@@ -511,13 +775,16 @@ _PyMemoTable_ResizeTable(PyMemoTable *self, Py_ssize_t min_size)
     PyMemoEntry *oldtable = NULL;
     PyMemoEntry *oldentry, *newentry;
     Py_ssize_t new_size = MT_MINSIZE;
+    int new_shift = MT_MINSHIFT;
     Py_ssize_t to_process;
 
     assert(min_size > 0);
 
     /* Find the smallest valid table size >= min_size. */
-    while (new_size < min_size && new_size > 0)
+    while (new_size < min_size && new_size > 0) {
         new_size <<= 1;
+        new_shift--;
+    }
     if (new_size <= 0) {
         PyErr_NoMemory();
         return -1;
@@ -529,12 +796,13 @@ _PyMemoTable_ResizeTable(PyMemoTable *self, Py_ssize_t min_size)
     oldtable = self->mt_table;
     self->mt_table = PyMem_MALLOC(new_size * sizeof(PyMemoEntry));
     if (self->mt_table == NULL) {
-        PyMem_FREE(oldtable);
+        self->mt_table = oldtable;
         PyErr_NoMemory();
         return -1;
     }
     self->mt_allocated = new_size;
     self->mt_mask = new_size - 1;
+    self->mt_shift = new_shift;
     memset(self->mt_table, 0, sizeof(PyMemoEntry) * new_size);
 
     /* Copy entries from the old table. */
@@ -556,6 +824,20 @@ _PyMemoTable_ResizeTable(PyMemoTable *self, Py_ssize_t min_size)
     return 0;
 }
 
+/* Tell the table that about n more keys are coming.  Nothing is allocated
+   up front, since n is only an estimate and may be far too high (think of
+   a long list referring to a handful of objects).  But once the table has
+   to grow anyway and already holds a fair share of the expected keys, it
+   grows straight to a size that holds all of them instead of going through
+   a series of resizes. */
+static void
+PyMemoTable_Expect(PyMemoTable *self, Py_ssize_t n)
+{
+    if (n < 0 || n > (PY_SSIZE_T_MAX / 4) - self->mt_used)
+        n = 0;
+    self->mt_expected = n ? self->mt_used + n : 0;
+}
+
 /* Returns NULL on failure, a pointer to the value otherwise. */
 static Py_ssize_t *
 PyMemoTable_Get(PyMemoTable *self, PyObject *key)
@@ -585,7 +867,9 @@ PyMemoTable_Set(PyMemoTable *self, PyObject *key, Py_ssize_t value)
     self->mt_used++;
 
     /* If we added a key, we can safely resize. Otherwise just return!
-     * If used >= 2/3 size, adjust size. Normally, this quaduples the size.
+     * If used >= 1/2 size, adjust size: linear probing degrades quickly
+     * once the table gets fuller than that. Normally, this quadruples
+     * the size.
      *
      * Quadrupling the size improves average table sparseness
      * (reducing collisions) at the cost of some memory. It also halves
@@ -594,14 +878,25 @@ PyMemoTable_Set(PyMemoTable *self, PyObject *key, Py_ssize_t value)
      * Very large memo tables (over 50K items) use doubling instead.
      * This may help applications with severe memory constraints.
      */
-    if (!(self->mt_used * 3 >= (self->mt_mask + 1) * 2))
+    if (!(self->mt_used * 2 >= self->mt_mask + 1))
         return 0;
+    if (self->mt_expected > self->mt_used &&
+        self->mt_expected / 16 <= self->mt_used) {
+        Py_ssize_t expected = self->mt_expected;
+
+        self->mt_expected = 0;
+        return _PyMemoTable_ResizeTable(self, 2 * expected + 1);
+    }
     return _PyMemoTable_ResizeTable(self,
-        (self->mt_used > 50000 ? 2 : 4) * self->mt_used);
+        (self->mt_used > 50000 ? 2 : 4) * self->mt_used + 1);
 }
 
 #undef MT_MINSIZE
-#undef PERTURB_SHIFT
+#undef MT_MINSHIFT
+#undef MT_HASH_MULT
+#undef MT_HASH
+#undef MT_PREFETCH_MINSIZE
+#undef MT_PREFETCH
 
 /*************************************************************************/
 
@@ -669,6 +964,41 @@ _Pickler_ClearBuffer(PicklerObject *self)
     if (self->output_buffer == NULL)
         return -1;
     self->output_len = 0;
+    self->frame_start = -1;
+    return 0;
+}
+
+static void
+_write_size64(char *out, size_t value)
+{
+    size_t i;
+
+    for (i = 0; i < 8; i++) {
+        out[i] = (unsigned char)((value >> (8 * i)) & 0xff);
+    }
+}
+
+/* Close the open frame, if any, by filling in its header.  Frames too short
+   to be worth it are unwrapped instead. */
+static int
+_Pickler_CommitFrame(PicklerObject *self)
+{
+    size_t frame_len;
+    char *qdata;
+
+    if (!self->framing || self->frame_start == -1)
+        return 0;
+    frame_len = self->output_len - self->frame_start - FRAME_HEADER_SIZE;
+    qdata = PyBytes_AS_STRING(self->output_buffer) + self->frame_start;
+    if (frame_len >= FRAME_SIZE_MIN) {
+        qdata[0] = FRAME;
+        _write_size64(qdata + 1, frame_len);
+    }
+    else {
+        memmove(qdata, qdata + FRAME_HEADER_SIZE, frame_len);
+        self->output_len -= FRAME_HEADER_SIZE;
+    }
+    self->frame_start = -1;
     return 0;
 }
 
@@ -701,17 +1031,46 @@ _Pickler_FlushToFile(PicklerObject *self)
     return (result == NULL) ? -1 : 0;
 }
 
+/* Called after each complete opcode.  Once the open frame has grown past
+   FRAME_SIZE_TARGET, commit it and, when pickling to a file, hand it over
+   to the file so the buffer does not grow with the whole pickle. */
+static int
+_Pickler_OpcodeBoundary(PicklerObject *self)
+{
+    if (!self->framing || self->frame_start == -1)
+        return 0;
+    if (self->output_len - self->frame_start - FRAME_HEADER_SIZE <
+        FRAME_SIZE_TARGET)
+        return 0;
+    if (_Pickler_CommitFrame(self) < 0)
+        return -1;
+    if (self->write != NULL) {
+        if (_Pickler_FlushToFile(self) < 0)
+            return -1;
+        if (_Pickler_ClearBuffer(self) < 0)
+            return -1;
+    }
+    return 0;
+}
+
 static Py_ssize_t
-_Pickler_Write(PicklerObject *self, const char *s, Py_ssize_t n)
+_Pickler_Write(PicklerObject *self, const char *s, Py_ssize_t data_len)
 {
-    Py_ssize_t i, required;
+    Py_ssize_t i, n, required;
     char *buffer;
+    int need_new_frame;
 
     assert(s != NULL);
 
+    /* Frames are only cut at opcode boundaries, so while framing the
+       buffer is never flushed from here. */
+    need_new_frame = (self->framing && self->frame_start == -1);
+    n = need_new_frame ? data_len + FRAME_HEADER_SIZE : data_len;
+
     required = self->output_len + n;
     if (required > self->max_output_len) {
-        if (self->write != NULL && required > MAX_WRITE_BUF_SIZE) {
+        if (!self->framing && self->write != NULL &&
+            required > MAX_WRITE_BUF_SIZE) {
             /* XXX This reallocates a new buffer every time, which is a bit
                wasteful. */
             if (_Pickler_FlushToFile(self) < 0)
@@ -719,7 +1078,7 @@ _Pickler_Write(PicklerObject *self, const char *s, Py_ssize_t n)
             if (_Pickler_ClearBuffer(self) < 0)
                 return -1;
         }
-        if (self->write != NULL && n > MAX_WRITE_BUF_SIZE) {
+        if (!self->framing && self->write != NULL && n > MAX_WRITE_BUF_SIZE) {
             /* we already flushed above, so the buffer is empty */
             PyObject *result;
             /* XXX we could spare an intermediate copy and pass
@@ -742,17 +1101,79 @@ _Pickler_Write(PicklerObject *self, const char *s, Py_ssize_t n)
         }
     }
     buffer = PyBytes_AS_STRING(self->output_buffer);
-    if (n < 8) {
+    if (need_new_frame) {
+        /* The header is filled in by _Pickler_CommitFrame(). */
+        self->frame_start = self->output_len;
+        self->output_len += FRAME_HEADER_SIZE;
+    }
+    if (data_len < 8) {
         /* This is faster than memcpy when the string is short. */
-        for (i = 0; i < n; i++) {
+        for (i = 0; i < data_len; i++) {
             buffer[self->output_len + i] = s[i];
         }
     }
     else {
-        memcpy(buffer + self->output_len, s, n);
+        memcpy(buffer + self->output_len, s, data_len);
     }
-    self->output_len += n;
-    return n;
+    self->output_len += data_len;
+    return data_len;
+}
+
+/* Write an opcode header followed by a data payload.  Payloads of at least
+   FRAME_SIZE_TARGET bytes are kept out of frames and, when pickling to a
+   file, passed to write() directly instead of being copied into the output
+   buffer.  `payload` is an object exporting `data`, or NULL. */
+static int
+_Pickler_WriteBytes(PicklerObject *self,
+                    const char *header, Py_ssize_t header_size,
+                    const char *data, Py_ssize_t data_size,
+                    PyObject *payload)
+{
+    int bypass_buffer = (data_size >= FRAME_SIZE_TARGET);
+    int framing = self->framing;
+
+    if (bypass_buffer) {
+        if (_Pickler_CommitFrame(self) < 0)
+            return -1;
+        self->framing = 0;
+    }
+    if (_Pickler_Write(self, header, header_size) < 0)
+        goto error;
+
+    if (bypass_buffer && self->write != NULL) {
+        PyObject *result, *mem = NULL;
+
+        if (_Pickler_FlushToFile(self) < 0)
+            goto error;
+        if (payload == NULL) {
+            payload = mem = PyBytes_FromStringAndSize(data, data_size);
+            if (payload == NULL)
+                goto error;
+        }
+        else if (Py_TYPE(payload) == &PickleBuffer_Type) {
+            /* write() wants a flat buffer, whatever the original shape. */
+            payload = mem = picklebuf_raw((PickleBufferObject *)payload);
+            if (payload == NULL)
+                goto error;
+        }
+        result = PyObject_CallFunctionObjArgs(self->write, payload, NULL);
+        Py_XDECREF(mem);
+        if (result == NULL)
+            goto error;
+        Py_DECREF(result);
+        if (_Pickler_ClearBuffer(self) < 0)
+            goto error;
+    }
+    else {
+        if (_Pickler_Write(self, data, data_size) < 0)
+            goto error;
+    }
+    self->framing = framing;
+    return 0;
+
+  error:
+    self->framing = framing;
+    return -1;
 }
 
 static PicklerObject *
@@ -774,6 +1195,10 @@ _Pickler_New(void)
     self->fast_nesting = 0;
     self->fix_imports = 0;
     self->fast_memo = NULL;
+    self->framing = 0;
+    self->frame_start = -1;
+    self->buffer_callback = NULL;
+    self->memoize_atoms = 1;
 
     self->memo = PyMemoTable_New();
     if (self->memo == NULL) {
@@ -823,6 +1248,35 @@ _Pickler_SetProtocol(PicklerObject *self, PyObject *proto_obj,
     return 0;
 }
 
+/* Returns -1 (with an exception set) on failure, 0 on success. This may
+   be called once on a freshly created Pickler, after the protocol is set. */
+static int
+_Pickler_SetBufferCallback(PicklerObject *self, PyObject *buffer_callback)
+{
+    if (buffer_callback == Py_None)
+        return 0;
+    if (self->proto < 5) {
+        PyErr_SetString(PyExc_ValueError,
+                        "buffer_callback needs protocol >= 5");
+        return -1;
+    }
+    Py_INCREF(buffer_callback);
+    self->buffer_callback = buffer_callback;
+    return 0;
+}
+
+/* Returns -1 (with an exception set) on failure, 0 on success. */
+static int
+_Pickler_SetMemoizeAtoms(PicklerObject *self, PyObject *memoize_atoms)
+{
+    int memoize = PyObject_IsTrue(memoize_atoms);
+
+    if (memoize < 0)
+        return -1;
+    self->memoize_atoms = memoize;
+    return 0;
+}
+
 /* Returns -1 (with an exception set) on failure, 0 on success. This may
    be called once on a freshly created Pickler. */
 static int
@@ -1001,6 +1455,54 @@ _Unpickler_Read(UnpicklerObject *self, char **s, Py_ssize_t n)
     return n;
 }
 
+/* Read `n` bytes into a new bytes object.  Large payloads which are not
+   already in the input buffer are returned straight from the file's read(),
+   saving the copy through the input buffer. */
+static PyObject *
+_Unpickler_ReadBytes(UnpicklerObject *self, Py_ssize_t n)
+{
+    char *s;
+
+    if (self->read != NULL && n >= FRAME_SIZE_TARGET &&
+        self->next_read_idx + n > self->input_len &&
+        self->next_read_idx >= self->prefetched_idx) {
+        PyObject *len, *data;
+
+        /* Everything left in the input buffer is only prefetched, so the
+           file position matches next_read_idx once the consumed part is
+           skipped. */
+        if (_Unpickler_SkipConsumed(self) < 0)
+            return NULL;
+        self->input_len = 0;
+        self->next_read_idx = 0;
+        self->prefetched_idx = 0;
+
+        len = PyLong_FromSsize_t(n);
+        if (len == NULL)
+            return NULL;
+        data = _Unpickler_FastCall(self, self->read, len);
+        if (data == NULL)
+            return NULL;
+        if (!PyBytes_Check(data)) {
+            PyObject *bytes = PyBytes_FromObject(data);
+            Py_DECREF(data);
+            if (bytes == NULL)
+                return NULL;
+            data = bytes;
+        }
+        if (PyBytes_GET_SIZE(data) != n) {
+            Py_DECREF(data);
+            PyErr_Format(PyExc_EOFError, "Ran out of input");
+            return NULL;
+        }
+        return data;
+    }
+
+    if (_Unpickler_Read(self, &s, n) < 0)
+        return NULL;
+    return PyBytes_FromStringAndSize(s, n);
+}
+
 static Py_ssize_t
 _Unpickler_CopyLine(UnpicklerObject *self, char *line, Py_ssize_t len,
                     char **result)
@@ -1096,7 +1598,10 @@ _Unpickler_MemoPut(UnpicklerObject *self, Py_ssize_t idx, PyObject *value)
     Py_INCREF(value);
     old_item = self->memo[idx];
     self->memo[idx] = value;
-    Py_XDECREF(old_item);
+    if (old_item != NULL)
+        Py_DECREF(old_item);
+    else
+        self->memo_len++;
     return 0;
 }
 
@@ -1120,6 +1625,7 @@ _Unpickler_MemoCleanup(UnpicklerObject *self)
     if (self->memo == NULL)
         return;
     self->memo = NULL;
+    self->memo_len = 0;
     i = self->memo_size;
     while (--i >= 0) {
         Py_XDECREF(memo[i]);
@@ -1144,6 +1650,7 @@ _Unpickler_New(void)
     memset(&self->buffer, 0, sizeof(Py_buffer));
 
     self->memo_size = 32;
+    self->memo_len = 0;
     self->memo = _Unpickler_NewMemo(self->memo_size);
     if (self->memo == NULL) {
         Py_DECREF(self);
@@ -1167,10 +1674,26 @@ _Unpickler_New(void)
     self->marks_size = 0;
     self->proto = 0;
     self->fix_imports = 0;
+    self->buffers = NULL;
 
     return self;
 }
 
+/* Returns -1 (with an exception set) on failure, 0 on success. */
+static int
+_Unpickler_SetBuffers(UnpicklerObject *self, PyObject *buffers)
+{
+    if (buffers == NULL || buffers == Py_None) {
+        self->buffers = NULL;
+    }
+    else {
+        self->buffers = PyObject_GetIter(buffers);
+        if (self->buffers == NULL)
+            return -1;
+    }
+    return 0;
+}
+
 /* Returns -1 (with an exception set) on failure, 0 on success. This may
    be called once on a freshly created Pickler. */
 static int
@@ -1222,38 +1745,32 @@ _Unpickler_SetInputEncoding(UnpicklerObject *self,
     return 0;
 }
 
-/* Generate a GET opcode for an object stored in the memo. */
+/* Generate a GET opcode for the object stored at index value of the memo.
+   Callers have already looked the object up, so it isn't hashed twice. */
 static int
-memo_get(PicklerObject *self, PyObject *key)
+memo_get(PicklerObject *self, Py_ssize_t value)
 {
-    Py_ssize_t *value;
     char pdata[30];
     Py_ssize_t len;
 
-    value = PyMemoTable_Get(self->memo, key);
-    if (value == NULL)  {
-        PyErr_SetObject(PyExc_KeyError, key);
-        return -1;
-    }
-
     if (!self->bin) {
         pdata[0] = GET;
         PyOS_snprintf(pdata + 1, sizeof(pdata) - 1,
-                      "%" PY_FORMAT_SIZE_T "d\n", *value);
+                      "%" PY_FORMAT_SIZE_T "d\n", value);
         len = strlen(pdata);
     }
     else {
-        if (*value < 256) {
+        if (value < 256) {
             pdata[0] = BINGET;
-            pdata[1] = (unsigned char)(*value & 0xff);
+            pdata[1] = (unsigned char)(value & 0xff);
             len = 2;
         }
-        else if (*value <= 0xffffffffL) {
+        else if (value <= 0xffffffffL) {
             pdata[0] = LONG_BINGET;
-            pdata[1] = (unsigned char)(*value & 0xff);
-            pdata[2] = (unsigned char)((*value >> 8) & 0xff);
-            pdata[3] = (unsigned char)((*value >> 16) & 0xff);
-            pdata[4] = (unsigned char)((*value >> 24) & 0xff);
+            pdata[1] = (unsigned char)(value & 0xff);
+            pdata[2] = (unsigned char)((value >> 8) & 0xff);
+            pdata[3] = (unsigned char)((value >> 16) & 0xff);
+            pdata[4] = (unsigned char)((value >> 24) & 0xff);
             len = 5;
         }
         else { /* unlikely */
@@ -1269,6 +1786,66 @@ memo_get(PicklerObject *self, PyObject *key)
     return 0;
 }
 
+/* Longest str (in code points) or bytes object that is still treated as an
+   atom when memoize_atoms is disabled. */
+#define MEMO_ATOM_MAX_SIZE 64
+
+/* Number of leading items of a container looked at to guess how many memo
+   entries pickling it will add. */
+#define MEMO_SAMPLE_SIZE 8
+
+/* Return 1 if obj is pickled afresh each time it is seen instead of going
+   through the memo.  None, booleans, ints and floats never are memoized;
+   with memoize_atoms disabled, neither are short str and bytes objects,
+   which saves both the memo entry and the PUT opcode. */
+Py_LOCAL_INLINE(int)
+_Pickler_IsAtom(PicklerObject *self, PyObject *obj)
+{
+    PyTypeObject *type = Py_TYPE(obj);
+
+    if (obj == Py_None || type == &PyBool_Type ||
+        type == &PyLong_Type || type == &PyFloat_Type)
+        return 1;
+    if (self->memoize_atoms)
+        return 0;
+    if (type == &PyUnicode_Type)
+        return (PyUnicode_IS_READY(obj) &&
+                PyUnicode_GET_LENGTH(obj) <= MEMO_ATOM_MAX_SIZE);
+    if (type == &PyBytes_Type)
+        return PyBytes_GET_SIZE(obj) <= MEMO_ATOM_MAX_SIZE;
+    return 0;
+}
+
+/* Return the number of memo entries pickling obj is likely to add.  This
+   looks one level into tuples, which are commonly used as records. */
+static Py_ssize_t
+_Pickler_MemoWeight(PicklerObject *self, PyObject *obj)
+{
+    Py_ssize_t i, weight;
+
+    if (_Pickler_IsAtom(self, obj))
+        return 0;
+    weight = 1;
+    if (PyTuple_CheckExact(obj)) {
+        for (i = 0; i < PyTuple_GET_SIZE(obj); i++) {
+            if (!_Pickler_IsAtom(self, PyTuple_GET_ITEM(obj, i)))
+                weight++;
+        }
+    }
+    return weight;
+}
+
+/* Let the memo know how many entries a container of size items is likely
+   to add, given the memo weight of its first sampled items. */
+static void
+_Pickler_ExpectMemo(PicklerObject *self, Py_ssize_t weight,
+                    Py_ssize_t sampled, Py_ssize_t size)
+{
+    if (self->fast || sampled == 0 || size <= MEMO_SAMPLE_SIZE)
+        return;
+    PyMemoTable_Expect(self->memo, (size / sampled) * weight);
+}
+
 /* Store an object in the memo, assign it a new unique ID based on the number
    of objects currently stored in the memo and generate a PUT opcode. */
 static int
@@ -1279,14 +1856,20 @@ memo_put(PicklerObject *self, PyObject *obj)
     Py_ssize_t len;
     int status = 0;
 
-    if (self->fast)
+    if (self->fast || _Pickler_IsAtom(self, obj))
         return 0;
 
     x = PyMemoTable_Size(self->memo);
     if (PyMemoTable_Set(self->memo, obj, x) < 0)
         goto error;
 
-    if (!self->bin) {
+    if (self->proto >= 4) {
+        /* The unpickler stores the object at the same index, the number
+           of objects memoized so far. */
+        pdata[0] = MEMOIZE;
+        len = 1;
+    }
+    else if (!self->bin) {
         pdata[0] = PUT;
         PyOS_snprintf(pdata + 1, sizeof(pdata) - 1,
                       "%" PY_FORMAT_SIZE_T "d\n", x);
@@ -1324,6 +1907,34 @@ memo_put(PicklerObject *self, PyObject *obj)
     return status;
 }
 
+/* Look up a dotted name such as "Outer.Inner" on obj.  Protocol 4 names
+   nested classes and methods this way. */
+static PyObject *
+getattribute(PyObject *obj, PyObject *name)
+{
+    PyObject *dotted_path;
+    Py_ssize_t i;
+    _Py_static_string(PyId_dot, ".");
+
+    dotted_path = PyUnicode_Split(name, _PyUnicode_FromId(&PyId_dot), -1);
+    if (dotted_path == NULL)
+        return NULL;
+    Py_INCREF(obj);
+    for (i = 0; i < PyList_GET_SIZE(dotted_path); i++) {
+        PyObject *attr;
+
+        attr = PyObject_GetAttr(obj, PyList_GET_ITEM(dotted_path, i));
+        Py_DECREF(obj);
+        if (attr == NULL) {
+            Py_DECREF(dotted_path);
+            return NULL;
+        }
+        obj = attr;
+    }
+    Py_DECREF(dotted_path);
+    return obj;
+}
+
 static PyObject *
 whichmodule(PyObject *global, PyObject *global_name)
 {
@@ -1373,7 +1984,7 @@ whichmodule(PyObject *global, PyObject *global_name)
         if (PyObject_RichCompareBool(module_name, main_str, Py_EQ) == 1)
             continue;
 
-        obj = PyObject_GetAttr(module, global_name);
+        obj = getattribute(module, global_name);
         if (obj == NULL) {
             if (PyErr_ExceptionMatches(PyExc_AttributeError))
                 PyErr_Clear();
@@ -1704,6 +2315,74 @@ done:
     return 0;
 }
 
+/* Write a bytes payload with the smallest BINBYTES opcode able to hold it,
+   and memoize `obj`. */
+static int
+_save_bytes_data(PicklerObject *self, PyObject *obj, const char *data,
+                 Py_ssize_t size)
+{
+    char header[9];
+    Py_ssize_t len;
+
+    assert(self->proto >= 3);
+    if (size < 0)
+        return -1;
+
+    if (size < 256) {
+        header[0] = SHORT_BINBYTES;
+        header[1] = (unsigned char)size;
+        len = 2;
+    }
+    else if ((size_t)size <= 0xffffffffUL) {
+        header[0] = BINBYTES;
+        header[1] = (unsigned char)(size & 0xff);
+        header[2] = (unsigned char)((size >> 8) & 0xff);
+        header[3] = (unsigned char)((size >> 16) & 0xff);
+        header[4] = (unsigned char)((size >> 24) & 0xff);
+        len = 5;
+    }
+    else if (self->proto >= 4) {
+        header[0] = BINBYTES8;
+        _write_size64(header + 1, size);
+        len = 9;
+    }
+    else {
+        PyErr_SetString(PyExc_OverflowError,
+                        "cannot serialize a bytes object larger than 4 GiB");
+        return -1;          /* string too large */
+    }
+
+    if (_Pickler_WriteBytes(self, header, len, data, size, obj) < 0)
+        return -1;
+
+    if (memo_put(self, obj) < 0)
+        return -1;
+
+    return 0;
+}
+
+static int
+_save_bytearray_data(PicklerObject *self, PyObject *obj, const char *data,
+                     Py_ssize_t size)
+{
+    char header[9];
+
+    assert(self->proto >= 5);
+    if (size < 0)
+        return -1;
+
+    header[0] = BYTEARRAY8;
+    _write_size64(header + 1, size);
+
+    if (_Pickler_WriteBytes(self, header, 9, data, size, obj) < 0)
+        return -1;
+
+    if (memo_put(self, obj) < 0)
+        return -1;
+
+    return 0;
+}
+
 static int
 save_bytes(PicklerObject *self, PyObject *obj)
 {
@@ -1765,44 +2444,70 @@ save_bytes(PicklerObject *self, PyObject *obj)
         return status;
     }
     else {
-        Py_ssize_t size;
-        char header[5];
-        Py_ssize_t len;
+        return _save_bytes_data(self, obj, PyBytes_AS_STRING(obj),
+                                PyBytes_GET_SIZE(obj));
+    }
+}
 
-        size = PyBytes_GET_SIZE(obj);
-        if (size < 0)
-            return -1;
+/* Only called for protocol 5 and above; older protocols pickle bytearrays
+   through their __reduce_ex__ method. */
+static int
+save_bytearray(PicklerObject *self, PyObject *obj)
+{
+    return _save_bytearray_data(self, obj, PyByteArray_AS_STRING(obj),
+                                PyByteArray_GET_SIZE(obj));
+}
 
-        if (size < 256) {
-            header[0] = SHORT_BINBYTES;
-            header[1] = (unsigned char)size;
-            len = 2;
-        }
-        else if (size <= 0xffffffffL) {
-            header[0] = BINBYTES;
-            header[1] = (unsigned char)(size & 0xff);
-            header[2] = (unsigned char)((size >> 8) & 0xff);
-            header[3] = (unsigned char)((size >> 16) & 0xff);
-            header[4] = (unsigned char)((size >> 24) & 0xff);
-            len = 5;
-        }
-        else {
-            PyErr_SetString(PyExc_OverflowError,
-                            "cannot serialize a bytes object larger than 4 GiB");
-            return -1;          /* string too large */
-        }
+static int
+save_picklebuffer(PicklerObject *self, PyObject *obj)
+{
+    Py_buffer *view = &((PickleBufferObject *)obj)->view;
+    int in_band = 1;
 
-        if (_Pickler_Write(self, header, len) < 0)
-            return -1;
+    if (self->proto < 5) {
+        PyErr_SetString(PicklingError,
+                        "PickleBuffer can only be pickled with protocol >= 5");
+        return -1;
+    }
+    if (picklebuf_check_released((PickleBufferObject *)obj) < 0)
+        return -1;
+    if (view->suboffsets != NULL || !PyBuffer_IsContiguous(view, 'A')) {
+        PyErr_SetString(PicklingError,
+                        "PickleBuffer can not be pickled when "
+                        "pointing to a non-contiguous buffer");
+        return -1;
+    }
+    if (self->buffer_callback != NULL) {
+        PyObject *ret;
 
-        if (_Pickler_Write(self, PyBytes_AS_STRING(obj), size) < 0)
+        ret = PyObject_CallFunctionObjArgs(self->buffer_callback, obj, NULL);
+        if (ret == NULL)
             return -1;
-
-        if (memo_put(self, obj) < 0)
+        in_band = PyObject_IsTrue(ret);
+        Py_DECREF(ret);
+        if (in_band == -1)
             return -1;
+    }
+    if (in_band) {
+        /* Write data in-band */
+        if (view->readonly)
+            return _save_bytes_data(self, obj, view->buf, view->len);
+        else
+            return _save_bytearray_data(self, obj, view->buf, view->len);
+    }
+    else {
+        /* Write data out-of-band; the buffer_callback took care of it. */
+        const char next_buffer_op = NEXT_BUFFER;
+        const char readonly_buffer_op = READONLY_BUFFER;
 
-        return 0;
+        if (_Pickler_Write(self, &next_buffer_op, 1) < 0)
+            return -1;
+        if (view->readonly) {
+            if (_Pickler_Write(self, &readonly_buffer_op, 1) < 0)
+                return -1;
+        }
     }
+    return 0;
 }
 
 /* A copy of PyUnicode_EncodeRawUnicodeEscape() that also translates
@@ -1879,29 +2584,40 @@ save_unicode(PicklerObject *self, PyObject *obj)
     PyObject *encoded = NULL;
 
     if (self->bin) {
-        char pdata[5];
+        char pdata[9];
+        Py_ssize_t len;
 
         encoded = PyUnicode_AsEncodedString(obj, "utf-8", "surrogatepass");
         if (encoded == NULL)
             goto error;
 
         size = PyBytes_GET_SIZE(encoded);
-        if (size > 0xffffffffL) {
+        if (size < 256 && self->proto >= 4) {
+            pdata[0] = SHORT_BINUNICODE;
+            pdata[1] = (unsigned char)(size & 0xff);
+            len = 2;
+        }
+        else if ((size_t)size <= 0xffffffffUL) {
+            pdata[0] = BINUNICODE;
+            pdata[1] = (unsigned char)(size & 0xff);
+            pdata[2] = (unsigned char)((size >> 8) & 0xff);
+            pdata[3] = (unsigned char)((size >> 16) & 0xff);
+            pdata[4] = (unsigned char)((size >> 24) & 0xff);
+            len = 5;
+        }
+        else if (self->proto >= 4) {
+            pdata[0] = BINUNICODE8;
+            _write_size64(pdata + 1, size);
+            len = 9;
+        }
+        else {
             PyErr_SetString(PyExc_OverflowError,
                             "cannot serialize a string larger than 4 GiB");
             goto error;          /* string too large */
         }
 
-        pdata[0] = BINUNICODE;
-        pdata[1] = (unsigned char)(size & 0xff);
-        pdata[2] = (unsigned char)((size >> 8) & 0xff);
-        pdata[3] = (unsigned char)((size >> 16) & 0xff);
-        pdata[4] = (unsigned char)((size >> 24) & 0xff);
-
-        if (_Pickler_Write(self, pdata, 5) < 0)
-            goto error;
-
-        if (_Pickler_Write(self, PyBytes_AS_STRING(encoded), size) < 0)
+        if (_Pickler_WriteBytes(self, pdata, len, PyBytes_AS_STRING(encoded),
+                                size, encoded) < 0)
             goto error;
     }
     else {
@@ -1945,6 +2661,8 @@ store_tuple_elements(PicklerObject *self, PyObject *t, Py_ssize_t len)
 
         if (element == NULL)
             return -1;
+        if (i + 1 < len)
+            PyMemoTable_Prefetch(self->memo, PyTuple_GET_ITEM(t, i + 1));
         if (save(self, element, 0) < 0)
             return -1;
     }
@@ -1962,6 +2680,7 @@ static int
 save_tuple(PicklerObject *self, PyObject *obj)
 {
     Py_ssize_t len, i;
+    Py_ssize_t *memo_value;
 
     const char mark_op = MARK;
     const char tuple_op = TUPLE;
@@ -1999,13 +2718,14 @@ save_tuple(PicklerObject *self, PyObject *obj)
         if (store_tuple_elements(self, obj, len) < 0)
             return -1;
 
-        if (PyMemoTable_Get(self->memo, obj)) {
+        memo_value = PyMemoTable_Get(self->memo, obj);
+        if (memo_value != NULL) {
             /* pop the len elements */
             for (i = 0; i < len; i++)
                 if (_Pickler_Write(self, &pop_op, 1) < 0)
                     return -1;
             /* fetch from memo */
-            if (memo_get(self, obj) < 0)
+            if (memo_get(self, *memo_value) < 0)
                 return -1;
 
             return 0;
@@ -2026,7 +2746,8 @@ save_tuple(PicklerObject *self, PyObject *obj)
     if (store_tuple_elements(self, obj, len) < 0)
         return -1;
 
-    if (PyMemoTable_Get(self->memo, obj)) {
+    memo_value = PyMemoTable_Get(self->memo, obj);
+    if (memo_value != NULL) {
         /* pop the stack stuff we pushed */
         if (self->bin) {
             if (_Pickler_Write(self, &pop_mark_op, 1) < 0)
@@ -2041,7 +2762,7 @@ save_tuple(PicklerObject *self, PyObject *obj)
                     return -1;
         }
         /* fetch from memo */
-        if (memo_get(self, obj) < 0)
+        if (memo_get(self, *memo_value) < 0)
             return -1;
 
         return 0;
@@ -2184,7 +2905,7 @@ static int
 batch_list_exact(PicklerObject *self, PyObject *obj)
 {
     PyObject *item = NULL;
-    Py_ssize_t this_batch, total;
+    Py_ssize_t this_batch, total, weight;
 
     const char append_op = APPEND;
     const char appends_op = APPENDS;
@@ -2203,6 +2924,14 @@ batch_list_exact(PicklerObject *self, PyObject *obj)
         return 0;
     }
 
+    weight = 0;
+    for (total = 0; total < PyList_GET_SIZE(obj); total++) {
+        if (total == MEMO_SAMPLE_SIZE)
+            break;
+        weight += _Pickler_MemoWeight(self, PyList_GET_ITEM(obj, total));
+    }
+    _Pickler_ExpectMemo(self, weight, total, PyList_GET_SIZE(obj));
+
     /* Write in batches of BATCHSIZE. */
     total = 0;
     do {
@@ -2211,6 +2940,9 @@ batch_list_exact(PicklerObject *self, PyObject *obj)
             return -1;
         while (total < PyList_GET_SIZE(obj)) {
             item = PyList_GET_ITEM(obj, total);
+            if (total + 1 < PyList_GET_SIZE(obj))
+                PyMemoTable_Prefetch(self->memo,
+                                     PyList_GET_ITEM(obj, total + 1));
             if (save(self, item, 0) < 0)
                 return -1;
             total++;
@@ -2435,7 +3167,7 @@ batch_dict_exact(PicklerObject *self, PyObject *obj)
 {
     PyObject *key = NULL, *value = NULL;
     int i;
-    Py_ssize_t dict_size, ppos = 0;
+    Py_ssize_t dict_size, ppos = 0, weight;
 
     const char mark_op = MARK;
     const char setitem_op = SETITEM;
@@ -2446,6 +3178,16 @@ batch_dict_exact(PicklerObject *self, PyObject *obj)
 
     dict_size = PyDict_Size(obj);
 
+    weight = 0;
+    for (i = 0; i < MEMO_SAMPLE_SIZE; i++) {
+        if (!PyDict_Next(obj, &ppos, &key, &value))
+            break;
+        weight += _Pickler_MemoWeight(self, key);
+        weight += _Pickler_MemoWeight(self, value);
+    }
+    _Pickler_ExpectMemo(self, weight, i, dict_size);
+    ppos = 0;
+
     /* Special-case len(d) == 1 to save space. */
     if (dict_size == 1) {
         PyDict_Next(obj, &ppos, &key, &value);
@@ -2464,6 +3206,7 @@ batch_dict_exact(PicklerObject *self, PyObject *obj)
         if (_Pickler_Write(self, &mark_op, 1) < 0)
             return -1;
         while (PyDict_Next(obj, &ppos, &key, &value)) {
+            PyMemoTable_Prefetch(self->memo, value);
             if (save(self, key, 0) < 0)
                 return -1;
             if (save(self, value, 0) < 0)
@@ -2556,10 +3299,103 @@ save_dict(PicklerObject *self, PyObject *obj)
     return status;
 }
 
+/* Only called for protocol 4 and above; older protocols pickle sets and
+   frozensets through their __reduce_ex__ method. */
+static int
+save_set(PicklerObject *self, PyObject *obj)
+{
+    PyObject *item;
+    Py_ssize_t i, set_size, ppos = 0;
+    Py_hash_t hash;
+    int status = 0;
+
+    const char empty_set_op = EMPTY_SET;
+    const char mark_op = MARK;
+    const char additems_op = ADDITEMS;
+
+    if (self->fast && !fast_save_enter(self, obj))
+        goto error;
+
+    if (_Pickler_Write(self, &empty_set_op, 1) < 0)
+        goto error;
+
+    if (memo_put(self, obj) < 0)
+        goto error;
+
+    set_size = PySet_GET_SIZE(obj);
+    if (set_size == 0)
+        goto done;
+
+    /* Write in batches of BATCHSIZE. */
+    do {
+        i = 0;
+        if (_Pickler_Write(self, &mark_op, 1) < 0)
+            goto error;
+        while (_PySet_NextEntry(obj, &ppos, &item, &hash)) {
+            if (save(self, item, 0) < 0)
+                goto error;
+            if (++i == BATCHSIZE)
+                break;
+        }
+        if (_Pickler_Write(self, &additems_op, 1) < 0)
+            goto error;
+        if (PySet_GET_SIZE(obj) != set_size) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "set changed size during iteration");
+            goto error;
+        }
+    } while (i == BATCHSIZE);
+
+    if (0) {
+  error:
+        status = -1;
+    }
+  done:
+    if (self->fast && !fast_save_leave(self, obj))
+        status = -1;
+
+    return status;
+}
+
+static int
+save_frozenset(PicklerObject *self, PyObject *obj)
+{
+    PyObject *item;
+    Py_ssize_t ppos = 0;
+    Py_ssize_t *memo_value;
+    Py_hash_t hash;
+
+    const char mark_op = MARK;
+    const char frozenset_op = FROZENSET;
+    const char pop_mark_op = POP_MARK;
+
+    if (_Pickler_Write(self, &mark_op, 1) < 0)
+        return -1;
+
+    while (_PySet_NextEntry(obj, &ppos, &item, &hash)) {
+        if (save(self, item, 0) < 0)
+            return -1;
+    }
+
+    /* If the frozenset is in the memo now, saving its items saved it too,
+       so it is recursive.  Throw away everything put on the stack and
+       fetch it from the memo instead, as save_tuple() does. */
+    memo_value = PyMemoTable_Get(self->memo, obj);
+    if (memo_value != NULL) {
+        if (_Pickler_Write(self, &pop_mark_op, 1) < 0)
+            return -1;
+        return memo_get(self, *memo_value);
+    }
+
+    if (_Pickler_Write(self, &frozenset_op, 1) < 0)
+        return -1;
+    return memo_put(self, obj);
+}
+
 static int
 save_global(PicklerObject *self, PyObject *obj, PyObject *name)
 {
-    static PyObject *name_str = NULL;
+    static PyObject *name_str = NULL, *qualname_str = NULL;
     PyObject *global_name = NULL;
     PyObject *module_name = NULL;
     PyObject *module = NULL;
@@ -2572,6 +3408,9 @@ save_global(PicklerObject *self, PyObject *obj, PyObject *name)
         name_str = PyUnicode_InternFromString("__name__");
         if (name_str == NULL)
             goto error;
+        qualname_str = PyUnicode_InternFromString("__qualname__");
+        if (qualname_str == NULL)
+            goto error;
     }
 
     if (name) {
@@ -2579,9 +3418,22 @@ save_global(PicklerObject *self, PyObject *obj, PyObject *name)
         Py_INCREF(global_name);
     }
     else {
-        global_name = PyObject_GetAttr(obj, name_str);
-        if (global_name == NULL)
-            goto error;
+        /* Protocol 4 can name nested classes and methods by their
+           qualified name, which STACK_GLOBAL resolves one dot at a
+           time. */
+        if (self->proto >= 4) {
+            global_name = PyObject_GetAttr(obj, qualname_str);
+            if (global_name == NULL) {
+                if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+                    goto error;
+                PyErr_Clear();
+            }
+        }
+        if (global_name == NULL) {
+            global_name = PyObject_GetAttr(obj, name_str);
+            if (global_name == NULL)
+                goto error;
+        }
     }
 
     module_name = whichmodule(obj, global_name);
@@ -2603,7 +3455,10 @@ save_global(PicklerObject *self, PyObject *obj, PyObject *name)
                      obj, module_name);
         goto error;
     }
-    cls = PyObject_GetAttr(module, global_name);
+    if (self->proto >= 4)
+        cls = getattribute(module, global_name);
+    else
+        cls = PyObject_GetAttr(module, global_name);
     if (cls == NULL) {
         PyErr_Format(PicklingError,
                      "Can't pickle %R: attribute lookup %S.%S failed",
@@ -2688,6 +3543,19 @@ save_global(PicklerObject *self, PyObject *obj, PyObject *name)
         PyObject *(*unicode_encoder)(PyObject *);
 
   gen_global:
+        if (self->proto >= 4) {
+            const char stack_global_op = STACK_GLOBAL;
+
+            /* Protocol 4 saves the names as strings, which can come from
+               the memo, and lets STACK_GLOBAL pop them. */
+            if (save(self, module_name, 0) < 0 ||
+                save(self, global_name, 0) < 0 ||
+                _Pickler_Write(self, &stack_global_op, 1) < 0 ||
+                memo_put(self, obj) < 0)
+                goto error;
+            goto done;
+        }
+
         if (_Pickler_Write(self, &global_op, 1) < 0)
             goto error;
 
@@ -2804,6 +3672,7 @@ save_global(PicklerObject *self, PyObject *obj, PyObject *name)
   error:
         status = -1;
     }
+  done:
     Py_XDECREF(module_name);
     Py_XDECREF(global_name);
     Py_XDECREF(module);
@@ -2954,11 +3823,12 @@ save_reduce(PicklerObject *self, PyObject *args, PyObject *obj)
     PyObject *dictitems = Py_None;
     Py_ssize_t size;
 
-    int use_newobj = self->proto >= 2;
+    int use_newobj = 0, use_newobj_ex = 0;
 
     const char reduce_op = REDUCE;
     const char build_op = BUILD;
     const char newobj_op = NEWOBJ;
+    const char newobj_ex_op = NEWOBJ_EX;
 
     size = PyTuple_Size(args);
     if (size < 2 || size > 5) {
@@ -3004,15 +3874,18 @@ save_reduce(PicklerObject *self, PyObject *args, PyObject *obj)
     }
 
     /* Protocol 2 special case: if callable's name is __newobj__, use
-       NEWOBJ. */
-    if (use_newobj) {
-        static PyObject *newobj_str = NULL, *name_str = NULL;
+       NEWOBJ.  Protocol 4 also turns __newobj_ex__ into NEWOBJ_EX. */
+    if (self->proto >= 2) {
+        static PyObject *newobj_str = NULL, *newobj_ex_str = NULL;
+        static PyObject *name_str = NULL;
         PyObject *name;
 
         if (newobj_str == NULL) {
             newobj_str = PyUnicode_InternFromString("__newobj__");
+            newobj_ex_str = PyUnicode_InternFromString("__newobj_ex__");
             name_str = PyUnicode_InternFromString("__name__");
-            if (newobj_str == NULL || name_str == NULL)
+            if (newobj_str == NULL || newobj_ex_str == NULL ||
+                name_str == NULL)
                 return -1;
         }
 
@@ -3022,15 +3895,66 @@ save_reduce(PicklerObject *self, PyObject *args, PyObject *obj)
                 PyErr_Clear();
             else
                 return -1;
-            use_newobj = 0;
         }
         else {
-            use_newobj = PyUnicode_Check(name) &&
-                         PyUnicode_Compare(name, newobj_str) == 0;
+            if (PyUnicode_Check(name)) {
+                use_newobj = PyUnicode_Compare(name, newobj_str) == 0;
+                use_newobj_ex = self->proto >= 4 &&
+                                PyUnicode_Compare(name, newobj_ex_str) == 0;
+            }
             Py_DECREF(name);
         }
     }
-    if (use_newobj) {
+    if (use_newobj_ex) {
+        PyObject *cls;
+        PyObject *args;
+        PyObject *kwargs;
+
+        if (Py_SIZE(argtup) != 3) {
+            PyErr_Format(PicklingError,
+                         "length of the NEWOBJ_EX argument tuple must be "
+                         "exactly 3, not %zd", Py_SIZE(argtup));
+            return -1;
+        }
+
+        cls = PyTuple_GET_ITEM(argtup, 0);
+        if (!PyType_Check(cls)) {
+            PyErr_SetString(PicklingError, "args[0] from "
+                            "__newobj_ex__ args is not a type");
+            return -1;
+        }
+        if (obj != NULL) {
+            PyObject *obj_class = get_class(obj);
+            int p = obj_class != cls;    /* true iff a problem */
+
+            Py_XDECREF(obj_class);
+            if (p) {
+                PyErr_SetString(PicklingError, "args[0] from "
+                                "__newobj_ex__ args has the wrong class");
+                return -1;
+            }
+        }
+
+        args = PyTuple_GET_ITEM(argtup, 1);
+        if (!PyTuple_Check(args)) {
+            PyErr_SetString(PicklingError, "args[1] from "
+                            "__newobj_ex__ args is not a tuple");
+            return -1;
+        }
+        kwargs = PyTuple_GET_ITEM(argtup, 2);
+        if (!PyDict_Check(kwargs)) {
+            PyErr_SetString(PicklingError, "args[2] from "
+                            "__newobj_ex__ args is not a dict");
+            return -1;
+        }
+
+        if (save(self, cls, 0) < 0 ||
+            save(self, args, 0) < 0 ||
+            save(self, kwargs, 0) < 0 ||
+            _Pickler_Write(self, &newobj_ex_op, 1) < 0)
+            return -1;
+    }
+    else if (use_newobj) {
         PyObject *cls;
         PyObject *newargtup;
         PyObject *obj_class;
@@ -3138,6 +4062,7 @@ save(PicklerObject *self, PyObject *obj, int pers_save)
     PyTypeObject *type;
     PyObject *reduce_func = NULL;
     PyObject *reduce_value = NULL;
+    Py_ssize_t *memo_value;
     int status = 0;
 
     if (Py_EnterRecursiveCall(" while pickling an object"))
@@ -3191,17 +4116,29 @@ save(PicklerObject *self, PyObject *obj, int pers_save)
 
     /* Check the memo to see if it has the object. If so, generate
        a GET (or BINGET) opcode, instead of pickling the object
-       once again. */
-    if (PyMemoTable_Get(self->memo, obj)) {
-        if (memo_get(self, obj) < 0)
-            goto error;
-        goto done;
+       once again.  Short strings aren't looked up when memoize_atoms
+       is disabled, since they never get into the memo. */
+    if (!_Pickler_IsAtom(self, obj)) {
+        memo_value = PyMemoTable_Get(self->memo, obj);
+        if (memo_value != NULL) {
+            if (memo_get(self, *memo_value) < 0)
+                goto error;
+            goto done;
+        }
     }
 
     if (type == &PyBytes_Type) {
         status = save_bytes(self, obj);
         goto done;
     }
+    else if (type == &PyByteArray_Type && self->proto >= 5) {
+        status = save_bytearray(self, obj);
+        goto done;
+    }
+    else if (type == &PickleBuffer_Type) {
+        status = save_picklebuffer(self, obj);
+        goto done;
+    }
     else if (type == &PyUnicode_Type) {
         status = save_unicode(self, obj);
         goto done;
@@ -3218,6 +4155,14 @@ save(PicklerObject *self, PyObject *obj, int pers_save)
         status = save_tuple(self, obj);
         goto done;
     }
+    else if (type == &PySet_Type && self->proto >= 4) {
+        status = save_set(self, obj);
+        goto done;
+    }
+    else if (type == &PyFrozenSet_Type && self->proto >= 4) {
+        status = save_frozenset(self, obj);
+        goto done;
+    }
     else if (type == &PyType_Type) {
         status = save_type(self, obj);
         goto done;
@@ -3335,6 +4280,8 @@ save(PicklerObject *self, PyObject *obj, int pers_save)
         status = -1;
     }
   done:
+    if (status == 0)
+        status = _Pickler_OpcodeBoundary(self);
     Py_LeaveRecursiveCall();
     Py_XDECREF(reduce_func);
     Py_XDECREF(reduce_value);
@@ -3355,12 +4302,17 @@ dump(PicklerObject *self, PyObject *obj)
         header[1] = (unsigned char)self->proto;
         if (_Pickler_Write(self, header, 2) < 0)
             return -1;
+        if (self->proto >= 4)
+            self->framing = 1;
     }
 
     if (save(self, obj, 0) < 0 ||
-        _Pickler_Write(self, &stop_op, 1) < 0)
+        _Pickler_Write(self, &stop_op, 1) < 0 ||
+        _Pickler_CommitFrame(self) < 0) {
+        self->framing = 0;
         return -1;
-
+    }
+    self->framing = 0;
     return 0;
 }
 
@@ -3433,6 +4385,7 @@ Pickler_dealloc(PicklerObject *self)
     Py_XDECREF(self->dispatch_table);
     Py_XDECREF(self->arg);
     Py_XDECREF(self->fast_memo);
+    Py_XDECREF(self->buffer_callback);
 
     PyMemoTable_Del(self->memo);
 
@@ -3447,6 +4400,7 @@ Pickler_traverse(PicklerObject *self, visitproc visit, void *arg)
     Py_VISIT(self->dispatch_table);
     Py_VISIT(self->arg);
     Py_VISIT(self->fast_memo);
+    Py_VISIT(self->buffer_callback);
     return 0;
 }
 
@@ -3459,6 +4413,7 @@ Pickler_clear(PicklerObject *self)
     Py_CLEAR(self->dispatch_table);
     Py_CLEAR(self->arg);
     Py_CLEAR(self->fast_memo);
+    Py_CLEAR(self->buffer_callback);
 
     if (self->memo != NULL) {
         PyMemoTable *memo = self->memo;
@@ -3470,14 +4425,16 @@ Pickler_clear(PicklerObject *self)
 
 
 PyDoc_STRVAR(Pickler_doc,
-"Pickler(file, protocol=None)"
+"Pickler(file, protocol=None, fix_imports=True, buffer_callback=None,\n"
+"        memoize_atoms=True)\n"
 "\n"
 "This takes a binary file for writing a pickle data stream.\n"
 "\n"
 "The optional protocol argument tells the pickler to use the\n"
-"given protocol; supported protocols are 0, 1, 2, 3.  The default\n"
+"given protocol; supported protocols are 0, 1, 2, 3, 4, 5.  The default\n"
 "protocol is 3; a backward-incompatible protocol designed for\n"
-"Python 3.0.\n"
+"Python 3.0.  Protocol 4 adds framing, sets and very large objects,\n"
+"and protocol 5 adds out-of-band buffers.\n"
 "\n"
 "Specifying a negative protocol version selects the highest\n"
 "protocol version supported.  The higher the protocol used, the\n"
@@ -3491,20 +4448,36 @@ PyDoc_STRVAR(Pickler_doc,
 "\n"
 "If fix_imports is True and protocol is less than 3, pickle will try to\n"
 "map the new Python 3.x names to the old module names used in Python\n"
-"2.x, so that the pickle data stream is readable with Python 2.x.\n");
+"2.x, so that the pickle data stream is readable with Python 2.x.\n"
+"\n"
+"If buffer_callback is not None, it is called with each PickleBuffer\n"
+"being pickled.  If it returns a false value, the buffer is serialized\n"
+"out-of-band: the pickle only records its position, and the same\n"
+"buffers must be passed to the unpickler.  buffer_callback requires\n"
+"protocol 5 or higher.\n"
+"\n"
+"If memoize_atoms is false, str and bytes objects of at most 64\n"
+"characters are written out each time they occur instead of being\n"
+"remembered in the memo, like ints and floats.  This trades a larger\n"
+"pickle for less memo maintenance when pickling many small objects;\n"
+"the unpickled strings are equal but no longer shared.\n");
 
 static int
 Pickler_init(PicklerObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"file", "protocol", "fix_imports", 0};
+    static char *kwlist[] = {"file", "protocol", "fix_imports",
+                             "buffer_callback", "memoize_atoms", 0};
     PyObject *file;
     PyObject *proto_obj = NULL;
     PyObject *fix_imports = Py_True;
+    PyObject *buffer_callback = Py_None;
+    PyObject *memoize_atoms = Py_True;
     _Py_IDENTIFIER(persistent_id);
     _Py_IDENTIFIER(dispatch_table);
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:Pickler",
-                                     kwlist, &file, &proto_obj, &fix_imports))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO:Pickler",
+                                     kwlist, &file, &proto_obj, &fix_imports,
+                                     &buffer_callback, &memoize_atoms))
         return -1;
 
     /* In case of multiple __init__() calls, clear previous content. */
@@ -3517,6 +4490,12 @@ Pickler_init(PicklerObject *self, PyObject *args, PyObject *kwds)
     if (_Pickler_SetOutputStream(self, file) < 0)
         return -1;
 
+    if (_Pickler_SetBufferCallback(self, buffer_callback) < 0)
+        return -1;
+
+    if (_Pickler_SetMemoizeAtoms(self, memoize_atoms) < 0)
+        return -1;
+
     /* memo and output_buffer may have already been created in _Pickler_New */
     if (self->memo == NULL) {
         self->memo = PyMemoTable_New();
@@ -3524,6 +4503,8 @@ Pickler_init(PicklerObject *self, PyObject *args, PyObject *kwds)
             return -1;
     }
     self->output_len = 0;
+    self->framing = 0;
+    self->frame_start = -1;
     if (self->output_buffer == NULL) {
         self->max_output_len = WRITE_BUF_SIZE;
         self->output_buffer = PyBytes_FromStringAndSize(NULL,
@@ -3987,14 +4968,20 @@ static Py_ssize_t
 calc_binsize(char *bytes, int size)
 {
     unsigned char *s = (unsigned char *)bytes;
+    int i;
     size_t x = 0;
 
-    assert(size == 4);
+    assert(size == 4 || size == 8);
 
-    x =  (size_t) s[0];
-    x |= (size_t) s[1] << 8;
-    x |= (size_t) s[2] << 16;
-    x |= (size_t) s[3] << 24;
+    for (i = 0; i < size; i++) {
+        /* A length that does not fit in a size_t cannot be a valid size. */
+        if (i >= SIZEOF_SIZE_T) {
+            if (s[i] != 0)
+                return -1;
+            continue;
+        }
+        x |= (size_t) s[i] << (8 * i);
+    }
 
     if (x > PY_SSIZE_T_MAX)
         return -1;
@@ -4243,16 +5230,16 @@ load_string(UnpicklerObject *self)
 }
 
 static int
-load_binbytes(UnpicklerObject *self)
+load_counted_binbytes(UnpicklerObject *self, int nbytes)
 {
     PyObject *bytes;
     Py_ssize_t x;
     char *s;
 
-    if (_Unpickler_Read(self, &s, 4) < 0)
+    if (_Unpickler_Read(self, &s, nbytes) < 0)
         return -1;
 
-    x = calc_binsize(s, 4);
+    x = calc_binsize(s, nbytes);
     if (x < 0) {
         PyErr_Format(PyExc_OverflowError,
                      "BINBYTES exceeds system's maximum size of %zd bytes",
@@ -4261,9 +5248,7 @@ load_binbytes(UnpicklerObject *self)
         return -1;
     }
 
-    if (_Unpickler_Read(self, &s, x) < 0)
-        return -1;
-    bytes = PyBytes_FromStringAndSize(s, x);
+    bytes = _Unpickler_ReadBytes(self, x);
     if (bytes == NULL)
         return -1;
 
@@ -4271,6 +5256,126 @@ load_binbytes(UnpicklerObject *self)
     return 0;
 }
 
+static int
+load_bytearray8(UnpicklerObject *self)
+{
+    PyObject *bytearray;
+    Py_ssize_t x;
+    char *s;
+
+    if (_Unpickler_Read(self, &s, 8) < 0)
+        return -1;
+
+    x = calc_binsize(s, 8);
+    if (x < 0) {
+        PyErr_Format(PyExc_OverflowError,
+                     "BYTEARRAY8 exceeds system's maximum size of %zd bytes",
+                     PY_SSIZE_T_MAX
+                    );
+        return -1;
+    }
+
+    if (_Unpickler_Read(self, &s, x) < 0)
+        return -1;
+    bytearray = PyByteArray_FromStringAndSize(s, x);
+    if (bytearray == NULL)
+        return -1;
+
+    PDATA_PUSH(self->stack, bytearray, -1);
+    return 0;
+}
+
+static int
+load_next_buffer(UnpicklerObject *self)
+{
+    PyObject *buf;
+
+    if (self->buffers == NULL) {
+        PyErr_SetString(UnpicklingError,
+                        "pickle stream refers to out-of-band data "
+                        "but no *buffers* argument was given");
+        return -1;
+    }
+    buf = PyIter_Next(self->buffers);
+    if (buf == NULL) {
+        if (!PyErr_Occurred())
+            PyErr_SetString(UnpicklingError,
+                            "not enough out-of-band buffers");
+        return -1;
+    }
+
+    PDATA_PUSH(self->stack, buf, -1);
+    return 0;
+}
+
+static int
+load_readonly_buffer(UnpicklerObject *self)
+{
+    Py_ssize_t len = Py_SIZE(self->stack);
+    PyObject *obj, *view;
+
+    if (len <= 0)
+        return stack_underflow();
+
+    obj = self->stack->data[len - 1];
+    view = PyMemoryView_FromObject(obj);
+    if (view == NULL)
+        return -1;
+    if (!PyMemoryView_GET_BUFFER(view)->readonly) {
+        /* The original object is writable: replace it with a read-only
+           view on the same memory. */
+        PyMemoryView_GET_BUFFER(view)->readonly = 1;
+        self->stack->data[len - 1] = view;
+        Py_DECREF(obj);
+    }
+    else {
+        Py_DECREF(view);
+    }
+    return 0;
+}
+
+/* Only the length is read here; the frame contents are then consumed
+   through the input buffer like any other data. */
+static int
+load_frame(UnpicklerObject *self)
+{
+    Py_ssize_t frame_len;
+    char *s;
+
+    if (_Unpickler_Read(self, &s, 8) < 0)
+        return -1;
+
+    frame_len = calc_binsize(s, 8);
+    if (frame_len < 0) {
+        PyErr_Format(PyExc_OverflowError,
+                     "FRAME length exceeds system's maximum of %zd bytes",
+                     PY_SSIZE_T_MAX);
+        return -1;
+    }
+
+    if (self->read != NULL &&
+        self->next_read_idx + frame_len > self->input_len) {
+        /* Pull the whole frame in with a single read(). */
+        Py_ssize_t num_read;
+
+        if (self->next_read_idx < self->prefetched_idx) {
+            PyErr_SetString(UnpicklingError,
+                            "beginning of a new frame before end of "
+                            "current frame");
+            return -1;
+        }
+        num_read = _Unpickler_ReadFromFile(self, frame_len);
+        if (num_read < 0)
+            return -1;
+        if (num_read < frame_len) {
+            PyErr_Format(PyExc_EOFError, "Ran out of input");
+            return -1;
+        }
+        self->next_read_idx = 0;
+    }
+    return 0;
+}
+
 static int
 load_short_binbytes(UnpicklerObject *self)
 {
@@ -4368,16 +5473,16 @@ load_unicode(UnpicklerObject *self)
 }
 
 static int
-load_binunicode(UnpicklerObject *self)
+load_counted_binunicode(UnpicklerObject *self, int nbytes)
 {
     PyObject *str;
     Py_ssize_t size;
     char *s;
 
-    if (_Unpickler_Read(self, &s, 4) < 0)
+    if (_Unpickler_Read(self, &s, nbytes) < 0)
         return -1;
 
-    size = calc_binsize(s, 4);
+    size = calc_binsize(s, nbytes);
     if (size < 0) {
         PyErr_Format(PyExc_OverflowError,
                      "BINUNICODE exceeds system's maximum size of %zd bytes",
@@ -4398,6 +5503,29 @@ load_binunicode(UnpicklerObject *self)
     return 0;
 }
 
+static int
+load_short_binunicode(UnpicklerObject *self)
+{
+    PyObject *str;
+    Py_ssize_t size;
+    char *s;
+
+    if (_Unpickler_Read(self, &s, 1) < 0)
+        return -1;
+
+    size = (unsigned char)s[0];
+
+    if (_Unpickler_Read(self, &s, size) < 0)
+        return -1;
+
+    str = PyUnicode_DecodeUTF8(s, size, "surrogatepass");
+    if (str == NULL)
+        return -1;
+
+    PDATA_PUSH(self->stack, str, -1);
+    return 0;
+}
+
 static int
 load_tuple(UnpicklerObject *self)
 {
@@ -4457,6 +5585,40 @@ load_empty_dict(UnpicklerObject *self)
     return 0;
 }
 
+static int
+load_empty_set(UnpicklerObject *self)
+{
+    PyObject *set;
+
+    if ((set = PySet_New(NULL)) == NULL)
+        return -1;
+    PDATA_PUSH(self->stack, set, -1);
+    return 0;
+}
+
+static int
+load_frozenset(UnpicklerObject *self)
+{
+    PyObject *items;
+    PyObject *frozenset;
+    Py_ssize_t i;
+
+    if ((i = marker(self)) < 0)
+        return -1;
+
+    items = Pdata_poptuple(self->stack, i);
+    if (items == NULL)
+        return -1;
+
+    frozenset = PyFrozenSet_New(items);
+    Py_DECREF(items);
+    if (frozenset == NULL)
+        return -1;
+
+    PDATA_PUSH(self->stack, frozenset, -1);
+    return 0;
+}
+
 static int
 load_list(UnpicklerObject *self)
 {
@@ -4649,6 +5811,68 @@ load_newobj(UnpicklerObject *self)
     return -1;
 }
 
+static int
+load_newobj_ex(UnpicklerObject *self)
+{
+    PyObject *kwargs = NULL;
+    PyObject *args = NULL;
+    PyObject *clsraw = NULL;
+    PyTypeObject *cls;          /* clsraw cast to its true type */
+    PyObject *obj;
+
+    /* Stack is ... cls argtuple kwargsdict, and we want to call
+     * cls.__new__(cls, *argtuple, **kwargsdict).
+     */
+    PDATA_POP(self->stack, kwargs);
+    if (kwargs == NULL)
+        goto error;
+    if (!PyDict_Check(kwargs)) {
+        PyErr_SetString(UnpicklingError,
+                        "NEWOBJ_EX expected a keyword argument dict.");
+        goto error;
+    }
+
+    PDATA_POP(self->stack, args);
+    if (args == NULL)
+        goto error;
+    if (!PyTuple_Check(args)) {
+        PyErr_SetString(UnpicklingError, "NEWOBJ_EX expected an arg tuple.");
+        goto error;
+    }
+
+    PDATA_POP(self->stack, clsraw);
+    cls = (PyTypeObject *)clsraw;
+    if (cls == NULL)
+        goto error;
+    if (!PyType_Check(cls)) {
+        PyErr_SetString(UnpicklingError, "NEWOBJ_EX class argument "
+                        "isn't a type object");
+        goto error;
+    }
+    if (cls->tp_new == NULL) {
+        PyErr_SetString(UnpicklingError, "NEWOBJ_EX class argument "
+                        "has NULL tp_new");
+        goto error;
+    }
+
+    /* Call __new__. */
+    obj = cls->tp_new(cls, args, kwargs);
+    if (obj == NULL)
+        goto error;
+
+    Py_DECREF(kwargs);
+    Py_DECREF(args);
+    Py_DECREF(clsraw);
+    PDATA_PUSH(self->stack, obj, -1);
+    return 0;
+
+  error:
+    Py_XDECREF(kwargs);
+    Py_XDECREF(args);
+    Py_XDECREF(clsraw);
+    return -1;
+}
+
 static int
 load_global(UnpicklerObject *self)
 {
@@ -4685,6 +5909,32 @@ load_global(UnpicklerObject *self)
     return 0;
 }
 
+static int
+load_stack_global(UnpicklerObject *self)
+{
+    PyObject *global;
+    PyObject *module_name;
+    PyObject *global_name;
+
+    PDATA_POP(self->stack, global_name);
+    PDATA_POP(self->stack, module_name);
+    if (module_name == NULL || !PyUnicode_CheckExact(module_name) ||
+        global_name == NULL || !PyUnicode_CheckExact(global_name)) {
+        if (!PyErr_Occurred())
+            PyErr_SetString(UnpicklingError, "STACK_GLOBAL requires str");
+        Py_XDECREF(global_name);
+        Py_XDECREF(module_name);
+        return -1;
+    }
+    global = find_class(self, module_name, global_name);
+    Py_DECREF(global_name);
+    Py_DECREF(module_name);
+    if (global == NULL)
+        return -1;
+    PDATA_PUSH(self->stack, global, -1);
+    return 0;
+}
+
 static int
 load_persid(UnpicklerObject *self)
 {
@@ -5028,6 +6278,18 @@ load_long_binput(UnpicklerObject *self)
     return _Unpickler_MemoPut(self, idx, value);
 }
 
+static int
+load_memoize(UnpicklerObject *self)
+{
+    PyObject *value;
+
+    if (Py_SIZE(self->stack) <= 0)
+        return stack_underflow();
+    value = self->stack->data[Py_SIZE(self->stack) - 1];
+
+    return _Unpickler_MemoPut(self, self->memo_len, value);
+}
+
 static int
 do_append(UnpicklerObject *self, Py_ssize_t x)
 {
@@ -5143,6 +6405,59 @@ load_setitems(UnpicklerObject *self)
     return do_setitems(self, marker(self));
 }
 
+static int
+load_additems(UnpicklerObject *self)
+{
+    PyObject *set;
+    Py_ssize_t mark, len, i;
+    int status = 0;
+
+    mark = marker(self);
+    len = Py_SIZE(self->stack);
+    if (mark > len || mark <= 0)
+        return stack_underflow();
+    if (len == mark)  /* nothing to do */
+        return 0;
+
+    set = self->stack->data[mark - 1];
+
+    if (PySet_Check(set)) {
+        PyObject *items;
+
+        items = Pdata_poptuple(self->stack, mark);
+        if (items == NULL)
+            return -1;
+
+        status = _PySet_Update(set, items);
+        Py_DECREF(items);
+        return status;
+    }
+    else {
+        /* Like SETITEMS, accept anything with an add() method. */
+        PyObject *add_func;
+        _Py_IDENTIFIER(add);
+
+        add_func = _PyObject_GetAttrId(set, &PyId_add);
+        if (add_func == NULL)
+            return -1;
+        for (i = mark; i < len; i++) {
+            PyObject *result;
+
+            result = PyObject_CallFunctionObjArgs(add_func,
+                                                  self->stack->data[i], NULL);
+            if (result == NULL) {
+                status = -1;
+                break;
+            }
+            Py_DECREF(result);
+        }
+        Py_DECREF(add_func);
+        Pdata_clear(self->stack, mark);
+    }
+
+    return status;
+}
+
 static int
 load_build(UnpicklerObject *self)
 {
@@ -5377,13 +6692,19 @@ load(UnpicklerObject *self)
         OP_ARG(LONG4, load_counted_long, 4)
         OP(FLOAT, load_float)
         OP(BINFLOAT, load_binfloat)
-        OP(BINBYTES, load_binbytes)
+        OP_ARG(BINBYTES, load_counted_binbytes, 4)
+        OP_ARG(BINBYTES8, load_counted_binbytes, 8)
         OP(SHORT_BINBYTES, load_short_binbytes)
+        OP(BYTEARRAY8, load_bytearray8)
+        OP(NEXT_BUFFER, load_next_buffer)
+        OP(READONLY_BUFFER, load_readonly_buffer)
         OP(BINSTRING, load_binstring)
         OP(SHORT_BINSTRING, load_short_binstring)
         OP(STRING, load_string)
         OP(UNICODE, load_unicode)
-        OP(BINUNICODE, load_binunicode)
+        OP_ARG(BINUNICODE, load_counted_binunicode, 4)
+        OP_ARG(BINUNICODE8, load_counted_binunicode, 8)
+        OP(SHORT_BINUNICODE, load_short_binunicode)
         OP_ARG(EMPTY_TUPLE, load_counted_tuple, 0)
         OP_ARG(TUPLE1, load_counted_tuple, 1)
         OP_ARG(TUPLE2, load_counted_tuple, 2)
@@ -5393,10 +6714,15 @@ load(UnpicklerObject *self)
         OP(LIST, load_list)
         OP(EMPTY_DICT, load_empty_dict)
         OP(DICT, load_dict)
+        OP(EMPTY_SET, load_empty_set)
+        OP(ADDITEMS, load_additems)
+        OP(FROZENSET, load_frozenset)
         OP(OBJ, load_obj)
         OP(INST, load_inst)
         OP(NEWOBJ, load_newobj)
+        OP(NEWOBJ_EX, load_newobj_ex)
         OP(GLOBAL, load_global)
+        OP(STACK_GLOBAL, load_stack_global)
         OP(APPEND, load_append)
         OP(APPENDS, load_appends)
         OP(BUILD, load_build)
@@ -5408,6 +6734,7 @@ load(UnpicklerObject *self)
         OP(BINPUT, load_binput)
         OP(LONG_BINPUT, load_long_binput)
         OP(PUT, load_put)
+        OP(MEMOIZE, load_memoize)
         OP(POP, load_pop)
         OP(POP_MARK, load_pop_mark)
         OP(SETITEM, load_setitem)
@@ -5416,6 +6743,7 @@ load(UnpicklerObject *self)
         OP(BINPERSID, load_binpersid)
         OP(REDUCE, load_reduce)
         OP(PROTO, load_proto)
+        OP(FRAME, load_frame)
         OP_ARG(EXT1, load_extension, 1)
         OP_ARG(EXT2, load_extension, 2)
         OP_ARG(EXT4, load_extension, 4)
@@ -5566,12 +6894,15 @@ Unpickler_find_class(UnpicklerObject *self, PyObject *args)
         module = PyImport_Import(module_name);
         if (module == NULL)
             return NULL;
-        global = PyObject_GetAttr(module, global_name);
-        Py_DECREF(module);
     }
     else {
-        global = PyObject_GetAttr(module, global_name);
+        Py_INCREF(module);
     }
+    if (self->proto >= 4)
+        global = getattribute(module, global_name);
+    else
+        global = PyObject_GetAttr(module, global_name);
+    Py_DECREF(module);
     return global;
 }
 
@@ -5593,6 +6924,7 @@ Unpickler_dealloc(UnpicklerObject *self)
     Py_XDECREF(self->stack);
     Py_XDECREF(self->pers_func);
     Py_XDECREF(self->arg);
+    Py_XDECREF(self->buffers);
     if (self->buffer.buf != NULL) {
         PyBuffer_Release(&self->buffer);
         self->buffer.buf = NULL;
@@ -5616,6 +6948,7 @@ Unpickler_traverse(UnpicklerObject *self, visitproc visit, void *arg)
     Py_VISIT(self->stack);
     Py_VISIT(self->pers_func);
     Py_VISIT(self->arg);
+    Py_VISIT(self->buffers);
     return 0;
 }
 
@@ -5628,6 +6961,7 @@ Unpickler_clear(UnpicklerObject *self)
     Py_CLEAR(self->stack);
     Py_CLEAR(self->pers_func);
     Py_CLEAR(self->arg);
+    Py_CLEAR(self->buffers);
     if (self->buffer.buf != NULL) {
         PyBuffer_Release(&self->buffer);
         self->buffer.buf = NULL;
@@ -5647,7 +6981,7 @@ Unpickler_clear(UnpicklerObject *self)
 }
 
 PyDoc_STRVAR(Unpickler_doc,
-"Unpickler(file, *, encoding='ASCII', errors='strict')"
+"Unpickler(file, *, encoding='ASCII', errors='strict', buffers=None)"
 "\n"
 "This takes a binary file for reading a pickle data stream.\n"
 "\n"
@@ -5667,16 +7001,23 @@ PyDoc_STRVAR(Unpickler_doc,
 "map the old Python 2.x names to the new names used in Python 3.x.  The\n"
 "*encoding* and *errors* tell pickle how to decode 8-bit string\n"
 "instances pickled by Python 2.x; these default to 'ASCII' and\n"
-"'strict', respectively.\n");
+"'strict', respectively.\n"
+"\n"
+"If *buffers* is not None, it should be an iterable of buffer-enabled\n"
+"objects that is consumed each time the pickle stream references an\n"
+"out-of-band buffer, in the order the pickler's buffer_callback saw\n"
+"them.\n");
 
 static int
 Unpickler_init(UnpicklerObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"file", "fix_imports", "encoding", "errors", 0};
+    static char *kwlist[] = {"file", "fix_imports", "encoding", "errors",
+                             "buffers", 0};
     PyObject *file;
     PyObject *fix_imports = Py_True;
     char *encoding = NULL;
     char *errors = NULL;
+    PyObject *buffers = NULL;
     _Py_IDENTIFIER(persistent_load);
 
     /* XXX: That is an horrible error message. But, I don't know how to do
@@ -5694,8 +7035,9 @@ Unpickler_init(UnpicklerObject *self, PyObject *args, PyObject *kwds)
        extra careful in the other Unpickler methods, since a subclass could
        forget to call Unpickler.__init__() thus breaking our internal
        invariants. */
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Oss:Unpickler", kwlist,
-                                     &file, &fix_imports, &encoding, &errors))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OssO:Unpickler", kwlist,
+                                     &file, &fix_imports, &encoding, &errors,
+                                     &buffers))
         return -1;
 
     /* In case of multiple __init__() calls, clear previous content. */
@@ -5708,6 +7050,9 @@ Unpickler_init(UnpicklerObject *self, PyObject *args, PyObject *kwds)
     if (_Unpickler_SetInputEncoding(self, encoding, errors) < 0)
         return -1;
 
+    if (_Unpickler_SetBuffers(self, buffers) < 0)
+        return -1;
+
     self->fix_imports = PyObject_IsTrue(fix_imports);
     if (self->fix_imports == -1)
         return -1;
@@ -5982,6 +7327,10 @@ Unpickler_set_memo(UnpicklerObject *self, PyObject *obj)
     _Unpickler_MemoCleanup(self);
     self->memo_size = new_memo_size;
     self->memo = new_memo;
+    for (i = 0; i < new_memo_size; i++) {
+        if (new_memo[i] != NULL)
+            self->memo_len++;
+    }
 
     return 0;
 
@@ -6082,14 +7431,15 @@ static PyTypeObject Unpickler_Type = {
 };
 
 PyDoc_STRVAR(pickle_dump_doc,
-"dump(obj, file, protocol=None, *, fix_imports=True) -> None\n"
+"dump(obj, file, protocol=None, *, fix_imports=True, buffer_callback=None,\n"
+"     memoize_atoms=True) -> None\n"
 "\n"
 "Write a pickled representation of obj to the open file object file.  This\n"
 "is equivalent to ``Pickler(file, protocol).dump(obj)``, but may be more\n"
 "efficient.\n"
 "\n"
 "The optional protocol argument tells the pickler to use the given protocol;\n"
-"supported protocols are 0, 1, 2, 3.  The default protocol is 3; a\n"
+"supported protocols are 0, 1, 2, 3, 4, 5.  The default protocol is 3; a\n"
 "backward-incompatible protocol designed for Python 3.0.\n"
 "\n"
 "Specifying a negative protocol version selects the highest protocol version\n"
@@ -6102,16 +7452,24 @@ PyDoc_STRVAR(pickle_dump_doc,
 "\n"
 "If fix_imports is True and protocol is less than 3, pickle will try to\n"
 "map the new Python 3.x names to the old module names used in Python 2.x,\n"
-"so that the pickle data stream is readable with Python 2.x.\n");
+"so that the pickle data stream is readable with Python 2.x.\n"
+"\n"
+"If buffer_callback is not None, PickleBuffer objects for which it returns\n"
+"a false value are serialized out-of-band (protocol 5 and above).\n"
+"\n"
+"If memoize_atoms is false, short str and bytes objects are not memoized.\n");
 
 static PyObject *
 pickle_dump(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"obj", "file", "protocol", "fix_imports", 0};
+    static char *kwlist[] = {"obj", "file", "protocol", "fix_imports",
+                             "buffer_callback", "memoize_atoms", 0};
     PyObject *obj;
     PyObject *file;
     PyObject *proto = NULL;
     PyObject *fix_imports = Py_True;
+    PyObject *buffer_callback = Py_None;
+    PyObject *memoize_atoms = Py_True;
     PicklerObject *pickler;
 
     /* fix_imports is a keyword-only argument.  */
@@ -6122,8 +7480,9 @@ pickle_dump(PyObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|OO:dump", kwlist,
-                                     &obj, &file, &proto, &fix_imports))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|OOOO:dump", kwlist,
+                                     &obj, &file, &proto, &fix_imports,
+                                     &buffer_callback, &memoize_atoms))
         return NULL;
 
     pickler = _Pickler_New();
@@ -6136,6 +7495,12 @@ pickle_dump(PyObject *self, PyObject *args, PyObject *kwds)
     if (_Pickler_SetOutputStream(pickler, file) < 0)
         goto error;
 
+    if (_Pickler_SetBufferCallback(pickler, buffer_callback) < 0)
+        goto error;
+
+    if (_Pickler_SetMemoizeAtoms(pickler, memoize_atoms) < 0)
+        goto error;
+
     if (dump(pickler, obj) < 0)
         goto error;
 
@@ -6151,13 +7516,14 @@ pickle_dump(PyObject *self, PyObject *args, PyObject *kwds)
 }
 
 PyDoc_STRVAR(pickle_dumps_doc,
-"dumps(obj, protocol=None, *, fix_imports=True) -> bytes\n"
+"dumps(obj, protocol=None, *, fix_imports=True, buffer_callback=None,\n"
+"      memoize_atoms=True) -> bytes\n"
 "\n"
 "Return the pickled representation of the object as a bytes\n"
 "object, instead of writing it to a file.\n"
 "\n"
 "The optional protocol argument tells the pickler to use the given protocol;\n"
-"supported protocols are 0, 1, 2, 3.  The default protocol is 3; a\n"
+"supported protocols are 0, 1, 2, 3, 4, 5.  The default protocol is 3; a\n"
 "backward-incompatible protocol designed for Python 3.0.\n"
 "\n"
 "Specifying a negative protocol version selects the highest protocol version\n"
@@ -6166,16 +7532,24 @@ PyDoc_STRVAR(pickle_dumps_doc,
 "\n"
 "If fix_imports is True and *protocol* is less than 3, pickle will try to\n"
 "map the new Python 3.x names to the old module names used in Python 2.x,\n"
-"so that the pickle data stream is readable with Python 2.x.\n");
+"so that the pickle data stream is readable with Python 2.x.\n"
+"\n"
+"If buffer_callback is not None, PickleBuffer objects for which it returns\n"
+"a false value are serialized out-of-band (protocol 5 and above).\n"
+"\n"
+"If memoize_atoms is false, short str and bytes objects are not memoized.\n");
 
 static PyObject *
 pickle_dumps(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"obj", "protocol", "fix_imports", 0};
+    static char *kwlist[] = {"obj", "protocol", "fix_imports",
+                             "buffer_callback", "memoize_atoms", 0};
     PyObject *obj;
     PyObject *proto = NULL;
     PyObject *result;
     PyObject *fix_imports = Py_True;
+    PyObject *buffer_callback = Py_None;
+    PyObject *memoize_atoms = Py_True;
     PicklerObject *pickler;
 
     /* fix_imports is a keyword-only argument.  */
@@ -6186,8 +7560,9 @@ pickle_dumps(PyObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:dumps", kwlist,
-                                     &obj, &proto, &fix_imports))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO:dumps", kwlist,
+                                     &obj, &proto, &fix_imports,
+                                     &buffer_callback, &memoize_atoms))
         return NULL;
 
     pickler = _Pickler_New();
@@ -6197,6 +7572,12 @@ pickle_dumps(PyObject *self, PyObject *args, PyObject *kwds)
     if (_Pickler_SetProtocol(pickler, proto, fix_imports) < 0)
         goto error;
 
+    if (_Pickler_SetBufferCallback(pickler, buffer_callback) < 0)
+        goto error;
+
+    if (_Pickler_SetMemoizeAtoms(pickler, memoize_atoms) < 0)
+        goto error;
+
     if (dump(pickler, obj) < 0)
         goto error;
 
@@ -6210,7 +7591,8 @@ pickle_dumps(PyObject *self, PyObject *args, PyObject *kwds)
 }
 
 PyDoc_STRVAR(pickle_load_doc,
-"load(file, *, fix_imports=True, encoding='ASCII', errors='strict') -> object\n"
+"load(file, *, fix_imports=True, encoding='ASCII', errors='strict',\n"
+"     buffers=None) -> object\n"
 "\n"
 "Read a pickled object representation from the open file object file and\n"
 "return the reconstituted object hierarchy specified therein.  This is\n"
@@ -6231,17 +7613,22 @@ PyDoc_STRVAR(pickle_load_doc,
 "by Python 2.x.  If fix_imports is True, pickle will try to map the old\n"
 "Python 2.x names to the new names used in Python 3.x.  The encoding and\n"
 "errors tell pickle how to decode 8-bit string instances pickled by Python\n"
-"2.x; these default to 'ASCII' and 'strict', respectively.\n");
+"2.x; these default to 'ASCII' and 'strict', respectively.\n"
+"\n"
+"buffers is an iterable supplying the out-of-band buffers referenced by\n"
+"the pickle, in the order they were given to the buffer_callback.\n");
 
 static PyObject *
 pickle_load(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"file", "fix_imports", "encoding", "errors", 0};
+    static char *kwlist[] = {"file", "fix_imports", "encoding", "errors",
+                             "buffers", 0};
     PyObject *file;
     PyObject *fix_imports = Py_True;
     PyObject *result;
     char *encoding = NULL;
     char *errors = NULL;
+    PyObject *buffers = NULL;
     UnpicklerObject *unpickler;
 
     /* fix_imports, encoding and errors are a keyword-only argument.  */
@@ -6252,8 +7639,9 @@ pickle_load(PyObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Oss:load", kwlist,
-                                     &file, &fix_imports, &encoding, &errors))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OssO:load", kwlist,
+                                     &file, &fix_imports, &encoding, &errors,
+                                     &buffers))
         return NULL;
 
     unpickler = _Unpickler_New();
@@ -6266,6 +7654,9 @@ pickle_load(PyObject *self, PyObject *args, PyObject *kwds)
     if (_Unpickler_SetInputEncoding(unpickler, encoding, errors) < 0)
         goto error;
 
+    if (_Unpickler_SetBuffers(unpickler, buffers) < 0)
+        goto error;
+
     unpickler->fix_imports = PyObject_IsTrue(fix_imports);
     if (unpickler->fix_imports == -1)
         goto error;
@@ -6280,7 +7671,8 @@ pickle_load(PyObject *self, PyObject *args, PyObject *kwds)
 }
 
 PyDoc_STRVAR(pickle_loads_doc,
-"loads(input, *, fix_imports=True, encoding='ASCII', errors='strict') -> object\n"
+"loads(input, *, fix_imports=True, encoding='ASCII', errors='strict',\n"
+"      buffers=None) -> object\n"
 "\n"
 "Read a pickled object hierarchy from a bytes object and return the\n"
 "reconstituted object hierarchy specified therein\n"
@@ -6294,17 +7686,22 @@ PyDoc_STRVAR(pickle_loads_doc,
 "by Python 2.x.  If fix_imports is True, pickle will try to map the old\n"
 "Python 2.x names to the new names used in Python 3.x.  The encoding and\n"
 "errors tell pickle how to decode 8-bit string instances pickled by Python\n"
-"2.x; these default to 'ASCII' and 'strict', respectively.\n");
+"2.x; these default to 'ASCII' and 'strict', respectively.\n"
+"\n"
+"buffers is an iterable supplying the out-of-band buffers referenced by\n"
+"the pickle, in the order they were given to the buffer_callback.\n");
 
 static PyObject *
 pickle_loads(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"input", "fix_imports", "encoding", "errors", 0};
+    static char *kwlist[] = {"input", "fix_imports", "encoding", "errors",
+                             "buffers", 0};
     PyObject *input;
     PyObject *fix_imports = Py_True;
     PyObject *result;
     char *encoding = NULL;
     char *errors = NULL;
+    PyObject *buffers = NULL;
     UnpicklerObject *unpickler;
 
     /* fix_imports, encoding and errors are a keyword-only argument.  */
@@ -6315,8 +7712,9 @@ pickle_loads(PyObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Oss:loads", kwlist,
-                                     &input, &fix_imports, &encoding, &errors))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OssO:loads", kwlist,
+                                     &input, &fix_imports, &encoding, &errors,
+                                     &buffers))
         return NULL;
 
     unpickler = _Unpickler_New();
@@ -6329,6 +7727,9 @@ pickle_loads(PyObject *self, PyObject *args, PyObject *kwds)
     if (_Unpickler_SetInputEncoding(unpickler, encoding, errors) < 0)
         goto error;
 
+    if (_Unpickler_SetBuffers(unpickler, buffers) < 0)
+        goto error;
+
     unpickler->fix_imports = PyObject_IsTrue(fix_imports);
     if (unpickler->fix_imports == -1)
         goto error;
@@ -6486,6 +7887,8 @@ PyInit__pickle(void)
         return NULL;
     if (PyType_Ready(&UnpicklerMemoProxyType) < 0)
         return NULL;
+    if (PyType_Ready(&PickleBuffer_Type) < 0)
+        return NULL;
 
     /* Create the module and add the functions. */
     m = PyModule_Create(&_picklemodule);
@@ -6498,6 +7901,10 @@ PyInit__pickle(void)
     Py_INCREF(&Unpickler_Type);
     if (PyModule_AddObject(m, "Unpickler", (PyObject *)&Unpickler_Type) < 0)
         return NULL;
+    Py_INCREF(&PickleBuffer_Type);
+    if (PyModule_AddObject(m, "PickleBuffer",
+                           (PyObject *)&PickleBuffer_Type) < 0)
+        return NULL;
 
     /* Initialize the exceptions. */
     PickleError = PyErr_NewException("_pickle.PickleError", NULL, NULL);
@@ -1557,6 +1557,363 @@ s_unpack_from(PyObject *self, PyObject *args, PyObject *kwds)
 }
 
 
+/* Unpack iterator type */
+
+typedef struct {
+    PyObject_HEAD
+    PyStructObject *so;
+    Py_buffer buf;
+    Py_ssize_t index;
+} unpackiterobject;
+
+static void
+unpackiter_dealloc(unpackiterobject *self)
+{
+    PyObject_GC_UnTrack(self);
+    Py_XDECREF(self->so);
+    PyBuffer_Release(&self->buf);
+    PyObject_GC_Del(self);
+}
+
+static int
+unpackiter_traverse(unpackiterobject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->so);
+    Py_VISIT(self->buf.obj);
+    return 0;
+}
+
+static PyObject *
+unpackiter_len(unpackiterobject *self)
+{
+    Py_ssize_t len;
+    if (self->so == NULL)
+        len = 0;
+    else
+        len = (self->buf.len - self->index) / self->so->s_size;
+    return PyLong_FromSsize_t(len);
+}
+
+static PyMethodDef unpackiter_methods[] = {
+    {"__length_hint__", (PyCFunction)unpackiter_len, METH_NOARGS, NULL},
+    {NULL,              NULL}           /* sentinel */
+};
+
+static PyObject *
+unpackiter_iternext(unpackiterobject *self)
+{
+    PyObject *result;
+    if (self->so == NULL)
+        return NULL;
+    if (self->index >= self->buf.len) {
+        /* Iterator exhausted */
+        Py_CLEAR(self->so);
+        PyBuffer_Release(&self->buf);
+        return NULL;
+    }
+    assert(self->index + self->so->s_size <= self->buf.len);
+    result = s_unpack_internal(self->so,
+                               (char*) self->buf.buf + self->index);
+    self->index += self->so->s_size;
+    return result;
+}
+
+static PyTypeObject unpackiter_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "unpack_iterator",                          /* tp_name */
+    sizeof(unpackiterobject),                   /* tp_basicsize */
+    0,                                          /* tp_itemsize */
+    (destructor)unpackiter_dealloc,             /* tp_dealloc */
+    0,                                          /* tp_print */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_reserved */
+    0,                                          /* tp_repr */
+    0,                                          /* tp_as_number */
+    0,                                          /* tp_as_sequence */
+    0,                                          /* tp_as_mapping */
+    0,                                          /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    PyObject_GenericGetAttr,                    /* tp_getattro */
+    0,                                          /* tp_setattro */
+    0,                                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,    /* tp_flags */
+    0,                                          /* tp_doc */
+    (traverseproc)unpackiter_traverse,          /* tp_traverse */
+    0,                                          /* tp_clear */
+    0,                                          /* tp_richcompare */
+    0,                                          /* tp_weaklistoffset */
+    PyObject_SelfIter,                          /* tp_iter */
+    (iternextfunc)unpackiter_iternext,          /* tp_iternext */
+    unpackiter_methods                          /* tp_methods */
+};
+
+PyDoc_STRVAR(s_iter_unpack__doc__,
+"S.iter_unpack(buffer) -> iterator(v1, v2, ...)\n\
+\n\
+Return an iterator yielding tuples unpacked from the given bytes\n\
+source, like a repeated invocation of unpack_from().  Requires\n\
+that the bytes length be a multiple of the struct size.");
+
+static PyObject *
+s_iter_unpack(PyObject *_so, PyObject *input)
+{
+    PyStructObject *so = (PyStructObject *) _so;
+    unpackiterobject *self;
+
+    assert(PyStruct_Check(_so));
+    assert(so->s_codes != NULL);
+
+    if (so->s_size == 0) {
+        PyErr_Format(StructError,
+                     "cannot iteratively unpack with a struct of length 0");
+        return NULL;
+    }
+
+    self = PyObject_GC_New(unpackiterobject, &unpackiter_type);
+    if (self == NULL)
+        return NULL;
+    self->so = NULL;
+    self->buf.obj = NULL;
+    self->index = 0;
+
+    if (PyObject_GetBuffer(input, &self->buf, PyBUF_SIMPLE) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    if (self->buf.len % so->s_size != 0) {
+        PyErr_Format(StructError,
+                     "iterative unpacking requires a bytes length "
+                     "multiple of %zd",
+                     so->s_size);
+        Py_DECREF(self);
+        return NULL;
+    }
+    Py_INCREF(so);
+    self->so = so;
+    PyObject_GC_Track(self);
+    return (PyObject *) self;
+}
+
+
+/*
+ * Column unpacking.
+ *
+ * unpack_many() walks the buffer once per format code and stores the raw
+ * values of numeric codes straight into the item buffer of an
+ * array.array, so no Python object is created per value.  Native codes
+ * and standard codes in host byte order are copied; other standard codes
+ * are assembled byte by byte.
+ */
+
+#ifdef HAVE_LONG_LONG
+typedef unsigned PY_LONG_LONG column_uint;
+#else
+typedef unsigned long column_uint;
+#endif
+
+/* 1 for little-endian standard codes, 0 for big-endian standard codes
+   and -1 for native codes. */
+static int
+code_byteorder(const formatdef *e)
+{
+    if (e >= lilendian_table &&
+        e < lilendian_table + Py_ARRAY_LENGTH(lilendian_table))
+        return 1;
+    if (e >= bigendian_table &&
+        e < bigendian_table + Py_ARRAY_LENGTH(bigendian_table))
+        return 0;
+    return -1;
+}
+
+/* The array typecode whose items can hold the values of a format code,
+   or 0 if the column is returned as a list. */
+static int
+column_typecode(const formatdef *e, Py_ssize_t *itemsize)
+{
+    Py_ssize_t size;
+
+    switch (e->format) {
+    case 'b': case 'B': size = sizeof(char); break;
+    case 'h': case 'H': size = sizeof(short); break;
+    case 'i': case 'I': size = sizeof(int); break;
+    case 'l': case 'L': size = sizeof(long); break;
+#ifdef HAVE_LONG_LONG
+    case 'q': case 'Q': size = sizeof(PY_LONG_LONG); break;
+#endif
+    case 'f': size = sizeof(float); break;
+    case 'd': size = sizeof(double); break;
+    default:
+        return 0;
+    }
+    if (size < e->size || (e->format == 'f' && e->size != 4) ||
+        (e->format == 'd' && e->size != 8))
+        return 0;
+    *itemsize = size;
+    return e->format;
+}
+
+static void
+unpack_column_items(const formatdef *e, const char *p, Py_ssize_t stride,
+                    Py_ssize_t count, char *out, Py_ssize_t itemsize)
+{
+    int byteorder = code_byteorder(e);
+    Py_ssize_t i, j;
+#ifdef WORDS_BIGENDIAN
+    int host_order = 0;
+#else
+    int host_order = 1;
+#endif
+
+    if (byteorder < 0 ||
+        (byteorder == host_order && itemsize == e->size &&
+         e->format != 'f' && e->format != 'd')) {
+        for (i = 0; i < count; i++, p += stride, out += itemsize)
+            memcpy(out, p, itemsize);
+        return;
+    }
+    if (e->format == 'f' || e->format == 'd') {
+        for (i = 0; i < count; i++, p += stride, out += itemsize) {
+            if (e->format == 'f') {
+                float x = (float)_PyFloat_Unpack4((const unsigned char *)p,
+                                                  byteorder);
+                memcpy(out, &x, sizeof(x));
+            }
+            else {
+                double x = _PyFloat_Unpack8((const unsigned char *)p,
+                                            byteorder);
+                memcpy(out, &x, sizeof(x));
+            }
+        }
+        return;
+    }
+    for (i = 0; i < count; i++, p += stride, out += itemsize) {
+        const unsigned char *bytes = (const unsigned char *)p;
+        column_uint x = 0;
+
+        for (j = 0; j < e->size; j++)
+            x = (x << 8) | bytes[byteorder ? e->size - 1 - j : j];
+        if (Py_ISLOWER(e->format) && e->size < (Py_ssize_t)sizeof(x) &&
+            (x >> (8 * e->size - 1)) & 1)
+            x |= ~(column_uint)0 << (8 * e->size);
+        switch (itemsize) {
+        case 1: { unsigned char v = (unsigned char)x; memcpy(out, &v, 1); break; }
+        case 2: { unsigned short v = (unsigned short)x; memcpy(out, &v, 2); break; }
+        case 4: { unsigned int v = (unsigned int)x; memcpy(out, &v, 4); break; }
+        default: memcpy(out, &x, sizeof(x)); break;
+        }
+    }
+}
+
+static PyObject *
+unpack_column(const formatcode *code, const char *buf, Py_ssize_t stride,
+              Py_ssize_t count, PyObject **arraytype)
+{
+    const formatdef *e = code->fmtdef;
+    const char *p = buf + code->offset;
+    PyObject *column, *items;
+    Py_ssize_t i, itemsize;
+    int typecode = column_typecode(e, &itemsize);
+
+    if (typecode == 0) {
+        column = PyList_New(count);
+        if (column == NULL)
+            return NULL;
+        for (i = 0; i < count; i++, p += stride) {
+            PyObject *v;
+            if (e->format == 's') {
+                v = PyBytes_FromStringAndSize(p, code->size);
+            } else if (e->format == 'p') {
+                Py_ssize_t n = *(unsigned char*)p;
+                if (n >= code->size)
+                    n = code->size - 1;
+                v = PyBytes_FromStringAndSize(p + 1, n);
+            } else {
+                v = e->unpack(p, e);
+            }
+            if (v == NULL) {
+                Py_DECREF(column);
+                return NULL;
+            }
+            PyList_SET_ITEM(column, i, v);
+        }
+        return column;
+    }
+
+    if (*arraytype == NULL) {
+        PyObject *module = PyImport_ImportModule("array");
+        if (module == NULL)
+            return NULL;
+        *arraytype = PyObject_GetAttrString(module, "array");
+        Py_DECREF(module);
+        if (*arraytype == NULL)
+            return NULL;
+    }
+    if (count > PY_SSIZE_T_MAX / itemsize)
+        return PyErr_NoMemory();
+    items = PyBytes_FromStringAndSize(NULL, count * itemsize);
+    if (items == NULL)
+        return NULL;
+    unpack_column_items(e, p, stride, count, PyBytes_AS_STRING(items),
+                        itemsize);
+    column = PyObject_CallFunction(*arraytype, "CO", typecode, items);
+    Py_DECREF(items);
+    return column;
+}
+
+PyDoc_STRVAR(s_unpack_many__doc__,
+"S.unpack_many(buffer) -> [column1, column2, ...]\n\
+\n\
+Unpack every record of the buffer and return one column per value of\n\
+the format: an array.array for numeric codes and a list otherwise.\n\
+Requires that the bytes length be a multiple of the struct size.");
+
+static PyObject *
+s_unpack_many(PyObject *self, PyObject *input)
+{
+    PyStructObject *soself = (PyStructObject *)self;
+    PyObject *result = NULL, *arraytype = NULL, *column;
+    formatcode *code;
+    Py_buffer vbuf;
+    Py_ssize_t i, count;
+
+    assert(PyStruct_Check(self));
+    assert(soself->s_codes != NULL);
+
+    if (soself->s_size == 0) {
+        PyErr_Format(StructError,
+                     "cannot unpack many records with a struct of length 0");
+        return NULL;
+    }
+    if (PyObject_GetBuffer(input, &vbuf, PyBUF_SIMPLE) < 0)
+        return NULL;
+    if (vbuf.len % soself->s_size != 0) {
+        PyErr_Format(StructError,
+                     "unpack_many requires a bytes length multiple of %zd",
+                     soself->s_size);
+        goto done;
+    }
+    count = vbuf.len / soself->s_size;
+    result = PyList_New(soself->s_len);
+    if (result == NULL)
+        goto done;
+    for (code = soself->s_codes, i = 0; code->fmtdef != NULL; code++, i++) {
+        column = unpack_column(code, vbuf.buf, soself->s_size, count,
+                               &arraytype);
+        if (column == NULL) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, column);
+    }
+done:
+    Py_XDECREF(arraytype);
+    PyBuffer_Release(&vbuf);
+    return result;
+}
+
+
 /*
  * Guts of the pack function.
  *
@@ -1749,6 +2106,165 @@ s_pack_into(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
+/* Pack one item of the iterable given to pack_many() or pack_many_into() */
+static int
+s_pack_item(PyStructObject *soself, PyObject *item, char *buf,
+            const char *fname)
+{
+    PyObject *args;
+    int result;
+
+    if (PyTuple_Check(item)) {
+        args = item;
+        Py_INCREF(args);
+    }
+    else {
+        args = PySequence_Tuple(item);
+        if (args == NULL)
+            return -1;
+    }
+    if (PyTuple_GET_SIZE(args) != soself->s_len) {
+        PyErr_Format(StructError,
+                     "%s expected %zd items for packing (got %zd)",
+                     fname, soself->s_len, PyTuple_GET_SIZE(args));
+        Py_DECREF(args);
+        return -1;
+    }
+    result = s_pack_internal(soself, args, 0, buf);
+    Py_DECREF(args);
+    return result;
+}
+
+PyDoc_STRVAR(s_pack_many__doc__,
+"S.pack_many(iterable) -> bytes\n\
+\n\
+Pack each item of the iterable, a sequence of values, according to the\n\
+format string S.format and return the records joined in one bytes\n\
+object.  See help(struct) for more on format strings.");
+
+static PyObject *
+s_pack_many(PyObject *self, PyObject *iterable)
+{
+    PyStructObject *soself = (PyStructObject *)self;
+    PyObject *it, *item, *result;
+    Py_ssize_t count = 0, allocated, size = soself->s_size;
+
+    assert(PyStruct_Check(self));
+    assert(soself->s_codes != NULL);
+
+    it = PyObject_GetIter(iterable);
+    if (it == NULL)
+        return NULL;
+    allocated = _PyObject_LengthHint(iterable, 8);
+    if (allocated < 0)
+        goto error_it;
+    if (allocated == 0)
+        allocated = 1;
+    if (size != 0 && allocated > PY_SSIZE_T_MAX / size)
+        allocated = PY_SSIZE_T_MAX / size;
+    result = PyBytes_FromStringAndSize(NULL, allocated * size);
+    if (result == NULL)
+        goto error_it;
+
+    while ((item = PyIter_Next(it)) != NULL) {
+        if (count == allocated) {
+            if (size != 0 && allocated > PY_SSIZE_T_MAX / size / 2) {
+                Py_DECREF(item);
+                PyErr_NoMemory();
+                goto error;
+            }
+            allocated *= 2;
+            if (_PyBytes_Resize(&result, allocated * size) < 0) {
+                Py_DECREF(item);
+                goto error_it;
+            }
+        }
+        if (s_pack_item(soself, item,
+                        PyBytes_AS_STRING(result) + count * size,
+                        "pack_many") < 0) {
+            Py_DECREF(item);
+            goto error;
+        }
+        Py_DECREF(item);
+        count++;
+    }
+    if (PyErr_Occurred())
+        goto error;
+    Py_DECREF(it);
+    if (count != allocated && _PyBytes_Resize(&result, count * size) < 0)
+        return NULL;
+    return result;
+
+error:
+    Py_DECREF(result);
+error_it:
+    Py_DECREF(it);
+    return NULL;
+}
+
+PyDoc_STRVAR(s_pack_many_into__doc__,
+"S.pack_many_into(buffer, offset, iterable) -> count\n\
+\n\
+Pack each item of the iterable according to the format string S.format\n\
+and write the records one after another into the writable buffer\n\
+starting at offset.  Return the number of records written.  See\n\
+help(struct) for more on format strings.");
+
+static PyObject *
+s_pack_many_into(PyObject *self, PyObject *args)
+{
+    PyStructObject *soself = (PyStructObject *)self;
+    PyObject *buffer, *iterable, *it, *item;
+    Py_buffer vbuf;
+    Py_ssize_t offset, count = 0;
+
+    assert(PyStruct_Check(self));
+    assert(soself->s_codes != NULL);
+
+    if (!PyArg_ParseTuple(args, "OnO:pack_many_into",
+                          &buffer, &offset, &iterable))
+        return NULL;
+    /* Hold the export while the iterable runs Python code, so the buffer
+       cannot be resized under us */
+    if (PyObject_GetBuffer(buffer, &vbuf, PyBUF_WRITABLE) < 0)
+        return NULL;
+    if (offset < 0)
+        offset += vbuf.len;
+    if (offset < 0 || offset > vbuf.len) {
+        PyErr_Format(StructError, "offset %zd out of range for %zd-byte buffer",
+                     offset, vbuf.len);
+        PyBuffer_Release(&vbuf);
+        return NULL;
+    }
+    it = PyObject_GetIter(iterable);
+    if (it == NULL) {
+        PyBuffer_Release(&vbuf);
+        return NULL;
+    }
+    while ((item = PyIter_Next(it)) != NULL) {
+        if (vbuf.len - offset < soself->s_size) {
+            PyErr_Format(StructError,
+                         "pack_many_into buffer too small for record %zd",
+                         count);
+            Py_DECREF(item);
+            break;
+        }
+        if (s_pack_item(soself, item, (char *)vbuf.buf + offset,
+                        "pack_many_into") < 0) {
+            Py_DECREF(item);
+            break;
+        }
+        Py_DECREF(item);
+        offset += soself->s_size;
+        count++;
+    }
+    Py_DECREF(it);
+    PyBuffer_Release(&vbuf);
+    if (PyErr_Occurred())
+        return NULL;
+    return PyLong_FromSsize_t(count);
+}
+
 static PyObject *
 s_get_format(PyStructObject *self, void *unused)
 {
@@ -1779,7 +2295,12 @@ s_sizeof(PyStructObject *self, void *unused)
 static struct PyMethodDef s_methods[] = {
     {"pack",            s_pack,         METH_VARARGS, s_pack__doc__},
     {"pack_into",       s_pack_into,    METH_VARARGS, s_pack_into__doc__},
+    {"pack_many",       s_pack_many,    METH_O, s_pack_many__doc__},
+    {"pack_many_into",  s_pack_many_into, METH_VARARGS,
+                    s_pack_many_into__doc__},
     {"unpack",          s_unpack,       METH_O, s_unpack__doc__},
+    {"iter_unpack",     s_iter_unpack,  METH_O, s_iter_unpack__doc__},
+    {"unpack_many",     s_unpack_many,  METH_O, s_unpack_many__doc__},
     {"unpack_from",     (PyCFunction)s_unpack_from, METH_VARARGS|METH_KEYWORDS,
                     s_unpack_from__doc__},
     {"__sizeof__",      (PyCFunction)s_sizeof, METH_NOARGS, s_sizeof__doc__},
@@ -2026,12 +2547,120 @@ unpack_from(PyObject *self, PyObject *args, PyObject *kwds)
     return result;
 }
 
+PyDoc_STRVAR(iter_unpack_doc,
+"iter_unpack(fmt, buffer) -> iterator(v1, v2, ...)\n\
+\n\
+Return an iterator yielding tuples unpacked from the given bytes\n\
+source according to the format string, like a repeated invocation of\n\
+unpack_from().  Requires that the bytes length be a multiple of the\n\
+format struct size.");
+
+static PyObject *
+iter_unpack(PyObject *self, PyObject *args)
+{
+    PyObject *s_object, *fmt, *input, *result;
+
+    if (!PyArg_ParseTuple(args, "OO:iter_unpack", &fmt, &input))
+        return NULL;
+
+    s_object = cache_struct(fmt);
+    if (s_object == NULL)
+        return NULL;
+    result = s_iter_unpack(s_object, input);
+    Py_DECREF(s_object);
+    return result;
+}
+
+PyDoc_STRVAR(unpack_many_doc,
+"unpack_many(fmt, buffer) -> [column1, column2, ...]\n\
+\n\
+Unpack every record of the buffer according to the format string fmt\n\
+and return one column per value: an array.array for numeric codes and\n\
+a list otherwise.  Requires that the bytes length be a multiple of\n\
+calcsize(fmt).");
+
+static PyObject *
+unpack_many(PyObject *self, PyObject *args)
+{
+    PyObject *s_object, *fmt, *input, *result;
+
+    if (!PyArg_ParseTuple(args, "OO:unpack_many", &fmt, &input))
+        return NULL;
+
+    s_object = cache_struct(fmt);
+    if (s_object == NULL)
+        return NULL;
+    result = s_unpack_many(s_object, input);
+    Py_DECREF(s_object);
+    return result;
+}
+
+PyDoc_STRVAR(pack_many_doc,
+"pack_many(fmt, iterable) -> bytes\n\
+\n\
+Pack each item of the iterable according to the format string fmt and\n\
+return the records joined in one bytes object.  See help(struct) for\n\
+more on format strings.");
+
+static PyObject *
+pack_many(PyObject *self, PyObject *args)
+{
+    PyObject *s_object, *fmt, *iterable, *result;
+
+    if (!PyArg_ParseTuple(args, "OO:pack_many", &fmt, &iterable))
+        return NULL;
+
+    s_object = cache_struct(fmt);
+    if (s_object == NULL)
+        return NULL;
+    result = s_pack_many(s_object, iterable);
+    Py_DECREF(s_object);
+    return result;
+}
+
+PyDoc_STRVAR(pack_many_into_doc,
+"pack_many_into(fmt, buffer, offset, iterable) -> count\n\
+\n\
+Pack each item of the iterable according to the format string fmt and\n\
+write the records one after another into the writable buffer starting\n\
+at offset.  Return the number of records written.");
+
+static PyObject *
+pack_many_into(PyObject *self, PyObject *args)
+{
+    PyObject *s_object, *fmt, *newargs, *result;
+    Py_ssize_t n = PyTuple_GET_SIZE(args);
+
+    if (n == 0) {
+        PyErr_SetString(PyExc_TypeError, "missing format argument");
+        return NULL;
+    }
+    fmt = PyTuple_GET_ITEM(args, 0);
+    newargs = PyTuple_GetSlice(args, 1, n);
+    if (newargs == NULL)
+        return NULL;
+
+    s_object = cache_struct(fmt);
+    if (s_object == NULL) {
+        Py_DECREF(newargs);
+        return NULL;
+    }
+    result = s_pack_many_into(s_object, newargs);
+    Py_DECREF(newargs);
+    Py_DECREF(s_object);
+    return result;
+}
+
 static struct PyMethodDef module_functions[] = {
     {"_clearcache",     (PyCFunction)clearcache,        METH_NOARGS,    clearcache_doc},
     {"calcsize",        calcsize,       METH_O, calcsize_doc},
+    {"iter_unpack",     iter_unpack,    METH_VARARGS,   iter_unpack_doc},
     {"pack",            pack,           METH_VARARGS,   pack_doc},
     {"pack_into",       pack_into,      METH_VARARGS,   pack_into_doc},
+    {"pack_many",       pack_many,      METH_VARARGS,   pack_many_doc},
+    {"pack_many_into",  pack_many_into, METH_VARARGS,   pack_many_into_doc},
     {"unpack",          unpack, METH_VARARGS,   unpack_doc},
+    {"unpack_many",     unpack_many,    METH_VARARGS,   unpack_many_doc},
     {"unpack_from",     (PyCFunction)unpack_from,
                     METH_VARARGS|METH_KEYWORDS,         unpack_from_doc},
     {NULL,       NULL}          /* sentinel */
@@ -2096,6 +2725,9 @@ PyInit__struct(void)
     if (PyType_Ready(&PyStructType) < 0)
         return NULL;
 
+    if (PyType_Ready(&unpackiter_type) < 0)
+        return NULL;
+
     /* Check endian and swap in faster functions */
     {
         int one = 1;
@@ -37,6 +37,7 @@ typedef struct arrayobject {
     Py_ssize_t allocated;
     struct arraydescr *ob_descr;
     PyObject *weakreflist; /* List of weak references */
+    Py_buffer *ob_view;  /* External memory ob_item points into, or NULL */
     int ob_exports;  /* Number of exported buffers */
 } arrayobject;
 
@@ -45,17 +46,32 @@ static PyTypeObject Arraytype;
 #define array_Check(op) PyObject_TypeCheck(op, &Arraytype)
 #define array_CheckExact(op) (Py_TYPE(op) == &Arraytype)
 
+/* Return 0 if the array's size may change, else set BufferError and
+   return -1.  Arrays made by frombuffer() never own their memory. */
+static int
+array_canresize(arrayobject *self)
+{
+    if (self->ob_view != NULL) {
+        PyErr_SetString(PyExc_BufferError,
+            "cannot resize an array that views external memory");
+        return -1;
+    }
+    if (self->ob_exports > 0) {
+        PyErr_SetString(PyExc_BufferError,
+            "cannot resize an array that is exporting buffers");
+        return -1;
+    }
+    return 0;
+}
+
 static int
 array_resize(arrayobject *self, Py_ssize_t newsize)
 {
     char *items;
     size_t _new_size;
 
-    if (self->ob_exports > 0 && newsize != Py_SIZE(self)) {
-        PyErr_SetString(PyExc_BufferError,
-            "cannot resize an array that is exporting buffers");
+    if (newsize != Py_SIZE(self) && array_canresize(self) < 0)
         return -1;
-    }
 
     /* Bypass realloc() when a previous overallocation is large enough
        to accommodate the newsize.  If the newsize is 16 smaller than the
@@ -495,6 +511,7 @@ newarrayobject(PyTypeObject *type, Py_ssize_t size, struct arraydescr *descr)
     op->ob_descr = descr;
     op->allocated = size;
     op->weakreflist = NULL;
+    op->ob_view = NULL;
     Py_SIZE(op) = size;
     if (size <= 0) {
         op->ob_item = NULL;
@@ -557,7 +574,11 @@ array_dealloc(arrayobject *op)
 {
     if (op->weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject *) op);
-    if (op->ob_item != NULL)
+    if (op->ob_view != NULL) {
+        PyBuffer_Release(op->ob_view);
+        PyMem_Free(op->ob_view);
+    }
+    else if (op->ob_item != NULL)
         PyMem_DEL(op->ob_item);
     Py_TYPE(op)->tp_free((PyObject *)op);
 }
@@ -807,11 +828,8 @@ array_ass_slice(arrayobject *a, Py_ssize_t ilow, Py_ssize_t ihigh, PyObject *v)
     /* Issue #4509: If the array has exported buffers and the slice
        assignment would change the size of the array, fail early to make
        sure we don't modify it. */
-    if (d != 0 && a->ob_exports > 0) {
-        PyErr_SetString(PyExc_BufferError,
-            "cannot resize an array that is exporting buffers");
+    if (d != 0 && array_canresize(a) < 0)
         return -1;
-    }
     if (d < 0) { /* Delete -d items */
         memmove(item + (ihigh+d)*a->ob_descr->itemsize,
             item + ihigh*a->ob_descr->itemsize,
@@ -1152,6 +1170,31 @@ array_byteswap(arrayobject *self, PyObject *unused)
     char *p;
     Py_ssize_t i;
 
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)) \
+    && defined(PY_UINT32_T) && defined(PY_UINT64_T)
+    /* The compiler turns these loops into vector byte shuffles */
+    switch (self->ob_descr->itemsize) {
+    case 2: {
+        unsigned short *q = (unsigned short *)self->ob_item;
+        for (i = 0; i < Py_SIZE(self); i++)
+            q[i] = __builtin_bswap16(q[i]);
+        Py_RETURN_NONE;
+    }
+    case 4: {
+        PY_UINT32_T *q = (PY_UINT32_T *)self->ob_item;
+        for (i = 0; i < Py_SIZE(self); i++)
+            q[i] = __builtin_bswap32(q[i]);
+        Py_RETURN_NONE;
+    }
+    case 8: {
+        PY_UINT64_T *q = (PY_UINT64_T *)self->ob_item;
+        for (i = 0; i < Py_SIZE(self); i++)
+            q[i] = __builtin_bswap64(q[i]);
+        Py_RETURN_NONE;
+    }
+    }
+#endif
+
     switch (self->ob_descr->itemsize) {
     case 1:
         break;
@@ -1235,6 +1278,688 @@ PyDoc_STRVAR(reverse_doc,
 \n\
 Reverse the order of the items in the array.");
 
+#ifdef HAVE_LONG_LONG
+
+/* Numeric kernels.
+ *
+ * These methods work on the raw items instead of boxing every element.
+ * Each loop is written once as a macro and expanded for every numeric
+ * item type.  The loops are plain (independent accumulators, no calls or
+ * early exits), so the compiler can vectorize them for the common
+ * typecodes.  Integer results are exact: sums are collected in chunks
+ * small enough that 64-bit accumulators cannot overflow.
+ */
+
+/* Items per chunk of an integer reduction.  Sums of up to this many
+   32-bit halves fit in 64 bits. */
+#define KERNEL_CHUNK ((Py_ssize_t)1 << 30)
+
+#define LOW32(x) ((x) & 0xffffffffU)
+
+/* Expand X(typecode, C type, is_signed) for every integer typecode and
+   X(typecode, C type) for every float typecode.  is_signed matches the
+   descriptor table. */
+#define ARRAY_INTEGER_TYPES(X) \
+    X('b', signed char, 1) \
+    X('B', unsigned char, 0) \
+    X('h', short, 1) \
+    X('H', unsigned short, 0) \
+    X('i', int, 1) \
+    X('I', unsigned int, 0) \
+    X('l', long, 1) \
+    X('L', unsigned long, 0) \
+    X('q', PY_LONG_LONG, 1) \
+    X('Q', unsigned PY_LONG_LONG, 0)
+
+#define ARRAY_FLOAT_TYPES(X) \
+    X('f', float) \
+    X('d', double)
+
+static int
+is_float_array(arrayobject *a)
+{
+    return a->ob_descr->typecode == 'f' || a->ob_descr->typecode == 'd';
+}
+
+static int
+check_numeric_array(arrayobject *a, const char *name)
+{
+    if (!a->ob_descr->is_integer_type && !is_float_array(a)) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s() requires a numeric array, not typecode '%c'",
+                     name, a->ob_descr->typecode);
+        return -1;
+    }
+    return 0;
+}
+
+/* Return hi * 2**32 + lo as an int, added to *total */
+static int
+add_split_sum(PyObject **total, PyObject *hi, PyObject *lo)
+{
+    PyObject *tmp, *shift;
+
+    if (hi == NULL || lo == NULL)
+        goto error;
+    shift = PyLong_FromLong(32);
+    if (shift == NULL)
+        goto error;
+    tmp = PyNumber_Lshift(hi, shift);
+    Py_DECREF(shift);
+    Py_DECREF(hi);
+    hi = tmp;
+    if (hi == NULL)
+        goto error;
+    tmp = PyNumber_Add(hi, lo);
+    Py_DECREF(hi);
+    Py_DECREF(lo);
+    if (tmp == NULL)
+        return -1;
+    hi = PyNumber_Add(*total, tmp);
+    Py_DECREF(tmp);
+    if (hi == NULL)
+        return -1;
+    Py_DECREF(*total);
+    *total = hi;
+    return 0;
+
+error:
+    Py_XDECREF(hi);
+    Py_XDECREF(lo);
+    return -1;
+}
+
+/* Sum of the chunk p[0:n] as the pair shi * 2**32 + slo (signed types)
+   or uhi * 2**32 + ulo (unsigned types) */
+#define SUM_INTEGER(code, type, is_signed)                              \
+    case code: {                                                        \
+        const type *p = (const type *)items;                            \
+        if (is_signed) {                                                \
+            for (i = 0; i < n; i++) {                                   \
+                PY_LONG_LONG v = (PY_LONG_LONG)p[i];                    \
+                shi += Py_ARITHMETIC_RIGHT_SHIFT(PY_LONG_LONG, v, 32);  \
+                ulo += LOW32((unsigned PY_LONG_LONG)v);                 \
+            }                                                           \
+        }                                                               \
+        else {                                                          \
+            for (i = 0; i < n; i++) {                                   \
+                unsigned PY_LONG_LONG v = (unsigned PY_LONG_LONG)p[i];  \
+                uhi += v >> 32;                                         \
+                ulo += LOW32(v);                                        \
+            }                                                           \
+        }                                                               \
+        break;                                                          \
+    }
+
+#define SUM_FLOAT(code, type)                                           \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;                  \
+        for (i = 0; i + 4 <= n; i += 4) {                               \
+            s0 += p[i];                                                 \
+            s1 += p[i + 1];                                             \
+            s2 += p[i + 2];                                             \
+            s3 += p[i + 3];                                             \
+        }                                                               \
+        for (; i < n; i++)                                              \
+            s0 += p[i];                                                 \
+        return PyFloat_FromDouble((s0 + s1) + (s2 + s3));               \
+    }
+
+static PyObject *
+array_sum(arrayobject *self, PyObject *unused)
+{
+    PyObject *total;
+    Py_ssize_t i, n, start, size = Py_SIZE(self);
+
+    if (check_numeric_array(self, "sum") < 0)
+        return NULL;
+    if (is_float_array(self)) {
+        n = size;
+        switch (self->ob_descr->typecode) {
+        ARRAY_FLOAT_TYPES(SUM_FLOAT)
+        }
+    }
+
+    total = PyLong_FromLong(0);
+    for (start = 0; total != NULL && start < size; start += n) {
+        const char *items = self->ob_item + start * self->ob_descr->itemsize;
+        PY_LONG_LONG shi = 0;
+        unsigned PY_LONG_LONG uhi = 0, ulo = 0;
+
+        n = Py_MIN(size - start, KERNEL_CHUNK);
+        switch (self->ob_descr->typecode) {
+        ARRAY_INTEGER_TYPES(SUM_INTEGER)
+        }
+        if (add_split_sum(&total,
+                          self->ob_descr->is_signed ?
+                              PyLong_FromLongLong(shi) :
+                              PyLong_FromUnsignedLongLong(uhi),
+                          PyLong_FromUnsignedLongLong(ulo)) < 0)
+            Py_CLEAR(total);
+    }
+    return total;
+}
+
+PyDoc_STRVAR(sum_doc,
+"sum()\n\
+\n\
+Return the sum of the items of a numeric array.  Integer arrays give an\n\
+exact int; float arrays give a float, accumulated in double precision.");
+
+#define MINMAX_INTEGER(code, type, is_signed)                           \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        type lo = p[0], hi = p[0];                                      \
+        for (i = 1; i < n; i++) {                                       \
+            lo = p[i] < lo ? p[i] : lo;                                 \
+            hi = p[i] > hi ? p[i] : hi;                                 \
+        }                                                               \
+        if (is_signed)                                                  \
+            return PyLong_FromLongLong(want_max ? hi : lo);             \
+        return PyLong_FromUnsignedLongLong(want_max ? hi : lo);         \
+    }
+
+#define MINMAX_FLOAT(code, type)                                        \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        type lo = p[0], hi = p[0];                                      \
+        int nan = p[0] != p[0];                                         \
+        for (i = 1; i < n; i++) {                                       \
+            lo = p[i] < lo ? p[i] : lo;                                 \
+            hi = p[i] > hi ? p[i] : hi;                                 \
+            nan |= p[i] != p[i];                                        \
+        }                                                               \
+        if (nan)                                                        \
+            return PyFloat_FromDouble(Py_NAN);                          \
+        return PyFloat_FromDouble(want_max ? hi : lo);                  \
+    }
+
+static PyObject *
+array_minmax(arrayobject *self, int want_max)
+{
+    Py_ssize_t i, n = Py_SIZE(self);
+
+    if (check_numeric_array(self, want_max ? "max" : "min") < 0)
+        return NULL;
+    if (n == 0) {
+        PyErr_Format(PyExc_ValueError, "%s() of an empty array",
+                     want_max ? "max" : "min");
+        return NULL;
+    }
+    switch (self->ob_descr->typecode) {
+    ARRAY_INTEGER_TYPES(MINMAX_INTEGER)
+    ARRAY_FLOAT_TYPES(MINMAX_FLOAT)
+    }
+    PyErr_BadInternalCall();
+    return NULL;
+}
+
+static PyObject *
+array_min(arrayobject *self, PyObject *unused)
+{
+    return array_minmax(self, 0);
+}
+
+PyDoc_STRVAR(min_doc,
+"min()\n\
+\n\
+Return the smallest item of a non-empty numeric array.  The result is\n\
+NaN if a float array contains a NaN.");
+
+static PyObject *
+array_max(arrayobject *self, PyObject *unused)
+{
+    return array_minmax(self, 1);
+}
+
+PyDoc_STRVAR(max_doc,
+"max()\n\
+\n\
+Return the largest item of a non-empty numeric array.  The result is\n\
+NaN if a float array contains a NaN.");
+
+/* Check that other is an array of the same typecode and length as self */
+static int
+check_same_shape(arrayobject *self, PyObject *other, const char *name)
+{
+    if (!array_Check(other)) {
+        PyErr_Format(PyExc_TypeError, "%s() argument must be an array, "
+                     "not %.200s", name, Py_TYPE(other)->tp_name);
+        return -1;
+    }
+    if (((arrayobject *)other)->ob_descr != self->ob_descr) {
+        PyErr_Format(PyExc_TypeError, "%s() requires arrays of the same "
+                     "typecode", name);
+        return -1;
+    }
+    if (Py_SIZE(other) != Py_SIZE(self)) {
+        PyErr_Format(PyExc_ValueError, "%s() requires arrays of the same "
+                     "length", name);
+        return -1;
+    }
+    return 0;
+}
+
+/* Products of items up to 32 bits fit in 64 bits; they are summed like
+   array_sum() sums 64-bit items. */
+#define DOT_INTEGER(code, type, is_signed)                              \
+    case code: {                                                        \
+        const type *p = (const type *)items;                            \
+        const type *q = (const type *)other_items;                      \
+        if (is_signed) {                                                \
+            for (i = 0; i < n; i++) {                                   \
+                PY_LONG_LONG v = (PY_LONG_LONG)p[i] * q[i];             \
+                shi += Py_ARITHMETIC_RIGHT_SHIFT(PY_LONG_LONG, v, 32);  \
+                ulo += LOW32((unsigned PY_LONG_LONG)v);                 \
+            }                                                           \
+        }                                                               \
+        else {                                                          \
+            for (i = 0; i < n; i++) {                                   \
+                unsigned PY_LONG_LONG v =                               \
+                    (unsigned PY_LONG_LONG)p[i] * q[i];                 \
+                uhi += v >> 32;                                         \
+                ulo += LOW32(v);                                        \
+            }                                                           \
+        }                                                               \
+        break;                                                          \
+    }
+
+#define DOT_FLOAT(code, type)                                           \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        const type *q = (const type *)b->ob_item;                       \
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;                  \
+        for (i = 0; i + 4 <= n; i += 4) {                               \
+            s0 += (double)p[i] * q[i];                                  \
+            s1 += (double)p[i + 1] * q[i + 1];                          \
+            s2 += (double)p[i + 2] * q[i + 2];                          \
+            s3 += (double)p[i + 3] * q[i + 3];                          \
+        }                                                               \
+        for (; i < n; i++)                                              \
+            s0 += (double)p[i] * q[i];                                  \
+        return PyFloat_FromDouble((s0 + s1) + (s2 + s3));               \
+    }
+
+static PyObject *
+array_dot(arrayobject *self, PyObject *other)
+{
+    arrayobject *b = (arrayobject *)other;
+    PyObject *total;
+    Py_ssize_t i, n, start, size = Py_SIZE(self);
+    int itemsize = self->ob_descr->itemsize;
+
+    if (check_numeric_array(self, "dot") < 0 ||
+        check_same_shape(self, other, "dot") < 0)
+        return NULL;
+    if (is_float_array(self)) {
+        n = size;
+        switch (self->ob_descr->typecode) {
+        ARRAY_FLOAT_TYPES(DOT_FLOAT)
+        }
+    }
+
+    total = PyLong_FromLong(0);
+    if (itemsize > 4) {
+        /* 64-bit products can overflow; multiply as ints */
+        for (i = 0; total != NULL && i < size; i++) {
+            PyObject *x, *y, *prod = NULL;
+
+            x = (*self->ob_descr->getitem)(self, i);
+            y = (*b->ob_descr->getitem)(b, i);
+            if (x != NULL && y != NULL)
+                prod = PyNumber_Multiply(x, y);
+            Py_XDECREF(x);
+            Py_XDECREF(y);
+            if (prod == NULL) {
+                Py_CLEAR(total);
+                break;
+            }
+            x = PyNumber_Add(total, prod);
+            Py_DECREF(prod);
+            Py_DECREF(total);
+            total = x;
+        }
+        return total;
+    }
+    for (start = 0; total != NULL && start < size; start += n) {
+        const char *items = self->ob_item + start * itemsize;
+        const char *other_items = b->ob_item + start * itemsize;
+        PY_LONG_LONG shi = 0;
+        unsigned PY_LONG_LONG uhi = 0, ulo = 0;
+
+        n = Py_MIN(size - start, KERNEL_CHUNK);
+        switch (self->ob_descr->typecode) {
+        ARRAY_INTEGER_TYPES(DOT_INTEGER)
+        }
+        if (add_split_sum(&total,
+                          self->ob_descr->is_signed ?
+                              PyLong_FromLongLong(shi) :
+                              PyLong_FromUnsignedLongLong(uhi),
+                          PyLong_FromUnsignedLongLong(ulo)) < 0)
+            Py_CLEAR(total);
+    }
+    return total;
+}
+
+PyDoc_STRVAR(dot_doc,
+"dot(other)\n\
+\n\
+Return the sum of the products of the items of two numeric arrays of the\n\
+same typecode and length.");
+
+/* Checked arithmetic for the in-place integer operations.  The operand of
+   an unsigned array is split into a sign and a magnitude, so that adding
+   a negative number still works. */
+static int
+ll_apply(int op, PY_LONG_LONG a, PY_LONG_LONG b, PY_LONG_LONG *r)
+{
+    if (op == '+') {
+        if ((b > 0 && a > PY_LLONG_MAX - b) ||
+            (b < 0 && a < PY_LLONG_MIN - b))
+            return -1;
+        *r = a + b;
+    }
+    else {
+        if (a > 0 ? (b > 0 ? a > PY_LLONG_MAX / b : b < PY_LLONG_MIN / a)
+                  : (b > 0 ? a < PY_LLONG_MIN / b
+                           : (a != 0 && b < PY_LLONG_MAX / a)))
+            return -1;
+        *r = a * b;
+    }
+    return 0;
+}
+
+static int
+ull_apply(int op, unsigned PY_LONG_LONG a, int negative,
+          unsigned PY_LONG_LONG b, unsigned PY_LONG_LONG *r)
+{
+    if (op == '+') {
+        if (negative) {
+            if (a < b)
+                return -1;
+            *r = a - b;
+        }
+        else {
+            *r = a + b;
+            if (*r < a)
+                return -1;
+        }
+    }
+    else if (negative) {
+        if (a != 0)
+            return -1;
+        *r = 0;
+    }
+    else {
+        if (b != 0 && a > PY_ULLONG_MAX / b)
+            return -1;
+        *r = a * b;
+    }
+    return 0;
+}
+
+#define APPLY_SIGNED(code, type, lo, hi)                                \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        const type *q = (const type *)other_items;                      \
+        type *r = (type *)out;                                          \
+        for (i = 0; i < n; i++) {                                       \
+            PY_LONG_LONG v;                                             \
+            if (ll_apply(op, p[i], q != NULL ? q[i] : s_operand, &v) < 0 \
+                || v < (lo) || v > (hi))                                \
+                goto overflow;                                          \
+            r[i] = (type)v;                                             \
+        }                                                               \
+        break;                                                          \
+    }
+
+#define APPLY_UNSIGNED(code, type, hi)                                  \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        const type *q = (const type *)other_items;                      \
+        type *r = (type *)out;                                          \
+        for (i = 0; i < n; i++) {                                       \
+            unsigned PY_LONG_LONG v;                                    \
+            if (ull_apply(op, p[i], q != NULL ? 0 : negative,           \
+                          q != NULL ? q[i] : u_operand, &v) < 0 ||      \
+                v > (hi))                                               \
+                goto overflow;                                          \
+            r[i] = (type)v;                                             \
+        }                                                               \
+        break;                                                          \
+    }
+
+#define APPLY_FLOAT(code, type)                                         \
+    case code: {                                                        \
+        type *p = (type *)self->ob_item;                                \
+        const type *q = (const type *)other_items;                      \
+        if (q == NULL && op == '+')                                     \
+            for (i = 0; i < n; i++)                                     \
+                p[i] = (type)(p[i] + d_operand);                        \
+        else if (q == NULL)                                             \
+            for (i = 0; i < n; i++)                                     \
+                p[i] = (type)(p[i] * d_operand);                        \
+        else if (op == '+')                                             \
+            for (i = 0; i < n; i++)                                     \
+                p[i] = p[i] + q[i];                                     \
+        else                                                            \
+            for (i = 0; i < n; i++)                                     \
+                p[i] = p[i] * q[i];                                     \
+        break;                                                          \
+    }
+
+/* self[i] = self[i] op operand[i] (or op operand for a scalar), in place.
+   Integer results must fit the typecode; if one does not, OverflowError is
+   raised and the array is left unchanged. */
+static PyObject *
+array_apply(arrayobject *self, PyObject *operand, int op, const char *name)
+{
+    const char *other_items = NULL;
+    char *out;
+    PY_LONG_LONG s_operand = 0;
+    unsigned PY_LONG_LONG u_operand = 0;
+    double d_operand = 0.0;
+    int negative = 0;
+    Py_ssize_t i, n = Py_SIZE(self);
+
+    if (check_numeric_array(self, name) < 0)
+        return NULL;
+    if (array_Check(operand)) {
+        if (check_same_shape(self, operand, name) < 0)
+            return NULL;
+        other_items = ((arrayobject *)operand)->ob_item;
+    }
+    else if (is_float_array(self)) {
+        d_operand = PyFloat_AsDouble(operand);
+        if (d_operand == -1.0 && PyErr_Occurred())
+            return NULL;
+    }
+    else {
+        if (!PyLong_Check(operand)) {
+            PyErr_Format(PyExc_TypeError, "%s() argument must be an int or "
+                         "an array, not %.200s", name,
+                         Py_TYPE(operand)->tp_name);
+            return NULL;
+        }
+        if (self->ob_descr->is_signed) {
+            s_operand = PyLong_AsLongLong(operand);
+            if (s_operand == -1 && PyErr_Occurred())
+                return NULL;
+        }
+        else {
+            PyObject *magnitude = PyNumber_Absolute(operand);
+            if (magnitude == NULL)
+                return NULL;
+            negative = _PyLong_Sign(operand) < 0;
+            u_operand = PyLong_AsUnsignedLongLong(magnitude);
+            Py_DECREF(magnitude);
+            if (u_operand == (unsigned PY_LONG_LONG)-1 && PyErr_Occurred())
+                return NULL;
+        }
+    }
+
+    if (is_float_array(self)) {
+        switch (self->ob_descr->typecode) {
+        ARRAY_FLOAT_TYPES(APPLY_FLOAT)
+        }
+        Py_RETURN_NONE;
+    }
+
+    /* Integer results go to a scratch buffer first */
+    out = PyMem_Malloc(n > 0 ? n * self->ob_descr->itemsize : 1);
+    if (out == NULL)
+        return PyErr_NoMemory();
+    switch (self->ob_descr->typecode) {
+    APPLY_SIGNED('b', signed char, SCHAR_MIN, SCHAR_MAX)
+    APPLY_UNSIGNED('B', unsigned char, UCHAR_MAX)
+    APPLY_SIGNED('h', short, SHRT_MIN, SHRT_MAX)
+    APPLY_UNSIGNED('H', unsigned short, USHRT_MAX)
+    APPLY_SIGNED('i', int, INT_MIN, INT_MAX)
+    APPLY_UNSIGNED('I', unsigned int, UINT_MAX)
+    APPLY_SIGNED('l', long, LONG_MIN, LONG_MAX)
+    APPLY_UNSIGNED('L', unsigned long, ULONG_MAX)
+    APPLY_SIGNED('q', PY_LONG_LONG, PY_LLONG_MIN, PY_LLONG_MAX)
+    APPLY_UNSIGNED('Q', unsigned PY_LONG_LONG, PY_ULLONG_MAX)
+    }
+    if (n > 0)
+        memcpy(self->ob_item, out, n * self->ob_descr->itemsize);
+    PyMem_Free(out);
+    Py_RETURN_NONE;
+
+overflow:
+    PyMem_Free(out);
+    PyErr_Format(PyExc_OverflowError, "%s() result out of range for array "
+                 "of typecode '%c'", name, self->ob_descr->typecode);
+    return NULL;
+}
+
+static PyObject *
+array_add(arrayobject *self, PyObject *operand)
+{
+    return array_apply(self, operand, '+', "add");
+}
+
+PyDoc_STRVAR(add_doc,
+"add(x)\n\
+\n\
+Add x to every item of the array, in place.  x is a number or an array\n\
+of the same typecode and length, which is added item by item.");
+
+static PyObject *
+array_mul(arrayobject *self, PyObject *operand)
+{
+    return array_apply(self, operand, '*', "mul");
+}
+
+PyDoc_STRVAR(mul_doc,
+"mul(x)\n\
+\n\
+Multiply every item of the array by x, in place.  x is a number or an\n\
+array of the same typecode and length, which is multiplied item by item.");
+
+#define SEARCH(code, type, value)                                       \
+    case code: {                                                        \
+        const type *p = (const type *)self->ob_item;                    \
+        while (lo < hi) {                                               \
+            Py_ssize_t mid = lo + (hi - lo) / 2;                        \
+            if (right ? !((value) < p[mid]) : p[mid] < (value))         \
+                lo = mid + 1;                                           \
+            else                                                        \
+                hi = mid;                                               \
+        }                                                               \
+        break;                                                          \
+    }
+#define SEARCH_SIGNED(code, type) SEARCH(code, type, s_value)
+#define SEARCH_UNSIGNED(code, type) SEARCH(code, type, u_value)
+#define SEARCH_FLOAT(code, type) SEARCH(code, type, d_value)
+
+static PyObject *
+array_searchsorted(arrayobject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"x", "side", NULL};
+    PyObject *x;
+    const char *side = "left";
+    PY_LONG_LONG s_value = 0;
+    unsigned PY_LONG_LONG u_value = 0;
+    double d_value = 0.0;
+    Py_ssize_t lo = 0, hi = Py_SIZE(self);
+    int right, overflow;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|s:searchsorted", kwlist,
+                                     &x, &side))
+        return NULL;
+    if (strcmp(side, "left") == 0)
+        right = 0;
+    else if (strcmp(side, "right") == 0)
+        right = 1;
+    else {
+        PyErr_SetString(PyExc_ValueError,
+                        "side must be 'left' or 'right'");
+        return NULL;
+    }
+    if (check_numeric_array(self, "searchsorted") < 0)
+        return NULL;
+
+    if (is_float_array(self)) {
+        d_value = PyFloat_AsDouble(x);
+        if (d_value == -1.0 && PyErr_Occurred())
+            return NULL;
+        switch (self->ob_descr->typecode) {
+        ARRAY_FLOAT_TYPES(SEARCH_FLOAT)
+        }
+        return PyLong_FromSsize_t(lo);
+    }
+
+    if (!PyLong_Check(x)) {
+        PyErr_Format(PyExc_TypeError, "searchsorted() argument must be an "
+                     "int, not %.200s", Py_TYPE(x)->tp_name);
+        return NULL;
+    }
+    /* Values outside the item range sort before or after every item */
+    if (self->ob_descr->is_signed) {
+        s_value = PyLong_AsLongLongAndOverflow(x, &overflow);
+        if (s_value == -1 && PyErr_Occurred())
+            return NULL;
+    }
+    else if (_PyLong_Sign(x) < 0)
+        overflow = -1;
+    else {
+        overflow = 0;
+        u_value = PyLong_AsUnsignedLongLong(x);
+        if (u_value == (unsigned PY_LONG_LONG)-1 && PyErr_Occurred()) {
+            if (!PyErr_ExceptionMatches(PyExc_OverflowError))
+                return NULL;
+            PyErr_Clear();
+            overflow = 1;
+        }
+    }
+    if (overflow)
+        return PyLong_FromSsize_t(overflow < 0 ? 0 : Py_SIZE(self));
+    switch (self->ob_descr->typecode) {
+    SEARCH_SIGNED('b', signed char)
+    SEARCH_UNSIGNED('B', unsigned char)
+    SEARCH_SIGNED('h', short)
+    SEARCH_UNSIGNED('H', unsigned short)
+    SEARCH_SIGNED('i', int)
+    SEARCH_UNSIGNED('I', unsigned int)
+    SEARCH_SIGNED('l', long)
+    SEARCH_UNSIGNED('L', unsigned long)
+    SEARCH_SIGNED('q', PY_LONG_LONG)
+    SEARCH_UNSIGNED('Q', unsigned PY_LONG_LONG)
+    }
+    return PyLong_FromSsize_t(lo);
+}
+
+PyDoc_STRVAR(searchsorted_doc,
+"searchsorted(x, side='left')\n\
+\n\
+Return the index where x would be inserted into the array, which must be\n\
+sorted in ascending order, to keep it sorted.  With side='left' the index\n\
+is before any items equal to x, with side='right' after them.");
+
+#endif /* HAVE_LONG_LONG */
+
 
 /* Forward */
 static PyObject *array_frombytes(arrayobject *self, PyObject *args);
@@ -1575,7 +2300,10 @@ static PyObject *
 array_sizeof(arrayobject *self, PyObject *unused)
 {
     Py_ssize_t res;
-    res = sizeof(arrayobject) + self->allocated * self->ob_descr->itemsize;
+    if (self->ob_view != NULL)
+        res = sizeof(arrayobject) + sizeof(Py_buffer);
+    else
+        res = sizeof(arrayobject) + self->allocated * self->ob_descr->itemsize;
     return PyLong_FromSsize_t(res);
 }
 
@@ -2160,6 +2888,22 @@ static PyMethodDef array_methods[] = {
      tounicode_doc},
     {"__sizeof__",      (PyCFunction)array_sizeof,      METH_NOARGS,
      sizeof_doc},
+#ifdef HAVE_LONG_LONG
+    {"add",             (PyCFunction)array_add,         METH_O,
+     add_doc},
+    {"dot",             (PyCFunction)array_dot,         METH_O,
+     dot_doc},
+    {"max",             (PyCFunction)array_max,         METH_NOARGS,
+     max_doc},
+    {"min",             (PyCFunction)array_min,         METH_NOARGS,
+     min_doc},
+    {"mul",             (PyCFunction)array_mul,         METH_O,
+     mul_doc},
+    {"searchsorted",    (PyCFunction)array_searchsorted,
+     METH_VARARGS | METH_KEYWORDS, searchsorted_doc},
+    {"sum",             (PyCFunction)array_sum,         METH_NOARGS,
+     sum_doc},
+#endif
     {NULL,              NULL}           /* sentinel */
 };
 
@@ -2325,11 +3069,9 @@ array_ass_subscr(arrayobject* self, PyObject* item, PyObject* value)
     /* Issue #4509: If the array has exported buffers and the slice
        assignment would change the size of the array, fail early to make
        sure we don't modify it. */
-    if ((needed == 0 || slicelength != needed) && self->ob_exports > 0) {
-        PyErr_SetString(PyExc_BufferError,
-            "cannot resize an array that is exporting buffers");
+    if ((needed == 0 || slicelength != needed) &&
+        array_canresize(self) < 0)
         return -1;
-    }
 
     if (step == 1) {
         if (slicelength > needed) {
@@ -2642,6 +3384,9 @@ C compiler used to build Python supports 'long long', or, on Windows, \n\
 The constructor is:\n\
 \n\
 array(typecode [, initializer]) -- create a new array\n\
+\n\
+frombuffer(typecode, buffer) makes an array over existing memory, such\n\
+as a shared mmap, without copying it.\n\
 ");
 
 PyDoc_STRVAR(arraytype_doc,
@@ -2673,6 +3418,16 @@ tofile() -- write all items to a file object\n\
 tolist() -- return the array converted to an ordinary list\n\
 tobytes() -- return the array converted to a string\n\
 \n\
+Numeric methods:\n\
+\n\
+sum() -- return the sum of the items\n\
+min() -- return the smallest item\n\
+max() -- return the largest item\n\
+dot() -- return the sum of the products of the items of two arrays\n\
+add() -- add a number or array to the items, in place\n\
+mul() -- multiply the items by a number or array, in place\n\
+searchsorted() -- return the insertion point of a value in a sorted array\n\
+\n\
 Attributes:\n\
 \n\
 typecode -- the typecode character used to create the array\n\
@@ -2844,12 +3599,82 @@ static PyTypeObject PyArrayIter_Type = {
 };
 
 
+/*********************** Shared memory ***************************/
+
+PyDoc_STRVAR(frombuffer_doc,
+"frombuffer(typecode, buffer) -> array\n\
+\n\
+Return an array whose items live in the memory of buffer, which must be\n\
+a writable, contiguous object such as a bytearray or an mmap.  Nothing is\n\
+copied: writes through either object are visible through the other, so an\n\
+array over a shared mmap is visible to other processes.  The buffer stays\n\
+exported for the lifetime of the array and the array cannot be resized.");
+
+static PyObject *
+array_frombuffer(PyObject *self, PyObject *args)
+{
+    int c;
+    PyObject *obj;
+    Py_buffer *view;
+    struct arraydescr *descr;
+    arrayobject *a;
+
+    if (!PyArg_ParseTuple(args, "CO:frombuffer", &c, &obj))
+        return NULL;
+    for (descr = descriptors; descr->typecode != '\0'; descr++) {
+        if ((int)descr->typecode == c)
+            break;
+    }
+    if (descr->typecode == '\0') {
+        PyErr_SetString(PyExc_ValueError,
+#ifdef HAVE_LONG_LONG
+            "bad typecode (must be b, B, u, h, H, i, I, l, L, q, Q, f or d)");
+#else
+            "bad typecode (must be b, B, u, h, H, i, I, l, L, f or d)");
+#endif
+        return NULL;
+    }
+
+    view = PyMem_Malloc(sizeof(Py_buffer));
+    if (view == NULL)
+        return PyErr_NoMemory();
+    if (PyObject_GetBuffer(obj, view, PyBUF_WRITABLE) < 0) {
+        PyMem_Free(view);
+        return NULL;
+    }
+    if (view->len % descr->itemsize != 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "buffer length not a multiple of item size");
+        goto error;
+    }
+    if ((Py_uintptr_t)view->buf % descr->itemsize != 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "buffer not aligned to the item size");
+        goto error;
+    }
+
+    a = (arrayobject *)newarrayobject(&Arraytype, 0, descr);
+    if (a == NULL)
+        goto error;
+    a->ob_item = view->buf;
+    a->ob_view = view;
+    Py_SIZE(a) = view->len / descr->itemsize;
+    a->allocated = Py_SIZE(a);
+    return (PyObject *)a;
+
+  error:
+    PyBuffer_Release(view);
+    PyMem_Free(view);
+    return NULL;
+}
+
+
 /*********************** Install Module **************************/
 
-/* No functions in array module. */
 static PyMethodDef a_methods[] = {
     {"_array_reconstructor", array_reconstructor, METH_VARARGS,
      PyDoc_STR("Internal. Used for pickling support.")},
+    {"frombuffer", array_frombuffer, METH_VARARGS, frombuffer_doc},
     {NULL, NULL, 0, NULL}        /* Sentinel */
 };
 
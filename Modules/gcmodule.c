@@ -25,6 +25,9 @@
 
 #include "Python.h"
 #include "frameobject.h"        /* for PyFrame_ClearFreeList */
+#ifdef WITH_THREAD
+#include "pythread.h"
+#endif
 
 #ifndef WITH_PARALLEL
 /* Get an object's GC head */
@@ -525,6 +528,345 @@ move_unreachable(PyGC_Head *young, PyGC_Head *unreachable)
     }
 }
 
+/*** parallel marking ***/
+
+/* Full collections of large heaps can split update_refs(), subtract_refs()
+ * and the reachability scan of move_unreachable() across several threads.
+ * The caller holds the GIL for the whole collection and only starts the
+ * helper threads after the young list has been merged, so the list links
+ * are never modified while the helpers run; the helpers only read the
+ * objects (through tp_traverse) and update gc_refs.
+ *
+ * Concurrent updates of gc_refs are done with atomic operations:
+ *
+ *  - subtract_refs: a positive gc_refs is only ever decremented, and never
+ *    below zero (the true refcount bounds the number of internal
+ *    references), so an atomic decrement is sufficient.
+ *
+ *  - marking: objects whose gc_refs is still positive are roots.  A worker
+ *    claims an object by swapping its gc_refs (>= 0) for GC_REACHABLE with
+ *    a compare-and-swap, and then traverses it.  Since GC_REACHABLE is the
+ *    only transition possible during this phase, a failed swap means that
+ *    another worker already claimed the object.
+ *
+ * Finally, a sequential sweep moves everything that was not claimed to the
+ * unreachable list.  The set of unreachable objects is the same as with
+ * move_unreachable(); only the order of the list differs.
+ *
+ * Worker threads must not run any code that needs the GIL or a thread
+ * state, which is why the traversal is the only thing done in them.  This
+ * rules out PyParallel builds, where Py_VISIT() asserts that it runs on the
+ * main thread.
+ */
+#if defined(WITH_THREAD) && !defined(WITH_PARALLEL)
+#  if defined(__GNUC__)
+#    define HAVE_GC_PARALLEL_MARK
+#    define GC_ATOMIC_DECREF(p) ((void)__sync_fetch_and_sub((p), 1))
+#    define GC_ATOMIC_CLAIM(p, old) \
+        __sync_bool_compare_and_swap((p), (old), (Py_ssize_t)GC_REACHABLE)
+#  elif defined(_MSC_VER)
+#    include <intrin.h>
+#    define HAVE_GC_PARALLEL_MARK
+#    ifdef MS_WIN64
+#      define GC_ATOMIC_DECREF(p) \
+        ((void)_InterlockedDecrement64((__int64 volatile *)(p)))
+#      define GC_ATOMIC_CLAIM(p, old) \
+        (_InterlockedCompareExchange64((__int64 volatile *)(p), \
+                                       GC_REACHABLE, (old)) == (old))
+#    else
+#      define GC_ATOMIC_DECREF(p) \
+        ((void)_InterlockedDecrement((long volatile *)(p)))
+#      define GC_ATOMIC_CLAIM(p, old) \
+        (_InterlockedCompareExchange((long volatile *)(p), \
+                                     GC_REACHABLE, (old)) == (old))
+#    endif
+#  endif
+#endif
+
+/* Number of threads used for marking full collections (1 disables parallel
+ * marking), and the minimum number of objects in the collected generation
+ * for which it is worth starting them. */
+static int mark_threads = 1;
+static Py_ssize_t mark_min_objects = 100000;
+
+#define GC_MAX_MARK_THREADS 64
+
+#ifdef HAVE_GC_PARALLEL_MARK
+
+typedef struct _gc_mark_chunk gc_mark_chunk;
+typedef void (*gc_mark_phase)(gc_mark_chunk *);
+
+struct _gc_mark_chunk {
+    PyGC_Head *start;           /* first object of this worker's slice */
+    Py_ssize_t count;           /* number of objects in the slice */
+    gc_mark_phase phase;        /* work to run on the slice */
+    PyThread_type_lock done;    /* released when phase has run */
+    PyGC_Head **stack;          /* pending objects for the mark phase */
+    Py_ssize_t stack_len;
+    Py_ssize_t stack_size;
+    int overflowed;             /* a mark stack allocation failed */
+};
+
+static void
+mark_update_refs(gc_mark_chunk *chunk)
+{
+    PyGC_Head *gc = chunk->start;
+    Py_ssize_t i;
+    for (i = 0; i < chunk->count; i++, gc = gc->gc.gc_next) {
+        assert(gc->gc.gc_refs == GC_REACHABLE);
+        gc->gc.gc_refs = Py_REFCNT(FROM_GC(gc));
+        assert(gc->gc.gc_refs != 0);
+    }
+}
+
+static int
+visit_decref_atomic(PyObject *op, void *data)
+{
+    if (PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        assert(gc->gc.gc_refs != 0);
+        if (gc->gc.gc_refs > 0)
+            GC_ATOMIC_DECREF(&gc->gc.gc_refs);
+    }
+    return 0;
+}
+
+static void
+mark_subtract_refs(gc_mark_chunk *chunk)
+{
+    PyGC_Head *gc = chunk->start;
+    Py_ssize_t i;
+    for (i = 0; i < chunk->count; i++, gc = gc->gc.gc_next) {
+        PyObject *op = FROM_GC(gc);
+        (void) Py_TYPE(op)->tp_traverse(op, visit_decref_atomic, NULL);
+    }
+}
+
+/* Claim gc for the calling worker and push it on the worker's stack.
+ * The mark stack is allocated with the system malloc: the object
+ * allocator isn't thread-safe. */
+static void
+mark_claim(gc_mark_chunk *chunk, PyGC_Head *gc)
+{
+    Py_ssize_t refs = gc->gc.gc_refs;
+
+    if (refs < 0 || !GC_ATOMIC_CLAIM(&gc->gc.gc_refs, refs))
+        return;
+    if (chunk->stack_len == chunk->stack_size) {
+        Py_ssize_t size = chunk->stack_size ? chunk->stack_size * 2 : 256;
+        PyGC_Head **stack = NULL;
+        if ((size_t)size <= PY_SSIZE_T_MAX / sizeof(PyGC_Head *))
+            stack = realloc(chunk->stack, size * sizeof(PyGC_Head *));
+        if (stack == NULL) {
+            /* gc is marked but its referents were not visited;
+               update_reachable_fixpoint() will take care of it. */
+            chunk->overflowed = 1;
+            return;
+        }
+        chunk->stack = stack;
+        chunk->stack_size = size;
+    }
+    chunk->stack[chunk->stack_len++] = gc;
+}
+
+static int
+visit_mark(PyObject *op, gc_mark_chunk *chunk)
+{
+    if (PyObject_IS_GC(op))
+        mark_claim(chunk, AS_GC(op));
+    return 0;
+}
+
+static void
+mark_reachable(gc_mark_chunk *chunk)
+{
+    PyGC_Head *gc = chunk->start;
+    Py_ssize_t i;
+    for (i = 0; i < chunk->count; i++, gc = gc->gc.gc_next) {
+        if (gc->gc.gc_refs <= 0)
+            continue;
+        mark_claim(chunk, gc);
+        while (chunk->stack_len > 0) {
+            PyObject *op = FROM_GC(chunk->stack[--chunk->stack_len]);
+            (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_mark,
+                                            chunk);
+        }
+    }
+}
+
+static void
+mark_worker(void *arg)
+{
+    gc_mark_chunk *chunk = (gc_mark_chunk *)arg;
+    chunk->phase(chunk);
+    PyThread_release_lock(chunk->done);
+}
+
+/* Run phase on every chunk, using one helper thread per chunk except the
+ * first one, which runs on the calling thread.  A chunk whose thread can't
+ * be started is run on the calling thread as well. */
+static void
+mark_run_phase(gc_mark_chunk *chunks, int n, gc_mark_phase phase)
+{
+    int i;
+    int started[GC_MAX_MARK_THREADS];
+
+    for (i = 1; i < n; i++) {
+        chunks[i].phase = phase;
+        started[i] = 0;
+        if (chunks[i].done == NULL ||
+            !PyThread_acquire_lock(chunks[i].done, NOWAIT_LOCK))
+            continue;
+        if (PyThread_start_new_thread(mark_worker, &chunks[i]) == -1) {
+            PyThread_release_lock(chunks[i].done);
+            continue;
+        }
+        started[i] = 1;
+    }
+    phase(&chunks[0]);
+    for (i = 1; i < n; i++) {
+        if (started[i]) {
+            PyThread_acquire_lock(chunks[i].done, WAIT_LOCK);
+            PyThread_release_lock(chunks[i].done);
+        }
+        else {
+            phase(&chunks[i]);
+        }
+    }
+}
+
+static int
+visit_mark_sequential(PyObject *op, int *changed)
+{
+    if (PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (gc->gc.gc_refs >= 0) {
+            gc->gc.gc_refs = GC_REACHABLE;
+            *changed = 1;
+        }
+    }
+    return 0;
+}
+
+/* Slow path used when a mark stack couldn't be grown: propagate
+ * reachability from every marked object until nothing changes. */
+static void
+update_reachable_fixpoint(PyGC_Head *young)
+{
+    PyGC_Head *gc;
+    int changed;
+    do {
+        changed = 0;
+        for (gc = young->gc.gc_next; gc != young; gc = gc->gc.gc_next) {
+            PyObject *op;
+            if (gc->gc.gc_refs != GC_REACHABLE)
+                continue;
+            op = FROM_GC(gc);
+            (void) Py_TYPE(op)->tp_traverse(op,
+                                            (visitproc)visit_mark_sequential,
+                                            &changed);
+        }
+    } while (changed);
+}
+
+/* Parallel equivalent of update_refs(), subtract_refs() and
+ * move_unreachable().  Returns -1 without doing anything if the helper
+ * state can't be allocated, in which case the caller must fall back to the
+ * sequential functions. */
+static int
+parallel_move_unreachable(PyGC_Head *young, PyGC_Head *unreachable,
+                          Py_ssize_t size)
+{
+    gc_mark_chunk chunks[GC_MAX_MARK_THREADS];
+    PyGC_Head *gc, *next;
+    int i, n = mark_threads, overflowed = 0;
+
+    if (n > size)
+        n = (int)size;
+    memset(chunks, 0, sizeof(chunks));
+    gc = young->gc.gc_next;
+    for (i = 0; i < n; i++) {
+        Py_ssize_t j;
+        chunks[i].start = gc;
+        chunks[i].count = size / n + (i < size % n);
+        for (j = 0; j < chunks[i].count; j++)
+            gc = gc->gc.gc_next;
+        if (i > 0) {
+            chunks[i].done = PyThread_allocate_lock();
+            if (chunks[i].done == NULL)
+                break;
+        }
+    }
+    if (i < n) {
+        while (--i > 0)
+            PyThread_free_lock(chunks[i].done);
+        return -1;
+    }
+    assert(gc == young);
+
+    mark_run_phase(chunks, n, mark_update_refs);
+    mark_run_phase(chunks, n, mark_subtract_refs);
+    mark_run_phase(chunks, n, mark_reachable);
+
+    for (i = 0; i < n; i++) {
+        overflowed |= chunks[i].overflowed;
+        free(chunks[i].stack);
+        if (i > 0)
+            PyThread_free_lock(chunks[i].done);
+    }
+    if (overflowed)
+        update_reachable_fixpoint(young);
+
+    /* Everything that wasn't claimed is unreachable. */
+    for (gc = young->gc.gc_next; gc != young; gc = next) {
+        next = gc->gc.gc_next;
+        if (gc->gc.gc_refs == GC_REACHABLE) {
+            PyObject *op = FROM_GC(gc);
+            if (PyTuple_CheckExact(op))
+                _PyTuple_MaybeUntrack(op);
+        }
+        else {
+            assert(gc->gc.gc_refs >= 0);
+            gc_list_move(gc, unreachable);
+            gc->gc.gc_refs = GC_TENTATIVELY_UNREACHABLE;
+        }
+    }
+    return 0;
+}
+
+#endif /* HAVE_GC_PARALLEL_MARK */
+
+/* Compute the unreachable part of young, using parallel marking for large
+ * full collections if enabled. */
+static void
+find_unreachable(PyGC_Head *young, PyGC_Head *unreachable, int generation)
+{
+    Py_GUARD
+#ifdef HAVE_GC_PARALLEL_MARK
+    if (mark_threads > 1 && generation == NUM_GENERATIONS - 1) {
+        Py_ssize_t size = gc_list_size(young);
+        if (size >= mark_min_objects &&
+            parallel_move_unreachable(young, unreachable, size) == 0)
+            return;
+    }
+#endif
+    /* Using ob_refcnt and gc_refs, calculate which objects in the
+     * container set are reachable from outside the set (i.e., have a
+     * refcount greater than 0 when all the references within the
+     * set are taken into account).
+     */
+    update_refs(young);
+    subtract_refs(young);
+
+    /* Leave everything reachable from outside young in young, and move
+     * everything else (in young) to unreachable.
+     * NOTE:  This used to move the reachable objects into a reachable
+     * set instead.  But most things usually turn out to be reachable,
+     * so it's more efficient to move the unreachable things.
+     */
+    move_unreachable(young, unreachable);
+}
+
 /* Try to untrack all currently tracked dictionaries */
 static void
 untrack_dicts(PyGC_Head *head)
@@ -927,22 +1269,9 @@ collect(int generation, Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable)
     else
         old = young;
 
-    /* Using ob_refcnt and gc_refs, calculate which objects in the
-     * container set are reachable from outside the set (i.e., have a
-     * refcount greater than 0 when all the references within the
-     * set are taken into account).
-     */
-    update_refs(young);
-    subtract_refs(young);
-
-    /* Leave everything reachable from outside young in young, and move
-     * everything else (in young) to unreachable.
-     * NOTE:  This used to move the reachable objects into a reachable
-     * set instead.  But most things usually turn out to be reachable,
-     * so it's more efficient to move the unreachable things.
-     */
+    /* Find the objects in young that aren't reachable from outside it. */
     gc_list_init(&unreachable);
-    move_unreachable(young, &unreachable);
+    find_unreachable(young, &unreachable, generation);
 
     /* Move reachable objects to next generation. */
     if (young != old) {
@@ -1289,6 +1618,58 @@ gc_get_count(PyObject *self, PyObject *noargs)
                          generations[2].count);
 }
 
+PyDoc_STRVAR(gc_set_mark_threads__doc__,
+"set_mark_threads(nthreads, [min_objects]) -> None\n"
+"\n"
+"Sets the number of threads used to find unreachable objects during\n"
+"full collections of at least min_objects objects.  Setting nthreads\n"
+"to 1 disables parallel marking.\n");
+
+static PyObject *
+gc_set_mark_threads(PyObject *self, PyObject *args)
+{
+    int nthreads;
+    Py_ssize_t min_objects = mark_min_objects;
+    Py_GUARD
+    if (!PyArg_ParseTuple(args, "i|n:set_mark_threads",
+                          &nthreads, &min_objects))
+        return NULL;
+    if (nthreads < 1 || nthreads > GC_MAX_MARK_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+                     "nthreads must be between 1 and %d",
+                     GC_MAX_MARK_THREADS);
+        return NULL;
+    }
+    if (min_objects < 0) {
+        PyErr_SetString(PyExc_ValueError, "min_objects must be >= 0");
+        return NULL;
+    }
+#ifndef HAVE_GC_PARALLEL_MARK
+    if (nthreads > 1) {
+        PyErr_SetString(PyExc_NotImplementedError,
+                        "parallel marking is not supported by this build");
+        return NULL;
+    }
+#endif
+    mark_threads = nthreads;
+    mark_min_objects = min_objects;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_get_mark_threads__doc__,
+"get_mark_threads() -> (nthreads, min_objects)\n"
+"\n"
+"Return the current parallel marking settings.\n");
+
+static PyObject *
+gc_get_mark_threads(PyObject *self, PyObject *noargs)
+{
+    Py_GUARD
+    return Py_BuildValue("(in)", mark_threads, mark_min_objects);
+}
+
 static int
 referrersvisit(PyObject* obj, PyObject *objs)
 {
@@ -1440,6 +1821,8 @@ PyDoc_STRVAR(gc__doc__,
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
 "get_threshold() -- Return the current the collection thresholds.\n"
+"set_mark_threads() -- Set the number of threads used by full collections.\n"
+"get_mark_threads() -- Return the parallel marking settings.\n"
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "get_referrers() -- Return the list of objects that refer to an object.\n"
@@ -1454,6 +1837,10 @@ static PyMethodDef GcMethods[] = {
     {"get_count",          gc_get_count,  METH_NOARGS,  gc_get_count__doc__},
     {"set_threshold",  gc_set_thresh, METH_VARARGS, gc_set_thresh__doc__},
     {"get_threshold",  gc_get_thresh, METH_NOARGS,  gc_get_thresh__doc__},
+    {"set_mark_threads", gc_set_mark_threads, METH_VARARGS,
+        gc_set_mark_threads__doc__},
+    {"get_mark_threads", gc_get_mark_threads, METH_NOARGS,
+        gc_get_mark_threads__doc__},
     {"collect",            (PyCFunction)gc_collect,
         METH_VARARGS | METH_KEYWORDS,           gc_collect__doc__},
     {"get_objects",    gc_get_objects,METH_NOARGS,  gc_get_objects__doc__},
@@ -1452,12 +1452,130 @@ setint(PyObject *d, const char *name, long value)
 }
 
 
+#if defined(UNIX) && defined(_POSIX_SHARED_MEMORY_OBJECTS) && \
+    _POSIX_SHARED_MEMORY_OBJECTS > 0
+#define HAVE_MMAP_SHM
+#include <fcntl.h>
+
+PyDoc_STRVAR(mmap_shm_open_doc,
+"shm_open(name, length=0, create=False, access=ACCESS_DEFAULT) -> mmap\n\
+\n\
+Map the named POSIX shared memory segment name (portable names start\n\
+with a single '/').  If create is true a new segment of length bytes is\n\
+created and it is an error for it to exist already; otherwise an existing\n\
+segment is opened and length defaults to its current size.  The segment\n\
+outlives every mapping of it until shm_unlink() is called.");
+
+static PyObject *
+mmap_shm_open(PyObject *self, PyObject *args, PyObject *kwdict)
+{
+    PyObject *path, *name, *mmap_args, *mmap_kwargs, *result = NULL;
+    Py_ssize_t length = 0;
+    int create = 0, access = (int)ACCESS_DEFAULT;
+    int fd, oflag, err;
+    struct stat st;
+    static char *keywords[] = {"name", "length", "create", "access", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwdict, "O|npi:shm_open",
+                                     keywords, &path, &length, &create,
+                                     &access))
+        return NULL;
+    if (!PyUnicode_FSConverter(path, &name))
+        return NULL;
+    if (length < 0) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "memory mapped length must be positive");
+        goto done;
+    }
+    if (create && (length == 0 || access == ACCESS_READ)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "creating a shared memory segment needs a positive "
+                        "length and a writable access mode");
+        goto done;
+    }
+
+    oflag = access == ACCESS_READ ? O_RDONLY : O_RDWR;
+    if (create)
+        oflag |= O_CREAT | O_EXCL;
+    Py_BEGIN_ALLOW_THREADS
+    fd = shm_open(PyBytes_AS_STRING(name), oflag, 0600);
+    err = fd < 0;
+    if (!err && create)
+        err = ftruncate(fd, (off_t)length) != 0;
+    else if (!err && length == 0 && fstat(fd, &st) == 0)
+        length = (Py_ssize_t)st.st_size;
+    Py_END_ALLOW_THREADS
+    if (err) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        goto fail;
+    }
+
+    /* mmap() dups the descriptor, so ours is closed either way. */
+    mmap_args = Py_BuildValue("(in)", fd, length);
+    mmap_kwargs = Py_BuildValue("{s:i}", "access", access);
+    if (mmap_args != NULL && mmap_kwargs != NULL)
+        result = PyObject_Call((PyObject *)&mmap_object_type,
+                               mmap_args, mmap_kwargs);
+    Py_XDECREF(mmap_args);
+    Py_XDECREF(mmap_kwargs);
+
+  fail:
+    if (fd >= 0) {
+        /* Don't leave a half-made segment behind if we created it. */
+        if (result == NULL && create)
+            (void)shm_unlink(PyBytes_AS_STRING(name));
+        (void)close(fd);
+    }
+  done:
+    Py_DECREF(name);
+    return result;
+}
+
+PyDoc_STRVAR(mmap_shm_unlink_doc,
+"shm_unlink(name)\n\
+\n\
+Remove the named POSIX shared memory segment.  Existing mappings stay\n\
+valid; the memory is released once the last of them is closed.");
+
+static PyObject *
+mmap_shm_unlink(PyObject *self, PyObject *args)
+{
+    PyObject *path, *name;
+    int res;
+
+    if (!PyArg_ParseTuple(args, "O:shm_unlink", &path))
+        return NULL;
+    if (!PyUnicode_FSConverter(path, &name))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    res = shm_unlink(PyBytes_AS_STRING(name));
+    Py_END_ALLOW_THREADS
+    if (res != 0) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        Py_DECREF(name);
+        return NULL;
+    }
+    Py_DECREF(name);
+    Py_RETURN_NONE;
+}
+#endif /* shm_open */
+
+static PyMethodDef mmap_functions[] = {
+#ifdef HAVE_MMAP_SHM
+    {"shm_open", (PyCFunction)mmap_shm_open, METH_VARARGS | METH_KEYWORDS,
+     mmap_shm_open_doc},
+    {"shm_unlink", (PyCFunction)mmap_shm_unlink, METH_VARARGS,
+     mmap_shm_unlink_doc},
+#endif
+    {NULL, NULL}
+};
+
 static struct PyModuleDef mmapmodule = {
     PyModuleDef_HEAD_INIT,
     "mmap",
     NULL,
     -1,
-    NULL,
+    mmap_functions,
     NULL,
     NULL,
     NULL,
@@ -46,6 +46,9 @@ typedef struct
     char eof;
     int is_initialised;
     PyObject *zdict;
+    char needs_input;
+    Byte *input_buffer;     /* input held back by decompress_into() */
+    unsigned int input_len;
     #ifdef WITH_THREAD
         PyThread_type_lock lock;
     #endif
@@ -80,6 +83,23 @@ zlib_error(z_stream zst, int err, char *msg)
         PyErr_Format(ZlibError, "Error %d %s: %.200s", err, msg, zmsg);
 }
 
+static int
+set_inflate_zdict(compobject *self)
+{
+    Py_buffer zdict_buf;
+    int err;
+
+    if (PyObject_GetBuffer(self->zdict, &zdict_buf, PyBUF_SIMPLE) == -1)
+        return -1;
+    err = inflateSetDictionary(&(self->zst), zdict_buf.buf, zdict_buf.len);
+    PyBuffer_Release(&zdict_buf);
+    if (err != Z_OK) {
+        zlib_error(self->zst, err, "while setting zdict");
+        return -1;
+    }
+    return 0;
+}
+
 PyDoc_STRVAR(compressobj__doc__,
 "compressobj(level=-1, method=DEFLATED, wbits=15, memlevel=8,\n"
 "            strategy=Z_DEFAULT_STRATEGY[, zdict])\n"
@@ -120,6 +140,9 @@ newcompobject(PyTypeObject *type)
     self->eof = 0;
     self->is_initialised = 0;
     self->zdict = NULL;
+    self->needs_input = 1;
+    self->input_buffer = NULL;
+    self->input_len = 0;
     self->unused_data = PyBytes_FromStringAndSize("", 0);
     if (self->unused_data == NULL) {
         Py_DECREF(self);
@@ -223,6 +246,414 @@ PyZlib_compress(PyObject *self, PyObject *args)
     return ReturnVal;
 }
 
+#if defined(ZLIB_VERNUM) && ZLIB_VERNUM >= 0x1221
+/* Parallel compression, after pigz: the input is cut into blocks which
+   are deflated independently as raw streams.  Each block is primed with
+   the 32K of input that precedes it, so matches can still reach back
+   across block boundaries, and all but the last end in a sync flush so
+   they concatenate into one deflate stream.  The caller's thread
+   assembles the wrapper and combines the per-block checksums. */
+#define HAVE_ZLIB_PARALLEL
+
+#define PDEFLATE_RAW  0
+#define PDEFLATE_ZLIB 1
+#define PDEFLATE_GZIP 2
+
+/* Upper bound on the threads compress_parallel() starts for one call. */
+#define PDEFLATE_MAX_THREADS 64
+
+typedef struct {
+    Byte *out;
+    size_t out_len;
+    uLong check;        /* adler32 or crc32 of this block's input */
+    int err;
+} pdeflate_block;
+
+typedef struct {
+    const Byte *input;
+    Py_ssize_t length;
+    Py_ssize_t blocksize;
+    Py_ssize_t nblocks;
+    Py_ssize_t next;    /* next block to hand out */
+    int level;
+    int wbits;          /* always positive, the wrapper is in format */
+    int format;
+    const Byte *zdict;
+    uInt zdict_len;
+    pdeflate_block *blocks;
+#ifdef WITH_THREAD
+    PyThread_type_lock lock;    /* protects next and running */
+    PyThread_type_lock done;    /* released when running drops to 0 */
+    int running;
+#endif
+} pdeflate_state;
+
+/* Deflate block i of pd.  Runs without the GIL. */
+static int
+pdeflate_one(pdeflate_state *pd, Py_ssize_t i)
+{
+    pdeflate_block *b = &pd->blocks[i];
+    Py_ssize_t start = i * pd->blocksize;
+    uInt len = (uInt)Py_MIN(pd->blocksize, pd->length - start);
+    int flush = i == pd->nblocks - 1 ? Z_FINISH : Z_SYNC_FLUSH;
+    const Byte *in = pd->input + start;
+    size_t alloc;
+    Byte *out;
+    z_stream zst;
+    int err;
+
+    if (pd->format == PDEFLATE_GZIP)
+        b->check = crc32(0L, in, len);
+    else
+        b->check = adler32(1L, in, len);
+
+    zst.zalloc = (alloc_func)NULL;
+    zst.zfree = (free_func)Z_NULL;
+    zst.opaque = Z_NULL;
+    err = deflateInit2(&zst, pd->level, DEFLATED, -pd->wbits,
+                       DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+    if (err != Z_OK)
+        return err;
+    if (start > 0) {
+        uInt window = (uInt)Py_MIN(start, (Py_ssize_t)1 << pd->wbits);
+        err = deflateSetDictionary(&zst, in - window, window);
+    }
+    else if (pd->zdict != NULL)
+        err = deflateSetDictionary(&zst, pd->zdict, pd->zdict_len);
+    if (err != Z_OK)
+        goto done;
+
+    /* deflateBound() covers Z_FINISH; leave room for the flush marker. */
+    alloc = deflateBound(&zst, len) + 16;
+    b->out = (Byte *)malloc(alloc);
+    if (b->out == NULL) {
+        err = Z_MEM_ERROR;
+        goto done;
+    }
+    zst.next_in = (Byte *)in;
+    zst.avail_in = len;
+    zst.next_out = b->out;
+    zst.avail_out = (uInt)alloc;
+    for (;;) {
+        err = deflate(&zst, flush);
+        if (err == Z_STREAM_END ||
+            (err == Z_OK && flush != Z_FINISH && zst.avail_out != 0)) {
+            err = Z_OK;
+            break;
+        }
+        if (err != Z_OK && err != Z_BUF_ERROR)
+            goto done;
+        out = (Byte *)realloc(b->out, alloc * 2);
+        if (out == NULL) {
+            err = Z_MEM_ERROR;
+            goto done;
+        }
+        b->out = out;
+        zst.next_out = b->out + alloc;
+        zst.avail_out = (uInt)alloc;
+        alloc *= 2;
+    }
+    b->out_len = zst.total_out;
+
+ done:
+    deflateEnd(&zst);
+    return err;
+}
+
+static void
+pdeflate_worker(pdeflate_state *pd)
+{
+    Py_ssize_t i;
+
+    for (;;) {
+#ifdef WITH_THREAD
+        if (pd->lock != NULL) {
+            PyThread_acquire_lock(pd->lock, 1);
+            i = pd->next++;
+            PyThread_release_lock(pd->lock);
+        }
+        else
+#endif
+            i = pd->next++;
+        if (i >= pd->nblocks)
+            break;
+        pd->blocks[i].err = pdeflate_one(pd, i);
+    }
+}
+
+#ifdef WITH_THREAD
+/* Drop n workers from the running count, waking the caller on the last. */
+static void
+pdeflate_leave(pdeflate_state *pd, int n)
+{
+    int last;
+
+    PyThread_acquire_lock(pd->lock, 1);
+    pd->running -= n;
+    last = pd->running == 0;
+    PyThread_release_lock(pd->lock);
+    /* pd may be gone as soon as done is released. */
+    if (last)
+        PyThread_release_lock(pd->done);
+}
+
+static void
+pdeflate_thread(void *arg)
+{
+    pdeflate_worker((pdeflate_state *)arg);
+    pdeflate_leave((pdeflate_state *)arg, 1);
+}
+#endif
+
+static int
+pdeflate_cpu_count(void)
+{
+#ifdef WITH_THREAD
+    return Py_MIN(_PyThread_cpu_count(), PDEFLATE_MAX_THREADS);
+#else
+    return 1;
+#endif
+}
+
+static void
+pdeflate_put32(Byte *p, uLong v, int big_endian)
+{
+    int k;
+    for (k = 0; k < 4; k++)
+        p[big_endian ? 3 - k : k] = (Byte)((v >> (8 * k)) & 0xff);
+}
+
+PyDoc_STRVAR(compress_parallel__doc__,
+"compress_parallel(data, level=-1, wbits=MAX_WBITS, blocksize=131072,\n"
+"                  threads=0[, zdict]) -- Compress data on several threads.\n"
+"\n"
+"data is cut into blocks of blocksize bytes which are compressed\n"
+"concurrently by up to threads threads (0 means one per CPU; at most 64\n"
+"are started).  The result is a single stream that decompress() accepts.\n"
+"Each block is primed with the input preceding it, so the ratio stays close\n"
+"to compress().  The output does not depend on the number of threads.\n"
+"\n"
+"wbits selects the container as for compressobj(): 9..15 for zlib, 25..31\n"
+"for gzip and -9..-15 for a raw deflate stream.  zdict is a preset\n"
+"dictionary for the first block; gzip streams cannot carry one.");
+
+static PyObject *
+PyZlib_compress_parallel(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"data", "level", "wbits", "blocksize",
+                             "threads", "zdict", NULL};
+    PyObject *RetVal = NULL;
+    Py_buffer pinput, pzdict;
+    pdeflate_state pd;
+    Py_ssize_t i, blocksize = 128 * 1024, total, done;
+    int level = Z_DEFAULT_COMPRESSION, wbits = MAX_WBITS, threads = 0;
+    int err = Z_OK;
+    Byte header[10], trailer[8], *out;
+    size_t header_len, trailer_len;
+    uLong check;
+
+    pzdict.buf = NULL;
+    pzdict.obj = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+                                     "y*|iiniy*:compress_parallel", kwlist,
+                                     &pinput, &level, &wbits, &blocksize,
+                                     &threads, &pzdict))
+        return NULL;
+
+    memset(&pd, 0, sizeof(pd));
+    if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+        PyErr_SetString(ZlibError, "Bad compression level");
+        goto error;
+    }
+    if (wbits >= 9 && wbits <= 15)
+        pd.format = PDEFLATE_ZLIB;
+    else if (wbits >= 16 + 9 && wbits <= 16 + 15) {
+        pd.format = PDEFLATE_GZIP;
+        wbits -= 16;
+    }
+    else if (wbits >= -15 && wbits <= -9) {
+        pd.format = PDEFLATE_RAW;
+        wbits = -wbits;
+    }
+    else {
+        PyErr_SetString(PyExc_ValueError, "invalid wbits value");
+        goto error;
+    }
+    if (blocksize <= 0 || (size_t)blocksize > UINT_MAX / 2) {
+        PyErr_SetString(PyExc_ValueError, "blocksize out of range");
+        goto error;
+    }
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must not be negative");
+        goto error;
+    }
+    if (pzdict.buf != NULL) {
+        if (pd.format == PDEFLATE_GZIP) {
+            PyErr_SetString(PyExc_ValueError,
+                            "gzip streams cannot use a preset dictionary");
+            goto error;
+        }
+        if ((size_t)pzdict.len > UINT_MAX) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "zdict length does not fit in an unsigned int");
+            goto error;
+        }
+        pd.zdict = pzdict.buf;
+        pd.zdict_len = (uInt)pzdict.len;
+    }
+
+    pd.input = pinput.buf;
+    pd.length = pinput.len;
+    pd.blocksize = blocksize;
+    pd.nblocks = pinput.len == 0 ? 1 : (pinput.len - 1) / blocksize + 1;
+    pd.level = level;
+    pd.wbits = wbits;
+    pd.blocks = PyMem_New(pdeflate_block, pd.nblocks);
+    if (pd.blocks == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    memset(pd.blocks, 0, pd.nblocks * sizeof(pdeflate_block));
+    if (threads == 0)
+        threads = pdeflate_cpu_count();
+    else if (threads > PDEFLATE_MAX_THREADS)
+        threads = PDEFLATE_MAX_THREADS;
+    if (threads > pd.nblocks)
+        threads = (int)pd.nblocks;
+
+#ifdef WITH_THREAD
+    if (threads > 1) {
+        pd.lock = PyThread_allocate_lock();
+        pd.done = PyThread_allocate_lock();
+        if (pd.lock == NULL || pd.done == NULL) {
+            PyErr_SetString(PyExc_MemoryError, "can't allocate lock");
+            goto error;
+        }
+        PyThread_acquire_lock(pd.done, 1);
+        pd.running = threads - 1;
+    }
+#endif
+    Py_BEGIN_ALLOW_THREADS
+#ifdef WITH_THREAD
+    if (threads > 1) {
+        int t;
+        for (t = 1; t < threads; t++) {
+            if (PyThread_start_new_thread(pdeflate_thread, &pd) == -1) {
+                /* Fewer helpers just means more work for this thread. */
+                pdeflate_leave(&pd, threads - t);
+                break;
+            }
+        }
+    }
+#endif
+    pdeflate_worker(&pd);
+#ifdef WITH_THREAD
+    if (threads > 1)
+        PyThread_acquire_lock(pd.done, 1);
+#endif
+    Py_END_ALLOW_THREADS
+
+    total = 0;
+    for (i = 0; i < pd.nblocks; i++) {
+        if (pd.blocks[i].err != Z_OK) {
+            err = pd.blocks[i].err;
+            break;
+        }
+        total += pd.blocks[i].out_len;
+    }
+    if (err == Z_MEM_ERROR) {
+        PyErr_SetString(PyExc_MemoryError,
+                        "Out of memory while compressing data");
+        goto error;
+    }
+    if (err != Z_OK) {
+        PyErr_Format(ZlibError, "Error %d while compressing data", err);
+        goto error;
+    }
+
+    header_len = trailer_len = 0;
+    if (pd.format == PDEFLATE_ZLIB) {
+        /* The two byte header deflate itself would write, see RFC 1950. */
+        int level_flags;
+        uInt head;
+        if (level >= 0 && level < 2)
+            level_flags = 0;
+        else if (level >= 0 && level < 6)
+            level_flags = 1;
+        else if (level == 6 || level == Z_DEFAULT_COMPRESSION)
+            level_flags = 2;
+        else
+            level_flags = 3;
+        head = (DEFLATED + ((wbits - 8) << 4)) << 8;
+        head |= level_flags << 6;
+        if (pd.zdict != NULL)
+            head |= 0x20;
+        head += 31 - (head % 31);
+        header[0] = (Byte)(head >> 8);
+        header[1] = (Byte)(head & 0xff);
+        header_len = 2;
+        if (pd.zdict != NULL) {
+            pdeflate_put32(header + 2, adler32(1L, pd.zdict, pd.zdict_len), 1);
+            header_len = 6;
+        }
+        trailer_len = 4;
+    }
+    else if (pd.format == PDEFLATE_GZIP) {
+        /* No name, no mtime, OS unknown; see RFC 1952. */
+        memset(header, 0, sizeof(header));
+        header[0] = 0x1f;
+        header[1] = 0x8b;
+        header[2] = DEFLATED;
+        header[8] = level == 9 ? 2 : (level == 1 ? 4 : 0);
+        header[9] = 255;
+        header_len = 10;
+        trailer_len = 8;
+    }
+
+    RetVal = PyBytes_FromStringAndSize(NULL, header_len + total + trailer_len);
+    if (RetVal == NULL)
+        goto error;
+    out = (Byte *)PyBytes_AS_STRING(RetVal);
+    memcpy(out, header, header_len);
+    out += header_len;
+    check = pd.format == PDEFLATE_GZIP ? crc32(0L, Z_NULL, 0)
+                                       : adler32(0L, Z_NULL, 0);
+    for (i = 0, done = 0; i < pd.nblocks; i++) {
+        z_off_t len = (z_off_t)Py_MIN(blocksize, pd.length - done);
+        memcpy(out, pd.blocks[i].out, pd.blocks[i].out_len);
+        out += pd.blocks[i].out_len;
+        if (pd.format == PDEFLATE_GZIP)
+            check = crc32_combine(check, pd.blocks[i].check, len);
+        else
+            check = adler32_combine(check, pd.blocks[i].check, len);
+        done += len;
+    }
+    if (pd.format == PDEFLATE_ZLIB)
+        pdeflate_put32(trailer, check, 1);
+    else if (pd.format == PDEFLATE_GZIP) {
+        pdeflate_put32(trailer, check, 0);
+        pdeflate_put32(trailer + 4, (uLong)(pd.length & 0xffffffffU), 0);
+    }
+    memcpy(out, trailer, trailer_len);
+
+ error:
+    if (pd.blocks != NULL) {
+        for (i = 0; i < pd.nblocks; i++)
+            free(pd.blocks[i].out);
+        PyMem_Free(pd.blocks);
+    }
+#ifdef WITH_THREAD
+    if (pd.lock != NULL)
+        PyThread_free_lock(pd.lock);
+    if (pd.done != NULL)
+        PyThread_free_lock(pd.done);
+#endif
+    PyBuffer_Release(&pinput);
+    PyBuffer_Release(&pzdict);
+    return RetVal;
+}
+#endif /* ZLIB_VERNUM >= 0x1221 */
+
 PyDoc_STRVAR(decompress__doc__,
 "decompress(string[, wbits[, bufsize]]) -- Return decompressed string.\n"
 "\n"
@@ -431,6 +862,11 @@ PyZlib_decompressobj(PyObject *selfptr, PyObject *args, PyObject *kwargs)
     switch(err) {
     case (Z_OK):
         self->is_initialised = 1;
+        /* Raw streams never report Z_NEED_DICT, so set it up front. */
+        if (self->zdict != NULL && wbits < 0 && set_inflate_zdict(self) < 0) {
+            Py_DECREF(self);
+            return NULL;
+        }
         return (PyObject*)self;
     case(Z_STREAM_ERROR):
         Py_DECREF(self);
@@ -457,6 +893,7 @@ Dealloc(compobject *self)
     Py_XDECREF(self->unused_data);
     Py_XDECREF(self->unconsumed_tail);
     Py_XDECREF(self->zdict);
+    PyMem_Free(self->input_buffer);
     PyObject_Del(self);
 }
 
@@ -560,6 +997,35 @@ PyZlib_objcompress(compobject *self, PyObject *args)
     return RetVal;
 }
 
+/* If input is held back from an earlier decompress_into(), append the new
+   data to it and point *data and *len at the whole. */
+static int
+append_held_input(compobject *self, Byte **data, unsigned int *len)
+{
+    Byte *buf;
+
+    if (self->input_len == 0)
+        return 0;
+    if (*len > UINT_MAX - self->input_len) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "Size does not fit in an unsigned int");
+        return -1;
+    }
+    if (*len > 0) {
+        buf = PyMem_Realloc(self->input_buffer, self->input_len + *len);
+        if (buf == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        memcpy(buf + self->input_len, *data, *len);
+        self->input_buffer = buf;
+        self->input_len += *len;
+    }
+    *data = self->input_buffer;
+    *len = self->input_len;
+    return 0;
+}
+
 /* Helper for objdecompress() and unflush(). Saves any unconsumed input data in
    self->unused_data or self->unconsumed_tail, as appropriate. */
 static int
@@ -649,6 +1115,15 @@ PyZlib_objdecompress(compobject *self, PyObject *args)
 
     ENTER_ZLIB(self);
 
+    if (append_held_input(self, &input, &inplen) < 0) {
+        Py_DECREF(RetVal);
+        RetVal = NULL;
+        goto error;
+    }
+    /* Anything not used below goes to unconsumed_tail. */
+    self->input_len = 0;
+    self->needs_input = 1;
+
     start_total_out = self->zst.total_out;
     self->zst.avail_in = inplen;
     self->zst.next_in = input;
@@ -660,16 +1135,7 @@ PyZlib_objdecompress(compobject *self, PyObject *args)
     Py_END_ALLOW_THREADS
 
     if (err == Z_NEED_DICT && self->zdict != NULL) {
-        Py_buffer zdict_buf;
-        if (PyObject_GetBuffer(self->zdict, &zdict_buf, PyBUF_SIMPLE) == -1) {
-            Py_DECREF(RetVal);
-            RetVal = NULL;
-            goto error;
-        }
-        err = inflateSetDictionary(&(self->zst), zdict_buf.buf, zdict_buf.len);
-        PyBuffer_Release(&zdict_buf);
-        if (err != Z_OK) {
-            zlib_error(self->zst, err, "while decompressing data");
+        if (set_inflate_zdict(self) < 0) {
             Py_DECREF(RetVal);
             RetVal = NULL;
             goto error;
@@ -743,6 +1209,105 @@ PyZlib_objdecompress(compobject *self, PyObject *args)
     return RetVal;
 }
 
+PyDoc_STRVAR(decomp_decompress_into__doc__,
+"decompress_into(data, buffer) -- Decompress data into buffer and return\n"
+"the number of bytes written.\n"
+"\n"
+"buffer may be any writable object, such as a bytearray or a memoryview\n"
+"slice, and no bytes object is created for the output.  If buffer fills\n"
+"up, the rest of data is kept and used by the next call, and needs_input\n"
+"is set to False.  Call again, with b'' if there is no new input, until\n"
+"needs_input is True.");
+
+static PyObject *
+PyZlib_objdecompress_into(compobject *self, PyObject *args)
+{
+    int err, held;
+    Py_buffer pinput, poutput;
+    PyObject *RetVal = NULL;
+    Byte *input, *buf;
+    unsigned int inplen;
+    unsigned long start_total_out;
+
+    if (!PyArg_ParseTuple(args, "y*w*:decompress_into", &pinput, &poutput))
+        return NULL;
+    if (pinput.len > UINT_MAX) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "Size does not fit in an unsigned int");
+        goto error_outer;
+    }
+    input = pinput.buf;
+    inplen = (unsigned int)pinput.len;
+
+    ENTER_ZLIB(self);
+
+    if (append_held_input(self, &input, &inplen) < 0)
+        goto error;
+    held = self->input_len > 0;
+
+    start_total_out = self->zst.total_out;
+    self->zst.avail_in = inplen;
+    self->zst.next_in = input;
+    /* A larger buffer is simply not filled past UINT_MAX bytes. */
+    self->zst.avail_out = (unsigned int)Py_MIN((size_t)poutput.len, UINT_MAX);
+    self->zst.next_out = poutput.buf;
+
+    Py_BEGIN_ALLOW_THREADS
+    err = inflate(&(self->zst), Z_SYNC_FLUSH);
+    Py_END_ALLOW_THREADS
+
+    if (err == Z_NEED_DICT && self->zdict != NULL) {
+        if (set_inflate_zdict(self) < 0)
+            goto error;
+        Py_BEGIN_ALLOW_THREADS
+        err = inflate(&(self->zst), Z_SYNC_FLUSH);
+        Py_END_ALLOW_THREADS
+    }
+
+    if (err == Z_STREAM_END) {
+        self->eof = 1;
+        self->needs_input = 0;
+        self->input_len = 0;
+        if (save_unconsumed_input(self, err) < 0)
+            goto error;
+    }
+    else if (err != Z_OK && err != Z_BUF_ERROR) {
+        zlib_error(self->zst, err, "while decompressing data");
+        goto error;
+    }
+    else if (self->zst.avail_in > 0) {
+        /* buffer is full; keep the rest of the input for the next call. */
+        if (held)
+            memmove(self->input_buffer, self->zst.next_in,
+                    self->zst.avail_in);
+        else {
+            buf = PyMem_Realloc(self->input_buffer, self->zst.avail_in);
+            if (buf == NULL) {
+                PyErr_NoMemory();
+                goto error;
+            }
+            memcpy(buf, self->zst.next_in, self->zst.avail_in);
+            self->input_buffer = buf;
+        }
+        self->input_len = self->zst.avail_in;
+        self->needs_input = 0;
+    }
+    else {
+        self->input_len = 0;
+        /* A full buffer may have left output inside the decompressor. */
+        self->needs_input = self->zst.avail_out != 0;
+    }
+
+    RetVal = PyLong_FromUnsignedLong(self->zst.total_out - start_total_out);
+
+ error:
+    LEAVE_ZLIB(self);
+ error_outer:
+    PyBuffer_Release(&pinput);
+    PyBuffer_Release(&poutput);
+    return RetVal;
+}
+
 PyDoc_STRVAR(comp_flush__doc__,
 "flush( [mode] ) -- Return a string containing any remaining compressed data.\n"
 "\n"
@@ -933,10 +1498,21 @@ PyZlib_uncopy(compobject *self)
     retval->unconsumed_tail = self->unconsumed_tail;
     retval->zdict = self->zdict;
     retval->eof = self->eof;
+    retval->needs_input = self->needs_input;
 
     /* Mark it as being initialized */
     retval->is_initialised = 1;
 
+    if (self->input_len > 0) {
+        retval->input_buffer = PyMem_Malloc(self->input_len);
+        if (retval->input_buffer == NULL) {
+            PyErr_NoMemory();
+            goto error;
+        }
+        memcpy(retval->input_buffer, self->input_buffer, self->input_len);
+        retval->input_len = self->input_len;
+    }
+
     LEAVE_ZLIB(self);
     return (PyObject *)retval;
 
@@ -974,8 +1550,16 @@ PyZlib_unflush(compobject *self, PyObject *args)
     ENTER_ZLIB(self);
 
     start_total_out = self->zst.total_out;
-    self->zst.avail_in = PyBytes_GET_SIZE(self->unconsumed_tail);
-    self->zst.next_in = (Byte *)PyBytes_AS_STRING(self->unconsumed_tail);
+    if (self->input_len > 0) {
+        /* Input held back by decompress_into() comes first. */
+        self->zst.avail_in = self->input_len;
+        self->zst.next_in = self->input_buffer;
+        self->input_len = 0;
+    }
+    else {
+        self->zst.avail_in = PyBytes_GET_SIZE(self->unconsumed_tail);
+        self->zst.next_in = (Byte *)PyBytes_AS_STRING(self->unconsumed_tail);
+    }
     self->zst.avail_out = length;
     self->zst.next_out = (Byte *)PyBytes_AS_STRING(retval);
 
@@ -1048,6 +1632,8 @@ static PyMethodDef Decomp_methods[] =
 {
     {"decompress", (binaryfunc)PyZlib_objdecompress, METH_VARARGS,
                    decomp_decompress__doc__},
+    {"decompress_into", (binaryfunc)PyZlib_objdecompress_into, METH_VARARGS,
+                        decomp_decompress_into__doc__},
     {"flush", (binaryfunc)PyZlib_unflush, METH_VARARGS,
               decomp_flush__doc__},
 #ifdef HAVE_ZLIB_COPY
@@ -1062,6 +1648,7 @@ static PyMemberDef Decomp_members[] = {
     {"unused_data",     T_OBJECT, COMP_OFF(unused_data), READONLY},
     {"unconsumed_tail", T_OBJECT, COMP_OFF(unconsumed_tail), READONLY},
     {"eof",             T_BOOL,   COMP_OFF(eof), READONLY},
+    {"needs_input",     T_BOOL,   COMP_OFF(needs_input), READONLY},
     {NULL},
 };
 
@@ -1149,6 +1736,10 @@ static PyMethodDef zlib_methods[] =
                  compress__doc__},
     {"compressobj", (PyCFunction)PyZlib_compressobj, METH_VARARGS|METH_KEYWORDS,
                     compressobj__doc__},
+#ifdef HAVE_ZLIB_PARALLEL
+    {"compress_parallel", (PyCFunction)PyZlib_compress_parallel,
+                          METH_VARARGS|METH_KEYWORDS, compress_parallel__doc__},
+#endif
     {"crc32", (PyCFunction)PyZlib_crc32, METH_VARARGS,
               crc32__doc__},
     {"decompress", (PyCFunction)PyZlib_decompress, METH_VARARGS,
@@ -1228,6 +1819,7 @@ PyDoc_STRVAR(zlib_module_documentation,
 "adler32(string[, start]) -- Compute an Adler-32 checksum.\n"
 "compress(string[, level]) -- Compress string, with compression level in 0-9.\n"
 "compressobj([level[, ...]]) -- Return a compressor object.\n"
+"compress_parallel(string[, ...]) -- Compress string on several threads.\n"
 "crc32(string[, start]) -- Compute a CRC-32 checksum.\n"
 "decompress(string,[wbits],[bufsize]) -- Decompresses a compressed string.\n"
 "decompressobj([wbits[, zdict]]]) -- Return a decompressor object.\n"
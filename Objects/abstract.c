@@ -1282,8 +1282,20 @@ PyNumber_Long(PyObject *o)
     if (PyUnicode_Check(o))
         /* The above check is done in PyLong_FromUnicode(). */
         return PyLong_FromUnicodeObject(o, 10);
-    if (!PyObject_AsCharBuffer(o, &buffer, &buffer_len))
-        return _PyLong_FromBytes(buffer, buffer_len, 10);
+    if (!PyObject_AsCharBuffer(o, &buffer, &buffer_len)) {
+        /* Other buffers, such as a memoryview slice, need not be
+           NUL-terminated, which PyLong_FromString() relies on to stop.
+           Parse a bytes copy instead. */
+        PyObject *bytes, *result;
+
+        bytes = PyBytes_FromStringAndSize(buffer, buffer_len);
+        if (bytes == NULL)
+            return NULL;
+        result = _PyLong_FromBytes(PyBytes_AS_STRING(bytes),
+                                   PyBytes_GET_SIZE(bytes), 10);
+        Py_DECREF(bytes);
+        return result;
+    }
 
     return type_error("int() argument must be a string or a "
                       "number, not '%.200s'", o);
@@ -2260,32 +2272,113 @@ _PyObject_CallMethodId_SizeT(PyObject *o, _Py_Identifier *name, char *format, ..
     return retval;
 }
 
-static PyObject *
-objargs_mktuple(va_list va)
+/* Arrays of up to this many arguments live on the C stack */
+#define OBJARGS_SMALL_STACK 8
+
+/* Collect the NULL-terminated arguments in va into small_stack, or into
+   a PyMem array if there are more than OBJARGS_SMALL_STACK of them. */
+static PyObject **
+objargs_mkstack(PyObject **small_stack, va_list va, Py_ssize_t *p_nargs)
 {
-    int i, n = 0;
+    Py_ssize_t i, n = 0;
     va_list countva;
-    PyObject *result, *tmp;
+    PyObject **stack;
 
         Py_VA_COPY(countva, va);
 
     while (((PyObject *)va_arg(countva, PyObject *)) != NULL)
         ++n;
-    result = PyTuple_New(n);
-    if (result != NULL && n > 0) {
-        for (i = 0; i < n; ++i) {
-            tmp = (PyObject *)va_arg(va, PyObject *);
-            PyTuple_SET_ITEM(result, i, tmp);
-            Py_INCREF(tmp);
+    if (n <= OBJARGS_SMALL_STACK)
+        stack = small_stack;
+    else {
+        stack = PyMem_NEW(PyObject *, n);
+        if (stack == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+    }
+    for (i = 0; i < n; ++i)
+        stack[i] = (PyObject *)va_arg(va, PyObject *);
+    *p_nargs = n;
+    return stack;
+}
+
+PyObject *
+_PyObject_FastCall(PyObject *func, PyObject **args, Py_ssize_t nargs,
+                   PyObject *kwnames)
+{
+    PyObject *small_stack[OBJARGS_SMALL_STACK], **stack;
+    PyObject *callargs, *kw = NULL, *result;
+    Py_ssize_t i, nkw;
+
+    if (PyFunction_Check(func))
+        return _PyFunction_FastCall(func, args, nargs, kwnames);
+
+    nkw = kwnames == NULL ? 0 : PyTuple_GET_SIZE(kwnames);
+    if (PyMethod_Check(func) && PyMethod_GET_SELF(func) != NULL) {
+        /* Put self in front of the arguments */
+        if (nargs + nkw < OBJARGS_SMALL_STACK)
+            stack = small_stack;
+        else {
+            stack = PyMem_NEW(PyObject *, nargs + nkw + 1);
+            if (stack == NULL)
+                return PyErr_NoMemory();
+        }
+        stack[0] = PyMethod_GET_SELF(func);
+        for (i = 0; i < nargs + nkw; i++)
+            stack[i + 1] = args[i];
+        result = _PyObject_FastCall(PyMethod_GET_FUNCTION(func), stack,
+                                    nargs + 1, kwnames);
+        if (stack != small_stack)
+            PyMem_FREE(stack);
+        return result;
+    }
+
+    if (PyCFunction_Check(func)) {
+        if (Py_EnterRecursiveCall(" while calling a Python object"))
+            return NULL;
+        result = _PyCFunction_FastCall(func, args, nargs, kwnames);
+        Py_LeaveRecursiveCall();
+        if (result == NULL && !PyErr_Occurred())
+            PyErr_SetString(
+                PyExc_SystemError,
+                "NULL result without error in PyObject_Call");
+        return result;
+    }
+
+    callargs = PyTuple_New(nargs);
+    if (callargs == NULL)
+        return NULL;
+    for (i = 0; i < nargs; i++) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(callargs, i, args[i]);
+    }
+    if (nkw) {
+        kw = PyDict_New();
+        if (kw == NULL) {
+            Py_DECREF(callargs);
+            return NULL;
+        }
+        for (i = 0; i < nkw; i++) {
+            if (PyDict_SetItem(kw, PyTuple_GET_ITEM(kwnames, i),
+                               args[nargs + i]) < 0) {
+                Py_DECREF(callargs);
+                Py_DECREF(kw);
+                return NULL;
+            }
         }
     }
+    result = PyObject_Call(func, callargs, kw);
+    Py_DECREF(callargs);
+    Py_XDECREF(kw);
     return result;
 }
 
 PyObject *
 PyObject_CallMethodObjArgs(PyObject *callable, PyObject *name, ...)
 {
-    PyObject *args, *tmp;
+    PyObject *small_stack[OBJARGS_SMALL_STACK], **stack, *tmp;
+    Py_ssize_t nargs;
     va_list vargs;
 
     if (callable == NULL || name == NULL)
@@ -2295,16 +2388,16 @@ PyObject_CallMethodObjArgs(PyObject *callable, PyObject *name, ...)
     if (callable == NULL)
         return NULL;
 
-    /* count the args */
     va_start(vargs, name);
-    args = objargs_mktuple(vargs);
+    stack = objargs_mkstack(small_stack, vargs, &nargs);
     va_end(vargs);
-    if (args == NULL) {
+    if (stack == NULL) {
         Py_DECREF(callable);
         return NULL;
     }
-    tmp = PyObject_Call(callable, args, NULL);
-    Py_DECREF(args);
+    tmp = _PyObject_FastCall(callable, stack, nargs, NULL);
+    if (stack != small_stack)
+        PyMem_FREE(stack);
     Py_DECREF(callable);
 
     return tmp;
@@ -2314,7 +2407,8 @@ PyObject *
 _PyObject_CallMethodObjIdArgs(PyObject *callable,
         struct _Py_Identifier *name, ...)
 {
-    PyObject *args, *tmp;
+    PyObject *small_stack[OBJARGS_SMALL_STACK], **stack, *tmp;
+    Py_ssize_t nargs;
     va_list vargs;
 
     if (callable == NULL || name == NULL)
@@ -2324,16 +2418,16 @@ _PyObject_CallMethodObjIdArgs(PyObject *callable,
     if (callable == NULL)
         return NULL;
 
-    /* count the args */
     va_start(vargs, name);
-    args = objargs_mktuple(vargs);
+    stack = objargs_mkstack(small_stack, vargs, &nargs);
     va_end(vargs);
-    if (args == NULL) {
+    if (stack == NULL) {
         Py_DECREF(callable);
         return NULL;
     }
-    tmp = PyObject_Call(callable, args, NULL);
-    Py_DECREF(args);
+    tmp = _PyObject_FastCall(callable, stack, nargs, NULL);
+    if (stack != small_stack)
+        PyMem_FREE(stack);
     Py_DECREF(callable);
 
     return tmp;
@@ -2342,20 +2436,21 @@ _PyObject_CallMethodObjIdArgs(PyObject *callable,
 PyObject *
 PyObject_CallFunctionObjArgs(PyObject *callable, ...)
 {
-    PyObject *args, *tmp;
+    PyObject *small_stack[OBJARGS_SMALL_STACK], **stack, *tmp;
+    Py_ssize_t nargs;
     va_list vargs;
 
     if (callable == NULL)
         return null_error();
 
-    /* count the args */
     va_start(vargs, callable);
-    args = objargs_mktuple(vargs);
+    stack = objargs_mkstack(small_stack, vargs, &nargs);
     va_end(vargs);
-    if (args == NULL)
+    if (stack == NULL)
         return NULL;
-    tmp = PyObject_Call(callable, args, NULL);
-    Py_DECREF(args);
+    tmp = _PyObject_FastCall(callable, stack, nargs, NULL);
+    if (stack != small_stack)
+        PyMem_FREE(stack);
 
     return tmp;
 }
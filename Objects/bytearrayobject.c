@@ -1045,7 +1045,9 @@ bytearray_dealloc(PyByteArrayObject *self)
 #define STRINGLIB_ISLINEBREAK(x) ((x == '\n') || (x == '\r'))
 #define STRINGLIB_CHECK_EXACT PyByteArray_CheckExact
 #define STRINGLIB_MUTABLE 1
+#define STRINGLIB_SIZEOF_CHAR 1
 
+#include "stringlib/simd.h"
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
@@ -580,6 +580,7 @@ PyBytes_AsStringAndSize(register PyObject *obj,
 
 #include "stringlib/stringdefs.h"
 
+#include "stringlib/simd.h"
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
@@ -149,6 +149,7 @@ PyCode_New(int argcount, int kwonlyargcount,
     co->co_lnotab = lnotab;
     co->co_zombieframe = NULL;
     co->co_weakreflist = NULL;
+    co->co_opcounts = NULL;
 #ifdef WITH_PARALLEL
     co->px_execount       = 0;
     co->px_heapsize_avg   = 0;
@@ -384,6 +385,8 @@ code_dealloc(PyCodeObject *co)
         PyMem_FREE(co->co_cell2arg);
     if (co->co_zombieframe != NULL)
         PyObject_GC_Del(co->co_zombieframe);
+    if (co->co_opcounts != NULL)
+        PyMem_FREE(co->co_opcounts);
     if (co->co_weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject*)co);
     PyObject_DEL(co);
@@ -397,6 +400,8 @@ code_sizeof(PyCodeObject *co, void *unused)
     res = sizeof(PyCodeObject);
     if (co->co_cell2arg != NULL && co->co_cellvars != NULL)
         res += PyTuple_GET_SIZE(co->co_cellvars) * sizeof(unsigned char);
+    if (co->co_opcounts != NULL)
+        res += 256 * sizeof(long);
     return PyLong_FromSsize_t(res);
 }
 
@@ -2246,7 +2246,8 @@ dict_contains(register PyDictObject *mp, PyObject *key)
 }
 
 static PyObject *
-dict_get(register PyDictObject *mp, PyObject *args)
+dict_get(register PyDictObject *mp, PyObject **args, Py_ssize_t nargs,
+         PyObject *kwnames)
 {
     PyObject *key;
     PyObject *failobj = Py_None;
@@ -2255,7 +2256,9 @@ dict_get(register PyDictObject *mp, PyObject *args)
     PyDictKeyEntry *ep;
     PyObject **value_addr;
 
-    if (!PyArg_UnpackTuple(args, "get", 1, 2, &key, &failobj))
+    if (!_PyArg_NoStackKeywords("get()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "get", 1, 2, &key, &failobj))
         return NULL;
 
     if (!PyUnicode_CheckExact(key) ||
@@ -2275,7 +2278,8 @@ dict_get(register PyDictObject *mp, PyObject *args)
 }
 
 static PyObject *
-dict_setdefault(register PyDictObject *mp, PyObject *args)
+dict_setdefault(register PyDictObject *mp, PyObject **args, Py_ssize_t nargs,
+                PyObject *kwnames)
 {
     PyObject *key;
     PyObject *failobj = Py_None;
@@ -2284,7 +2288,9 @@ dict_setdefault(register PyDictObject *mp, PyObject *args)
     PyDictKeyEntry *ep;
     PyObject **value_addr;
 
-    if (!PyArg_UnpackTuple(args, "setdefault", 1, 2, &key, &failobj))
+    if (!_PyArg_NoStackKeywords("setdefault()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "setdefault", 1, 2, &key, &failobj))
         return NULL;
 
     /*
@@ -2340,7 +2346,8 @@ dict_clear(register PyDictObject *mp)
 }
 
 static PyObject *
-dict_pop(PyDictObject *mp, PyObject *args)
+dict_pop(PyDictObject *mp, PyObject **args, Py_ssize_t nargs,
+         PyObject *kwnames)
 {
     Py_hash_t hash;
     PyObject *old_value, *old_key;
@@ -2353,7 +2360,9 @@ dict_pop(PyDictObject *mp, PyObject *args)
         return NULL;
     */
 
-    if(!PyArg_UnpackTuple(args, "pop", 1, 2, &key, &deflt))
+    if (!_PyArg_NoStackKeywords("pop()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "pop", 1, 2, &key, &deflt))
         return NULL;
     if (mp->ma_used == 0) {
         if (deflt) {
@@ -2580,11 +2589,11 @@ static PyMethodDef mapp_methods[] = {
      getitem__doc__},
     {"__sizeof__",      (PyCFunction)dict_sizeof,       METH_NOARGS,
      sizeof__doc__},
-    {"get",         (PyCFunction)dict_get,          METH_VARARGS,
+    {"get",         (PyCFunction)dict_get,          METH_FASTCALL,
      get__doc__},
-    {"setdefault",  (PyCFunction)dict_setdefault,   METH_VARARGS,
+    {"setdefault",  (PyCFunction)dict_setdefault,   METH_FASTCALL,
      setdefault_doc__},
-    {"pop",         (PyCFunction)dict_pop,          METH_VARARGS,
+    {"pop",         (PyCFunction)dict_pop,          METH_FASTCALL,
      pop__doc__},
     {"popitem",         (PyCFunction)dict_popitem,      METH_NOARGS,
      popitem__doc__},
@@ -153,6 +153,14 @@ PyFloat_FromString(PyObject *v)
             "float() argument must be a string or a number");
         return NULL;
     }
+    else if (!PyBytes_Check(v)) {
+        /* Only bytes objects are guaranteed to be NUL-terminated, which
+           PyOS_string_to_double() relies on to stop. */
+        s_buffer = PyBytes_FromStringAndSize(s, len);
+        if (s_buffer == NULL)
+            return NULL;
+        s = PyBytes_AS_STRING(s_buffer);
+    }
     last = s + len;
     /* strip space */
     while (s < last && Py_ISSPACE(*s))
@@ -392,33 +392,50 @@ static PyGetSetDef frame_getsetlist[] = {
      * f_localsplus does not require re-allocation and
        the local variables in f_localsplus are NULL.
 
-   2. We also maintain a separate free list of stack frames (just like
+   2. We also maintain separate free lists of stack frames (just like
    floats are allocated in a special way -- see floatobject.c).  When
-   a stack frame is on the free list, only the following members have
+   a stack frame is on a free list, only the following members have
    a meaning:
     ob_type             == &Frametype
     f_back              next item on free list, or NULL
-    f_stacksize         size of value stack
     ob_size             size of localsplus
    Note that the value and block stacks are preserved -- this can save
    another malloc() call or two (and two free() calls as well!).
    Also note that, unlike for integers, each frame object is a
    malloc'ed object in its own right -- it is only the actual calls to
    malloc() that we are trying to save here, not the administration.
-   After all, while a typical program may make millions of calls, a
-   call depth of more than 20 or 30 is probably already exceptional
-   unless the program contains run-away recursion.  I hope.
 
-   Later, PyFrame_MAXFREELIST was added to bound the # of frames saved on
-   free_list.  Else programs creating lots of cyclic trash involving
-   frames could provoke free_list into growing without bound.
+   The zombie frame only serves one call of a code object at a time, so
+   recursive calls, generators and callbacks running in other threads
+   all go to the free lists.  Frames are therefore sized in classes of
+   FRAME_CLASS_SLOTS localsplus slots, with one free list per class: a
+   frame taken from a list is always big enough and never realloc'ed,
+   and a frame released by a deep recursion lands on the list that the
+   next recursion will take it from.  Frames bigger than the largest
+   class get their exact size and aren't kept.
+
+   PyFrame_MAXFREELIST bounds the # of frames saved on each list.  Else
+   programs creating lots of cyclic trash involving frames could provoke
+   the free lists into growing without bound.  PyFrame_ClearFreeList(),
+   called by full garbage collections, gives all of them back at once.
+
+   All of this happens under the GIL; frames created in parallel
+   contexts come from the context's own heap and never reach the lists.
 */
 
-static PyFrameObject *free_list = NULL;
-static int numfree = 0;         /* number of frames currently in free_list */
-/* max value for numfree */
+#define FRAME_CLASS_SLOTS 8
+#define FRAME_NUM_CLASSES 32
 #define PyFrame_MAXFREELIST 200
 
+/* Size class of a frame with n localsplus slots, FRAME_NUM_CLASSES if
+   it is too big for any of them. */
+#define FRAME_CLASS(n) \
+    ((n) < FRAME_CLASS_SLOTS * FRAME_NUM_CLASSES ? \
+     ((n) + FRAME_CLASS_SLOTS - 1) / FRAME_CLASS_SLOTS : FRAME_NUM_CLASSES)
+
+static PyFrameObject *free_list[FRAME_NUM_CLASSES];
+static int numfree[FRAME_NUM_CLASSES];  /* # of frames on each list */
+
 static void
 frame_dealloc(PyFrameObject *f)
 {
@@ -451,13 +468,17 @@ frame_dealloc(PyFrameObject *f)
     co = f->f_code;
     if (co->co_zombieframe == NULL)
         co->co_zombieframe = f;
-    else if (numfree < PyFrame_MAXFREELIST) {
-        ++numfree;
-        f->f_back = free_list;
-        free_list = f;
+    else {
+        int c = FRAME_CLASS(Py_SIZE(f));
+        if (c < FRAME_NUM_CLASSES && numfree[c] < PyFrame_MAXFREELIST) {
+            assert(Py_SIZE(f) == c * FRAME_CLASS_SLOTS);
+            ++numfree[c];
+            f->f_back = free_list[c];
+            free_list[c] = f;
+        }
+        else
+            PyObject_GC_Del(f);
     }
-    else
-        PyObject_GC_Del(f);
 
     Py_DECREF(co);
     Py_TRASHCAN_SAFE_END(f)
@@ -652,10 +673,14 @@ PyFrame_New(PyThreadState *tstate, PyCodeObject *code, PyObject *globals,
     }
     else {
         Py_ssize_t extras, ncells, nfrees;
+        int c;
         ncells = PyTuple_GET_SIZE(code->co_cellvars);
         nfrees = PyTuple_GET_SIZE(code->co_freevars);
         extras = code->co_stacksize + code->co_nlocals + ncells + nfrees;
-        if (Py_PXCTX || free_list == NULL) {
+        c = FRAME_CLASS(extras);
+        if (Py_PXCTX || c == FRAME_NUM_CLASSES || free_list[c] == NULL) {
+            if (!Py_PXCTX && c < FRAME_NUM_CLASSES)
+                extras = c * FRAME_CLASS_SLOTS;
             f = PyObject_GC_NewVar(PyFrameObject, &PyFrame_Type, extras);
             if (f == NULL) {
                 Py_DECREF(builtins);
@@ -664,19 +689,11 @@ PyFrame_New(PyThreadState *tstate, PyCodeObject *code, PyObject *globals,
         }
         else {
             Py_GUARD
-            assert(numfree > 0);
-            --numfree;
-            f = free_list;
-            free_list = free_list->f_back;
-            if (Py_SIZE(f) < extras) {
-                PyFrameObject *new_f = PyObject_GC_Resize(PyFrameObject, f, extras);
-                if (new_f == NULL) {
-                    PyObject_GC_Del(f);
-                    Py_DECREF(builtins);
-                    return NULL;
-                }
-                f = new_f;
-            }
+            assert(numfree[c] > 0);
+            --numfree[c];
+            f = free_list[c];
+            free_list[c] = f->f_back;
+            assert(Py_SIZE(f) >= extras);
             _Py_NewReference((PyObject *)f);
         }
 
@@ -942,16 +959,19 @@ PyFrame_LocalsToFast(PyFrameObject *f, int clear)
 int
 PyFrame_ClearFreeList(void)
 {
-    int freelist_size = numfree;
+    int c, freelist_size = 0;
     if (Py_PXCTX)
         return 0;
-    while (free_list != NULL) {
-        PyFrameObject *f = free_list;
-        free_list = free_list->f_back;
-        PyObject_GC_Del(f);
-        --numfree;
+    for (c = 0; c < FRAME_NUM_CLASSES; c++) {
+        freelist_size += numfree[c];
+        while (free_list[c] != NULL) {
+            PyFrameObject *f = free_list[c];
+            free_list[c] = f->f_back;
+            PyObject_GC_Del(f);
+            --numfree[c];
+        }
+        assert(numfree[c] == 0);
     }
-    assert(numfree == 0);
     return freelist_size;
 }
 
@@ -966,8 +986,14 @@ PyFrame_Fini(void)
 void
 _PyFrame_DebugMallocStats(FILE *out)
 {
-    _PyDebugAllocatorStats(out,
-                           "free PyFrameObject",
-                           numfree, sizeof(PyFrameObject));
+    int c;
+    char buf[128];
+    for (c = 0; c < FRAME_NUM_CLASSES; c++) {
+        PyOS_snprintf(buf, sizeof(buf),
+                      "free %d-slot PyFrameObject", c * FRAME_CLASS_SLOTS);
+        _PyDebugAllocatorStats(out, buf, numfree[c],
+                               _PyObject_VAR_SIZE(&PyFrame_Type,
+                                                  c * FRAME_CLASS_SLOTS));
+    }
 }
 
@@ -3,6 +3,10 @@
 #include "Python.h"
 #include "accu.h"
 
+#ifdef WITH_THREAD
+#include "pythread.h"
+#endif
+
 #ifdef STDC_HEADERS
 #include <stddef.h>
 #else
@@ -784,11 +788,17 @@ list_ass_item(PyListObject *a, Py_ssize_t i, PyObject *v)
 }
 
 static PyObject *
-listinsert(PyListObject *self, PyObject *args)
+listinsert(PyListObject *self, PyObject **args, Py_ssize_t nargs,
+           PyObject *kwnames)
 {
     Py_ssize_t i;
-    PyObject *v;
-    if (!PyArg_ParseTuple(args, "nO:insert", &i, &v))
+    PyObject *index, *v;
+    if (!_PyArg_NoStackKeywords("insert()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "insert", 2, 2, &index, &v))
+        return NULL;
+    i = PyNumber_AsSsize_t(index, PyExc_OverflowError);
+    if (i == -1 && PyErr_Occurred())
         return NULL;
     /* Px_CHECK_PROTECTION handled by ins1()->list_resize() */
     if (ins1(self, i, v) == 0)
@@ -958,14 +968,22 @@ list_inplace_concat(PyListObject *self, PyObject *other)
 }
 
 static PyObject *
-listpop(PyListObject *self, PyObject *args)
+listpop(PyListObject *self, PyObject **args, Py_ssize_t nargs,
+        PyObject *kwnames)
 {
     Py_ssize_t i = -1;
-    PyObject *v;
+    PyObject *index = NULL, *v;
     int status;
 
-    if (!PyArg_ParseTuple(args, "|n:pop", &i))
+    if (!_PyArg_NoStackKeywords("pop()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "pop", 0, 1, &index))
         return NULL;
+    if (index != NULL) {
+        i = PyNumber_AsSsize_t(index, PyExc_OverflowError);
+        if (i == -1 && PyErr_Occurred())
+            return NULL;
+    }
 
     if (Py_SIZE(self) == 0) {
         /* Special-case most common failure cause */
@@ -1085,11 +1103,80 @@ sortslice_advance(sortslice *slice, Py_ssize_t n)
         slice->values += n;
 }
 
-/* Comparison function: PyObject_RichCompareBool with Py_LT.
+typedef struct s_MergeState MergeState;
+
+/* The maximum number of entries in a MergeState's pending-runs stack.
+ * This is enough to sort arrays of size up to about
+ *     32 * phi ** MAX_MERGE_PENDING
+ * where phi ~= 1.618.  85 is ridiculouslylarge enough, good for an array
+ * with 2**64 elements.
+ */
+#define MAX_MERGE_PENDING 85
+
+/* When we get into galloping mode, we stay there until both runs win less
+ * often than MIN_GALLOP consecutive times.  See listsort.txt for more info.
+ */
+#define MIN_GALLOP 7
+
+/* Avoid malloc for small temp arrays. */
+#define MERGESTATE_TEMP_SIZE 256
+
+/* One MergeState exists on the stack per invocation of mergesort.  It's just
+ * a convenient way to pass state around among the helper functions.
+ */
+struct s_slice {
+    sortslice base;
+    Py_ssize_t len;
+};
+
+struct s_MergeState {
+    /* This controls when we get *into* galloping mode.  It's initialized
+     * to MIN_GALLOP.  merge_lo and merge_hi tend to nudge it higher for
+     * random data, and lower for highly structured data.
+     */
+    Py_ssize_t min_gallop;
+
+    /* 'a' is temp storage to help with merges.  It contains room for
+     * alloced entries.
+     */
+    sortslice a;        /* may point to temparray below */
+    Py_ssize_t alloced;
+
+    /* A stack of n pending runs yet to be merged.  Run #i starts at
+     * address base[i] and extends for len[i] elements.  It's always
+     * true (so long as the indices are in bounds) that
+     *
+     *     pending[i].base + pending[i].len == pending[i+1].base
+     *
+     * so we could cut the storage for this, but it's a minor amount,
+     * and keeping all the info explicit simplifies the code.
+     */
+    int n;
+    struct s_slice pending[MAX_MERGE_PENDING];
+
+    /* 'a' points to this when possible, rather than muck with malloc. */
+    PyObject *temparray[MERGESTATE_TEMP_SIZE];
+
+    /* The function used to compare two keys; safe_object_compare() when
+     * none of the special cases apply.
+     */
+    int (*key_compare)(PyObject *, PyObject *, MergeState *);
+
+    /* tp_richcompare of the keys' type, for unsafe_object_compare(). */
+    PyObject *(*key_richcompare)(PyObject *, PyObject *, int);
+
+    /* The function used by unsafe_tuple_compare() to compare the first
+     * items of the tuples.
+     */
+    int (*tuple_elem_compare)(PyObject *, PyObject *, MergeState *);
+};
+
+/* Comparison function: ms->key_compare, which listsort() picks after
+ * looking at the types of the keys; see the compare functions below it.
  * Returns -1 on error, 1 if x < y, 0 if x >= y.
  */
 
-#define ISLT(X, Y) (PyObject_RichCompareBool(X, Y, Py_LT))
+#define ISLT(X, Y) (*(ms->key_compare))(X, Y, ms)
 
 /* Compare X to Y via "<".  Goto "fail" if the comparison raises an
    error.  Else "k" is set to true iff X<Y, and an "if (k)" block is
@@ -1110,7 +1197,7 @@ sortslice_advance(sortslice *slice, Py_ssize_t n)
    the input (nothing is lost or duplicated).
 */
 static int
-binarysort(sortslice lo, PyObject **hi, PyObject **start)
+binarysort(MergeState *ms, sortslice lo, PyObject **hi, PyObject **start)
 {
     register Py_ssize_t k;
     register PyObject **l, **p, **r;
@@ -1184,7 +1271,7 @@ elements to get out of order).
 Returns -1 in case of error.
 */
 static Py_ssize_t
-count_run(PyObject **lo, PyObject **hi, int *descending)
+count_run(MergeState *ms, PyObject **lo, PyObject **hi, int *descending)
 {
     Py_ssize_t k;
     Py_ssize_t n;
@@ -1239,7 +1326,8 @@ key, and the last n-k should follow key.
 Returns -1 on error.  See listsort.txt for info on the method.
 */
 static Py_ssize_t
-gallop_left(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint)
+gallop_left(MergeState *ms, PyObject *key, PyObject **a, Py_ssize_t n,
+            Py_ssize_t hint)
 {
     Py_ssize_t ofs;
     Py_ssize_t lastofs;
@@ -1330,7 +1418,8 @@ we're sticking to "<" comparisons that it's much harder to follow if
 written as one routine with yet another "left or right?" flag.
 */
 static Py_ssize_t
-gallop_right(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint)
+gallop_right(MergeState *ms, PyObject *key, PyObject **a, Py_ssize_t n,
+             Py_ssize_t hint)
 {
     Py_ssize_t ofs;
     Py_ssize_t lastofs;
@@ -1406,59 +1495,6 @@ fail:
     return -1;
 }
 
-/* The maximum number of entries in a MergeState's pending-runs stack.
- * This is enough to sort arrays of size up to about
- *     32 * phi ** MAX_MERGE_PENDING
- * where phi ~= 1.618.  85 is ridiculouslylarge enough, good for an array
- * with 2**64 elements.
- */
-#define MAX_MERGE_PENDING 85
-
-/* When we get into galloping mode, we stay there until both runs win less
- * often than MIN_GALLOP consecutive times.  See listsort.txt for more info.
- */
-#define MIN_GALLOP 7
-
-/* Avoid malloc for small temp arrays. */
-#define MERGESTATE_TEMP_SIZE 256
-
-/* One MergeState exists on the stack per invocation of mergesort.  It's just
- * a convenient way to pass state around among the helper functions.
- */
-struct s_slice {
-    sortslice base;
-    Py_ssize_t len;
-};
-
-typedef struct s_MergeState {
-    /* This controls when we get *into* galloping mode.  It's initialized
-     * to MIN_GALLOP.  merge_lo and merge_hi tend to nudge it higher for
-     * random data, and lower for highly structured data.
-     */
-    Py_ssize_t min_gallop;
-
-    /* 'a' is temp storage to help with merges.  It contains room for
-     * alloced entries.
-     */
-    sortslice a;        /* may point to temparray below */
-    Py_ssize_t alloced;
-
-    /* A stack of n pending runs yet to be merged.  Run #i starts at
-     * address base[i] and extends for len[i] elements.  It's always
-     * true (so long as the indices are in bounds) that
-     *
-     *     pending[i].base + pending[i].len == pending[i+1].base
-     *
-     * so we could cut the storage for this, but it's a minor amount,
-     * and keeping all the info explicit simplifies the code.
-     */
-    int n;
-    struct s_slice pending[MAX_MERGE_PENDING];
-
-    /* 'a' points to this when possible, rather than muck with malloc. */
-    PyObject *temparray[MERGESTATE_TEMP_SIZE];
-} MergeState;
-
 /* Conceptually a MergeState's constructor. */
 static void
 merge_init(MergeState *ms, Py_ssize_t list_size, int has_keyfunc)
@@ -1611,7 +1647,7 @@ merge_lo(MergeState *ms, sortslice ssa, Py_ssize_t na,
             assert(na > 1 && nb > 0);
             min_gallop -= min_gallop > 1;
             ms->min_gallop = min_gallop;
-            k = gallop_right(ssb.keys[0], ssa.keys, na, 0);
+            k = gallop_right(ms, ssb.keys[0], ssa.keys, na, 0);
             acount = k;
             if (k) {
                 if (k < 0)
@@ -1634,7 +1670,7 @@ merge_lo(MergeState *ms, sortslice ssa, Py_ssize_t na,
             if (nb == 0)
                 goto Succeed;
 
-            k = gallop_left(ssa.keys[0], ssb.keys, nb, 0);
+            k = gallop_left(ms, ssa.keys[0], ssb.keys, nb, 0);
             bcount = k;
             if (k) {
                 if (k < 0)
@@ -1749,7 +1785,7 @@ merge_hi(MergeState *ms, sortslice ssa, Py_ssize_t na,
             assert(na > 0 && nb > 1);
             min_gallop -= min_gallop > 1;
             ms->min_gallop = min_gallop;
-            k = gallop_right(ssb.keys[0], basea.keys, na, na-1);
+            k = gallop_right(ms, ssb.keys[0], basea.keys, na, na-1);
             if (k < 0)
                 goto Fail;
             k = na - k;
@@ -1767,7 +1803,7 @@ merge_hi(MergeState *ms, sortslice ssa, Py_ssize_t na,
             if (nb == 1)
                 goto CopyA;
 
-            k = gallop_left(ssa.keys[0], baseb.keys, nb, nb-1);
+            k = gallop_left(ms, ssa.keys[0], baseb.keys, nb, nb-1);
             if (k < 0)
                 goto Fail;
             k = nb - k;
@@ -1844,7 +1880,7 @@ merge_at(MergeState *ms, Py_ssize_t i)
     /* Where does b start in a?  Elements in a before that can be
      * ignored (already in place).
      */
-    k = gallop_right(*ssb.keys, ssa.keys, na, 0);
+    k = gallop_right(ms, *ssb.keys, ssa.keys, na, 0);
     if (k < 0)
         return -1;
     sortslice_advance(&ssa, k);
@@ -1855,7 +1891,7 @@ merge_at(MergeState *ms, Py_ssize_t i)
     /* Where does a end in b?  Elements in b after that can be
      * ignored (already in place).
      */
-    nb = gallop_left(ssa.keys[na-1], ssb.keys, nb, nb-1);
+    nb = gallop_left(ms, ssa.keys[na-1], ssb.keys, nb, nb-1);
     if (nb <= 0)
         return nb;
 
@@ -1954,6 +1990,397 @@ reverse_sortslice(sortslice *s, Py_ssize_t n)
         reverse_slice(s->values, &s->values[n]);
 }
 
+/* Sort the n > 0 elements at lo: find the natural runs, extend short ones
+ * to minrun elements, and merge them, leaving a single run on ms's stack.
+ * Returns 0 on success, -1 on error.
+ */
+static int
+sort_runs(MergeState *ms, sortslice lo, Py_ssize_t nremaining)
+{
+    Py_ssize_t minrun;
+
+    assert(nremaining > 0);
+    /* March over the array once, left to right, finding natural runs,
+     * and extending short natural runs to minrun elements.
+     */
+    minrun = merge_compute_minrun(nremaining);
+    do {
+        int descending;
+        Py_ssize_t n;
+
+        /* Identify next run. */
+        n = count_run(ms, lo.keys, lo.keys + nremaining, &descending);
+        if (n < 0)
+            return -1;
+        if (descending)
+            reverse_sortslice(&lo, n);
+        /* If short, extend to min(minrun, nremaining). */
+        if (n < minrun) {
+            const Py_ssize_t force = nremaining <= minrun ?
+                              nremaining : minrun;
+            if (binarysort(ms, lo, lo.keys + force, lo.keys + n) < 0)
+                return -1;
+            n = force;
+        }
+        /* Push run onto pending-runs stack, and maybe merge. */
+        assert(ms->n < MAX_MERGE_PENDING);
+        ms->pending[ms->n].base = lo;
+        ms->pending[ms->n].len = n;
+        ++ms->n;
+        if (merge_collapse(ms) < 0)
+            return -1;
+        /* Advance to find next run. */
+        sortslice_advance(&lo, n);
+        nremaining -= n;
+    } while (nremaining);
+
+    return merge_force_collapse(ms);
+}
+
+/* Here we define custom comparison functions for the cases one commonly
+ * meets in practice: lists of ints, floats, 1-byte strs, or tuples whose
+ * first items are one of those.  listsort() checks once that every key
+ * satisfies the assumptions of a function before using it, so the
+ * functions can skip the type dispatch and the error handling of
+ * PyObject_RichCompareBool().
+ */
+
+/* Safe, general comparison: no assumptions. */
+static int
+safe_object_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    return PyObject_RichCompareBool(v, w, Py_LT);
+}
+
+/* Homogeneous keys of a type with tp_richcompare: call it directly. */
+static int
+unsafe_object_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    PyObject *res_obj;
+    int res;
+
+    /* The type may have been changed during the sort. */
+    if (Py_TYPE(v)->tp_richcompare != ms->key_richcompare)
+        return PyObject_RichCompareBool(v, w, Py_LT);
+
+    res_obj = (*(ms->key_richcompare))(v, w, Py_LT);
+    if (res_obj == Py_NotImplemented) {
+        Py_DECREF(res_obj);
+        return PyObject_RichCompareBool(v, w, Py_LT);
+    }
+    if (res_obj == NULL)
+        return -1;
+    if (PyBool_Check(res_obj))
+        res = (res_obj == Py_True);
+    else
+        res = PyObject_IsTrue(res_obj);
+    Py_DECREF(res_obj);
+    return res;
+}
+
+/* Ready strs of kind PyUnicode_1BYTE_KIND. */
+static int
+unsafe_latin_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    Py_ssize_t vlen, wlen;
+    int res;
+
+    assert(Py_TYPE(v) == Py_TYPE(w) && Py_TYPE(v) == &PyUnicode_Type);
+    assert(PyUnicode_KIND(v) == PyUnicode_1BYTE_KIND);
+    assert(PyUnicode_KIND(w) == PyUnicode_1BYTE_KIND);
+
+    vlen = PyUnicode_GET_LENGTH(v);
+    wlen = PyUnicode_GET_LENGTH(w);
+    res = memcmp(PyUnicode_DATA(v), PyUnicode_DATA(w), Py_MIN(vlen, wlen));
+    return res != 0 ? res < 0 : vlen < wlen;
+}
+
+/* ints with at most one digit. */
+static int
+unsafe_long_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    PyLongObject *vl = (PyLongObject *)v, *wl = (PyLongObject *)w;
+    sdigit v0, w0;
+
+    assert(Py_TYPE(v) == Py_TYPE(w) && Py_TYPE(v) == &PyLong_Type);
+    assert(-1 <= Py_SIZE(v) && Py_SIZE(v) <= 1);
+    assert(-1 <= Py_SIZE(w) && Py_SIZE(w) <= 1);
+
+    v0 = Py_SIZE(vl) == 0 ? 0 : (sdigit)vl->ob_digit[0];
+    w0 = Py_SIZE(wl) == 0 ? 0 : (sdigit)wl->ob_digit[0];
+    if (Py_SIZE(vl) < 0)
+        v0 = -v0;
+    if (Py_SIZE(wl) < 0)
+        w0 = -w0;
+    return v0 < w0;
+}
+
+/* floats. */
+static int
+unsafe_float_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    assert(Py_TYPE(v) == Py_TYPE(w) && Py_TYPE(v) == &PyFloat_Type);
+    return PyFloat_AS_DOUBLE(v) < PyFloat_AS_DOUBLE(w);
+}
+
+/* Non-empty tuples, whose first items are compared with
+ * ms->tuple_elem_compare.  Like tuplerichcompare() otherwise.
+ */
+static int
+unsafe_tuple_compare(PyObject *v, PyObject *w, MergeState *ms)
+{
+    PyTupleObject *vt = (PyTupleObject *)v, *wt = (PyTupleObject *)w;
+    Py_ssize_t i, vlen, wlen;
+    int k;
+
+    assert(Py_TYPE(v) == Py_TYPE(w) && Py_TYPE(v) == &PyTuple_Type);
+    assert(Py_SIZE(v) > 0 && Py_SIZE(w) > 0);
+
+    vlen = Py_SIZE(vt);
+    wlen = Py_SIZE(wt);
+    for (i = 0; i < vlen && i < wlen; i++) {
+        k = PyObject_RichCompareBool(vt->ob_item[i], wt->ob_item[i], Py_EQ);
+        if (k < 0)
+            return -1;
+        if (!k)
+            break;
+    }
+    if (i >= vlen || i >= wlen)
+        return vlen < wlen;
+    if (i == 0)
+        return ms->tuple_elem_compare(vt->ob_item[i], wt->ob_item[i], ms);
+    return PyObject_RichCompareBool(vt->ob_item[i], wt->ob_item[i], Py_LT);
+}
+
+/* Pick ms->key_compare for the n keys at keys. */
+static void
+choose_key_compare(MergeState *ms, PyObject **keys, Py_ssize_t n)
+{
+    int keys_are_in_tuples, keys_are_all_same_type = 1;
+    int strings_are_latin = 1, ints_are_bounded = 1;
+    PyTypeObject *key_type;
+    Py_ssize_t i;
+
+    ms->key_compare = safe_object_compare;
+    if (n < 2)
+        return;
+
+    /* Assume the first key is representative, then check every key. */
+    keys_are_in_tuples = (Py_TYPE(keys[0]) == &PyTuple_Type &&
+                          Py_SIZE(keys[0]) > 0);
+    key_type = Py_TYPE(keys_are_in_tuples ? PyTuple_GET_ITEM(keys[0], 0)
+                                          : keys[0]);
+    for (i = 0; i < n; i++) {
+        PyObject *key;
+
+        if (keys_are_in_tuples &&
+            !(Py_TYPE(keys[i]) == &PyTuple_Type && Py_SIZE(keys[i]) > 0)) {
+            keys_are_in_tuples = 0;
+            keys_are_all_same_type = 0;
+            break;
+        }
+        /* For tuples, check the type of the first item. */
+        key = keys_are_in_tuples ? PyTuple_GET_ITEM(keys[i], 0) : keys[i];
+        if (Py_TYPE(key) != key_type) {
+            keys_are_all_same_type = 0;
+            /* All the keys must still be checked for being tuples. */
+            if (!keys_are_in_tuples)
+                break;
+        }
+        if (keys_are_all_same_type) {
+            if (key_type == &PyLong_Type &&
+                (Py_SIZE(key) > 1 || Py_SIZE(key) < -1))
+                ints_are_bounded = 0;
+            else if (key_type == &PyUnicode_Type &&
+                     (!PyUnicode_IS_READY(key) ||
+                      PyUnicode_KIND(key) != PyUnicode_1BYTE_KIND))
+                strings_are_latin = 0;
+        }
+    }
+
+    if (keys_are_all_same_type) {
+        if (key_type == &PyUnicode_Type && strings_are_latin)
+            ms->key_compare = unsafe_latin_compare;
+        else if (key_type == &PyLong_Type && ints_are_bounded)
+            ms->key_compare = unsafe_long_compare;
+        else if (key_type == &PyFloat_Type)
+            ms->key_compare = unsafe_float_compare;
+        else if ((ms->key_richcompare = key_type->tp_richcompare) != NULL)
+            ms->key_compare = unsafe_object_compare;
+    }
+    if (keys_are_in_tuples) {
+        /* Tuples of tuples compare their first items generically. */
+        if (key_type == &PyTuple_Type)
+            ms->tuple_elem_compare = safe_object_compare;
+        else
+            ms->tuple_elem_compare = ms->key_compare;
+        ms->key_compare = unsafe_tuple_compare;
+    }
+}
+
+/* Lists of at least parallel_sort_min elements are sorted by several
+ * threads when the keys can be compared without calling back into Python
+ * (and without the GIL): every thread sorts a slice with its own
+ * MergeState, and the sorted slices are then merged as runs.
+ * parallel_sort_threads is the number of threads, or 0 for one per CPU.
+ */
+#define PARALLEL_SORT_MIN (1 << 20)
+#define PARALLEL_SORT_MAX_THREADS 8
+
+static int parallel_sort_threads = 0;
+static Py_ssize_t parallel_sort_min = PARALLEL_SORT_MIN;
+
+/* Set the parallel sort settings; used by sys._setparallelsort().  Returns
+   0 on success, or -1 with ValueError set. */
+int
+_PyList_SetParallelSort(int nthreads, Py_ssize_t min_size)
+{
+    if (nthreads < 0 || nthreads > PARALLEL_SORT_MAX_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+                     "nthreads must be between 0 and %d",
+                     PARALLEL_SORT_MAX_THREADS);
+        return -1;
+    }
+    if (min_size < 2) {
+        PyErr_SetString(PyExc_ValueError, "min_size must be at least 2");
+        return -1;
+    }
+    parallel_sort_threads = nthreads;
+    parallel_sort_min = min_size;
+    return 0;
+}
+
+void
+_PyList_GetParallelSort(int *nthreads, Py_ssize_t *min_size)
+{
+    *nthreads = parallel_sort_threads;
+    *min_size = parallel_sort_min;
+}
+
+#ifdef WITH_THREAD
+
+typedef struct {
+    MergeState ms;
+    sortslice lo;
+    Py_ssize_t n;
+    PyThread_type_lock done;
+} sort_worker;
+
+static void
+sort_worker_run(void *arg)
+{
+    sort_worker *w = (sort_worker *)arg;
+    int res;
+
+    /* The compare functions used here can't fail, and the temp memory
+       was allocated up front. */
+    res = sort_runs(&w->ms, w->lo, w->n);
+    assert(res == 0);
+    (void)res;
+    PyThread_release_lock(w->done);
+}
+
+/* Sort the n elements at lo in parallel, leaving the result as a single run
+ * on ms's stack.  Returns 0 on success, 1 if the sort should be done
+ * serially instead, and -1 on error.
+ */
+static int
+parallel_sort(MergeState *ms, sortslice lo, Py_ssize_t n)
+{
+    sort_worker *workers;
+    int nworkers, i, res = 0;
+    Py_ssize_t chunk;
+
+    if (n < parallel_sort_min ||
+        !(ms->key_compare == unsafe_long_compare ||
+          ms->key_compare == unsafe_float_compare ||
+          ms->key_compare == unsafe_latin_compare))
+        return 1;
+    nworkers = parallel_sort_threads;
+    if (nworkers == 0)
+        nworkers = Py_MIN(_PyThread_cpu_count(), PARALLEL_SORT_MAX_THREADS);
+    /* Every slice needs at least one element. */
+    if (nworkers > n)
+        nworkers = (int)n;
+    if (nworkers < 2)
+        return 1;
+
+    workers = PyMem_New(sort_worker, nworkers);
+    if (workers == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    chunk = n / nworkers;
+    for (i = 0; i < nworkers; i++) {
+        sort_worker *w = &workers[i];
+        w->lo = lo;
+        sortslice_advance(&w->lo, i * chunk);
+        w->n = i == nworkers - 1 ? n - i * chunk : chunk;
+        merge_init(&w->ms, w->n, lo.values != NULL);
+        w->ms.key_compare = ms->key_compare;
+        w->done = NULL;
+    }
+    /* Allocate everything the threads need while we hold the GIL. */
+    for (i = 0; i < nworkers; i++) {
+        sort_worker *w = &workers[i];
+        if (merge_getmem(&w->ms, (w->n + 1) / 2) < 0 ||
+            (i > 0 && (w->done = PyThread_allocate_lock()) == NULL)) {
+            if (!PyErr_Occurred())
+                PyErr_NoMemory();
+            res = -1;
+            goto done;
+        }
+    }
+
+    for (i = 1; i < nworkers; i++) {
+        sort_worker *w = &workers[i];
+        PyThread_acquire_lock(w->done, WAIT_LOCK);
+        if (PyThread_start_new_thread(sort_worker_run, w) == -1) {
+            /* Sort this slice ourselves. */
+            PyThread_release_lock(w->done);
+            if (sort_runs(&w->ms, w->lo, w->n) < 0) {
+                res = -1;
+                break;
+            }
+        }
+    }
+    if (res == 0)
+        res = sort_runs(&workers[0].ms, workers[0].lo, workers[0].n);
+    /* Wait for all the threads, even after an error. */
+    for (i = 1; i < nworkers; i++) {
+        if (workers[i].done != NULL) {
+            PyThread_acquire_lock(workers[i].done, WAIT_LOCK);
+            PyThread_release_lock(workers[i].done);
+        }
+    }
+    if (res < 0)
+        goto done;
+
+    /* Merge the sorted slices. */
+    for (i = 0; i < nworkers; i++) {
+        assert(ms->n < MAX_MERGE_PENDING);
+        ms->pending[ms->n].base = workers[i].lo;
+        ms->pending[ms->n].len = workers[i].n;
+        ++ms->n;
+        if (merge_collapse(ms) < 0) {
+            res = -1;
+            goto done;
+        }
+    }
+    res = merge_force_collapse(ms);
+
+  done:
+    for (i = 0; i < nworkers; i++) {
+        merge_freemem(&workers[i].ms);
+        if (workers[i].done != NULL)
+            PyThread_free_lock(workers[i].done);
+    }
+    PyMem_Free(workers);
+    return res;
+}
+
+#endif /* WITH_THREAD */
+
 /* An adaptive, stable, natural mergesort.  See listsort.txt.
  * Returns Py_None on success, NULL on error.  Even in case of error, the
  * list will be some permutation of its input state (nothing is lost or
@@ -1963,8 +2390,6 @@ static PyObject *
 listsort(PyListObject *self, PyObject *args, PyObject *kwds)
 {
     MergeState ms;
-    Py_ssize_t nremaining;
-    Py_ssize_t minrun;
     sortslice lo;
     Py_ssize_t saved_ob_size, saved_allocated;
     PyObject **saved_ob_item;
@@ -2042,10 +2467,11 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
 
     merge_init(&ms, saved_ob_size, keys != NULL);
 
-    nremaining = saved_ob_size;
-    if (nremaining < 2)
+    if (saved_ob_size < 2)
         goto succeed;
 
+    choose_key_compare(&ms, lo.keys, saved_ob_size);
+
     /* Reverse sort stability achieved by initially reversing the list,
     applying a stable forward sort, then reversing the final result. */
     if (reverse) {
@@ -2054,42 +2480,16 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
         reverse_slice(&saved_ob_item[0], &saved_ob_item[saved_ob_size]);
     }
 
-    /* March over the array once, left to right, finding natural runs,
-     * and extending short natural runs to minrun elements.
-     */
-    minrun = merge_compute_minrun(nremaining);
-    do {
-        int descending;
-        Py_ssize_t n;
-
-        /* Identify next run. */
-        n = count_run(lo.keys, lo.keys + nremaining, &descending);
-        if (n < 0)
-            goto fail;
-        if (descending)
-            reverse_sortslice(&lo, n);
-        /* If short, extend to min(minrun, nremaining). */
-        if (n < minrun) {
-            const Py_ssize_t force = nremaining <= minrun ?
-                              nremaining : minrun;
-            if (binarysort(lo, lo.keys + force, lo.keys + n) < 0)
-                goto fail;
-            n = force;
-        }
-        /* Push run onto pending-runs stack, and maybe merge. */
-        assert(ms.n < MAX_MERGE_PENDING);
-        ms.pending[ms.n].base = lo;
-        ms.pending[ms.n].len = n;
-        ++ms.n;
-        if (merge_collapse(&ms) < 0)
-            goto fail;
-        /* Advance to find next run. */
-        sortslice_advance(&lo, n);
-        nremaining -= n;
-    } while (nremaining);
-
-    if (merge_force_collapse(&ms) < 0)
+#ifdef WITH_THREAD
+    i = parallel_sort(&ms, lo, saved_ob_size);
+    if (i < 0)
         goto fail;
+    if (i > 0 && sort_runs(&ms, lo, saved_ob_size) < 0)
+        goto fail;
+#else
+    if (sort_runs(&ms, lo, saved_ob_size) < 0)
+        goto fail;
+#endif
     assert(ms.n == 1);
     assert(keys == NULL
            ? ms.pending[0].base.keys == saved_ob_item
@@ -2443,9 +2843,9 @@ static PyMethodDef list_methods[] = {
     {"clear",           (PyCFunction)listclear,   METH_NOARGS, clear_doc},
     {"copy",            (PyCFunction)listcopy,   METH_NOARGS, copy_doc},
     {"append",          (PyCFunction)listappend,  METH_O, append_doc},
-    {"insert",          (PyCFunction)listinsert,  METH_VARARGS, insert_doc},
+    {"insert",          (PyCFunction)listinsert,  METH_FASTCALL, insert_doc},
     {"extend",          (PyCFunction)listextend,  METH_O, extend_doc},
-    {"pop",             (PyCFunction)listpop,     METH_VARARGS, pop_doc},
+    {"pop",             (PyCFunction)listpop,     METH_FASTCALL, pop_doc},
     {"remove",          (PyCFunction)listremove,  METH_O, remove_doc},
     {"index",           (PyCFunction)listindex,   METH_VARARGS, index_doc},
     {"count",           (PyCFunction)listcount,   METH_O, count_doc},
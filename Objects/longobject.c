@@ -1569,6 +1569,72 @@ divrem1(PyLongObject *a, digit n, digit *prem)
     return long_normalize(z);
 }
 
+/* Divide-and-conquer conversion between ints and decimal strings.
+
+   The loops in long_to_decimal_string_internal() and PyLong_FromString()
+   take time quadratic in the number of digits.  Above the cutoffs below,
+   a value is instead split around a power of ten into two halves that are
+   converted recursively, and the halves are combined (parsing) or
+   separated (formatting) with k_mul.  The powers used are
+
+       pow[i] = 10 ** (DECIMAL_DC_LEAF * _PyLong_DECIMAL_SHIFT << i)
+
+   so that every level of the recursion uses a single power.  Formatting
+   divides by pow[i] by multiplying with a precomputed reciprocal (Newton's
+   method), so both directions cost O(M(n) log n), where M(n) is the cost
+   of multiplying n-digit ints. */
+
+/* Ints with more than this many digits are formatted by divide and
+   conquer. */
+#define DECIMAL_FORMAT_CUTOFF 2000
+/* Decimal strings with more than this many digits are parsed by divide and
+   conquer. */
+#define DECIMAL_PARSE_CUTOFF 8000
+/* Size of the smallest pieces, in base _PyLong_DECIMAL_BASE digits. */
+#define DECIMAL_DC_LEAF 64
+/* Reciprocals of divisors with at most this many bits are computed by
+   long division. */
+#define DECIMAL_RECIP_CUTOFF 4096
+
+/* forward */
+static int long_to_decimal_digits_large(PyLongObject *, digit *, int);
+static PyLongObject *long_from_decimal_large(const char *, Py_ssize_t);
+
+/* Convert the array of base _PyLong_BASE digits of abs(a) to an array of
+   base _PyLong_DECIMAL_BASE digits in pout, least significant first,
+   following Knuth (TAOCP, Volume 2 (3rd edn), section 4.4, Method 1b).
+   pout must have room for all of them.  Returns the number of digits
+   stored (0 for a == 0), or -1 on error. */
+
+static Py_ssize_t
+long_to_decimal_digits(PyLongObject *a, digit *pout)
+{
+    Py_ssize_t size, size_a, i, j;
+    digit *pin;
+
+    size_a = ABS(Py_SIZE(a));
+    pin = a->ob_digit;
+    size = 0;
+    for (i = size_a; --i >= 0; ) {
+        digit hi = pin[i];
+        for (j = 0; j < size; j++) {
+            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
+            hi = (digit)(z / _PyLong_DECIMAL_BASE);
+            pout[j] = (digit)(z - (twodigits)hi *
+                              _PyLong_DECIMAL_BASE);
+        }
+        while (hi) {
+            pout[size++] = hi % _PyLong_DECIMAL_BASE;
+            hi /= _PyLong_DECIMAL_BASE;
+        }
+        /* check for keyboard interrupt */
+        SIGCHECK({
+                return -1;
+            });
+    }
+    return size;
+}
+
 /* Convert an integer to a base 10 string.  Returns a new non-shared
    string.  (Return value is non-shared so that callers can modify the
    returned value if necessary.) */
@@ -1581,7 +1647,7 @@ long_to_decimal_string_internal(PyObject *aa,
     PyLongObject *scratch, *a;
     PyObject *str;
     Py_ssize_t size, strlen, size_a, i, j;
-    digit *pout, *pin, rem, tenpow;
+    digit *pout, rem, tenpow;
     int negative;
     enum PyUnicode_Kind kind;
 
@@ -1609,33 +1675,33 @@ long_to_decimal_string_internal(PyObject *aa,
     }
     /* the expression size_a * PyLong_SHIFT is now safe from overflow */
     size = 1 + size_a * PyLong_SHIFT / (3 * _PyLong_DECIMAL_SHIFT);
-    scratch = _PyLong_New(size);
-    if (scratch == NULL)
-        return -1;
-
-    /* convert array of base _PyLong_BASE digits in pin to an array of
-       base _PyLong_DECIMAL_BASE digits in pout, following Knuth (TAOCP,
-       Volume 2 (3rd edn), section 4.4, Method 1b). */
-    pin = a->ob_digit;
-    pout = scratch->ob_digit;
-    size = 0;
-    for (i = size_a; --i >= 0; ) {
-        digit hi = pin[i];
-        for (j = 0; j < size; j++) {
-            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
-            hi = (digit)(z / _PyLong_DECIMAL_BASE);
-            pout[j] = (digit)(z - (twodigits)hi *
-                              _PyLong_DECIMAL_BASE);
+    if (size_a > DECIMAL_FORMAT_CUTOFF) {
+        /* round the size up for the divide-and-conquer conversion */
+        int level = 0;
+        while (((Py_ssize_t)DECIMAL_DC_LEAF << level) < size)
+            level++;
+        size = (Py_ssize_t)DECIMAL_DC_LEAF << level;
+        scratch = _PyLong_New(size);
+        if (scratch == NULL)
+            return -1;
+        pout = scratch->ob_digit;
+        if (long_to_decimal_digits_large(a, pout, level) < 0) {
+            Py_DECREF(scratch);
+            return -1;
         }
-        while (hi) {
-            pout[size++] = hi % _PyLong_DECIMAL_BASE;
-            hi /= _PyLong_DECIMAL_BASE;
+        while (size > 0 && pout[size - 1] == 0)
+            size--;
+    }
+    else {
+        scratch = _PyLong_New(size);
+        if (scratch == NULL)
+            return -1;
+        pout = scratch->ob_digit;
+        size = long_to_decimal_digits(a, pout);
+        if (size < 0) {
+            Py_DECREF(scratch);
+            return -1;
         }
-        /* check for keyboard interrupt */
-        SIGCHECK({
-                Py_DECREF(scratch);
-                return -1;
-            });
     }
     /* pout should have at least one digit, so that the case when a = 0
        works correctly */
@@ -2003,6 +2069,16 @@ long_from_binary_base(char **str, int base)
     return long_normalize(z);
 }
 
+/* Return the number of decimal digits at the start of str. */
+static Py_ssize_t
+decimal_length(const char *str)
+{
+    const char *p = str;
+    while (_PyLong_DigitValue[Py_CHARMASK(*p)] < 10)
+        ++p;
+    return p - str;
+}
+
 /* Parses an int from a bytestring. Leading and trailing whitespace will be
  * ignored.
  *
@@ -2018,7 +2094,7 @@ PyLong_FromString(char *str, char **pend, int base)
     char *start, *orig_str = str;
     PyLongObject *z = NULL;
     PyObject *strobj;
-    Py_ssize_t slen;
+    Py_ssize_t slen, ndigits;
 
     if ((base != 0 && base < 2) || base > 36) {
         PyErr_SetString(PyExc_ValueError,
@@ -2058,6 +2134,11 @@ PyLong_FromString(char *str, char **pend, int base)
     start = str;
     if ((base & (base - 1)) == 0)
         z = long_from_binary_base(&str, base);
+    else if (base == 10 &&
+             (ndigits = decimal_length(str)) > DECIMAL_PARSE_CUTOFF) {
+        z = long_from_decimal_large(str, ndigits);
+        str += ndigits;
+    }
     else {
 /***
 Binary bases can be converted in time linear in the number of digits, because
@@ -3067,6 +3148,230 @@ x_mul(PyLongObject *a, PyLongObject *b)
     return long_normalize(z);
 }
 
+/* Number-theoretic transform (NTT) multiplication.
+
+   The digits of the two operands are the coefficients of two polynomials
+   whose product is computed as a cyclic convolution, with a radix-2 NTT
+   modulo each of the three primes below.  The exact coefficients are
+   recovered with the Chinese remainder theorem (Garner's algorithm), and
+   the carries propagated as they are.  A coefficient of the product is
+   less than 2**NTT_MAX_LOG2 * PyLong_BASE**2 <= 2**84, below the product of
+   the primes (about 2**89.2); NTT_MAX_LOG2 is the smallest 2-adic order of
+   p - 1.  This takes O(n log n) time, against O(n**1.585) for Karatsuba.
+*/
+
+#if defined(PY_UINT32_T) && defined(PY_UINT64_T)
+#define HAVE_LONG_NTT
+
+/* Use the NTT when the smaller operand has at least this many digits. */
+#define NTT_CUTOFF 2000
+/* Length of the largest transform. */
+#define NTT_MAX_LOG2 24
+#define NTT_MAX_SIZE ((Py_ssize_t)1 << NTT_MAX_LOG2)
+
+typedef PY_UINT32_T ntt_word;
+typedef PY_UINT64_T ntt_dword;
+
+/* p = c * 2**k + 1 and a primitive root mod p */
+static const ntt_word ntt_primes[3] = {2013265921, 469762049, 754974721};
+static const ntt_word ntt_roots[3] = {31, 3, 11};
+
+static ntt_word
+ntt_powmod(ntt_word a, ntt_dword e, ntt_word p)
+{
+    ntt_dword r = 1, x = a;
+    while (e) {
+        if (e & 1)
+            r = r * x % p;
+        x = x * x % p;
+        e >>= 1;
+    }
+    return (ntt_word)r;
+}
+
+/* Return a * w % p, for a < 2**32, given wq = (w << 32) // p (Shoup's
+   trick: no division at run time). */
+Py_LOCAL_INLINE(ntt_word)
+ntt_mulmod(ntt_word a, ntt_word w, ntt_word wq, ntt_word p)
+{
+    ntt_word q = (ntt_word)(((ntt_dword)a * wq) >> 32);
+    ntt_word r = a * w - q * p;
+    return r >= p ? r - p : r;
+}
+
+/* Fill tw[h:2*h] and twq[h:2*h] with the powers 0 .. h-1 of a primitive
+   (2*h)-th root of unity mod p, or of its inverse, for every h < n. */
+static void
+ntt_twiddles(ntt_word *tw, ntt_word *twq, Py_ssize_t n, int prime,
+             int inverse)
+{
+    ntt_word p = ntt_primes[prime];
+    Py_ssize_t h, j;
+
+    for (h = n / 2; h >= 1; h /= 2) {
+        ntt_word w = ntt_powmod(ntt_roots[prime], (p - 1) / (2 * h), p);
+        ntt_dword x = 1;
+        if (inverse)
+            w = ntt_powmod(w, p - 2, p);
+        for (j = 0; j < h; j++) {
+            tw[h + j] = (ntt_word)x;
+            twq[h + j] = (ntt_word)(((ntt_dword)x << 32) / p);
+            x = x * w % p;
+        }
+    }
+}
+
+/* Forward transform of a[:n], decimation in frequency: the input is in
+   natural order, the output in bit-reversed order. */
+static void
+ntt_forward(ntt_word *a, Py_ssize_t n, const ntt_word *tw,
+            const ntt_word *twq, ntt_word p)
+{
+    Py_ssize_t h, i, j;
+
+    for (h = n / 2; h >= 1; h /= 2) {
+        for (i = 0; i < n; i += 2 * h) {
+            ntt_word *x = a + i, *y = a + i + h;
+            for (j = 0; j < h; j++) {
+                ntt_word u = x[j], v = y[j];
+                ntt_word s = u + v;
+                x[j] = s >= p ? s - p : s;
+                y[j] = ntt_mulmod(u + p - v, tw[h + j], twq[h + j], p);
+            }
+        }
+    }
+}
+
+/* Inverse transform of a[:n] without the division by n, decimation in
+   time: the input is in bit-reversed order, the output in natural
+   order. */
+static void
+ntt_inverse(ntt_word *a, Py_ssize_t n, const ntt_word *tw,
+            const ntt_word *twq, ntt_word p)
+{
+    Py_ssize_t h, i, j;
+
+    for (h = 1; h < n; h *= 2) {
+        for (i = 0; i < n; i += 2 * h) {
+            ntt_word *x = a + i, *y = a + i + h;
+            for (j = 0; j < h; j++) {
+                ntt_word u = x[j];
+                ntt_word v = ntt_mulmod(y[j], tw[h + j], twq[h + j], p);
+                ntt_word s = u + v;
+                x[j] = s >= p ? s - p : s;
+                s = u + p - v;
+                y[j] = s >= p ? s - p : s;
+            }
+        }
+    }
+}
+
+/* Store the cyclic convolution of the digits of a and b, modulo the given
+   prime, into r[:n].  fb is scratch space for n words, tw and twq for n
+   words each. */
+static void
+ntt_convolve(PyLongObject *a, PyLongObject *b, int prime, Py_ssize_t n,
+             ntt_word *r, ntt_word *fb, ntt_word *tw, ntt_word *twq)
+{
+    ntt_word p = ntt_primes[prime];
+    Py_ssize_t asize = ABS(Py_SIZE(a)), bsize = ABS(Py_SIZE(b)), i;
+    ntt_word ninv, ninvq;
+
+    /* digits may exceed the smaller primes */
+    for (i = 0; i < asize; i++)
+        r[i] = a->ob_digit[i] % p;
+    memset(r + asize, 0, (n - asize) * sizeof(ntt_word));
+    ntt_twiddles(tw, twq, n, prime, 0);
+    ntt_forward(r, n, tw, twq, p);
+    if (a == b)
+        fb = r;
+    else {
+        for (i = 0; i < bsize; i++)
+            fb[i] = b->ob_digit[i] % p;
+        memset(fb + bsize, 0, (n - bsize) * sizeof(ntt_word));
+        ntt_forward(fb, n, tw, twq, p);
+    }
+    /* Pointwise product, scaled by 1/n for the inverse transform. */
+    ninv = ntt_powmod((ntt_word)(n % p), p - 2, p);
+    ninvq = (ntt_word)(((ntt_dword)ninv << 32) / p);
+    for (i = 0; i < n; i++)
+        r[i] = ntt_mulmod((ntt_word)((ntt_dword)r[i] * fb[i] % p),
+                          ninv, ninvq, p);
+    ntt_twiddles(tw, twq, n, prime, 1);
+    ntt_inverse(r, n, tw, twq, p);
+}
+
+/* Return abs(a) * abs(b), for 0 < size(a) + size(b) <= NTT_MAX_SIZE. */
+static PyLongObject *
+ntt_mul(PyLongObject *a, PyLongObject *b)
+{
+    Py_ssize_t asize = ABS(Py_SIZE(a)), bsize = ABS(Py_SIZE(b));
+    Py_ssize_t zsize = asize + bsize, n, i;
+    ntt_word *buf, *r0, *r1, *r2, *fb, *tw, *twq;
+    ntt_word p0 = ntt_primes[0], p1 = ntt_primes[1], p2 = ntt_primes[2];
+    ntt_word inv01, inv02, inv12;
+    ntt_dword acc_lo = 0, acc_hi = 0;
+    PyLongObject *z;
+
+    assert(zsize <= NTT_MAX_SIZE);
+    n = 1;
+    while (n < zsize - 1)
+        n *= 2;
+
+    z = _PyLong_New(zsize);
+    if (z == NULL)
+        return NULL;
+    buf = PyMem_New(ntt_word, 6 * n);
+    if (buf == NULL) {
+        Py_DECREF(z);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    r0 = buf;
+    r1 = buf + n;
+    r2 = buf + 2 * n;
+    fb = buf + 3 * n;
+    tw = buf + 4 * n;
+    twq = buf + 5 * n;
+    ntt_convolve(a, b, 0, n, r0, fb, tw, twq);
+    ntt_convolve(a, b, 1, n, r1, fb, tw, twq);
+    ntt_convolve(a, b, 2, n, r2, fb, tw, twq);
+
+    /* Garner: the coefficient is x = v0 + p0*v1 + p0*p1*v2, where
+       v1 = (r1 - v0) / p0 mod p1 and v2 = ((r2 - v0) / p0 - v1) / p1 mod p2. */
+    inv01 = ntt_powmod(p0 % p1, p1 - 2, p1);
+    inv02 = ntt_powmod(p0 % p2, p2 - 2, p2);
+    inv12 = ntt_powmod(p1 % p2, p2 - 2, p2);
+    for (i = 0; i < zsize; i++) {
+        if (i < zsize - 1) {
+            ntt_dword v0, v1, v2, t, mid;
+            v0 = r0[i];
+            v1 = (r1[i] + p1 - v0 % p1) * inv01 % p1;
+            v2 = (r2[i] + p2 - v0 % p2) * inv02 % p2;
+            v2 = (v2 + p2 - v1 % p2) * inv12 % p2;
+            /* x = v0 + p0 * mid, with mid < 2**59 split in 32-bit halves */
+            mid = v1 + p1 * v2;
+            t = v0 + p0 * (mid & 0xFFFFFFFFU);
+            acc_lo += t;
+            if (acc_lo < t)
+                acc_hi++;
+            t = p0 * (mid >> 32);
+            acc_lo += t << 32;
+            if (acc_lo < (t << 32))
+                acc_hi++;
+            acc_hi += t >> 32;
+        }
+        z->ob_digit[i] = (digit)(acc_lo & PyLong_MASK);
+        acc_lo = (acc_lo >> PyLong_SHIFT) | (acc_hi << (64 - PyLong_SHIFT));
+        acc_hi >>= PyLong_SHIFT;
+    }
+    assert(acc_lo == 0 && acc_hi == 0);
+    PyMem_Free(buf);
+    return long_normalize(z);
+}
+
+#endif /* PY_UINT32_T && PY_UINT64_T */
+
 /* A helper for Karatsuba multiplication (k_mul).
    Takes an int "n" and an integer "size" representing the place to
    split, and sets low and high such that abs(n) == (high << size) + low,
@@ -3152,6 +3457,12 @@ k_mul(PyLongObject *a, PyLongObject *b)
             return x_mul(a, b);
     }
 
+#ifdef HAVE_LONG_NTT
+    /* Use the number-theoretic transform when both numbers are large. */
+    if (asize >= NTT_CUTOFF && asize + bsize <= NTT_MAX_SIZE)
+        return ntt_mul(a, b);
+#endif
+
     /* If a is small compared to b, splitting on b gives a degenerate
      * case with ah==0, and Karatsuba may be (even much) less efficient
      * than "grade school" then.  However, we can still win, by viewing
@@ -4130,6 +4441,333 @@ long_lshift(PyObject *v, PyObject *w)
     return (PyObject *) maybe_small_long(z);
 }
 
+/* Helpers for the divide-and-conquer decimal conversions; see the comment
+   above long_to_decimal_digits(). */
+
+#define DECIMAL_DC_LEVELS (8 * SIZEOF_SIZE_T)
+
+typedef struct {
+    int count;
+    PyLongObject *pow[DECIMAL_DC_LEVELS];
+    /* Bit length of pow[i] */
+    Py_ssize_t bits[DECIMAL_DC_LEVELS];
+    /* Approximation of 2**(2*bits[i]) // pow[i], or NULL */
+    PyLongObject *recip[DECIMAL_DC_LEVELS];
+} decimal_powers;
+
+static void
+decimal_powers_clear(decimal_powers *pw)
+{
+    int i;
+    for (i = 0; i < pw->count; i++) {
+        Py_DECREF(pw->pow[i]);
+        Py_XDECREF(pw->recip[i]);
+    }
+    pw->count = 0;
+}
+
+/* Make sure pw->pow[level] exists.  Returns -1 on error. */
+static int
+decimal_powers_extend(decimal_powers *pw, int level)
+{
+    PyLongObject *z;
+
+    assert(level < DECIMAL_DC_LEVELS);
+    while (pw->count <= level) {
+        if (pw->count == 0) {
+            PyObject *ten, *exponent;
+            ten = PyLong_FromLong(10);
+            exponent = PyLong_FromLong(DECIMAL_DC_LEAF *
+                                       _PyLong_DECIMAL_SHIFT);
+            if (ten == NULL || exponent == NULL) {
+                Py_XDECREF(ten);
+                Py_XDECREF(exponent);
+                return -1;
+            }
+            z = (PyLongObject *)long_pow(ten, exponent, Py_None);
+            Py_DECREF(ten);
+            Py_DECREF(exponent);
+        }
+        else {
+            PyLongObject *prev = pw->pow[pw->count - 1];
+            z = (PyLongObject *)long_mul(prev, prev);
+        }
+        if (z == NULL)
+            return -1;
+        pw->pow[pw->count] = z;
+        pw->bits[pw->count] = (Py_ssize_t)_PyLong_NumBits((PyObject *)z);
+        pw->recip[pw->count] = NULL;
+        pw->count++;
+    }
+    return 0;
+}
+
+/* Return a << n (n > 0) or a >> -n (n < 0). */
+static PyLongObject *
+decimal_shift(PyLongObject *a, Py_ssize_t n)
+{
+    PyObject *count, *z;
+
+    count = PyLong_FromSsize_t(n < 0 ? -n : n);
+    if (count == NULL)
+        return NULL;
+    if (n < 0)
+        z = long_rshift(a, (PyLongObject *)count);
+    else
+        z = long_lshift((PyObject *)a, count);
+    Py_DECREF(count);
+    return (PyLongObject *)z;
+}
+
+/* Return an approximation of 2**(2*b) // d, where d > 0 has b bits, off by
+   a few units at most. */
+static PyLongObject *
+decimal_reciprocal(PyLongObject *d, Py_ssize_t b)
+{
+    PyLongObject *one, *t, *u, *dh, *r = NULL, *e = NULL;
+    Py_ssize_t h;
+
+    one = (PyLongObject *)PyLong_FromLong(1);
+    if (one == NULL)
+        return NULL;
+    if (b <= DECIMAL_RECIP_CUTOFF) {
+        t = decimal_shift(one, 2 * b);
+        Py_DECREF(one);
+        if (t == NULL)
+            return NULL;
+        if (l_divmod(t, d, &r, NULL) < 0)
+            r = NULL;
+        Py_DECREF(t);
+        return r;
+    }
+
+    /* Invert the top h bits of d, then do one Newton step
+       r = r + r * (2**(2*b) - d*r) // 2**(2*b), which doubles the number of
+       correct bits.  The guard bits keep the error of the result small. */
+    h = b / 2 + 32;
+    dh = decimal_shift(d, h - b);
+    if (dh == NULL)
+        goto error;
+    t = decimal_reciprocal(dh, h);
+    Py_DECREF(dh);
+    if (t == NULL)
+        goto error;
+    r = decimal_shift(t, b - h);
+    Py_DECREF(t);
+    if (r == NULL)
+        goto error;
+    t = (PyLongObject *)long_mul(d, r);
+    if (t == NULL)
+        goto error;
+    u = decimal_shift(one, 2 * b);
+    if (u == NULL) {
+        Py_DECREF(t);
+        goto error;
+    }
+    e = (PyLongObject *)long_sub(u, t);
+    Py_DECREF(u);
+    Py_DECREF(t);
+    if (e == NULL)
+        goto error;
+    t = (PyLongObject *)long_mul(r, e);
+    Py_CLEAR(e);
+    if (t == NULL)
+        goto error;
+    u = decimal_shift(t, -2 * b);
+    Py_DECREF(t);
+    if (u == NULL)
+        goto error;
+    t = (PyLongObject *)long_add(r, u);
+    Py_DECREF(u);
+    Py_DECREF(r);
+    Py_DECREF(one);
+    return t;
+
+  error:
+    Py_DECREF(one);
+    Py_XDECREF(r);
+    return NULL;
+}
+
+/* Compute *phi, *plo = divmod(v, pw->pow[level]), for
+   0 <= v < pw->pow[level] ** 2. */
+static int
+decimal_divmod(PyLongObject *v, decimal_powers *pw, int level,
+               PyLongObject **phi, PyLongObject **plo)
+{
+    PyLongObject *d = pw->pow[level];
+    Py_ssize_t b = pw->bits[level];
+    PyLongObject *q = NULL, *r = NULL, *t, *one;
+
+    if (pw->recip[level] == NULL) {
+        pw->recip[level] = decimal_reciprocal(d, b);
+        if (pw->recip[level] == NULL)
+            return -1;
+    }
+    t = (PyLongObject *)long_mul(v, pw->recip[level]);
+    if (t == NULL)
+        return -1;
+    q = decimal_shift(t, -2 * b);
+    Py_DECREF(t);
+    if (q == NULL)
+        return -1;
+    t = (PyLongObject *)long_mul(q, d);
+    if (t == NULL)
+        goto error;
+    r = (PyLongObject *)long_sub(v, t);
+    Py_DECREF(t);
+    if (r == NULL)
+        goto error;
+
+    /* The quotient is off by a few units at most. */
+    one = (PyLongObject *)PyLong_FromLong(1);
+    if (one == NULL)
+        goto error;
+    while (Py_SIZE(r) < 0 || long_compare(r, d) >= 0) {
+        int negative = Py_SIZE(r) < 0;
+        t = (PyLongObject *)(negative ? long_sub(q, one) : long_add(q, one));
+        if (t == NULL) {
+            Py_DECREF(one);
+            goto error;
+        }
+        Py_DECREF(q);
+        q = t;
+        t = (PyLongObject *)(negative ? long_add(r, d) : long_sub(r, d));
+        if (t == NULL) {
+            Py_DECREF(one);
+            goto error;
+        }
+        Py_DECREF(r);
+        r = t;
+    }
+    Py_DECREF(one);
+    *phi = q;
+    *plo = r;
+    return 0;
+
+  error:
+    Py_XDECREF(q);
+    Py_XDECREF(r);
+    return -1;
+}
+
+/* Store the DECIMAL_DC_LEAF << level base _PyLong_DECIMAL_BASE digits of
+   0 <= v < 10 ** (_PyLong_DECIMAL_SHIFT * DECIMAL_DC_LEAF << level) into
+   pout, least significant first.  Returns -1 on error. */
+static int
+long_to_decimal_digits_dc(PyLongObject *v, digit *pout, int level,
+                          decimal_powers *pw)
+{
+    Py_ssize_t width = (Py_ssize_t)DECIMAL_DC_LEAF << level;
+    PyLongObject *hi, *lo;
+    int res;
+
+    if (level == 0 || Py_SIZE(v) <= DECIMAL_FORMAT_CUTOFF) {
+        Py_ssize_t size = long_to_decimal_digits(v, pout);
+        if (size < 0)
+            return -1;
+        assert(size <= width);
+        memset(pout + size, 0, (width - size) * sizeof(digit));
+        return 0;
+    }
+    if (decimal_powers_extend(pw, level - 1) < 0 ||
+        decimal_divmod(v, pw, level - 1, &hi, &lo) < 0)
+        return -1;
+    res = long_to_decimal_digits_dc(lo, pout, level - 1, pw);
+    if (res == 0)
+        res = long_to_decimal_digits_dc(hi, pout + width / 2, level - 1, pw);
+    Py_DECREF(hi);
+    Py_DECREF(lo);
+    return res;
+}
+
+/* Convert the decimal digits str[:len] to an int. */
+static PyLongObject *
+long_from_decimal_dc(const char *str, Py_ssize_t len, decimal_powers *pw)
+{
+    PyLongObject *hi, *lo, *t, *z;
+    Py_ssize_t lolen;
+    int level;
+
+    if (len <= DECIMAL_PARSE_CUTOFF) {
+        char buf[DECIMAL_PARSE_CUTOFF + 1];
+        memcpy(buf, str, len);
+        buf[len] = '\0';
+        return (PyLongObject *)PyLong_FromString(buf, NULL, 10);
+    }
+    /* Split off the largest power that leaves a non-empty high part. */
+    level = 0;
+    lolen = DECIMAL_DC_LEAF * _PyLong_DECIMAL_SHIFT;
+    while (2 * lolen < len) {
+        lolen *= 2;
+        level++;
+    }
+    if (decimal_powers_extend(pw, level) < 0)
+        return NULL;
+    hi = long_from_decimal_dc(str, len - lolen, pw);
+    if (hi == NULL)
+        return NULL;
+    lo = long_from_decimal_dc(str + len - lolen, lolen, pw);
+    if (lo == NULL) {
+        Py_DECREF(hi);
+        return NULL;
+    }
+    t = (PyLongObject *)long_mul(hi, pw->pow[level]);
+    Py_DECREF(hi);
+    if (t == NULL) {
+        Py_DECREF(lo);
+        return NULL;
+    }
+    z = (PyLongObject *)long_add(t, lo);
+    Py_DECREF(t);
+    Py_DECREF(lo);
+    return z;
+}
+
+/* Store the base _PyLong_DECIMAL_BASE digits of abs(a) into
+   pout[:width], where width = DECIMAL_DC_LEAF << level is large enough to
+   hold them.  Returns -1 on error. */
+static int
+long_to_decimal_digits_large(PyLongObject *a, digit *pout, int level)
+{
+    decimal_powers pw;
+    PyLongObject *v;
+    int res;
+
+    v = (PyLongObject *)long_abs(a);
+    if (v == NULL)
+        return -1;
+    pw.count = 0;
+    res = long_to_decimal_digits_dc(v, pout, level, &pw);
+    decimal_powers_clear(&pw);
+    Py_DECREF(v);
+    return res;
+}
+
+/* Convert the decimal digits str[:len] to a new, unshared int. */
+static PyLongObject *
+long_from_decimal_large(const char *str, Py_ssize_t len)
+{
+    decimal_powers pw;
+    PyLongObject *z, *t;
+
+    pw.count = 0;
+    z = long_from_decimal_dc(str, len, &pw);
+    decimal_powers_clear(&pw);
+    if (z != NULL && ABS(Py_SIZE(z)) <= 1) {
+        /* The caller negates the result in place: don't hand it a small
+           int. */
+        t = _PyLong_New(1);
+        if (t != NULL) {
+            Py_SIZE(t) = Py_SIZE(z);
+            t->ob_digit[0] = Py_SIZE(z) ? z->ob_digit[0] : 0;
+        }
+        Py_DECREF(z);
+        z = t;
+    }
+    return z;
+}
+
 /* Compute two's complement of digit vector a[0:m], writing result to
    z[0:m].  The digit vector a need not be normalized, but should not
    be entirely zero.  a and z may point to the same digit vector. */
@@ -67,6 +67,122 @@ PyCFunction_GetFlags(PyObject *op)
     return PyCFunction_GET_FLAGS(op);
 }
 
+/* Call a METH_FASTCALL function with the keyword arguments in a dict */
+static PyObject *
+fastcall_with_dict(PyCFunctionObject *f, PyObject *self, PyObject *arg,
+                   PyObject *kw)
+{
+    Py_ssize_t nargs = PyTuple_GET_SIZE(arg);
+    Py_ssize_t nkw = PyDict_Size(kw);
+    Py_ssize_t i, pos = 0;
+    PyObject **stack, *kwnames, *key, *value, *result;
+
+    stack = PyMem_NEW(PyObject *, nargs + nkw);
+    if (stack == NULL)
+        return PyErr_NoMemory();
+    kwnames = PyTuple_New(nkw);
+    if (kwnames == NULL) {
+        PyMem_FREE(stack);
+        return NULL;
+    }
+    for (i = 0; i < nargs; i++)
+        stack[i] = PyTuple_GET_ITEM(arg, i);
+    for (i = 0; PyDict_Next(kw, &pos, &key, &value); i++) {
+        Py_INCREF(key);
+        PyTuple_SET_ITEM(kwnames, i, key);
+        stack[nargs + i] = value;
+    }
+    result = (*(_PyCFunctionFast)f->m_ml->ml_meth)(self, stack, nargs,
+                                                   kwnames);
+    Py_DECREF(kwnames);
+    PyMem_FREE(stack);
+    return result;
+}
+
+/* Call func with the arguments in a C array, laid out as for
+   METH_FASTCALL, whatever its calling convention.  Only functions that
+   need them get a tuple and a dict. */
+PyObject *
+_PyCFunction_FastCall(PyObject *func, PyObject **args, Py_ssize_t nargs,
+                      PyObject *kwnames)
+{
+    PyCFunctionObject* f = (PyCFunctionObject*)func;
+    PyCFunction meth = PyCFunction_GET_FUNCTION(func);
+    PyObject *self = PyCFunction_GET_SELF(func);
+    PyObject *callargs, *kw = NULL, *result;
+    Py_ssize_t i, nkw;
+    int flags;
+
+    assert(PyCFunction_Check(func));
+    nkw = kwnames == NULL ? 0 : PyTuple_GET_SIZE(kwnames);
+    flags = PyCFunction_GET_FLAGS(func) &
+        ~(METH_CLASS | METH_STATIC | METH_COEXIST);
+    switch (flags) {
+    case METH_FASTCALL:
+        return (*(_PyCFunctionFast)meth)(self, args, nargs,
+                                         nkw ? kwnames : NULL);
+    case METH_NOARGS:
+        if (nkw)
+            break;
+        if (nargs == 0)
+            return (*meth)(self, NULL);
+        PyErr_Format(PyExc_TypeError,
+            "%.200s() takes no arguments (%zd given)",
+            f->m_ml->ml_name, nargs);
+        return NULL;
+    case METH_O:
+        if (nkw)
+            break;
+        if (nargs == 1)
+            return (*meth)(self, args[0]);
+        PyErr_Format(PyExc_TypeError,
+            "%.200s() takes exactly one argument (%zd given)",
+            f->m_ml->ml_name, nargs);
+        return NULL;
+    case METH_VARARGS:
+        if (nkw)
+            break;
+        /* fall through */
+    case METH_VARARGS | METH_KEYWORDS:
+        callargs = PyTuple_New(nargs);
+        if (callargs == NULL)
+            return NULL;
+        for (i = 0; i < nargs; i++) {
+            Py_INCREF(args[i]);
+            PyTuple_SET_ITEM(callargs, i, args[i]);
+        }
+        if (nkw) {
+            kw = PyDict_New();
+            if (kw == NULL) {
+                Py_DECREF(callargs);
+                return NULL;
+            }
+            for (i = 0; i < nkw; i++) {
+                if (PyDict_SetItem(kw, PyTuple_GET_ITEM(kwnames, i),
+                                   args[nargs + i]) < 0) {
+                    Py_DECREF(callargs);
+                    Py_DECREF(kw);
+                    return NULL;
+                }
+            }
+        }
+        if (flags & METH_KEYWORDS)
+            result = (*(PyCFunctionWithKeywords)meth)(self, callargs, kw);
+        else
+            result = (*meth)(self, callargs);
+        Py_DECREF(callargs);
+        Py_XDECREF(kw);
+        return result;
+    default:
+        PyErr_SetString(PyExc_SystemError,
+                        "Bad call flags in _PyCFunction_FastCall");
+        return NULL;
+    }
+    PyErr_Format(PyExc_TypeError, "%.200s() takes no keyword arguments",
+                 f->m_ml->ml_name);
+    return NULL;
+}
+
 PyObject *
 PyCFunction_Call(PyObject *func, PyObject *arg, PyObject *kw)
 {
@@ -104,6 +220,12 @@ PyCFunction_Call(PyObject *func, PyObject *arg, PyObject *kw)
             return NULL;
         }
         break;
+    case METH_FASTCALL:
+        size = PyTuple_GET_SIZE(arg);
+        if (kw == NULL || PyDict_Size(kw) == 0)
+            return (*(_PyCFunctionFast)meth)(self, &PyTuple_GET_ITEM(arg, 0),
+                                             size, NULL);
+        return fastcall_with_dict(f, self, arg, kw);
     default:
         PyErr_SetString(PyExc_SystemError, "Bad call flags in "
                         "PyCFunction_Call. METH_OLDARGS is no "
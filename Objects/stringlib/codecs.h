@@ -15,6 +15,32 @@
 /* 10xxxxxx */
 #define IS_CONTINUATION_BYTE(ch) ((ch) >= 0x80 && (ch) < 0xC0)
 
+/* Vector kernels from stringlib/simd.h for this kind, if there are any. */
+#ifdef HAVE_STRINGLIB_SSE2
+# if STRINGLIB_SIZEOF_CHAR == 1
+#  define STRINGLIB_SIMD_FROM_ASCII(s, end, p) \
+    _Py_simd_ascii_copy((s), (end), (char *)(p))
+#  define STRINGLIB_SIMD_TO_ASCII(s, end, p) \
+    _Py_simd_ascii_copy((const char *)(s), (const char *)(end), (p))
+#  define STRINGLIB_SIMD_FROM_UTF16(q, e, p, native_ordering) \
+    _Py_simd_utf16_to_ucs1((q), (e), (p), (native_ordering), \
+                           STRINGLIB_MAX_CHAR)
+# elif STRINGLIB_SIZEOF_CHAR == 2
+#  define STRINGLIB_SIMD_FROM_ASCII _Py_simd_ascii_to_ucs2
+#  define STRINGLIB_SIMD_TO_ASCII _Py_simd_ucs2_to_ascii
+#  define STRINGLIB_SIMD_FROM_UTF16 _Py_simd_utf16_to_ucs2
+# else
+#  define STRINGLIB_SIMD_FROM_ASCII _Py_simd_ascii_to_ucs4
+#  define STRINGLIB_SIMD_TO_ASCII _Py_simd_ucs4_to_ascii
+#  define STRINGLIB_SIMD_FROM_UTF16 _Py_simd_utf16_to_ucs4
+# endif
+/* Distance to skip before trying a kernel again after it converted n
+   units.  It doubles every time a kernel makes no progress at all, so that
+   text made of short runs doesn't pay for failed attempts. */
+# define STRINGLIB_SIMD_SKIP(n, skip) \
+    ((n) > 0 ? STRINGLIB_VECTOR_SIZE : Py_MIN(2 * (skip), 1024))
+#endif
+
 Py_LOCAL_INLINE(Py_UCS4)
 STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                        STRINGLIB_CHAR *dest,
@@ -24,6 +50,10 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
     const char *s = *inptr;
     const char *aligned_end = (const char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
     STRINGLIB_CHAR *p = dest + *outpos;
+#ifdef STRINGLIB_SIMD_FROM_ASCII
+    const char *simd_retry = s;
+    Py_ssize_t simd_skip = STRINGLIB_VECTOR_SIZE;
+#endif
 
     while (s < end) {
         ch = (unsigned char)*s;
@@ -40,6 +70,16 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 /* Help register allocation */
                 register const char *_s = s;
                 register STRINGLIB_CHAR *_p = p;
+#ifdef STRINGLIB_SIMD_FROM_ASCII
+                /* Convert whole vectors first, when the CPU has them. */
+                if (_s >= simd_retry) {
+                    Py_ssize_t n = STRINGLIB_SIMD_FROM_ASCII(_s, end, _p);
+                    _s += n;
+                    _p += n;
+                    simd_skip = STRINGLIB_SIMD_SKIP(n, simd_skip);
+                    simd_retry = _s + simd_skip;
+                }
+#endif
                 while (_s < aligned_end) {
                     /* Read a whole long at a time (either 4 or 8 bytes),
                        and do a fast unrolled copy if it only contains ASCII
@@ -272,6 +312,10 @@ STRINGLIB(utf8_encoder)(PyObject *unicode,
     PyObject *exc = NULL;
     PyObject *rep = NULL;
 #endif
+#ifdef STRINGLIB_SIMD_TO_ASCII
+    Py_ssize_t simd_retry = 0;
+    Py_ssize_t simd_skip = STRINGLIB_VECTOR_SIZE;
+#endif
 #if STRINGLIB_SIZEOF_CHAR == 1
     const Py_ssize_t max_char_size = 2;
     char stackbuf[MAX_SHORT_UNICHARS * 2];
@@ -313,7 +357,17 @@ STRINGLIB(utf8_encoder)(PyObject *unicode,
         if (ch < 0x80) {
             /* Encode ASCII */
             *p++ = (char) ch;
-
+#ifdef STRINGLIB_SIMD_TO_ASCII
+            /* Copy the rest of the run a vector at a time. */
+            if (i >= simd_retry) {
+                Py_ssize_t n = STRINGLIB_SIMD_TO_ASCII(data + i, data + size,
+                                                       p);
+                i += n;
+                p += n;
+                simd_skip = STRINGLIB_SIMD_SKIP(n, simd_skip);
+                simd_retry = i + simd_skip;
+            }
+#endif
         }
         else
 #if STRINGLIB_SIZEOF_CHAR > 1
@@ -500,6 +554,15 @@ STRINGLIB(utf16_decode)(const unsigned char **inptr, const unsigned char *e,
         if (_Py_IS_ALIGNED(q, SIZEOF_LONG)) {
             /* Fast path for runs of in-range non-surrogate chars. */
             register const unsigned char *_q = q;
+#ifdef STRINGLIB_SIMD_FROM_UTF16
+            /* Convert whole vectors first, when the CPU has them. */
+            if (aligned_end - _q >= STRINGLIB_VECTOR_SIZE) {
+                Py_ssize_t n = STRINGLIB_SIMD_FROM_UTF16(_q, aligned_end, p,
+                                                         native_ordering);
+                _q += 2 * n;
+                p += n;
+            }
+#endif
             while (_q < aligned_end) {
                 unsigned long block = * (unsigned long *) _q;
                 if (native_ordering) {
@@ -613,6 +676,11 @@ STRINGLIB(utf16_encode)(unsigned short *out,
 # if STRINGLIB_SIZEOF_CHAR == 2
         Py_MEMCPY(out, in, 2 * len);
 # else
+#  ifdef HAVE_STRINGLIB_SSE2
+        Py_ssize_t n = _Py_simd_ucs1_to_ucs2(in, end, (Py_UCS2 *)out);
+        in += n;
+        out += n;
+#  endif
         _PyUnicode_CONVERT_BYTES(STRINGLIB_CHAR, unsigned short, in, end, out);
 # endif
     } else {
@@ -658,4 +726,9 @@ STRINGLIB(utf16_encode)(unsigned short *out,
 #endif
 #undef SWAB2
 }
+
+#undef STRINGLIB_SIMD_FROM_ASCII
+#undef STRINGLIB_SIMD_TO_ASCII
+#undef STRINGLIB_SIMD_FROM_UTF16
+#undef STRINGLIB_SIMD_SKIP
 #endif /* STRINGLIB_IS_UNICODE */
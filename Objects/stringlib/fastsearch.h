@@ -80,6 +80,296 @@ STRINGLIB(fastsearch_memchr_1char)(const STRINGLIB_CHAR* s, Py_ssize_t n,
 #undef DO_MEMCHR
 }
 
+/* Needles at least this long are searched for with the Two-Way algorithm
+   in haystacks at least STRINGLIB_TWO_WAY_MIN_HAYSTACK characters long. */
+#define STRINGLIB_TWO_WAY_MIN_NEEDLE 100
+#define STRINGLIB_TWO_WAY_MIN_HAYSTACK 2000
+/* Size of the bad character table of Two-Way; characters are hashed into it
+   by their low bits. */
+#define STRINGLIB_TWO_WAY_TABLE 64
+
+#if defined(HAVE_STRINGLIB_SSE2) && defined(STRINGLIB_SIZEOF_CHAR)
+/* Compare a vector of characters for equality; each character that matched
+   sets STRINGLIB_SIMD_CHAR_BITS consecutive bits in the result of
+   _mm_movemask_epi8(), and STRINGLIB_SIMD_LANES keeps one bit per character
+   of it. */
+# if STRINGLIB_SIZEOF_CHAR == 1
+#  define STRINGLIB_SIMD_SET1(ch) _mm_set1_epi8((char)(ch))
+#  define STRINGLIB_SIMD_CMPEQ _mm_cmpeq_epi8
+#  define STRINGLIB_SIMD_LANES 0xFFFFu
+# elif STRINGLIB_SIZEOF_CHAR == 2
+#  define STRINGLIB_SIMD_SET1(ch) _mm_set1_epi16((short)(ch))
+#  define STRINGLIB_SIMD_CMPEQ _mm_cmpeq_epi16
+#  define STRINGLIB_SIMD_LANES 0x5555u
+# else
+#  define STRINGLIB_SIMD_SET1(ch) _mm_set1_epi32((int)(ch))
+#  define STRINGLIB_SIMD_CMPEQ _mm_cmpeq_epi32
+#  define STRINGLIB_SIMD_LANES 0x1111u
+# endif
+# define STRINGLIB_SIMD_CHARS (16 / STRINGLIB_SIZEOF_CHAR)
+
+/* Count the occurrences of ch in s[:n], up to maxcount. */
+Py_LOCAL_INLINE(Py_ssize_t)
+STRINGLIB(simd_count_char)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                           STRINGLIB_CHAR ch, Py_ssize_t maxcount)
+{
+    const __m128i needle = STRINGLIB_SIMD_SET1(ch);
+    Py_ssize_t i, count = 0;
+
+    for (i = 0; i + STRINGLIB_SIMD_CHARS <= n; i += STRINGLIB_SIMD_CHARS) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        unsigned int bits = _mm_movemask_epi8(STRINGLIB_SIMD_CMPEQ(v, needle));
+        if (bits) {
+            count += stringlib_popcount(bits & STRINGLIB_SIMD_LANES);
+            if (count >= maxcount)
+                return maxcount;
+        }
+    }
+    for (; i < n; i++)
+        if (s[i] == ch) {
+            count++;
+            if (count == maxcount)
+                return maxcount;
+        }
+    return count;
+}
+
+/* Forward search and count for short needles (m >= 2).  Whole vectors of
+   candidate positions are filtered by comparing their first and last
+   characters with those of the needle; only the positions where both match
+   are compared in full. */
+Py_LOCAL_INLINE(Py_ssize_t)
+STRINGLIB(simd_search)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                       const STRINGLIB_CHAR *p, Py_ssize_t m,
+                       Py_ssize_t maxcount, int mode)
+{
+    const __m128i first = STRINGLIB_SIMD_SET1(p[0]);
+    const __m128i last = STRINGLIB_SIMD_SET1(p[m - 1]);
+    const size_t middle = (m - 2) * sizeof(STRINGLIB_CHAR);
+    Py_ssize_t w = n - m;
+    Py_ssize_t i, j, count = 0;
+    /* In count mode, matches may not overlap: no match can start before
+       next. */
+    Py_ssize_t next = 0;
+
+    for (i = 0; i + STRINGLIB_SIMD_CHARS - 1 <= w; i += STRINGLIB_SIMD_CHARS) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(s + i + m - 1));
+        unsigned int bits = _mm_movemask_epi8(
+            _mm_and_si128(STRINGLIB_SIMD_CMPEQ(a, first),
+                          STRINGLIB_SIMD_CMPEQ(b, last)));
+        bits &= STRINGLIB_SIMD_LANES;
+        while (bits) {
+            j = i + stringlib_ctz(bits) / STRINGLIB_SIZEOF_CHAR;
+            bits &= bits - 1;
+            if (j < next || memcmp(s + j + 1, p + 1, middle) != 0)
+                continue;
+            if (mode != FAST_COUNT)
+                return j;
+            count++;
+            if (count == maxcount)
+                return maxcount;
+            next = j + m;
+        }
+    }
+    for (i = Py_MAX(i, next); i <= w; i++) {
+        if (s[i] == p[0] && s[i + m - 1] == p[m - 1] &&
+            memcmp(s + i + 1, p + 1, middle) == 0) {
+            if (mode != FAST_COUNT)
+                return i;
+            count++;
+            if (count == maxcount)
+                return maxcount;
+            i += m - 1;
+        }
+    }
+    if (mode != FAST_COUNT)
+        return -1;
+    return count;
+}
+#endif /* HAVE_STRINGLIB_SSE2 && STRINGLIB_SIZEOF_CHAR */
+
+/* Two-Way string matching (Crochemore and Perrin, 1991) guarantees linear
+   time whatever the needle and the haystack, where the loop of FASTSEARCH
+   below can degrade to O(n*m).  A bad character shift on the last
+   character of the window lets it skip ahead like Horspool on typical text.
+   The code follows the description in glibc's str-two-way.h. */
+
+/* Compute the critical factorization of p[:m]: return the start of its
+   right half and store the period of that half in *period. */
+Py_LOCAL_INLINE(Py_ssize_t)
+STRINGLIB(two_way_factorize)(const STRINGLIB_CHAR *p, Py_ssize_t m,
+                             Py_ssize_t *period)
+{
+    Py_ssize_t max_suffix, max_suffix_rev, j, k, per;
+    STRINGLIB_CHAR a, b;
+
+    /* Maximal suffix for the ordering of the characters. */
+    max_suffix = -1;
+    j = 0;
+    k = per = 1;
+    while (j + k < m) {
+        a = p[j + k];
+        b = p[max_suffix + k];
+        if (a < b) {
+            j += k;
+            k = 1;
+            per = j - max_suffix;
+        }
+        else if (a == b) {
+            if (k != per)
+                k++;
+            else {
+                j += per;
+                k = 1;
+            }
+        }
+        else {
+            max_suffix = j++;
+            k = per = 1;
+        }
+    }
+    *period = per;
+
+    /* Maximal suffix for the reverse ordering. */
+    max_suffix_rev = -1;
+    j = 0;
+    k = per = 1;
+    while (j + k < m) {
+        a = p[j + k];
+        b = p[max_suffix_rev + k];
+        if (b < a) {
+            j += k;
+            k = 1;
+            per = j - max_suffix_rev;
+        }
+        else if (a == b) {
+            if (k != per)
+                k++;
+            else {
+                j += per;
+                k = 1;
+            }
+        }
+        else {
+            max_suffix_rev = j++;
+            k = per = 1;
+        }
+    }
+
+    /* Pick the longer of the two suffixes. */
+    if (max_suffix_rev < max_suffix)
+        return max_suffix + 1;
+    *period = per;
+    return max_suffix_rev + 1;
+}
+
+Py_LOCAL_INLINE(Py_ssize_t)
+STRINGLIB(two_way)(const STRINGLIB_CHAR *s, Py_ssize_t n,
+                   const STRINGLIB_CHAR *p, Py_ssize_t m,
+                   Py_ssize_t maxcount, int mode)
+{
+    Py_ssize_t shift_table[STRINGLIB_TWO_WAY_TABLE];
+    Py_ssize_t suffix, period, shift, memory, i, j, count = 0;
+    Py_ssize_t w = n - m;
+
+    suffix = STRINGLIB(two_way_factorize)(p, m, &period);
+
+    /* Distance from the last occurrence of each (hashed) character to the
+       end of the needle.  Collisions only make the shifts shorter. */
+    for (i = 0; i < STRINGLIB_TWO_WAY_TABLE; i++)
+        shift_table[i] = m;
+    for (i = 0; i < m; i++)
+        shift_table[(size_t)p[i] & (STRINGLIB_TWO_WAY_TABLE - 1)] = m - 1 - i;
+
+#define TWO_WAY_SHIFT(j) \
+    shift_table[(size_t)s[(j) + m - 1] & (STRINGLIB_TWO_WAY_TABLE - 1)]
+
+    if (memcmp(p, p + period, suffix * sizeof(STRINGLIB_CHAR)) == 0) {
+        /* The needle is periodic: remember how much of its prefix is known
+           to match after shifting by one period. */
+        memory = 0;
+        j = 0;
+        while (j <= w) {
+            shift = TWO_WAY_SHIFT(j);
+            if (shift > 0) {
+                /* The last character doesn't match; after a full period no
+                   match is possible before the mismatch. */
+                if (memory && shift < period)
+                    shift = m - period;
+                memory = 0;
+                j += shift;
+                continue;
+            }
+            /* Scan the right half, including the last character since the
+               table is hashed. */
+            i = Py_MAX(suffix, memory);
+            while (i < m && p[i] == s[i + j])
+                i++;
+            if (i >= m) {
+                /* Scan the left half. */
+                i = suffix - 1;
+                while (memory < i + 1 && p[i] == s[i + j])
+                    i--;
+                if (i + 1 < memory + 1) {
+                    if (mode != FAST_COUNT)
+                        return j;
+                    count++;
+                    if (count == maxcount)
+                        return maxcount;
+                    j += m;
+                    memory = 0;
+                    continue;
+                }
+                j += period;
+                memory = m - period;
+            }
+            else {
+                j += i - suffix + 1;
+                memory = 0;
+            }
+        }
+    }
+    else {
+        /* The two halves are distinct: no memory is needed, and a mismatch
+           in the left half allows a shift by more than the period. */
+        period = Py_MAX(suffix, m - suffix) + 1;
+        j = 0;
+        while (j <= w) {
+            shift = TWO_WAY_SHIFT(j);
+            if (shift > 0) {
+                j += shift;
+                continue;
+            }
+            i = suffix;
+            while (i < m && p[i] == s[i + j])
+                i++;
+            if (i >= m) {
+                i = suffix - 1;
+                while (i >= 0 && p[i] == s[i + j])
+                    i--;
+                if (i < 0) {
+                    if (mode != FAST_COUNT)
+                        return j;
+                    count++;
+                    if (count == maxcount)
+                        return maxcount;
+                    j += m;
+                    continue;
+                }
+                j += period;
+            }
+            else
+                j += i - suffix + 1;
+        }
+    }
+#undef TWO_WAY_SHIFT
+
+    if (mode != FAST_COUNT)
+        return -1;
+    return count;
+}
+
 Py_LOCAL_INLINE(Py_ssize_t)
 FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
            const STRINGLIB_CHAR* p, Py_ssize_t m,
@@ -118,6 +408,9 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
                        (s, n, p[0], needle, maxcount, mode);
         }
         if (mode == FAST_COUNT) {
+#ifdef STRINGLIB_SIMD_CMPEQ
+            return STRINGLIB(simd_count_char)(s, n, p[0], maxcount);
+#else
             for (i = 0; i < n; i++)
                 if (s[i] == p[0]) {
                     count++;
@@ -125,6 +418,7 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
                         return maxcount;
                 }
             return count;
+#endif
         } else if (mode == FAST_SEARCH) {
             for (i = 0; i < n; i++)
                 if (s[i] == p[0])
@@ -137,6 +431,16 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
         return -1;
     }
 
+    if (mode != FAST_RSEARCH) {
+        if (m >= STRINGLIB_TWO_WAY_MIN_NEEDLE &&
+            n >= STRINGLIB_TWO_WAY_MIN_HAYSTACK)
+            return STRINGLIB(two_way)(s, n, p, m, maxcount, mode);
+#ifdef STRINGLIB_SIMD_CMPEQ
+        if (m < STRINGLIB_TWO_WAY_MIN_NEEDLE)
+            return STRINGLIB(simd_search)(s, n, p, m, maxcount, mode);
+#endif
+    }
+
     mlast = m - 1;
     skip = mlast - 1;
     mask = 0;
@@ -222,3 +526,7 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
     return count;
 }
 
+#undef STRINGLIB_SIMD_SET1
+#undef STRINGLIB_SIMD_CMPEQ
+#undef STRINGLIB_SIMD_LANES
+#undef STRINGLIB_SIMD_CHARS
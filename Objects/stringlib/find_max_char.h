@@ -21,6 +21,9 @@ STRINGLIB(find_max_char)(const STRINGLIB_CHAR *begin, const STRINGLIB_CHAR *end)
     const unsigned char *aligned_end =
             (const unsigned char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
 
+#ifdef HAVE_STRINGLIB_SSE2
+    p += _Py_simd_ascii_copy((const char *) p, (const char *) end, NULL);
+#endif
     while (p < end) {
         if (_Py_IS_ALIGNED(p, SIZEOF_LONG)) {
             /* Help register allocation */
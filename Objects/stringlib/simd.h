@@ -0,0 +1,309 @@
+/* stringlib: SIMD kernels for the str codecs and for searching
+
+   The kernels only handle whole vectors and return how much of the input
+   they consumed; the caller finishes the rest with its portable scalar loop.
+   This keeps every kernel optional: on platforms without SSE2 the macros
+   below are not defined and the scalar code does all the work.
+
+   SSE2 is part of the x86-64 baseline, so it is used unconditionally there.
+   Compilers that can build AVX2 code for individual functions also get
+   32-byte versions of the hottest kernels, selected at run time. */
+
+#ifndef STRINGLIB_SIMD_H
+#define STRINGLIB_SIMD_H
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define HAVE_STRINGLIB_SSE2
+# include <emmintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
+
+#if defined(HAVE_STRINGLIB_SSE2) && defined(__x86_64__) && \
+    ((defined(__GNUC__) && !defined(__clang__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || \
+     (defined(__clang__) && \
+      (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))))
+# define HAVE_STRINGLIB_AVX2
+# include <immintrin.h>
+# define STRINGLIB_AVX2_FUNC __attribute__((target("avx2")))
+#endif
+
+#ifdef HAVE_STRINGLIB_SSE2
+
+/* Width in bytes of the SSE2 vectors.  Callers skip the kernels for inputs
+   shorter than this. */
+#define STRINGLIB_VECTOR_SIZE 16
+
+/* Index of the lowest set bit of x, which must not be 0. */
+Py_LOCAL_INLINE(int)
+stringlib_ctz(unsigned int x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return (int)i;
+#else
+    int i = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/* Number of bits set in x. */
+Py_LOCAL_INLINE(int)
+stringlib_popcount(unsigned int x)
+{
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return (int)((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+#ifdef HAVE_STRINGLIB_AVX2
+/* -1: not checked yet, 0: no AVX2, 1: AVX2 available. */
+static int stringlib_have_avx2 = -1;
+
+Py_LOCAL_INLINE(int)
+stringlib_use_avx2(void)
+{
+    if (stringlib_have_avx2 < 0) {
+        __builtin_cpu_init();
+        stringlib_have_avx2 = __builtin_cpu_supports("avx2") != 0;
+    }
+    return stringlib_have_avx2;
+}
+
+STRINGLIB_AVX2_FUNC static Py_ssize_t
+ascii_copy_avx2(const char *start, const char *end, char *dest)
+{
+    const char *p = start;
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        if (_mm256_movemask_epi8(v))
+            break;
+        if (dest != NULL) {
+            _mm256_storeu_si256((__m256i *)dest, v);
+            dest += 32;
+        }
+        p += 32;
+    }
+    return p - start;
+}
+#endif /* HAVE_STRINGLIB_AVX2 */
+
+/* Copy the leading run of ASCII bytes in [start, end) to dest, a whole
+   vector at a time.  If dest is NULL the run is only measured.  Returns the
+   number of bytes in the run that were handled. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_ascii_copy(const char *start, const char *end, char *dest)
+{
+    const char *p = start;
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        if (_mm_movemask_epi8(v))
+            break;
+        if (dest != NULL) {
+            _mm_storeu_si128((__m128i *)dest, v);
+            dest += 16;
+        }
+        p += 16;
+#ifdef HAVE_STRINGLIB_AVX2
+        /* Switch to wider vectors once the run turns out to be long. */
+        if (p - start == 16 && end - p >= 64 && stringlib_use_avx2()) {
+            Py_ssize_t n = ascii_copy_avx2(p, end, dest);
+            p += n;
+            if (dest != NULL)
+                dest += n;
+        }
+#endif
+    }
+    return p - start;
+}
+
+/* Widen the leading run of ASCII bytes in [start, end) to UCS2. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_ascii_to_ucs2(const char *start, const char *end, Py_UCS2 *dest)
+{
+    const char *p = start;
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        if (_mm_movemask_epi8(v))
+            break;
+        _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i *)(dest + 8), _mm_unpackhi_epi8(v, zero));
+        p += 16;
+        dest += 16;
+    }
+    return p - start;
+}
+
+/* Widen the leading run of ASCII bytes in [start, end) to UCS4. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_ascii_to_ucs4(const char *start, const char *end, Py_UCS4 *dest)
+{
+    const char *p = start;
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i lo, hi;
+        if (_mm_movemask_epi8(v))
+            break;
+        lo = _mm_unpacklo_epi8(v, zero);
+        hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *)(dest + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *)(dest + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i *)(dest + 12), _mm_unpackhi_epi16(hi, zero));
+        p += 16;
+        dest += 16;
+    }
+    return p - start;
+}
+
+/* Narrow the leading run of ASCII characters in [start, end) to bytes. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_ucs2_to_ascii(const Py_UCS2 *start, const Py_UCS2 *end, char *dest)
+{
+    const Py_UCS2 *p = start;
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 8));
+        __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+            break;
+        _mm_storeu_si128((__m128i *)dest, _mm_packus_epi16(a, b));
+        p += 16;
+        dest += 16;
+    }
+    return p - start;
+}
+
+/* Narrow the leading run of ASCII characters in [start, end) to bytes. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_ucs4_to_ascii(const Py_UCS4 *start, const Py_UCS4 *end, char *dest)
+{
+    const Py_UCS4 *p = start;
+    const __m128i mask = _mm_set1_epi32((int)0xFFFFFF80);
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 4));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 8));
+        __m128i d = _mm_loadu_si128((const __m128i *)(p + 12));
+        __m128i high = _mm_and_si128(
+            _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF)
+            break;
+        /* All values are below 0x80, so the saturating packs are exact. */
+        _mm_storeu_si128((__m128i *)dest,
+                         _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                          _mm_packs_epi32(c, d)));
+        p += 16;
+        dest += 16;
+    }
+    return p - start;
+}
+
+/* Widen UCS1 characters to UCS2. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_ucs1_to_ucs2(const Py_UCS1 *start, const Py_UCS1 *end,
+                      Py_UCS2 *dest)
+{
+    const Py_UCS1 *p = start;
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i *)(dest + 8), _mm_unpackhi_epi8(v, zero));
+        p += 16;
+        dest += 16;
+    }
+    return p - start;
+}
+
+/* Load 8 UTF-16 code units, swapping their bytes unless they are in native
+   order. */
+Py_LOCAL_INLINE(__m128i)
+simd_load_utf16(const unsigned char *q, int native_ordering)
+{
+    __m128i v = _mm_loadu_si128((const __m128i *)q);
+    if (!native_ordering)
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    return v;
+}
+
+/* Decode the leading UTF-16 code units in [start, end) that are not
+   surrogates and do not exceed maxchar.  The number of code units decoded is
+   returned; the kernels for the wider kinds follow. */
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_utf16_to_ucs1(const unsigned char *start, const unsigned char *end,
+                       Py_UCS1 *dest, int native_ordering, Py_UCS4 maxchar)
+{
+    const unsigned char *q = start;
+    const __m128i mask = _mm_set1_epi16((short)(0xFFFF & ~maxchar));
+    const __m128i zero = _mm_setzero_si128();
+    while (end - q >= 16) {
+        __m128i v = simd_load_utf16(q, native_ordering);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), zero))
+            != 0xFFFF)
+            break;
+        _mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(v, v));
+        q += 16;
+        dest += 8;
+    }
+    return (q - start) / 2;
+}
+
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_utf16_to_ucs2(const unsigned char *start, const unsigned char *end,
+                       Py_UCS2 *dest, int native_ordering)
+{
+    const unsigned char *q = start;
+    const __m128i mask = _mm_set1_epi16((short)0xF800);
+    const __m128i surrogate = _mm_set1_epi16((short)0xD800);
+    while (end - q >= 16) {
+        __m128i v = simd_load_utf16(q, native_ordering);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask),
+                                              surrogate)))
+            break;
+        _mm_storeu_si128((__m128i *)dest, v);
+        q += 16;
+        dest += 8;
+    }
+    return (q - start) / 2;
+}
+
+Py_LOCAL_INLINE(Py_ssize_t)
+_Py_simd_utf16_to_ucs4(const unsigned char *start, const unsigned char *end,
+                       Py_UCS4 *dest, int native_ordering)
+{
+    const unsigned char *q = start;
+    const __m128i mask = _mm_set1_epi16((short)0xF800);
+    const __m128i surrogate = _mm_set1_epi16((short)0xD800);
+    const __m128i zero = _mm_setzero_si128();
+    while (end - q >= 16) {
+        __m128i v = simd_load_utf16(q, native_ordering);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask),
+                                              surrogate)))
+            break;
+        _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi16(v, zero));
+        _mm_storeu_si128((__m128i *)(dest + 4), _mm_unpackhi_epi16(v, zero));
+        q += 16;
+        dest += 8;
+    }
+    return (q - start) / 2;
+}
+
+#endif /* HAVE_STRINGLIB_SSE2 */
+
+#endif /* !STRINGLIB_SIMD_H */
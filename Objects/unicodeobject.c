@@ -167,15 +167,23 @@ extern "C" {
             *_to++ = (to_type) *_iter++;                \
     } while (0)
 
-/* This dictionary holds all interned unicode strings.  Note that references
-   to strings in this dictionary are *not* counted in the string's ob_refcnt.
-   When the interned string reaches a refcnt of 0 the string deallocation
-   function will delete the reference from this dictionary.
-
-   Another way to look at this is that to say that the actual reference
-   count of a string is:  s->ob_refcnt + (s->state ? 2 : 0)
-*/
-static PyObject *interned = NULL;
+/* All interned unicode strings live in an open-addressing hash table of
+   string pointers rather than in a dict, so that parallel contexts can
+   search it without the GIL (see intern_lookup() below).  The table does
+   not own references to the strings: when a mortal interned string
+   reaches a refcnt of 0 the string deallocation function removes it from
+   the table. */
+typedef struct _intern_table {
+    Py_ssize_t mask;            /* number of slots - 1 */
+    Py_ssize_t fill;            /* slots holding a string or a dummy */
+    struct _intern_table *retired;  /* older tables parallel contexts may
+                                       still be searching */
+    _Py_atomic_address slots[1];
+} intern_table;
+
+static _Py_atomic_address interned = {NULL};
+
+static void intern_remove(PyObject *s);
 
 /* The empty Unicode object is shared to improve performance. */
 static PyObject *unicode_empty = NULL;
@@ -585,6 +593,8 @@ make_bloom_mask(int kind, void* ptr, Py_ssize_t len)
 
 /* Compilation of templated routines */
 
+#include "stringlib/simd.h"
+
 #include "stringlib/asciilib.h"
 #include "stringlib/fastsearch.h"
 #include "stringlib/partition.h"
@@ -1536,11 +1546,7 @@ unicode_dealloc(register PyObject *unicode)
         break;
 
     case SSTATE_INTERNED_MORTAL:
-        /* revive dead object temporarily for DelItem */
-        Py_REFCNT(unicode) = 3;
-        if (PyDict_DelItem(interned, unicode) != 0)
-            Py_FatalError(
-                "deletion of interned string failed");
+        intern_remove(unicode);
         break;
 
     case SSTATE_INTERNED_IMMORTAL:
@@ -4762,6 +4768,15 @@ ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
 {
     const char *p = start;
     const char *aligned_end = (const char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
+#ifdef HAVE_STRINGLIB_SSE2
+    Py_ssize_t n;
+
+    /* Copy whole vectors first and leave the tail to the loops below.  The
+       recursive call returns at once from its own vector loop. */
+    n = _Py_simd_ascii_copy(start, end, (char *)dest);
+    if (n > 0)
+        return n + ascii_decode(start + n, end, dest + n);
+#endif
 
     /*
      * Issue #17237: m68k is a bit different from most architectures in
@@ -10533,6 +10548,24 @@ unicode_compare(PyObject *str1, PyObject *str2)
     return (len1 < len2) ? -1 : (len1 != len2);
 }
 
+/* Return 1 if the ready strings str1 and str2 are equal, 0 if not. */
+
+static int
+unicode_compare_eq(PyObject *str1, PyObject *str2)
+{
+    int kind;
+    Py_ssize_t len;
+
+    len = PyUnicode_GET_LENGTH(str1);
+    if (PyUnicode_GET_LENGTH(str2) != len)
+        return 0;
+    kind = PyUnicode_KIND(str1);
+    if (PyUnicode_KIND(str2) != kind)
+        return 0;
+    return memcmp(PyUnicode_DATA(str1), PyUnicode_DATA(str2),
+                  len * kind) == 0;
+}
+
 int
 PyUnicode_Compare(PyObject *left, PyObject *right)
 {
@@ -14308,6 +14341,182 @@ _PyUnicode_Fini(void)
     (void)PyUnicode_ClearFreeList();
 }
 
+/* The intern table
+
+   Lookups take no lock, so parallel contexts can search the table while
+   the main thread is waiting for them.  Only the GIL holder adds, removes
+   and moves strings; slot and table pointers are published with release
+   stores so that a reader never sees a half-written entry.
+
+   Removed strings leave a dummy behind, which keeps the probe sequences
+   of other strings valid; insertion reuses the first dummy it passes.
+   When live strings and dummies fill two thirds of the table, the live
+   strings are moved to a new table sized for them alone, so a table full
+   of dummies is rebuilt at the same size instead of growing.  The old
+   table is freed at once unless parallel contexts are running, in which
+   case it is freed by the next change made after they have stopped. */
+
+#define INTERN_MINSIZE 1024
+
+static int intern_dummy_marker;
+#define INTERN_DUMMY ((PyObject *)&intern_dummy_marker)
+
+#define INTERN_LOAD(p) \
+    ((void *)_Py_atomic_load_explicit((p), _Py_memory_order_acquire))
+#define INTERN_STORE(p, v) \
+    _Py_atomic_store_explicit((p), (v), _Py_memory_order_release)
+#define INTERN_SLOT(t, i) ((PyObject *)INTERN_LOAD(&(t)->slots[i]))
+
+#ifdef WITH_PARALLEL
+#define INTERN_HAS_READERS() (Py_ParallelContextsEnabled == 1)
+#else
+#define INTERN_HAS_READERS() 0
+#endif
+
+/* Number of live strings in the table */
+static Py_ssize_t intern_used = 0;
+
+static intern_table *
+intern_table_new(Py_ssize_t size)
+{
+    intern_table *t;
+    size_t nbytes = sizeof(intern_table) +
+        (size - 1) * sizeof(_Py_atomic_address);
+
+    assert(size > 0 && (size & (size - 1)) == 0);
+    t = (intern_table *)PyMem_MALLOC(nbytes);
+    if (t == NULL)
+        return NULL;
+    memset(t, 0, nbytes);
+    t->mask = size - 1;
+    return t;
+}
+
+/* Free the tables retired by intern_resize() once nobody can be searching
+   them.  Needs the GIL. */
+static void
+intern_free_retired(intern_table *t)
+{
+    intern_table *retired;
+
+    if (INTERN_HAS_READERS())
+        return;
+    while ((retired = t->retired) != NULL) {
+        t->retired = retired->retired;
+        PyMem_FREE(retired);
+    }
+}
+
+/* Return the interned string equal to s, or NULL if there is none.  Safe
+   to call without the GIL. */
+static PyObject *
+intern_lookup(PyObject *s, Py_hash_t hash)
+{
+    intern_table *t = (intern_table *)INTERN_LOAD(&interned);
+    Py_ssize_t i, n;
+    PyObject *v;
+
+    if (t == NULL)
+        return NULL;
+    i = (size_t)hash & t->mask;
+    for (n = 0; n <= t->mask; n++) {
+        v = INTERN_SLOT(t, i);
+        if (v == NULL)
+            break;
+        if (v == s || (v != INTERN_DUMMY &&
+                       ((PyASCIIObject *)v)->hash == hash &&
+                       unicode_compare_eq(v, s)))
+            return v;
+        i = (i + 1) & t->mask;
+    }
+    return NULL;
+}
+
+/* Move the live strings to a new table with room for at least minused
+   strings.  Needs the GIL. */
+static int
+intern_resize(Py_ssize_t minused)
+{
+    intern_table *old = (intern_table *)INTERN_LOAD(&interned);
+    intern_table *t;
+    Py_ssize_t i, j, size = INTERN_MINSIZE;
+    PyObject *v;
+
+    while (size <= minused * 4)
+        size <<= 1;
+    t = intern_table_new(size);
+    if (t == NULL)
+        return -1;
+    if (old != NULL) {
+        for (i = 0; i <= old->mask; i++) {
+            v = INTERN_SLOT(old, i);
+            if (v == NULL || v == INTERN_DUMMY)
+                continue;
+            j = (size_t)((PyASCIIObject *)v)->hash & t->mask;
+            while (t->slots[j]._value != NULL)
+                j = (j + 1) & t->mask;
+            t->slots[j]._value = v;
+            t->fill++;
+        }
+        t->retired = old;
+    }
+    INTERN_STORE(&interned, t);
+    intern_free_retired(t);
+    return 0;
+}
+
+/* Add s, which must not be in the table yet.  Needs the GIL.  Returns 0
+   on success and -1 on failure; no exception is set. */
+static int
+intern_insert(PyObject *s, Py_hash_t hash)
+{
+    intern_table *t = (intern_table *)INTERN_LOAD(&interned);
+    Py_ssize_t i;
+    PyObject *v;
+
+    assert(!Py_PXCTX);
+    if (t == NULL || (t->fill + 1) * 3 >= (t->mask + 1) * 2) {
+        if (intern_resize(intern_used + 1) < 0)
+            return -1;
+        t = (intern_table *)INTERN_LOAD(&interned);
+    }
+    else if (t->retired != NULL)
+        intern_free_retired(t);
+    i = (size_t)hash & t->mask;
+    for (;;) {
+        v = INTERN_SLOT(t, i);
+        if (v == NULL || v == INTERN_DUMMY)
+            break;
+        assert(v != s);
+        i = (i + 1) & t->mask;
+    }
+    if (v == NULL)
+        t->fill++;
+    INTERN_STORE(&t->slots[i], s);
+    intern_used++;
+    return 0;
+}
+
+/* Remove the dead string s.  Needs the GIL. */
+static void
+intern_remove(PyObject *s)
+{
+    intern_table *t = (intern_table *)INTERN_LOAD(&interned);
+    Py_ssize_t i, n;
+
+    assert(t != NULL);
+    i = (size_t)((PyASCIIObject *)s)->hash & t->mask;
+    for (n = 0; n <= t->mask; n++) {
+        if (INTERN_SLOT(t, i) == s) {
+            INTERN_STORE(&t->slots[i], INTERN_DUMMY);
+            intern_used--;
+            return;
+        }
+        i = (i + 1) & t->mask;
+    }
+    Py_FatalError("deletion of interned string failed");
+}
+
 #ifdef WITH_PARALLEL
 void
 _PyParallelUnicode_InternInPlace(PyObject **p)
@@ -14315,20 +14524,21 @@ _PyParallelUnicode_InternInPlace(PyObject **p)
     PyObject *s = *p;
     PyObject *t;
     PyThreadState *tstate;
+    Py_hash_t hash;
     int failed;
 
     Px_GUARD
 
-    if (interned) {
-        _PyParallel_EnableTLSHeap();
-        Py_ALLOW_RECURSION
-        t = PyDict_GetItem(interned, s);
-        Py_END_ALLOW_RECURSION
-        _PyParallel_DisableTLSHeap();
-        if (t) {
-            *p = t;
-            return;
-        }
+    hash = PyObject_Hash(s);
+    if (hash == -1) {
+        PyErr_Clear();
+        return;
+    }
+    /* Main thread strings outlive the context, so they can be shared */
+    t = intern_lookup(s, hash);
+    if (t) {
+        *p = t;
+        return;
     }
 
     if (!tls_interned) {
@@ -14377,6 +14587,7 @@ PyUnicode_InternInPlace(PyObject **p)
 {
     register PyObject *s = *p;
     PyObject *t;
+    Py_hash_t hash;
 #ifdef Py_DEBUG
     assert(s != NULL);
     assert(_PyUnicode_CHECK(s));
@@ -14385,7 +14596,7 @@ PyUnicode_InternInPlace(PyObject **p)
         return;
 #endif
     /* If it's a subclass, we don't really know what putting
-       it in the interned dict might do. */
+       it in the intern table might do. */
     if (!PyUnicode_CheckExact(s))
         return;
     if (PyUnicode_CHECK_INTERNED(s))
@@ -14399,35 +14610,24 @@ PyUnicode_InternInPlace(PyObject **p)
                       "a parallel object from the main thread");
 #endif
 
-    if (!interned)
-        /* interned dict hasn't been initialized yet */
+    hash = PyObject_Hash(s);
+    if (hash == -1) {
+        PyErr_Clear();
         return;
-
-    /* It might be that the GetItem call fails even
-       though the key is present in the dictionary,
-       namely when this happens during a stack overflow. */
-    Py_ALLOW_RECURSION
-    t = PyDict_GetItem(interned, s);
-    Py_END_ALLOW_RECURSION
-
-        if (t) {
-            Py_INCREF(t);
-            Py_DECREF(*p);
-            *p = t;
+    }
+    t = intern_lookup(s, hash);
+    if (t == NULL) {
+        if (intern_insert(s, hash) < 0)
             return;
-        }
-
-    PyThreadState_GET()->recursion_critical = 1;
-    if (PyDict_SetItem(interned, s, s) < 0) {
-        PyErr_Clear();
-        PyThreadState_GET()->recursion_critical = 0;
+        t = s;
+    }
+    if (t != s) {
+        Py_INCREF(t);
+        Py_DECREF(*p);
+        *p = t;
         return;
     }
-    PyThreadState_GET()->recursion_critical = 0;
-    /* The two references in interned are not counted by refcnt.
-       The deallocator will take care of this */
-    Py_DECREF(s);
-    Py_DECREF(s);
+    /* The table holds no reference to s; the deallocator removes it */
     _PyUnicode_STATE(s).interned = SSTATE_INTERNED_MORTAL;
 }
 
@@ -14458,58 +14658,54 @@ end:
 void
 _Py_ReleaseInternedUnicodeStrings(void)
 {
-    PyObject *keys;
+    intern_table *t, *retired;
     PyObject *s;
-    Py_ssize_t i, n;
+    Py_ssize_t i;
     Py_ssize_t immortal_size = 0, mortal_size = 0;
     Py_GUARD
 
-    if (interned == NULL || !PyDict_Check(interned))
+    t = (intern_table *)INTERN_LOAD(&interned);
+    if (t == NULL)
         return;
-    keys = PyDict_Keys(interned);
-    if (keys == NULL || !PyList_Check(keys)) {
-        PyErr_Clear();
-        return;
-    }
 
     /* Since _Py_ReleaseInternedUnicodeStrings() is intended to help a leak
        detector, interned unicode strings are not forcibly deallocated;
-       rather, we give them their stolen references back, and then clear
-       and DECREF the interned dict. */
+       rather, immortal strings lose the reference that kept them alive,
+       and the table is freed. */
 
-    n = PyList_GET_SIZE(keys);
     fprintf(stderr, "releasing %" PY_FORMAT_SIZE_T "d interned strings\n",
-            n);
-    for (i = 0; i < n; i++) {
-        s = PyList_GET_ITEM(keys, i);
-        if (PyUnicode_READY(s) == -1) {
-            assert(0 && "could not ready string");
-            fprintf(stderr, "could not ready string\n");
-        }
+            intern_used);
+    for (i = 0; i <= t->mask; i++) {
+        s = INTERN_SLOT(t, i);
+        if (s == NULL || s == INTERN_DUMMY)
+            continue;
         switch (PyUnicode_CHECK_INTERNED(s)) {
         case SSTATE_NOT_INTERNED:
             /* XXX Shouldn't happen */
             break;
         case SSTATE_INTERNED_IMMORTAL:
-            Py_INCREF(s);
             immortal_size += PyUnicode_GET_LENGTH(s);
+            _PyUnicode_STATE(s).interned = SSTATE_NOT_INTERNED;
+            Py_DECREF(s);
             break;
         case SSTATE_INTERNED_MORTAL:
-            Py_INCREF(s);
-            Py_INCREF(s);
             mortal_size += PyUnicode_GET_LENGTH(s);
+            _PyUnicode_STATE(s).interned = SSTATE_NOT_INTERNED;
             break;
         default:
             Py_FatalError("Inconsistent interned string state.");
         }
-        _PyUnicode_STATE(s).interned = SSTATE_NOT_INTERNED;
     }
     fprintf(stderr, "total size of all interned strings: "
             "%" PY_FORMAT_SIZE_T "d/%" PY_FORMAT_SIZE_T "d "
             "mortal/immortal\n", mortal_size, immortal_size);
-    Py_DECREF(keys);
-    PyDict_Clear(interned);
-    Py_CLEAR(interned);
+    INTERN_STORE(&interned, NULL);
+    intern_used = 0;
+    while (t != NULL) {
+        retired = t->retired;
+        PyMem_FREE(t);
+        t = retired;
+    }
 }
 
 
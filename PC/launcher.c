@@ -970,7 +970,7 @@ static PYC_MAGIC magic_values[] = {
     { 0x0bb8, 0x0c3b, L"3.0" },
     { 0x0c45, 0x0c4f, L"3.1" },
     { 0x0c58, 0x0c6c, L"3.2" },
-    { 0x0c76, 0x0c76, L"3.3" },
+    { 0x0c76, 0x0cb2, L"3.3" },
     { 0 }
 };
 
@@ -713,11 +713,14 @@ PyDoc_STRVAR(dir_doc,
 "    recursively the attributes of its class's base classes.");
 
 static PyObject *
-builtin_divmod(PyObject *self, PyObject *args)
+builtin_divmod(PyObject *self, PyObject **args, Py_ssize_t nargs,
+               PyObject *kwnames)
 {
     PyObject *v, *w;
 
-    if (!PyArg_UnpackTuple(args, "divmod", 2, 2, &v, &w))
+    if (!_PyArg_NoStackKeywords("divmod()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "divmod", 2, 2, &v, &w))
         return NULL;
     return PyNumber_Divmod(v, w);
 }
@@ -881,12 +884,15 @@ globals and locals.  If only globals is given, locals defaults to it.");
 
 
 static PyObject *
-builtin_getattr(PyObject *self, PyObject *args)
+builtin_getattr(PyObject *self, PyObject **args, Py_ssize_t nargs,
+                PyObject *kwnames)
 {
     PyObject *v, *result, *dflt = NULL;
     PyObject *name;
 
-    if (!PyArg_UnpackTuple(args, "getattr", 2, 3, &v, &name, &dflt))
+    if (!_PyArg_NoStackKeywords("getattr()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "getattr", 2, 3, &v, &name, &dflt))
         return NULL;
 
     if (!PyUnicode_Check(name)) {
@@ -930,12 +936,15 @@ Return the dictionary containing the current scope's global variables.");
 
 
 static PyObject *
-builtin_hasattr(PyObject *self, PyObject *args)
+builtin_hasattr(PyObject *self, PyObject **args, Py_ssize_t nargs,
+                PyObject *kwnames)
 {
     PyObject *v;
     PyObject *name;
 
-    if (!PyArg_UnpackTuple(args, "hasattr", 2, 2, &v, &name))
+    if (!_PyArg_NoStackKeywords("hasattr()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "hasattr", 2, 2, &v, &name))
         return NULL;
     if (!PyUnicode_Check(name)) {
         PyErr_SetString(PyExc_TypeError,
@@ -1146,12 +1155,15 @@ PyTypeObject PyMap_Type = {
 };
 
 static PyObject *
-builtin_next(PyObject *self, PyObject *args)
+builtin_next(PyObject *self, PyObject **args, Py_ssize_t nargs,
+             PyObject *kwnames)
 {
     PyObject *it, *res;
     PyObject *def = NULL;
 
-    if (!PyArg_UnpackTuple(args, "next", 1, 2, &it, &def))
+    if (!_PyArg_NoStackKeywords("next()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "next", 1, 2, &it, &def))
         return NULL;
     if (!PyIter_Check(it)) {
         PyErr_Format(PyExc_TypeError,
@@ -1187,13 +1199,16 @@ is exhausted, it is returned instead of raising StopIteration.");
 
 
 static PyObject *
-builtin_setattr(PyObject *self, PyObject *args)
+builtin_setattr(PyObject *self, PyObject **args, Py_ssize_t nargs,
+                PyObject *kwnames)
 {
     PyObject *v;
     PyObject *name;
     PyObject *value;
 
-    if (!PyArg_UnpackTuple(args, "setattr", 3, 3, &v, &name, &value))
+    if (!_PyArg_NoStackKeywords("setattr()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "setattr", 3, 3, &v, &name, &value))
         return NULL;
     if (PyObject_SetAttr(v, name, value) != 0)
         return NULL;
@@ -2108,13 +2123,16 @@ empty, return start.");
 
 
 static PyObject *
-builtin_isinstance(PyObject *self, PyObject *args)
+builtin_isinstance(PyObject *self, PyObject **args, Py_ssize_t nargs,
+                   PyObject *kwnames)
 {
     PyObject *inst;
     PyObject *cls;
     int retval;
 
-    if (!PyArg_UnpackTuple(args, "isinstance", 2, 2, &inst, &cls))
+    if (!_PyArg_NoStackKeywords("isinstance()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "isinstance", 2, 2, &inst, &cls))
         return NULL;
 
     retval = PyObject_IsInstance(inst, cls);
@@ -2133,13 +2151,16 @@ isinstance(x, A) or isinstance(x, B) or ... (etc.).");
 
 
 static PyObject *
-builtin_issubclass(PyObject *self, PyObject *args)
+builtin_issubclass(PyObject *self, PyObject **args, Py_ssize_t nargs,
+                   PyObject *kwnames)
 {
     PyObject *derived;
     PyObject *cls;
     int retval;
 
-    if (!PyArg_UnpackTuple(args, "issubclass", 2, 2, &derived, &cls))
+    if (!_PyArg_NoStackKeywords("issubclass()", kwnames))
+        return NULL;
+    if (!_PyArg_UnpackStack(args, nargs, "issubclass", 2, 2, &derived, &cls))
         return NULL;
 
     retval = PyObject_IsSubclass(derived, cls);
@@ -2359,32 +2380,32 @@ static PyMethodDef builtin_methods[] = {
     {"compile",         (PyCFunction)builtin_compile,    METH_VARARGS | METH_KEYWORDS, compile_doc},
     {"delattr",         builtin_delattr,    METH_VARARGS, delattr_doc},
     {"dir",             builtin_dir,        METH_VARARGS, dir_doc},
-    {"divmod",          builtin_divmod,     METH_VARARGS, divmod_doc},
+    {"divmod",          (PyCFunction)builtin_divmod,     METH_FASTCALL, divmod_doc},
     {"eval",            builtin_eval,       METH_VARARGS, eval_doc},
     {"exec",        builtin_exec,       METH_VARARGS, exec_doc},
     {"format",          builtin_format,     METH_VARARGS, format_doc},
-    {"getattr",         builtin_getattr,    METH_VARARGS, getattr_doc},
+    {"getattr",         (PyCFunction)builtin_getattr,    METH_FASTCALL, getattr_doc},
     {"globals",         (PyCFunction)builtin_globals,    METH_NOARGS, globals_doc},
-    {"hasattr",         builtin_hasattr,    METH_VARARGS, hasattr_doc},
+    {"hasattr",         (PyCFunction)builtin_hasattr,    METH_FASTCALL, hasattr_doc},
     {"hash",            builtin_hash,       METH_O, hash_doc},
     {"hex",             builtin_hex,        METH_O, hex_doc},
     {"id",              builtin_id,         METH_O, id_doc},
     {"input",           builtin_input,      METH_VARARGS, input_doc},
-    {"isinstance",  builtin_isinstance, METH_VARARGS, isinstance_doc},
-    {"issubclass",  builtin_issubclass, METH_VARARGS, issubclass_doc},
+    {"isinstance",  (PyCFunction)builtin_isinstance, METH_FASTCALL, isinstance_doc},
+    {"issubclass",  (PyCFunction)builtin_issubclass, METH_FASTCALL, issubclass_doc},
     {"iter",            builtin_iter,       METH_VARARGS, iter_doc},
     {"len",             builtin_len,        METH_O, len_doc},
     {"locals",          (PyCFunction)builtin_locals,     METH_NOARGS, locals_doc},
     {"max",             (PyCFunction)builtin_max,        METH_VARARGS | METH_KEYWORDS, max_doc},
     {"min",             (PyCFunction)builtin_min,        METH_VARARGS | METH_KEYWORDS, min_doc},
-    {"next",            (PyCFunction)builtin_next,       METH_VARARGS, next_doc},
+    {"next",            (PyCFunction)builtin_next,       METH_FASTCALL, next_doc},
     {"oct",             builtin_oct,        METH_O, oct_doc},
     {"ord",             builtin_ord,        METH_O, ord_doc},
     {"pow",             builtin_pow,        METH_VARARGS, pow_doc},
     {"print",           (PyCFunction)builtin_print,      METH_VARARGS | METH_KEYWORDS, print_doc},
     {"repr",            builtin_repr,       METH_O, repr_doc},
     {"round",           (PyCFunction)builtin_round,      METH_VARARGS | METH_KEYWORDS, round_doc},
-    {"setattr",         builtin_setattr,    METH_VARARGS, setattr_doc},
+    {"setattr",         (PyCFunction)builtin_setattr,    METH_FASTCALL, setattr_doc},
     {"sorted",          (PyCFunction)builtin_sorted,     METH_VARARGS | METH_KEYWORDS, sorted_doc},
     {"sum",             builtin_sum,        METH_VARARGS, sum_doc},
     {"vars",            builtin_vars,       METH_VARARGS, vars_doc},
@@ -143,6 +143,7 @@ static void format_exc_unbound(PyCodeObject *co, int oparg);
 static PyObject * unicode_concatenate(PyObject *, PyObject *,
                                       PyFrameObject *, unsigned char *);
 static PyObject * special_lookup(PyObject *, _Py_Identifier *);
+static void count_opcode(PyCodeObject *, int, int);
 
 #define NAME_ERROR_MSG \
     "name '%.200s' is not defined"
@@ -154,15 +155,14 @@ static PyObject * special_lookup(PyObject *, _Py_Identifier *);
     "free variable '%.200s' referenced before assignment" \
     " in enclosing scope"
 
-/* Dynamic execution profile */
-#ifdef DYNAMIC_EXECUTION_PROFILE
-#ifdef DXPAIRS
+/* Dynamic execution profile, switched on and off at run time with
+   sys.setopcodeprofile().  dxpairs[i][j] counts how often opcode j
+   followed opcode i in the same frame (i is 0 for the first instruction
+   of a frame); dxpairs[256] holds the totals per opcode.  Each code
+   object also gets its own totals in co_opcounts. */
+static int opcode_profiling = 0;
 static long dxpairs[257][256];
 #define dxp dxpairs[256]
-#else
-static long dxp[256];
-#endif
-#endif
 
 /* Function call profile */
 #ifdef CALL_PROFILE
@@ -832,9 +832,7 @@ PyEval_EvalFrame(PyFrameObject *f) {
 PyObject *
 PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 {
-#ifdef DXPAIRS
     int lastopcode = 0;
-#endif
     register PyObject **stack_pointer;  /* Next free slot in value stack */
     register unsigned char *next_instr;
     register int opcode;        /* Current opcode */
@@ -897,8 +895,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
    faster than the normal "switch" version, depending on the compiler and the
    CPU architecture.
 
-   We disable the optimization if DYNAMIC_EXECUTION_PROFILE is defined,
-   because it would render the measurements invalid.
+   While the execution profile is on, _Py_TracingPossible is raised so
+   that FAST_DISPATCH() takes the slow path through fast_next_opcode and
+   every instruction is counted at dispatch_opcode.  The jump table stays
+   in place, so turning the profile off costs nothing.
 
 
    NOTE: care must be taken that the compiler doesn't try to "optimize" the
@@ -907,11 +907,6 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
    -fno-crossjumping).
 */
 
-#ifdef DYNAMIC_EXECUTION_PROFILE
-#undef USE_COMPUTED_GOTOS
-#define USE_COMPUTED_GOTOS 0
-#endif
-
 #ifdef HAVE_COMPUTED_GOTOS
     #ifndef USE_COMPUTED_GOTOS
     #define USE_COMPUTED_GOTOS 1
@@ -1068,16 +1063,27 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
     the CPU to record separate branch prediction information for each
     opcode.
 
+    In the switch-based build a predicted opcode skips dispatch_opcode, so
+    the run-time profile (sys.setopcodeprofile()) counts it at its PRED_
+    label instead.  PREDICT itself stays a single compare either way.
+
 */
 
-#if defined(DYNAMIC_EXECUTION_PROFILE) || USE_COMPUTED_GOTOS
+#define PREDICTED_COUNT(op) \
+    if (opcode_profiling && !Py_PXCTX) { \
+        count_opcode(co, lastopcode, op); \
+        lastopcode = op; \
+    }
+
+#if USE_COMPUTED_GOTOS || defined(DYNAMIC_EXECUTION_PROFILE)
 #define PREDICT(op)             if (0) goto PRED_##op
 #define PREDICTED(op)           PRED_##op:
 #define PREDICTED_WITH_ARG(op)  PRED_##op:
 #else
 #define PREDICT(op)             if (*next_instr == op) goto PRED_##op
-#define PREDICTED(op)           PRED_##op: next_instr++
-#define PREDICTED_WITH_ARG(op)  PRED_##op: oparg = PEEKARG(); next_instr += 3
+#define PREDICTED(op)           PRED_##op: next_instr++; PREDICTED_COUNT(op)
+#define PREDICTED_WITH_ARG(op) \
+    PRED_##op: oparg = PEEKARG(); next_instr += 3; PREDICTED_COUNT(op)
 #endif
 
 
@@ -1374,13 +1380,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
         if (HAS_ARG(opcode))
             oparg = NEXTARG();
     dispatch_opcode:
-#ifdef DYNAMIC_EXECUTION_PROFILE
-#ifdef DXPAIRS
-        dxpairs[lastopcode][opcode]++;
-        lastopcode = opcode;
-#endif
-        dxp[opcode]++;
-#endif
+        if (opcode_profiling && !Py_PXCTX) {
+            count_opcode(co, lastopcode, opcode);
+            lastopcode = opcode;
+        }
 
 #ifdef LLTRACE
         /* Instruction tracing */
@@ -1428,6 +1431,53 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             PUSH(x);
             FAST_DISPATCH();
 
+        /* The superinstructions below do the work of their own
+           instruction and of the one following it, whose argument they
+           read with PEEKARG() before skipping it.  See fuse_pairs() in
+           peephole.c. */
+
+        TARGET(LOAD_FAST_LOAD_FAST)
+            x = GETLOCAL(oparg);
+            if (x != NULL) {
+                oparg = PEEKARG();
+                w = GETLOCAL(oparg);
+                if (w != NULL) {
+                    JUMPBY(3);
+                    Py_INCREF(x);
+                    PUSH(x);
+                    Py_INCREF(w);
+                    PUSH(w);
+                    FAST_DISPATCH();
+                }
+                x = NULL;
+            }
+            format_exc_check_arg(PyExc_UnboundLocalError,
+                UNBOUNDLOCAL_ERROR_MSG,
+                PyTuple_GetItem(co->co_varnames, oparg));
+            break;
+
+        TARGET(LOAD_FAST_LOAD_ATTR)
+            x = GETLOCAL(oparg);
+            if (x == NULL) {
+                format_exc_check_arg(PyExc_UnboundLocalError,
+                    UNBOUNDLOCAL_ERROR_MSG,
+                    PyTuple_GetItem(co->co_varnames, oparg));
+                break;
+            }
+            w = GETITEM(names, PEEKARG());
+            JUMPBY(3);
+            x = PyObject_GetAttr(x, w);
+            if (x == NULL)
+                break;
+            PUSH(x);
+            DISPATCH();
+
+        TARGET(LOAD_CONST_RETURN_VALUE)
+            retval = GETITEM(consts, oparg);
+            Py_INCREF(retval);
+            why = WHY_RETURN;
+            goto fast_block_end;
+
         PREDICTED_WITH_ARG(STORE_FAST);
         TARGET(STORE_FAST)
             v = POP();
@@ -2348,6 +2398,35 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             PREDICT(POP_JUMP_IF_TRUE);
             DISPATCH();
 
+        TARGET(COMPARE_OP_POP_JUMP_IF_FALSE)
+            w = POP();
+            v = POP();
+            x = cmp_outcome(oparg, v, w);
+            Py_DECREF(v);
+            Py_DECREF(w);
+            if (x == NULL)
+                break;
+            oparg = PEEKARG();
+            JUMPBY(3);
+            if (x == Py_True) {
+                Py_DECREF(x);
+                DISPATCH();
+            }
+            if (x == Py_False) {
+                Py_DECREF(x);
+                JUMPTO(oparg);
+                DISPATCH();
+            }
+            err = PyObject_IsTrue(x);
+            Py_DECREF(x);
+            if (err > 0)
+                err = 0;
+            else if (err == 0)
+                JUMPTO(oparg);
+            else
+                break;
+            DISPATCH();
+
 #ifdef WITH_PARALLEL
 #define PREVENT_PARALLEL_IMPORT() do {                                      \
     if (Py_PXCTX) {                                                         \
@@ -4127,6 +4206,14 @@ call_function(PyObject ***pp_stack, int oparg
                 x = NULL;
             }
         }
+        else if (flags & METH_FASTCALL) {
+            _PyCFunctionFast meth =
+                (_PyCFunctionFast)PyCFunction_GET_FUNCTION(func);
+            PyObject *self = PyCFunction_GET_SELF(func);
+            READ_TIMESTAMP(*pintr0);
+            C_TRACE(x, (*meth)(self, (*pp_stack) - na, na, NULL));
+            READ_TIMESTAMP(*pintr1);
+        }
         else {
             PyObject *callargs;
             callargs = load_args(pp_stack, na);
@@ -4180,6 +4267,40 @@ call_function(PyObject ***pp_stack, int oparg
    done before evaluating the frame.
 */
 
+static PyObject *
+function_code_fastcall(PyCodeObject *co, PyObject *globals,
+                       PyObject **args, int n)
+{
+    PyFrameObject *f;
+    PyObject *retval = NULL;
+    PyThreadState *tstate = PyThreadState_GET();
+    PyObject **fastlocals;
+    int i;
+
+    PCALL(PCALL_FASTER_FUNCTION);
+    assert(globals != NULL);
+    /* XXX Perhaps we should create a specialized
+       PyFrame_New() that doesn't take locals, but does
+       take builtins without sanity checking them.
+    */
+    assert(tstate != NULL);
+    f = PyFrame_New(tstate, co, globals, NULL);
+    if (f == NULL)
+        return NULL;
+
+    fastlocals = f->f_localsplus;
+
+    for (i = 0; i < n; i++) {
+        Py_INCREF(*args);
+        fastlocals[i] = *args++;
+    }
+    retval = PyEval_EvalFrameEx(f,0);
+    ++tstate->recursion_depth;
+    Py_DECREF(f);
+    --tstate->recursion_depth;
+    return retval;
+}
+
 static PyObject *
 fast_function(PyObject *func, PyObject ***pp_stack, int n, int na, int nk)
 {
@@ -4194,37 +4315,8 @@ fast_function(PyObject *func, PyObject ***pp_stack, int n, int na, int nk)
     PCALL(PCALL_FAST_FUNCTION);
     if (argdefs == NULL && co->co_argcount == n &&
         co->co_kwonlyargcount == 0 && nk==0 &&
-        co->co_flags == (CO_OPTIMIZED | CO_NEWLOCALS | CO_NOFREE)) {
-        PyFrameObject *f;
-        PyObject *retval = NULL;
-        PyThreadState *tstate = PyThreadState_GET();
-        PyObject **fastlocals, **stack;
-        int i;
-
-        PCALL(PCALL_FASTER_FUNCTION);
-        assert(globals != NULL);
-        /* XXX Perhaps we should create a specialized
-           PyFrame_New() that doesn't take locals, but does
-           take builtins without sanity checking them.
-        */
-        assert(tstate != NULL);
-        f = PyFrame_New(tstate, co, globals, NULL);
-        if (f == NULL)
-            return NULL;
-
-        fastlocals = f->f_localsplus;
-        stack = (*pp_stack) - n;
-
-        for (i = 0; i < n; i++) {
-            Py_INCREF(*stack);
-            fastlocals[i] = *stack++;
-        }
-        retval = PyEval_EvalFrameEx(f,0);
-        ++tstate->recursion_depth;
-        Py_DECREF(f);
-        --tstate->recursion_depth;
-        return retval;
-    }
+        co->co_flags == (CO_OPTIMIZED | CO_NEWLOCALS | CO_NOFREE))
+        return function_code_fastcall(co, globals, (*pp_stack) - n, n);
     if (argdefs != NULL) {
         d = &PyTuple_GET_ITEM(argdefs, 0);
         nd = Py_SIZE(argdefs);
@@ -4235,6 +4327,53 @@ fast_function(PyObject *func, PyObject ***pp_stack, int n, int na, int nk)
                              PyFunction_GET_CLOSURE(func));
 }
 
+/* fast_function() for calls from C, with the arguments laid out as for
+   METH_FASTCALL */
+PyObject *
+_PyFunction_FastCall(PyObject *func, PyObject **args, Py_ssize_t nargs,
+                     PyObject *kwnames)
+{
+    PyCodeObject *co = (PyCodeObject *)PyFunction_GET_CODE(func);
+    PyObject *globals = PyFunction_GET_GLOBALS(func);
+    PyObject *argdefs = PyFunction_GET_DEFAULTS(func);
+    PyObject *kwdefs = PyFunction_GET_KW_DEFAULTS(func);
+    PyObject **d = NULL, **kws = NULL, *result;
+    Py_ssize_t i, nk;
+    int nd = 0;
+
+    PCALL(PCALL_FUNCTION);
+    nk = kwnames == NULL ? 0 : PyTuple_GET_SIZE(kwnames);
+    if (nargs > INT_MAX || nk > INT_MAX / 2) {
+        PyErr_SetString(PyExc_OverflowError, "too many arguments");
+        return NULL;
+    }
+    if (argdefs == NULL && co->co_argcount == nargs &&
+        co->co_kwonlyargcount == 0 && nk == 0 &&
+        co->co_flags == (CO_OPTIMIZED | CO_NEWLOCALS | CO_NOFREE))
+        return function_code_fastcall(co, globals, args, (int)nargs);
+    if (argdefs != NULL) {
+        d = &PyTuple_GET_ITEM(argdefs, 0);
+        nd = Py_SIZE(argdefs);
+    }
+    if (nk) {
+        /* PyEval_EvalCodeEx() wants (name, value) pairs */
+        kws = PyMem_NEW(PyObject *, 2 * nk);
+        if (kws == NULL)
+            return PyErr_NoMemory();
+        for (i = 0; i < nk; i++) {
+            kws[2 * i] = PyTuple_GET_ITEM(kwnames, i);
+            kws[2 * i + 1] = args[nargs + i];
+        }
+    }
+    result = PyEval_EvalCodeEx((PyObject*)co, globals,
+                               (PyObject *)NULL, args, (int)nargs,
+                               kws, (int)nk, d, nd, kwdefs,
+                               PyFunction_GET_CLOSURE(func));
+    if (kws != NULL)
+        PyMem_FREE(kws);
+    return result;
+}
+
 static PyObject *
 update_keyword_args(PyObject *orig_kwdict, int nk, PyObject ***pp_stack,
                     PyObject *func)
@@ -4701,10 +4840,36 @@ unicode_concatenate(PyObject *v, PyObject *w,
     return res;
 }
 
-#ifdef DYNAMIC_EXECUTION_PROFILE
+static void
+count_opcode(PyCodeObject *co, int lastopcode, int opcode)
+{
+    dxpairs[lastopcode][opcode]++;
+    dxp[opcode]++;
+    if (co->co_opcounts == NULL) {
+        co->co_opcounts = PyMem_NEW(long, 256);
+        if (co->co_opcounts == NULL)
+            return;
+        memset(co->co_opcounts, 0, 256 * sizeof(long));
+    }
+    co->co_opcounts[opcode]++;
+}
+
+void
+_PyEval_SetOpcodeProfile(int on)
+{
+    on = on != 0;
+    _Py_TracingPossible += on - opcode_profiling;
+    opcode_profiling = on;
+}
+
+int
+_PyEval_GetOpcodeProfile(void)
+{
+    return opcode_profiling;
+}
 
 static PyObject *
-getarray(long a[256])
+getarray(long a[256], int clear)
 {
     int i;
     PyObject *l = PyList_New(256);
@@ -4717,22 +4882,38 @@ getarray(long a[256])
         }
         PyList_SetItem(l, i, x);
     }
-    for (i = 0; i < 256; i++)
-        a[i] = 0;
+    if (clear) {
+        for (i = 0; i < 256; i++)
+            a[i] = 0;
+    }
     return l;
 }
 
+/* Return the opcode totals of code object co as a list of 256 ints, or
+   None if it hasn't run while the profile was on. */
+PyObject *
+_PyEval_GetOpcodeCounts(PyObject *co)
+{
+    if (!PyCode_Check(co)) {
+        PyErr_Format(PyExc_TypeError, "expected code object, not %.200s",
+                     Py_TYPE(co)->tp_name);
+        return NULL;
+    }
+    if (((PyCodeObject *)co)->co_opcounts == NULL)
+        Py_RETURN_NONE;
+    return getarray(((PyCodeObject *)co)->co_opcounts, 0);
+}
+
+/* Return the pair counts as a list of 257 lists, the last one holding the
+   totals, and start over from zero. */
 PyObject *
 _Py_GetDXProfile(PyObject *self, PyObject *args)
 {
-#ifndef DXPAIRS
-    return getarray(dxp);
-#else
     int i;
     PyObject *l = PyList_New(257);
     if (l == NULL) return NULL;
     for (i = 0; i < 257; i++) {
-        PyObject *x = getarray(dxpairs[i]);
+        PyObject *x = getarray(dxpairs[i], 1);
         if (x == NULL) {
             Py_DECREF(l);
             return NULL;
@@ -4740,7 +4921,4 @@ _Py_GetDXProfile(PyObject *self, PyObject *args)
         PyList_SetItem(l, i, x);
     }
     return l;
-#endif
 }
-
-#endif
@@ -1726,28 +1726,15 @@ err:
 }
 
 
-int
-PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t max, ...)
+static int
+unpack_stack(PyObject **args, Py_ssize_t l, const char *name,
+             Py_ssize_t min, Py_ssize_t max, va_list vargs)
 {
-    Py_ssize_t i, l;
+    Py_ssize_t i;
     PyObject **o;
-    va_list vargs;
-
-#ifdef HAVE_STDARG_PROTOTYPES
-    va_start(vargs, max);
-#else
-    va_start(vargs);
-#endif
 
     assert(min >= 0);
     assert(min <= max);
-    if (!PyTuple_Check(args)) {
-        va_end(vargs);
-        PyErr_SetString(PyExc_SystemError,
-            "PyArg_UnpackTuple() argument list is not a tuple");
-        return 0;
-    }
-    l = PyTuple_GET_SIZE(args);
     if (l < min) {
         if (name != NULL)
             PyErr_Format(
@@ -1760,7 +1747,6 @@ PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t m
                 "unpacked tuple should have %s%zd elements,"
                 " but has %zd",
                 (min == max ? "" : "at least "), min, l);
-        va_end(vargs);
         return 0;
     }
     if (l > max) {
@@ -1775,17 +1761,58 @@ PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t m
                 "unpacked tuple should have %s%zd elements,"
                 " but has %zd",
                 (min == max ? "" : "at most "), max, l);
-        va_end(vargs);
         return 0;
     }
     for (i = 0; i < l; i++) {
         o = va_arg(vargs, PyObject **);
-        *o = PyTuple_GET_ITEM(args, i);
+        *o = args[i];
     }
-    va_end(vargs);
     return 1;
 }
 
+int
+PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t max, ...)
+{
+    int retval;
+    va_list vargs;
+
+#ifdef HAVE_STDARG_PROTOTYPES
+    va_start(vargs, max);
+#else
+    va_start(vargs);
+#endif
+
+    if (!PyTuple_Check(args)) {
+        va_end(vargs);
+        PyErr_SetString(PyExc_SystemError,
+            "PyArg_UnpackTuple() argument list is not a tuple");
+        return 0;
+    }
+    retval = unpack_stack(&PyTuple_GET_ITEM(args, 0), PyTuple_GET_SIZE(args),
+                          name, min, max, vargs);
+    va_end(vargs);
+    return retval;
+}
+
+/* Like PyArg_UnpackTuple(), for the argument array of a METH_FASTCALL
+   function */
+int
+_PyArg_UnpackStack(PyObject **args, Py_ssize_t nargs, const char *name,
+                   Py_ssize_t min, Py_ssize_t max, ...)
+{
+    int retval;
+    va_list vargs;
+
+#ifdef HAVE_STDARG_PROTOTYPES
+    va_start(vargs, max);
+#else
+    va_start(vargs);
+#endif
+    retval = unpack_stack(args, nargs, name, min, max, vargs);
+    va_end(vargs);
+    return retval;
+}
+
 
 /* For type constructors that don't take keyword args
  *
@@ -1808,6 +1835,21 @@ _PyArg_NoKeywords(const char *funcname, PyObject *kw)
                     funcname);
     return 0;
 }
+
+/* The same for the kwnames of a METH_FASTCALL function */
+int
+_PyArg_NoStackKeywords(const char *funcname, PyObject *kwnames)
+{
+    if (kwnames == NULL)
+        return 1;
+    assert(PyTuple_CheckExact(kwnames));
+    if (PyTuple_GET_SIZE(kwnames) == 0)
+        return 1;
+
+    PyErr_Format(PyExc_TypeError, "%s does not take keyword arguments",
+                    funcname);
+    return 0;
+}
 #ifdef __cplusplus
 };
 #endif
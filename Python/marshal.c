@@ -11,6 +11,19 @@
 #include "code.h"
 #include "marshal.h"
 
+#if defined(HAVE_MMAP) && defined(HAVE_FSTAT) && !defined(MS_WINDOWS)
+#include <sys/mman.h>
+#define USE_MMAP_FOR_LAST_OBJECT
+#endif
+
+#if defined(USE_MMAP_FOR_LAST_OBJECT) || defined(MS_WINDOWS)
+#define USE_MAPPED_FILE
+#ifdef MS_WINDOWS
+#include <windows.h>
+#include <io.h>
+#endif
+#endif
+
 #define ABS(x) ((x) < 0 ? -(x) : (x))
 
 /* High water mark to determine when the marshalled object is dangerously deep
@@ -49,6 +62,11 @@
 #define TYPE_UNKNOWN            '?'
 #define TYPE_SET                '<'
 #define TYPE_FROZENSET          '>'
+#define TYPE_INTERNED           't'
+#define TYPE_REF                'r'
+/* Set on the type code of an object that is stored in the reference table
+   (version 3 and later); a later TYPE_REF can then refer back to it. */
+#define FLAG_REF                '\x80'
 
 #define WFERR_OK 0
 #define WFERR_UNMARSHALLABLE 1
@@ -65,6 +83,7 @@ typedef struct {
     PyObject *current_filename;
     char *ptr;
     char *end;
+    PyObject *refs; /* dict on marshal, list on unmarshal */
     int version;
 } WFILE;
 
@@ -129,7 +148,6 @@ w_long(long x, WFILE *p)
 #if SIZEOF_SIZE_T > 4
 # define W_SIZE(n, p)  do {                     \
         if ((n) > SIZE32_MAX) {                 \
-            (p)->depth--;                       \
             (p)->error = WFERR_UNMARSHALLABLE;  \
             return;                             \
         }                                       \
@@ -158,13 +176,17 @@ w_pstring(const char *s, Py_ssize_t n, WFILE *p)
 #endif
 #define PyLong_MARSHAL_RATIO (PyLong_SHIFT / PyLong_MARSHAL_SHIFT)
 
+#define W_TYPE(t, p) do { \
+    w_byte((t) | flag, (p)); \
+} while(0)
+
 static void
-w_PyLong(const PyLongObject *ob, WFILE *p)
+w_PyLong(const PyLongObject *ob, char flag, WFILE *p)
 {
     Py_ssize_t i, j, n, l;
     digit d;
 
-    w_byte(TYPE_LONG, p);
+    W_TYPE(TYPE_LONG, p);
     if (Py_SIZE(ob) == 0) {
         w_long((long)0, p);
         return;
@@ -180,7 +202,6 @@ w_PyLong(const PyLongObject *ob, WFILE *p)
         l++;
     } while (d != 0);
     if (l > SIZE32_MAX) {
-        p->depth--;
         p->error = WFERR_UNMARSHALLABLE;
         return;
     }
@@ -201,10 +222,67 @@ w_PyLong(const PyLongObject *ob, WFILE *p)
     } while (d != 0);
 }
 
+/* If v was already written, write a reference to it and return 1.
+   Otherwise remember its position, set FLAG_REF in *flag and return 0. */
+static int
+w_ref(PyObject *v, char *flag, WFILE *p)
+{
+    PyObject *id;
+    PyObject *idx;
+
+    if (p->version < 3 || p->refs == NULL)
+        return 0; /* not writing object references */
+
+    /* if it has only one reference, it definitely isn't shared */
+    if (Py_REFCNT(v) == 1)
+        return 0;
+
+    id = PyLong_FromVoidPtr((void *)v);
+    if (id == NULL)
+        goto err;
+    idx = PyDict_GetItem(p->refs, id);
+    if (idx != NULL) {
+        /* write the reference index to the stream */
+        long w = PyLong_AsLong(idx);
+        Py_DECREF(id);
+        if (w == -1 && PyErr_Occurred())
+            goto err;
+        /* we don't store "long" indices in the dict */
+        assert(0 <= w && w <= SIZE32_MAX);
+        w_byte(TYPE_REF, p);
+        w_long(w, p);
+        return 1;
+    }
+    else {
+        int ok;
+        Py_ssize_t s = PyDict_Size(p->refs);
+        /* we don't support long indices */
+        if (s >= SIZE32_MAX) {
+            Py_DECREF(id);
+            p->error = WFERR_UNMARSHALLABLE;
+            return 1;
+        }
+        idx = PyLong_FromSsize_t(s);
+        ok = idx && PyDict_SetItem(p->refs, id, idx) == 0;
+        Py_DECREF(id);
+        Py_XDECREF(idx);
+        if (!ok)
+            goto err;
+        *flag |= FLAG_REF;
+        return 0;
+    }
+err:
+    p->error = WFERR_NOMEMORY;
+    return 1;
+}
+
+static void
+w_complex_object(PyObject *v, char flag, WFILE *p);
+
 static void
 w_object(PyObject *v, WFILE *p)
 {
-    Py_ssize_t i, n;
+    char flag = '\0';
 
     p->depth++;
 
@@ -229,24 +307,35 @@ w_object(PyObject *v, WFILE *p)
     else if (v == Py_True) {
         w_byte(TYPE_TRUE, p);
     }
-    else if (PyLong_CheckExact(v)) {
+    else if (!w_ref(v, &flag, p))
+        w_complex_object(v, flag, p);
+
+    p->depth--;
+}
+
+static void
+w_complex_object(PyObject *v, char flag, WFILE *p)
+{
+    Py_ssize_t i, n;
+
+    if (PyLong_CheckExact(v)) {
         long x = PyLong_AsLong(v);
         if ((x == -1)  && PyErr_Occurred()) {
             PyLongObject *ob = (PyLongObject *)v;
             PyErr_Clear();
-            w_PyLong(ob, p);
+            w_PyLong(ob, flag, p);
         }
         else {
 #if SIZEOF_LONG > 4
             long y = Py_ARITHMETIC_RIGHT_SHIFT(long, x, 31);
             if (y && y != -1) {
                 /* Too large for TYPE_INT */
-                w_PyLong((PyLongObject*)v, p);
+                w_PyLong((PyLongObject*)v, flag, p);
             }
             else
 #endif
             {
-                w_byte(TYPE_INT, p);
+                W_TYPE(TYPE_INT, p);
                 w_long(x, p);
             }
         }
@@ -259,7 +348,7 @@ w_object(PyObject *v, WFILE *p)
                 p->error = WFERR_UNMARSHALLABLE;
                 return;
             }
-            w_byte(TYPE_BINARY_FLOAT, p);
+            W_TYPE(TYPE_BINARY_FLOAT, p);
             w_string((char*)buf, 8, p);
         }
         else {
@@ -270,7 +359,7 @@ w_object(PyObject *v, WFILE *p)
                 return;
             }
             n = strlen(buf);
-            w_byte(TYPE_FLOAT, p);
+            W_TYPE(TYPE_FLOAT, p);
             w_byte((int)n, p);
             w_string(buf, n, p);
             PyMem_Free(buf);
@@ -284,7 +373,7 @@ w_object(PyObject *v, WFILE *p)
                 p->error = WFERR_UNMARSHALLABLE;
                 return;
             }
-            w_byte(TYPE_BINARY_COMPLEX, p);
+            W_TYPE(TYPE_BINARY_COMPLEX, p);
             w_string((char*)buf, 8, p);
             if (_PyFloat_Pack8(PyComplex_ImagAsDouble(v),
                                buf, 1) < 0) {
@@ -295,7 +384,7 @@ w_object(PyObject *v, WFILE *p)
         }
         else {
             char *buf;
-            w_byte(TYPE_COMPLEX, p);
+            W_TYPE(TYPE_COMPLEX, p);
             buf = PyOS_double_to_string(PyComplex_RealAsDouble(v),
                                         'g', 17, 0, NULL);
             if (!buf) {
@@ -319,23 +408,25 @@ w_object(PyObject *v, WFILE *p)
         }
     }
     else if (PyBytes_CheckExact(v)) {
-        w_byte(TYPE_STRING, p);
+        W_TYPE(TYPE_STRING, p);
         w_pstring(PyBytes_AS_STRING(v), PyBytes_GET_SIZE(v), p);
     }
     else if (PyUnicode_CheckExact(v)) {
         PyObject *utf8;
         utf8 = PyUnicode_AsEncodedString(v, "utf8", "surrogatepass");
         if (utf8 == NULL) {
-            p->depth--;
             p->error = WFERR_UNMARSHALLABLE;
             return;
         }
-        w_byte(TYPE_UNICODE, p);
+        if (p->version >= 3 && PyUnicode_CHECK_INTERNED(v))
+            W_TYPE(TYPE_INTERNED, p);
+        else
+            W_TYPE(TYPE_UNICODE, p);
         w_pstring(PyBytes_AS_STRING(utf8), PyBytes_GET_SIZE(utf8), p);
         Py_DECREF(utf8);
     }
     else if (PyTuple_CheckExact(v)) {
-        w_byte(TYPE_TUPLE, p);
+        W_TYPE(TYPE_TUPLE, p);
         n = PyTuple_Size(v);
         W_SIZE(n, p);
         for (i = 0; i < n; i++) {
@@ -343,7 +434,7 @@ w_object(PyObject *v, WFILE *p)
         }
     }
     else if (PyList_CheckExact(v)) {
-        w_byte(TYPE_LIST, p);
+        W_TYPE(TYPE_LIST, p);
         n = PyList_GET_SIZE(v);
         W_SIZE(n, p);
         for (i = 0; i < n; i++) {
@@ -353,7 +444,7 @@ w_object(PyObject *v, WFILE *p)
     else if (PyDict_CheckExact(v)) {
         Py_ssize_t pos;
         PyObject *key, *value;
-        w_byte(TYPE_DICT, p);
+        W_TYPE(TYPE_DICT, p);
         /* This one is NULL object terminated! */
         pos = 0;
         while (PyDict_Next(v, &pos, &key, &value)) {
@@ -366,19 +457,17 @@ w_object(PyObject *v, WFILE *p)
         PyObject *value, *it;
 
         if (PyObject_TypeCheck(v, &PySet_Type))
-            w_byte(TYPE_SET, p);
+            W_TYPE(TYPE_SET, p);
         else
-            w_byte(TYPE_FROZENSET, p);
+            W_TYPE(TYPE_FROZENSET, p);
         n = PyObject_Size(v);
         if (n == -1) {
-            p->depth--;
             p->error = WFERR_UNMARSHALLABLE;
             return;
         }
         W_SIZE(n, p);
         it = PyObject_GetIter(v);
         if (it == NULL) {
-            p->depth--;
             p->error = WFERR_UNMARSHALLABLE;
             return;
         }
@@ -388,14 +477,13 @@ w_object(PyObject *v, WFILE *p)
         }
         Py_DECREF(it);
         if (PyErr_Occurred()) {
-            p->depth--;
             p->error = WFERR_UNMARSHALLABLE;
             return;
         }
     }
     else if (PyCode_Check(v)) {
         PyCodeObject *co = (PyCodeObject *)v;
-        w_byte(TYPE_CODE, p);
+        W_TYPE(TYPE_CODE, p);
         w_long(co->co_argcount, p);
         w_long(co->co_kwonlyargcount, p);
         w_long(co->co_nlocals, p);
@@ -417,11 +505,10 @@ w_object(PyObject *v, WFILE *p)
         Py_buffer view;
         if (PyObject_GetBuffer(v, &view, PyBUF_SIMPLE) != 0) {
             w_byte(TYPE_UNKNOWN, p);
-            p->depth--;
             p->error = WFERR_UNMARSHALLABLE;
             return;
         }
-        w_byte(TYPE_STRING, p);
+        W_TYPE(TYPE_STRING, p);
         w_pstring(view.buf, view.len, p);
         PyBuffer_Release(&view);
     }
@@ -429,7 +516,6 @@ w_object(PyObject *v, WFILE *p)
         w_byte(TYPE_UNKNOWN, p);
         p->error = WFERR_UNMARSHALLABLE;
     }
-    p->depth--;
 }
 
 /* version currently has no effect for writing ints. */
@@ -440,6 +526,7 @@ PyMarshal_WriteLongToFile(long x, FILE *fp, int version)
     wf.fp = fp;
     wf.error = WFERR_OK;
     wf.depth = 0;
+    wf.refs = NULL;
     wf.version = version;
     w_long(x, &wf);
 }
@@ -452,7 +539,14 @@ PyMarshal_WriteObjectToFile(PyObject *x, FILE *fp, int version)
     wf.error = WFERR_OK;
     wf.depth = 0;
     wf.version = version;
+    if (version >= 3) {
+        if ((wf.refs = PyDict_New()) == NULL)
+            return; /* caller must check PyErr_Occurred() */
+    }
+    else
+        wf.refs = NULL;
     w_object(x, &wf);
+    Py_XDECREF(wf.refs);
 }
 
 typedef WFILE RFILE; /* Same struct with different invariants */
@@ -512,6 +606,27 @@ r_string(char *s, Py_ssize_t n, RFILE *p)
     return read;
 }
 
+/* When reading from memory, return a pointer to the next n bytes of the
+   input and skip them, so that the caller can use them in place instead of
+   copying them first.  Return NULL with an exception set if there are fewer
+   than n bytes left, or NULL without an exception when reading from a file
+   (the caller must then fall back to r_string()). */
+static const char *
+r_string_inplace(Py_ssize_t n, RFILE *p)
+{
+    const char *res;
+
+    if (p->readable || p->fp != NULL)
+        return NULL;
+    if (p->end - p->ptr < n) {
+        p->ptr = p->end;
+        PyErr_SetString(PyExc_EOFError, "EOF read where not expected");
+        return NULL;
+    }
+    res = p->ptr;
+    p->ptr += n;
+    return res;
+}
 
 static int
 r_byte(RFILE *p)
@@ -667,6 +782,64 @@ r_PyLong(RFILE *p)
     return NULL;
 }
 
+/* allocate the reflist index for a new object. Return -1 on failure */
+static Py_ssize_t
+r_ref_reserve(int flag, RFILE *p)
+{
+    if (flag) { /* currently only FLAG_REF is defined */
+        Py_ssize_t idx = PyList_GET_SIZE(p->refs);
+        if (idx >= SIZE32_MAX) {
+            PyErr_SetString(PyExc_ValueError, "bad marshal data (index list too large)");
+            return -1;
+        }
+        if (PyList_Append(p->refs, Py_None) < 0)
+            return -1;
+        return idx;
+    } else
+        return 0;
+}
+
+/* insert the new object 'o' to the reflist at previously
+ * allocated index 'idx'.
+ * 'o' can be NULL, in which case nothing is done.
+ * if 'o' was non-NULL, and the function succeeds, 'o' is returned.
+ * if 'o' was non-NULL, and the function fails, 'o' is released and
+ * NULL returned. This simplifies error checking at the call site since
+ * a single test for NULL for the function result is enough.
+ */
+static PyObject *
+r_ref_insert(PyObject *o, Py_ssize_t idx, int flag, RFILE *p)
+{
+    if (o != NULL && flag) { /* currently only FLAG_REF is defined */
+        Py_INCREF(o);
+        if (PyList_SetItem(p->refs, idx, o) < 0) {
+            Py_DECREF(o); /* release the new object */
+            return NULL;
+        }
+    }
+    return o;
+}
+
+/* combination of both above, used when an object can be
+ * created whenever it is seen in the file, as opposed to
+ * after having loaded its sub-objects.
+ */
+static PyObject *
+r_ref(PyObject *o, int flag, RFILE *p)
+{
+    if (o != NULL && flag) { /* currently only FLAG_REF is defined */
+        if (PyList_Append(p->refs, o) < 0) {
+            Py_DECREF(o); /* release the new object */
+            return NULL;
+        }
+    }
+    return o;
+}
+
+#define R_REF(O) do {\
+    if (flag) \
+        O = r_ref(O, flag, p);\
+} while (0)
 
 static PyObject *
 r_object(RFILE *p)
@@ -675,9 +848,18 @@ r_object(RFILE *p)
        an exception is set. */
     PyObject *v, *v2;
     long i, n;
-    int type = r_byte(p);
+    int code = r_byte(p);
+    int type, flag = 0;
+    Py_ssize_t idx = 0;
     PyObject *retval;
 
+    if (code == EOF)
+        type = EOF;
+    else {
+        flag = code & FLAG_REF;
+        type = code & ~FLAG_REF;
+    }
+
     p->depth++;
 
     if (p->depth > MAX_MARSHAL_STACK_DEPTH) {
@@ -726,14 +908,17 @@ r_object(RFILE *p)
     case TYPE_INT:
         n = r_long(p);
         retval = PyErr_Occurred() ? NULL : PyLong_FromLong(n);
+        R_REF(retval);
         break;
 
     case TYPE_INT64:
         retval = r_long64(p);
+        R_REF(retval);
         break;
 
     case TYPE_LONG:
         retval = r_PyLong(p);
+        R_REF(retval);
         break;
 
     case TYPE_FLOAT:
@@ -754,6 +939,7 @@ r_object(RFILE *p)
             if (dx == -1.0 && PyErr_Occurred())
                 break;
             retval = PyFloat_FromDouble(dx);
+            R_REF(retval);
             break;
         }
 
@@ -771,6 +957,7 @@ r_object(RFILE *p)
                 break;
             }
             retval = PyFloat_FromDouble(x);
+            R_REF(retval);
             break;
         }
 
@@ -804,6 +991,7 @@ r_object(RFILE *p)
             if (c.imag == -1.0 && PyErr_Occurred())
                 break;
             retval = PyComplex_FromCComplex(c);
+            R_REF(retval);
             break;
         }
 
@@ -830,6 +1018,7 @@ r_object(RFILE *p)
                 break;
             }
             retval = PyComplex_FromCComplex(c);
+            R_REF(retval);
             break;
         }
 
@@ -855,11 +1044,14 @@ r_object(RFILE *p)
             break;
         }
         retval = v;
+        R_REF(retval);
         break;
 
     case TYPE_UNICODE:
+    case TYPE_INTERNED:
         {
         char *buffer;
+        const char *inplace;
 
         n = r_long(p);
         if (PyErr_Occurred()) {
@@ -871,19 +1063,33 @@ r_object(RFILE *p)
             retval = NULL;
             break;
         }
-        buffer = PyMem_NEW(char, n);
-        if (buffer == NULL) {
-            retval = PyErr_NoMemory();
-            break;
+        inplace = r_string_inplace(n, p);
+        if (inplace != NULL) {
+            /* decode straight from the input, without a temporary copy */
+            v = PyUnicode_DecodeUTF8(inplace, n, "surrogatepass");
         }
-        if (r_string(buffer, n, p) != n) {
-            PyMem_DEL(buffer);
+        else if (PyErr_Occurred()) {
             retval = NULL;
             break;
         }
-        v = PyUnicode_DecodeUTF8(buffer, n, "surrogatepass");
-        PyMem_DEL(buffer);
+        else {
+            buffer = PyMem_NEW(char, n);
+            if (buffer == NULL) {
+                retval = PyErr_NoMemory();
+                break;
+            }
+            if (r_string(buffer, n, p) != n) {
+                PyMem_DEL(buffer);
+                retval = NULL;
+                break;
+            }
+            v = PyUnicode_DecodeUTF8(buffer, n, "surrogatepass");
+            PyMem_DEL(buffer);
+        }
+        if (v != NULL && type == TYPE_INTERNED)
+            PyUnicode_InternInPlace(&v);
         retval = v;
+        R_REF(retval);
         break;
         }
 
@@ -899,6 +1105,7 @@ r_object(RFILE *p)
             break;
         }
         v = PyTuple_New(n);
+        R_REF(v);
         if (v == NULL) {
             retval = NULL;
             break;
@@ -930,6 +1137,7 @@ r_object(RFILE *p)
             break;
         }
         v = PyList_New(n);
+        R_REF(v);
         if (v == NULL) {
             retval = NULL;
             break;
@@ -951,6 +1159,7 @@ r_object(RFILE *p)
 
     case TYPE_DICT:
         v = PyDict_New();
+        R_REF(v);
         if (v == NULL) {
             retval = NULL;
             break;
@@ -986,6 +1195,16 @@ r_object(RFILE *p)
             break;
         }
         v = (type == TYPE_SET) ? PySet_New(NULL) : PyFrozenSet_New(NULL);
+        if (type == TYPE_SET) {
+            R_REF(v);
+        } else {
+            /* must use delayed registration of frozensets because they must
+             * be init with a refcount of 1
+             */
+            idx = r_ref_reserve(flag, p);
+            if (idx < 0)
+                Py_CLEAR(v); /* signal error */
+        }
         if (v == NULL) {
             retval = NULL;
             break;
@@ -1008,6 +1227,8 @@ r_object(RFILE *p)
             }
             Py_DECREF(v2);
         }
+        if (type != TYPE_SET)
+            v = r_ref_insert(v, idx, flag, p);
         retval = v;
         break;
 
@@ -1029,6 +1250,12 @@ r_object(RFILE *p)
             int firstlineno;
             PyObject *lnotab = NULL;
 
+            idx = r_ref_reserve(flag, p);
+            if (idx < 0) {
+                retval = NULL;
+                break;
+            }
+
             v = NULL;
 
             /* XXX ignore long->int overflows for now */
@@ -1094,6 +1321,7 @@ r_object(RFILE *p)
                             code, consts, names, varnames,
                             freevars, cellvars, filename, name,
                             firstlineno, lnotab);
+            v = r_ref_insert(v, idx, flag, p);
 
           code_error:
             Py_XDECREF(code);
@@ -1109,6 +1337,26 @@ r_object(RFILE *p)
         retval = v;
         break;
 
+    case TYPE_REF:
+        n = r_long(p);
+        if (n < 0 || n >= PyList_GET_SIZE(p->refs)) {
+            if (!PyErr_Occurred())
+                PyErr_SetString(PyExc_ValueError,
+                                "bad marshal data (invalid reference)");
+            retval = NULL;
+            break;
+        }
+        v = PyList_GET_ITEM(p->refs, n);
+        if (v == Py_None) {
+            PyErr_SetString(PyExc_ValueError,
+                            "bad marshal data (invalid reference)");
+            retval = NULL;
+            break;
+        }
+        Py_INCREF(v);
+        retval = v;
+        break;
+
     default:
         /* Bogus data got written, which isn't ideal.
            This will let you keep working and recover. */
@@ -1171,9 +1419,35 @@ getfilesize(FILE *fp)
 }
 #endif
 
+#ifdef USE_MMAP_FOR_LAST_OBJECT
+/* Map the whole file and unmarshal the remainder straight from the mapping.
+   Return NULL without an exception set if the file can't be mapped. */
+static PyObject *
+read_last_object_mapped(FILE *fp, off_t filesize)
+{
+    PyObject *v;
+    char *map;
+    long offset = ftell(fp);
+
+    if (offset < 0 || offset > filesize)
+        return NULL;
+    map = mmap(NULL, (size_t)filesize, PROT_READ, MAP_PRIVATE,
+               fileno(fp), 0);
+    if (map == MAP_FAILED)
+        return NULL;
+    v = PyMarshal_ReadObjectFromString(map + offset, filesize - offset);
+    munmap(map, (size_t)filesize);
+    if (v == NULL && !PyErr_Occurred())
+        PyErr_SetString(PyExc_TypeError,
+                        "NULL object in marshal data for object");
+    return v;
+}
+#endif
+
 /* If we can get the size of the file up-front, and it's reasonably small,
  * read it in one gulp and delegate to ...FromString() instead.  Much quicker
- * than reading a byte at a time from file; speeds .pyc imports.
+ * than reading a byte at a time from file; speeds .pyc imports.  Larger
+ * files are mapped into memory if possible and unmarshalled in place.
  * CAUTION:  since this may read the entire remainder of the file, don't
  * call it unless you know you're done with the file.
  */
@@ -1195,6 +1469,13 @@ PyMarshal_ReadLastObjectFromFile(FILE *fp)
         }
 
     }
+#ifdef USE_MMAP_FOR_LAST_OBJECT
+    else if (filesize > REASONABLE_FILE_LIMIT) {
+        PyObject *v = read_last_object_mapped(fp, filesize);
+        if (v != NULL || PyErr_Occurred())
+            return v;
+    }
+#endif
 #endif
     /* We don't have fstat, or we do but the file is larger than
      * REASONABLE_FILE_LIMIT or malloc failed -- read a byte at a time.
@@ -1214,7 +1495,11 @@ PyMarshal_ReadObjectFromFile(FILE *fp)
     rf.current_filename = NULL;
     rf.depth = 0;
     rf.ptr = rf.end = NULL;
+    rf.refs = PyList_New(0);
+    if (rf.refs == NULL)
+        return NULL;
     result = r_object(&rf);
+    Py_DECREF(rf.refs);
     return result;
 }
 
@@ -1229,7 +1514,11 @@ PyMarshal_ReadObjectFromString(char *str, Py_ssize_t len)
     rf.ptr = str;
     rf.end = str + len;
     rf.depth = 0;
+    rf.refs = PyList_New(0);
+    if (rf.refs == NULL)
+        return NULL;
     result = r_object(&rf);
+    Py_DECREF(rf.refs);
     return result;
 }
 
@@ -1248,7 +1537,16 @@ PyMarshal_WriteObjectToString(PyObject *x, int version)
     wf.error = WFERR_OK;
     wf.depth = 0;
     wf.version = version;
+    if (version >= 3) {
+        if ((wf.refs = PyDict_New()) == NULL) {
+            Py_DECREF(wf.str);
+            return NULL;
+        }
+    }
+    else
+        wf.refs = NULL;
     w_object(x, &wf);
+    Py_XDECREF(wf.refs);
     if (wf.str != NULL) {
         char *base = PyBytes_AS_STRING((PyBytesObject *)wf.str);
         if (wf.ptr - base > PY_SSIZE_T_MAX) {
@@ -1335,7 +1633,12 @@ marshal_load(PyObject *self, PyObject *f)
         rf.fp = NULL;
         rf.readable = f;
         rf.current_filename = NULL;
-        result = read_object(&rf);
+        if ((rf.refs = PyList_New(0)) != NULL) {
+            result = read_object(&rf);
+            Py_DECREF(rf.refs);
+        }
+        else
+            result = NULL;
     }
     Py_DECREF(data);
     return result;
@@ -1392,7 +1695,12 @@ marshal_loads(PyObject *self, PyObject *args)
     rf.ptr = s;
     rf.end = s + n;
     rf.depth = 0;
+    if ((rf.refs = PyList_New(0)) == NULL) {
+        PyBuffer_Release(&p);
+        return NULL;
+    }
     result = read_object(&rf);
+    Py_DECREF(rf.refs);
     PyBuffer_Release(&p);
     return result;
 }
@@ -1404,11 +1712,146 @@ Convert the bytes object to a value. If no valid value is found, raise\n\
 EOFError, ValueError or TypeError. Extra characters in the input are\n\
 ignored.");
 
+#ifdef USE_MAPPED_FILE
+/* A read-only mapping of a whole file, exported through the buffer
+   protocol.  The file is unmapped when the last view on it is released. */
+typedef struct {
+    PyObject_HEAD
+    char *map;
+    Py_ssize_t size;
+} MappedFileObject;
+
+static void
+mappedfile_dealloc(MappedFileObject *self)
+{
+#ifdef MS_WINDOWS
+    UnmapViewOfFile(self->map);
+#else
+    munmap(self->map, (size_t)self->size);
+#endif
+    PyObject_Del(self);
+}
+
+static int
+mappedfile_getbuffer(MappedFileObject *self, Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *)self, self->map, self->size,
+                             1, flags);
+}
+
+static PyBufferProcs mappedfile_as_buffer = {
+    (getbufferproc)mappedfile_getbuffer,
+    NULL,
+};
+
+static PyTypeObject MappedFile_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "marshal.mappedfile",                       /* tp_name */
+    sizeof(MappedFileObject),                   /* tp_basicsize */
+    0,                                          /* tp_itemsize */
+    (destructor)mappedfile_dealloc,             /* tp_dealloc */
+    0,                                          /* tp_print */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_reserved */
+    0,                                          /* tp_repr */
+    0,                                          /* tp_as_number */
+    0,                                          /* tp_as_sequence */
+    0,                                          /* tp_as_mapping */
+    0,                                          /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    0,                                          /* tp_getattro */
+    0,                                          /* tp_setattro */
+    &mappedfile_as_buffer,                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                         /* tp_flags */
+};
+
+static PyObject *
+marshal_map_file(PyObject *self, PyObject *args)
+{
+    MappedFileObject *mf;
+    PyObject *view;
+    char *map;
+    Py_ssize_t size;
+    int fd;
+#ifdef MS_WINDOWS
+    HANDLE fh, mh;
+    LARGE_INTEGER st_size;
+#else
+    struct stat st;
+#endif
+
+    if (!PyArg_ParseTuple(args, "i:_map_file", &fd))
+        return NULL;
+#ifdef MS_WINDOWS
+    fh = (HANDLE)_get_osfhandle(fd);
+    if (fh == INVALID_HANDLE_VALUE) {
+        errno = EBADF;
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    if (!GetFileSizeEx(fh, &st_size))
+        return PyErr_SetFromWindowsErr(0);
+    if (st_size.QuadPart > PY_SSIZE_T_MAX)
+        return PyErr_NoMemory();
+    size = (Py_ssize_t)st_size.QuadPart;
+    /* Empty files can't be mapped. */
+    if (size == 0)
+        return PyBytes_FromStringAndSize(NULL, 0);
+    mh = CreateFileMapping(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mh == NULL)
+        return PyErr_SetFromWindowsErr(0);
+    map = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    /* The view keeps the mapping alive. */
+    CloseHandle(mh);
+    if (map == NULL)
+        return PyErr_SetFromWindowsErr(0);
+#else
+    if (fstat(fd, &st) != 0)
+        return PyErr_SetFromErrno(PyExc_OSError);
+    if (st.st_size > PY_SSIZE_T_MAX)
+        return PyErr_NoMemory();
+    size = (Py_ssize_t)st.st_size;
+    if (size == 0)
+        return PyBytes_FromStringAndSize(NULL, 0);
+    map = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        return PyErr_SetFromErrno(PyExc_OSError);
+#endif
+
+    mf = PyObject_New(MappedFileObject, &MappedFile_Type);
+    if (mf == NULL) {
+#ifdef MS_WINDOWS
+        UnmapViewOfFile(map);
+#else
+        munmap(map, (size_t)size);
+#endif
+        return NULL;
+    }
+    mf->map = map;
+    mf->size = size;
+    view = PyMemoryView_FromObject((PyObject *)mf);
+    Py_DECREF(mf);
+    return view;
+}
+
+PyDoc_STRVAR(map_file_doc,
+"_map_file(fd) -> memoryview\n\
+\n\
+Map the whole file open on fd read-only and return a view of it, which\n\
+loads() can unmarshal in place.  The import system uses this for .pyc\n\
+files, which are replaced by renaming rather than rewritten in place.\n\
+Raise OSError if the file can't be mapped.");
+#endif
+
 static PyMethodDef marshal_methods[] = {
     {"dump",            marshal_dump,   METH_VARARGS,   dump_doc},
     {"load",            marshal_load,   METH_O,         load_doc},
     {"dumps",           marshal_dumps,  METH_VARARGS,   dumps_doc},
     {"loads",           marshal_loads,  METH_VARARGS,   loads_doc},
+#ifdef USE_MAPPED_FILE
+    {"_map_file",       marshal_map_file, METH_VARARGS, map_file_doc},
+#endif
     {NULL,              NULL}           /* sentinel */
 };
 
@@ -1432,7 +1875,9 @@ Variables:\n\
 \n\
 version -- indicates the format that the module uses. Version 0 is the\n\
     historical format, version 1 shares interned strings and version 2\n\
-    uses a binary format for floating point numbers.\n\
+    uses a binary format for floating point numbers.  Version 3 writes\n\
+    repeated objects once and refers back to them, and keeps strings\n\
+    interned.\n\
 \n\
 Functions:\n\
 \n\
@@ -1458,7 +1903,13 @@ static struct PyModuleDef marshalmodule = {
 PyMODINIT_FUNC
 PyMarshal_Init(void)
 {
-    PyObject *mod = PyModule_Create(&marshalmodule);
+    PyObject *mod;
+
+#ifdef USE_MAPPED_FILE
+    if (PyType_Ready(&MappedFile_Type) < 0)
+        return NULL;
+#endif
+    mod = PyModule_Create(&marshalmodule);
     if (mod == NULL)
         return NULL;
     PyModule_AddIntConstant(mod, "version", Py_MARSHAL_VERSION);
@@ -147,10 +147,10 @@ static void *opcode_targets[256] = {
     &&TARGET_LIST_APPEND,
     &&TARGET_SET_ADD,
     &&TARGET_MAP_ADD,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
+    &&TARGET_LOAD_FAST_LOAD_FAST,
+    &&TARGET_LOAD_FAST_LOAD_ATTR,
+    &&TARGET_COMPARE_OP_POP_JUMP_IF_FALSE,
+    &&TARGET_LOAD_CONST_RETURN_VALUE,
     &&_unknown_opcode,
     &&_unknown_opcode,
     &&_unknown_opcode,
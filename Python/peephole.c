@@ -358,6 +358,78 @@ load_global(unsigned char *codestr, Py_ssize_t i, char *name, PyObject *consts)
     return 1;
 }
 
+/* Replace the first instruction of common pairs with a superinstruction
+   that also does the work of the second one (see ceval.c).  The second
+   instruction is left in place, so jumps to it keep working, and the
+   code size and line number table don't change.  Pairs split by a line
+   boundary are left alone so that line tracing still sees every line.
+   Returns 0 on success, -1 with an exception set on error. */
+static int
+fuse_pairs(unsigned char *codestr, Py_ssize_t codelen,
+           unsigned char *lineno, Py_ssize_t tabsiz)
+{
+    Py_ssize_t i, addr;
+    int opcode;
+    unsigned char *linestarts;
+
+    linestarts = (unsigned char *)PyMem_Malloc(codelen);
+    if (linestarts == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(linestarts, 0, codelen);
+    for (i = 0, addr = 0; i < tabsiz; i += 2) {
+        addr += lineno[i];
+        if (addr < codelen)
+            linestarts[addr] = 1;
+    }
+    for (i = 0; i + 3 < codelen; i += CODESIZE(codestr[i])) {
+        if (linestarts[i + 3])
+            continue;
+        opcode = codestr[i + 3];
+        switch (codestr[i]) {
+            case LOAD_FAST:
+                if (opcode == LOAD_FAST)
+                    codestr[i] = LOAD_FAST_LOAD_FAST;
+                else if (opcode == LOAD_ATTR)
+                    codestr[i] = LOAD_FAST_LOAD_ATTR;
+                break;
+            case COMPARE_OP:
+                if (opcode == POP_JUMP_IF_FALSE)
+                    codestr[i] = COMPARE_OP_POP_JUMP_IF_FALSE;
+                break;
+            case LOAD_CONST:
+                if (opcode == RETURN_VALUE)
+                    codestr[i] = LOAD_CONST_RETURN_VALUE;
+                break;
+        }
+    }
+    PyMem_Free(linestarts);
+    return 0;
+}
+
+/* Apply fuse_pairs() to a copy of code the other optimizations gave up
+   on.  Returns a new reference; on error, to code itself. */
+static PyObject *
+fuse_code(PyObject *code, PyObject *lineno_obj)
+{
+    PyObject *fused;
+
+    fused = PyBytes_FromStringAndSize(PyBytes_AS_STRING(code),
+                                      PyBytes_GET_SIZE(code));
+    if (fused == NULL ||
+        fuse_pairs((unsigned char *)PyBytes_AS_STRING(fused),
+                   PyBytes_GET_SIZE(fused),
+                   (unsigned char *)PyBytes_AS_STRING(lineno_obj),
+                   PyBytes_GET_SIZE(lineno_obj)) < 0) {
+        PyErr_Clear();
+        Py_XDECREF(fused);
+        Py_INCREF(code);
+        return code;
+    }
+    return fused;
+}
+
 /* Perform basic peephole optimizations to components of a code object.
    The consts object should still be in list form to allow new constants
    to be appended.
@@ -373,7 +445,8 @@ load_global(unsigned char *codestr, Py_ssize_t i, char *name, PyObject *consts)
    single basic block.  All transformations keep the code size the same or
    smaller.  For those that reduce size, the gaps are initially filled with
    NOPs.  Later those NOPs are removed and the jump addresses retargeted in
-   a single pass.  Line numbering is adjusted accordingly. */
+   a single pass.  Line numbering is adjusted accordingly.  Finally, common
+   pairs of instructions are fused into superinstructions. */
 
 PyObject *
 PyCode_Optimize(PyObject *code, PyObject* consts, PyObject *names,
@@ -749,6 +822,9 @@ PyCode_Optimize(PyObject *code, PyObject* consts, PyObject *names,
     }
     assert(h + nops == codelen);
 
+    if (fuse_pairs(codestr, h, lineno, tabsiz) < 0)
+        goto exitError;
+
     code = PyBytes_FromStringAndSize((char *)codestr, h);
     CONST_STACK_DELETE();
     PyMem_Free(addrmap);
@@ -767,6 +843,7 @@ PyCode_Optimize(PyObject *code, PyObject* consts, PyObject *names,
         PyMem_Free(addrmap);
     if (codestr != NULL)
         PyMem_Free(codestr);
-    Py_XINCREF(code);
-    return code;
+    if (code != NULL)
+        return fuse_code(code, lineno_obj);
+    return NULL;
 }
@@ -526,6 +526,56 @@ PyDoc_STRVAR(getcheckinterval_doc,
 "getcheckinterval() -> current check interval; see setcheckinterval()."
 );
 
+static PyObject *
+sys_setopcodeprofile(PyObject *self, PyObject *args)
+{
+    int on;
+    if (!PyArg_ParseTuple(args, "p:setopcodeprofile", &on))
+        return NULL;
+    _PyEval_SetOpcodeProfile(on);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(setopcodeprofile_doc,
+"setopcodeprofile(flag)\n\
+\n\
+Turn counting of executed opcodes on or off.  While it is on, the\n\
+totals and the opcode pairs are gathered for getdxp(), and each code\n\
+object keeps its own totals for getopcodecounts()."
+);
+
+static PyObject *
+sys_getopcodeprofile(PyObject *self, PyObject *args)
+{
+    return PyBool_FromLong(_PyEval_GetOpcodeProfile());
+}
+
+PyDoc_STRVAR(getopcodeprofile_doc,
+"getopcodeprofile() -> True if opcodes are being counted; see\n\
+setopcodeprofile()."
+);
+
+static PyObject *
+sys_getopcodecounts(PyObject *self, PyObject *code)
+{
+    return _PyEval_GetOpcodeCounts(code);
+}
+
+PyDoc_STRVAR(getopcodecounts_doc,
+"getopcodecounts(code) -> list of 256 ints or None\n\
+\n\
+Return how often each opcode of the code object has run while\n\
+setopcodeprofile() was on, or None if it hasn't run at all then."
+);
+
+PyDoc_STRVAR(getdxp_doc,
+"getdxp() -> list of 257 lists of 256 ints\n\
+\n\
+Return the opcode pairs counted since the last call while\n\
+setopcodeprofile() was on, and reset them.  Item [i][j] is the number\n\
+of times opcode j followed opcode i; item [256] holds the totals."
+);
+
 #ifdef WITH_THREAD
 static PyObject *
 sys_setswitchinterval(PyObject *self, PyObject *args)
@@ -1026,10 +1076,8 @@ checks.\n\
 extern PyObject *_Py_GetObjects(PyObject *, PyObject *);
 #endif
 
-#ifdef DYNAMIC_EXECUTION_PROFILE
 /* Defined in ceval.c because it uses static globals if that file */
 extern PyObject *_Py_GetDXProfile(PyObject *,  PyObject *);
-#endif
 
 #ifdef __cplusplus
 }
@@ -1046,6 +1094,39 @@ PyDoc_STRVAR(sys_clear_type_cache__doc__,
 "_clear_type_cache() -> None\n\
 Clear the internal type lookup cache.");
 
+static PyObject *
+sys_setparallelsort(PyObject *self, PyObject *args)
+{
+    int nthreads;
+    Py_ssize_t min_size;
+
+    if (!PyArg_ParseTuple(args, "in:_setparallelsort", &nthreads, &min_size))
+        return NULL;
+    if (_PyList_SetParallelSort(nthreads, min_size) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(sys_setparallelsort__doc__,
+"_setparallelsort(nthreads, min_size) -> None\n\
+Sort lists of at least min_size items with nthreads threads when their\n\
+keys allow it; nthreads=0 uses one thread per CPU and 1 never sorts in\n\
+parallel.  Meant for testing and tuning.");
+
+static PyObject *
+sys_getparallelsort(PyObject *self)
+{
+    int nthreads;
+    Py_ssize_t min_size;
+
+    _PyList_GetParallelSort(&nthreads, &min_size);
+    return Py_BuildValue("(in)", nthreads, min_size);
+}
+
+PyDoc_STRVAR(sys_getparallelsort__doc__,
+"_getparallelsort() -> (nthreads, min_size)\n\
+Return the settings made by _setparallelsort().");
+
 
 static PyMethodDef sys_methods[] = {
     /* Might as well keep this in alphabetic order */
@@ -1068,9 +1149,7 @@ static PyMethodDef sys_methods[] = {
 #ifdef COUNT_ALLOCS
     {"getcounts",       (PyCFunction)sys_getcounts, METH_NOARGS},
 #endif
-#ifdef DYNAMIC_EXECUTION_PROFILE
-    {"getdxp",          _Py_GetDXProfile, METH_VARARGS},
-#endif
+    {"getdxp",          _Py_GetDXProfile, METH_NOARGS, getdxp_doc},
     {"getfilesystemencoding", (PyCFunction)sys_getfilesystemencoding,
      METH_NOARGS, getfilesystemencoding_doc},
 #ifdef Py_TRACE_REFS
@@ -1097,6 +1176,16 @@ static PyMethodDef sys_methods[] = {
      setcheckinterval_doc},
     {"getcheckinterval",        sys_getcheckinterval, METH_NOARGS,
      getcheckinterval_doc},
+    {"setopcodeprofile",        sys_setopcodeprofile, METH_VARARGS,
+     setopcodeprofile_doc},
+    {"getopcodeprofile",        sys_getopcodeprofile, METH_NOARGS,
+     getopcodeprofile_doc},
+    {"getopcodecounts",         sys_getopcodecounts, METH_O,
+     getopcodecounts_doc},
+    {"_setparallelsort",        sys_setparallelsort, METH_VARARGS,
+     sys_setparallelsort__doc__},
+    {"_getparallelsort",        (PyCFunction)sys_getparallelsort, METH_NOARGS,
+     sys_getparallelsort__doc__},
 #ifdef WITH_THREAD
     {"setswitchinterval",       sys_setswitchinterval, METH_VARARGS,
      setswitchinterval_doc},
@@ -1320,6 +1409,8 @@ excepthook() -- print an exception and its traceback to sys.stderr\n\
 exc_info() -- return thread-safe information about the current exception\n\
 exit() -- exit the interpreter by raising SystemExit\n\
 getdlopenflags() -- returns flags to be used for dlopen() calls\n\
+getdxp() -- return and reset the counted opcode pairs\n\
+getopcodecounts() -- return the counted opcodes of a code object\n\
 getprofile() -- get the global profiling function\n\
 getrefcount() -- return the reference count for an object (plus one :-)\n\
 getrecursionlimit() -- return the max recursion depth for the interpreter\n\
@@ -1327,6 +1418,7 @@ getsizeof() -- return the size of an object in bytes\n\
 gettrace() -- get the global debug tracing function\n\
 setcheckinterval() -- control how often the interpreter checks for events\n\
 setdlopenflags() -- set the flags to be used for dlopen() calls\n\
+setopcodeprofile() -- turn counting of executed opcodes on or off\n\
 setprofile() -- set the global profiling function\n\
 setrecursionlimit() -- set the max recursion depth for the interpreter\n\
 settrace() -- set the global debug tracing function\n\
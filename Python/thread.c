@@ -124,6 +124,27 @@ PyThread_set_stacksize(size_t size)
 #endif
 }
 
+/* Return the number of online logical CPUs, or 1 if it can't be
+   determined.  Used to size pools of helper threads. */
+int
+_PyThread_cpu_count(void)
+{
+    static int ncpu = 0;
+
+    if (ncpu == 0) {
+#ifdef MS_WINDOWS
+        SYSTEM_INFO sysinfo;
+        GetSystemInfo(&sysinfo);
+        ncpu = (int)sysinfo.dwNumberOfProcessors;
+#elif defined(HAVE_SYSCONF) && defined(_SC_NPROCESSORS_ONLN)
+        ncpu = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (ncpu < 1)
+            ncpu = 1;
+    }
+    return ncpu;
+}
+
 #ifndef Py_HAVE_NATIVE_TLS
 /* If the platform has not supplied a platform specific
    TLS implementation, provide our own.
@@ -1,13 +1,10 @@
 """
-Some helper functions to analyze the output of sys.getdxp() (which is
-only available if Python was built with -DDYNAMIC_EXECUTION_PROFILE).
-These will tell you which opcodes have been executed most frequently
-in the current process, and, if Python was also built with -DDXPAIRS,
-will tell you which instruction _pairs_ were executed most frequently,
-which may help in choosing new instructions.
-
-If Python was built without -DDYNAMIC_EXECUTION_PROFILE, importing
-this module will raise a RuntimeError.
+Some helper functions to analyze the output of sys.getdxp(), which
+counts opcodes while sys.setopcodeprofile() is on.  Importing this
+module turns the counting on.  These will tell you which opcodes have
+been executed most frequently in the current process, and which
+instruction _pairs_ were executed most frequently, which may help in
+choosing new instructions.
 
 If you're running a script you want to profile, a simple way to get
 the common pairs is:
@@ -18,6 +15,8 @@ $ PYTHONPATH=$PYTHONPATH:<python_srcdir>/Tools/scripts \
 > from analyze_dxp import *
 > s = render_common_pairs()
 > open('/tmp/some_file', 'w').write(s)
+
+For the opcodes run by a single function, see sys.getopcodecounts().
 """
 
 import copy
@@ -26,19 +25,17 @@ import operator
 import sys
 import threading
 
-if not hasattr(sys, "getdxp"):
-    raise RuntimeError("Can't import analyze_dxp: Python built without"
-                       " -DDYNAMIC_EXECUTION_PROFILE.")
+sys.setopcodeprofile(True)
 
 
 _profile_lock = threading.RLock()
 _cumulative_profile = sys.getdxp()
 
-# If Python was built with -DDXPAIRS, sys.getdxp() returns a list of
-# lists of ints.  Otherwise it returns just a list of ints.
+# sys.getdxp() returns a list of lists of ints.  Pythons built with the
+# old -DDYNAMIC_EXECUTION_PROFILE but without -DDXPAIRS returned just a
+# list of ints.
 def has_pairs(profile):
-    """Returns True if the Python that produced the argument profile
-    was built with -DDXPAIRS."""
+    """Returns True if the argument profile includes opcode pairs."""
 
     return len(profile) > 0 and isinstance(profile[0], list)
 
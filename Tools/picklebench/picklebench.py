@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Benchmark pickling and unpickling of representative object graphs.
+
+The graphs are chosen to stress different parts of the pickler: atoms that
+never go through the memo, many small memoized objects, records, nested
+containers, instances and shared references.  Every benchmark reports the
+best time out of several runs, for both dump() and load().
+"""
+
+import argparse
+import gc
+import io
+import pickle
+import sys
+import time
+
+
+class Point:
+
+    def __init__(self, x, y, label):
+        self.x = x
+        self.y = y
+        self.label = label
+
+
+def ints(n):
+    """list of ints"""
+    return list(range(-n // 2, n // 2))
+
+def floats(n):
+    """list of floats"""
+    return [i * 0.5 for i in range(n)]
+
+def short_strs(n):
+    """list of short distinct strs"""
+    return ['item%d' % i for i in range(n)]
+
+def repeated_strs(n):
+    """list of a few short strs, repeated"""
+    words = ['alpha', 'beta', 'gamma', 'delta', 'epsilon']
+    return [words[i % len(words)] for i in range(n)]
+
+def records(n):
+    """list of (int, str, float) tuples"""
+    return [(i, 'name%d' % i, i / 3.0) for i in range(n)]
+
+def str_dict(n):
+    """dict of str -> small list"""
+    return {'key%d' % i: [i, i + 1] for i in range(n)}
+
+def tree(n):
+    """nested lists, four children per node"""
+    def build(size):
+        if size <= 4:
+            return list(range(size))
+        quarter = size // 4
+        return [build(quarter) for i in range(4)]
+    return build(n)
+
+def instances(n):
+    """list of instances with a __dict__"""
+    return [Point(i, -i, 'p%d' % i) for i in range(n)]
+
+def shared(n):
+    """list of refs to 256 shared lists"""
+    pool = [[i] for i in range(256)]
+    return [pool[i % len(pool)] for i in range(n)]
+
+def large_bytes(n):
+    """a few large bytes objects"""
+    return [bytes(n * 8) for i in range(4)]
+
+
+BENCHMARKS = [ints, floats, short_strs, repeated_strs, records, str_dict,
+              tree, instances, shared, large_bytes]
+
+
+def best_time(func, repeat):
+    times = []
+    for i in range(repeat):
+        gc.collect()
+        t0 = time.perf_counter()
+        func()
+        times.append(time.perf_counter() - t0)
+    return min(times)
+
+
+def run(args):
+    if args.pure:
+        pickler, unpickler = pickle._Pickler, pickle._Unpickler
+    else:
+        pickler, unpickler = pickle.Pickler, pickle.Unpickler
+    kwargs = {}
+    if not args.memoize_atoms:
+        kwargs['memoize_atoms'] = False
+
+    def dump(obj):
+        f = io.BytesIO()
+        pickler(f, args.protocol, **kwargs).dump(obj)
+        return f.getvalue()
+
+    def load(data):
+        return unpickler(io.BytesIO(data)).load()
+
+    print("Python %s" % sys.version.split()[0])
+    print("protocol %d, %s, %d objects per graph%s" % (
+          args.protocol, 'pure Python' if args.pure else 'C accelerator',
+          args.size, '' if args.memoize_atoms else ', atoms not memoized'))
+    print()
+    print("%-40s %10s %10s %10s" % ('graph', 'size', 'dump', 'load'))
+    for bench in BENCHMARKS:
+        if args.benchmarks and bench.__name__ not in args.benchmarks:
+            continue
+        obj = bench(args.size)
+        data = dump(obj)
+        assert load(data) is not None
+        dump_time = best_time(lambda: dump(obj), args.repeat)
+        load_time = best_time(lambda: load(data), args.repeat)
+        print("%-40s %10d %8.1fms %8.1fms" % (
+              bench.__doc__, len(data), dump_time * 1e3, load_time * 1e3))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('benchmarks', nargs='*', metavar='benchmark',
+                        help="benchmarks to run (default: all of %s)" %
+                        ', '.join(b.__name__ for b in BENCHMARKS))
+    parser.add_argument('-p', '--protocol', type=int,
+                        default=pickle.HIGHEST_PROTOCOL,
+                        help="pickle protocol (default: %(default)s)")
+    parser.add_argument('-n', '--size', type=int, default=100000,
+                        help="objects per graph (default: %(default)s)")
+    parser.add_argument('-r', '--repeat', type=int, default=5,
+                        help="runs per measurement (default: %(default)s)")
+    parser.add_argument('--pure', action='store_true',
+                        help="use the pure Python pickle implementation")
+    parser.add_argument('--no-memoize-atoms', dest='memoize_atoms',
+                        action='store_false',
+                        help="don't memoize short str and bytes objects")
+    run(parser.parse_args())
+
+
+if __name__ == '__main__':
+    main()
@@ -1389,6 +1389,72 @@ def upper_conversion_dense(STR):
     for x in _RANGE_1000:
         s_upper()
 
+####### codecs
+
+# The bytes column times decoding and the unicode column times encoding.
+
+_CODEC_ASCII_TEXT = b"Where in the world is Carmen San Deigo? " * 250
+_CODEC_LATIN1_TEXT = (b"Caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9e, "
+                      b"s'il vous pla\xc3\xaet, merci. " * 250)
+_CODEC_BMP_TEXT = (b"\xd0\x93\xd0\xb4\xd0\xb5 \xd0\xb2 \xd0\xbc\xd0\xb8\xd1"
+                   b"\x80\xd0\xb5 \xd0\x9a\xd0\xb0\xd1\x80\xd0\xbc\xd0\xb5"
+                   b"\xd0\xbd \xd0\xa1\xd0\xb0\xd0\xbd-\xd0\x94\xd0\xb8\xd0"
+                   b"\xb5\xd0\xb3\xd0\xbe? " * 250)
+
+def _codec_bench(STR, utf8_text, encoding):
+    text = utf8_text.decode("utf-8")
+    if STR is BYTES:
+        f = text.encode(encoding).decode
+    else:
+        f = text.encode
+    for x in _RANGE_100:
+        f(encoding)
+
+@bench('ASCII text (10KB) decode / encode "utf-8"',
+       "codecs -- ASCII text", 100)
+def codec_utf8_ascii(STR):
+    _codec_bench(STR, _CODEC_ASCII_TEXT, "utf-8")
+
+@bench('ASCII text (10KB) decode / encode "ascii"',
+       "codecs -- ASCII text", 100)
+def codec_ascii_ascii(STR):
+    _codec_bench(STR, _CODEC_ASCII_TEXT, "ascii")
+
+@bench('ASCII text (10KB) decode / encode "latin-1"',
+       "codecs -- ASCII text", 100)
+def codec_latin1_ascii(STR):
+    _codec_bench(STR, _CODEC_ASCII_TEXT, "latin-1")
+
+@bench('ASCII text (10KB) decode / encode "utf-16-le"',
+       "codecs -- ASCII text", 100)
+def codec_utf16_ascii(STR):
+    _codec_bench(STR, _CODEC_ASCII_TEXT, "utf-16-le")
+
+@bench('French text (10KB) decode / encode "utf-8"',
+       "codecs -- Latin-1 text", 100)
+def codec_utf8_latin1(STR):
+    _codec_bench(STR, _CODEC_LATIN1_TEXT, "utf-8")
+
+@bench('French text (10KB) decode / encode "latin-1"',
+       "codecs -- Latin-1 text", 100)
+def codec_latin1_latin1(STR):
+    _codec_bench(STR, _CODEC_LATIN1_TEXT, "latin-1")
+
+@bench('French text (10KB) decode / encode "utf-16-be"',
+       "codecs -- Latin-1 text", 100)
+def codec_utf16_latin1(STR):
+    _codec_bench(STR, _CODEC_LATIN1_TEXT, "utf-16-be")
+
+@bench('Russian text (10KB) decode / encode "utf-8"',
+       "codecs -- BMP text", 100)
+def codec_utf8_bmp(STR):
+    _codec_bench(STR, _CODEC_BMP_TEXT, "utf-8")
+
+@bench('Russian text (10KB) decode / encode "utf-16-le"',
+       "codecs -- BMP text", 100)
+def codec_utf16_bmp(STR):
+    _codec_bench(STR, _CODEC_BMP_TEXT, "utf-16-le")
+
 
 # end of benchmarks
 
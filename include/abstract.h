@@ -272,6 +272,21 @@ xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx*/
      NULL, but the 'kw' argument can be NULL.
        */
 
+#ifndef Py_LIMITED_API
+     PyAPI_FUNC(PyObject *) _PyObject_FastCall(PyObject *callable_object,
+                                               PyObject **args,
+                                               Py_ssize_t nargs,
+                                               PyObject *kwnames);
+
+       /*
+     Call a callable Python object with the nargs positional arguments
+     in the C array args, followed by the values of the keyword
+     arguments named in the tuple kwnames, which may be NULL.  Python
+     functions and C functions are called without building an argument
+     tuple.
+       */
+#endif
+
      PyAPI_FUNC(PyObject *) PyObject_CallObject(PyObject *callable_object,
                                                 PyObject *args);
 
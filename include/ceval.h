@@ -109,6 +109,11 @@ PyAPI_FUNC(const char *) PyEval_GetFuncName(PyObject *);
 PyAPI_FUNC(const char *) PyEval_GetFuncDesc(PyObject *);
 
 PyAPI_FUNC(PyObject *) PyEval_GetCallStats(PyObject *);
+#ifndef Py_LIMITED_API
+PyAPI_FUNC(void) _PyEval_SetOpcodeProfile(int);
+PyAPI_FUNC(int) _PyEval_GetOpcodeProfile(void);
+PyAPI_FUNC(PyObject *) _PyEval_GetOpcodeCounts(PyObject *);
+#endif
 PyAPI_FUNC(PyObject *) PyEval_EvalFrame(struct _frame *);
 PyAPI_FUNC(PyObject *) PyEval_EvalFrameEx(struct _frame *f, int exc);
 
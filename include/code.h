@@ -30,6 +30,9 @@ typedef struct {
 				   Objects/lnotab_notes.txt for details. */
     void *co_zombieframe;     /* for optimization only (see frameobject.c) */
     PyObject *co_weakreflist;   /* to support weakrefs to code objects */
+    long *co_opcounts;          /* per-opcode execution counts, see
+                                   sys.setopcodeprofile(); NULL until the
+                                   code runs with the profile on */
 #ifdef WITH_PARALLEL
     Py_ssize_t px_execount;
     Py_ssize_t px_heapsize_avg;
@@ -57,6 +57,12 @@ PyAPI_FUNC(PyObject *) PyFunction_GetClosure(PyObject *);
 PyAPI_FUNC(int) PyFunction_SetClosure(PyObject *, PyObject *);
 PyAPI_FUNC(PyObject *) PyFunction_GetAnnotations(PyObject *);
 PyAPI_FUNC(int) PyFunction_SetAnnotations(PyObject *, PyObject *);
+#ifndef Py_LIMITED_API
+/* Defined in ceval.c; see _PyObject_FastCall() */
+PyAPI_FUNC(PyObject *) _PyFunction_FastCall(PyObject *func, PyObject **args,
+                                            Py_ssize_t nargs,
+                                            PyObject *kwnames);
+#endif
 
 /* Macros for direct access to these values. Type checks are *not*
    done, so use with care. */
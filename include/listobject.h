@@ -65,6 +65,9 @@ PyAPI_FUNC(PyObject *) _PyList_Extend(PyListObject *, PyObject *);
 
 PyAPI_FUNC(int) PyList_ClearFreeList(void);
 PyAPI_FUNC(void) _PyList_DebugMallocStats(FILE *out);
+
+PyAPI_FUNC(int) _PyList_SetParallelSort(int nthreads, Py_ssize_t min_size);
+PyAPI_FUNC(void) _PyList_GetParallelSort(int *nthreads, Py_ssize_t *min_size);
 #endif
 
 /* Macro, trading safety for speed */
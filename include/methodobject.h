@@ -19,6 +19,10 @@ typedef PyObject *(*PyCFunction)(PyObject *, PyObject *);
 typedef PyObject *(*PyCFunctionWithKeywords)(PyObject *, PyObject *,
                                              PyObject *);
 typedef PyObject *(*PyNoArgsFunction)(PyObject *);
+#ifndef Py_LIMITED_API
+typedef PyObject *(*_PyCFunctionFast)(PyObject *, PyObject **, Py_ssize_t,
+                                      PyObject *);
+#endif
 
 PyAPI_FUNC(PyCFunction) PyCFunction_GetFunction(PyObject *);
 PyAPI_FUNC(PyObject *) PyCFunction_GetSelf(PyObject *);
@@ -36,6 +40,12 @@ PyAPI_FUNC(int) PyCFunction_GetFlags(PyObject *);
         (((PyCFunctionObject *)func) -> m_ml -> ml_flags)
 #endif
 PyAPI_FUNC(PyObject *) PyCFunction_Call(PyObject *, PyObject *, PyObject *);
+#ifndef Py_LIMITED_API
+PyAPI_FUNC(PyObject *) _PyCFunction_FastCall(PyObject *func,
+                                             PyObject **args,
+                                             Py_ssize_t nargs,
+                                             PyObject *kwnames);
+#endif
 
 struct PyMethodDef {
     const char  *ml_name;   /* The name of the built-in function/method */
@@ -71,6 +81,14 @@ PyAPI_FUNC(PyObject *) PyCFunction_NewEx(PyMethodDef *, PyObject *,
 
 #define METH_COEXIST   0x0040
 
+/* METH_FASTCALL functions are _PyCFunctionFast: instead of a tuple they
+   get a C array of the positional arguments, followed by the values of
+   the keyword arguments whose names are in the kwnames tuple (NULL if
+   there are none).  Calls from the eval loop don't build a tuple. */
+#ifndef Py_LIMITED_API
+#define METH_FASTCALL  0x0080
+#endif
+
 #ifndef Py_LIMITED_API
 typedef struct {
     PyObject_HEAD
@@ -36,6 +36,11 @@ PyAPI_FUNC(PyObject *) _Py_BuildValue_SizeT(const char *, ...);
 #endif
 #ifndef Py_LIMITED_API
 PyAPI_FUNC(int) _PyArg_NoKeywords(const char *funcname, PyObject *kw);
+PyAPI_FUNC(int) _PyArg_NoStackKeywords(const char *funcname,
+                                       PyObject *kwnames);
+PyAPI_FUNC(int) _PyArg_UnpackStack(PyObject **args, Py_ssize_t nargs,
+                                   const char *name,
+                                   Py_ssize_t min, Py_ssize_t max, ...);
 
 PyAPI_FUNC(int) PyArg_VaParse(PyObject *, const char *, va_list);
 PyAPI_FUNC(int) PyArg_VaParseTupleAndKeywords(PyObject *, PyObject *,
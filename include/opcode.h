@@ -140,6 +140,14 @@ extern "C" {
 #define SET_ADD         146
 #define MAP_ADD         147
 
+/* Superinstructions, emitted by the peephole optimizer in place of the
+   first instruction of a pair.  The second instruction stays in the code
+   string after them; they read its argument and skip it. */
+#define LOAD_FAST_LOAD_FAST     148
+#define LOAD_FAST_LOAD_ATTR     149
+#define COMPARE_OP_POP_JUMP_IF_FALSE 150
+#define LOAD_CONST_RETURN_VALUE 151
+
 
 /* EXCEPT_HANDLER is a special, implicit block type which is created when
    entering an except handler. It is not an opcode but we define it here
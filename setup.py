@@ -620,8 +620,13 @@ class PyBuildExt(build_ext):
         # Fred Drake's interface to the Python parser
         exts.append( Extension('parser', ['parsermodule.c']) )
 
-        # Memory-mapped files (also works on Win32).
-        exts.append( Extension('mmap', ['mmapmodule.c']) )
+        # Memory-mapped files (also works on Win32).  shm_open() lives in
+        # librt on older glibc.
+        mmap_libs = []
+        if host_platform.startswith('linux'):
+            mmap_libs = ['rt']
+        exts.append( Extension('mmap', ['mmapmodule.c'],
+                               libraries=mmap_libs) )
 
         # Lance Ellinghaus's syslog module
         # syslog daemon interface